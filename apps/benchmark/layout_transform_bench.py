@@ -0,0 +1,89 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""Benchmark script for the layout transform kernel against the generated code.
+see README.md for the usage of this script.
+"""
+import argparse
+
+import numpy as np
+
+import tvm
+from tvm import te, topi
+from tvm.contrib import layout_transform
+
+# (shape, src_layout, dst_layout) of the layout transforms in common CNNs.
+WORKLOADS = [
+    ((1, 3, 224, 224), "NCHW", "NCHW3c"),
+    ((1, 64, 56, 56), "NCHW", "NCHW16c"),
+    ((1, 4, 56, 56, 16), "NCHW16c", "NCHW"),
+    ((1, 8, 28, 28, 16), "NCHW16c", "NCHW8c"),
+    ((1, 128, 28, 28), "NCHW", "NHWC"),
+    ((1, 28, 28, 128), "NHWC", "NCHW"),
+    ((1, 14, 14, 256), "NHWC", "NCHW16c"),
+    ((8, 256, 14, 14), "NCHW", "NHWC"),
+    ((1, 2048, 7, 7), "NCHW", "NHWC"),
+]
+
+
+def build(shape, src_layout, dst_layout, dtype, target, use_kernel):
+    data = te.placeholder(shape, name="data", dtype=dtype)
+    with tvm.target.Target(target):
+        if use_kernel:
+            out = layout_transform.layout_transform(data, src_layout, dst_layout)
+            s = topi.generic.schedule_extern(out)
+        else:
+            out = topi.layout_transform(data, src_layout, dst_layout)
+            s = topi.x86.schedule_injective(out)
+    return tvm.build(s, [data, out], target), out
+
+
+def evaluate(shape, src_layout, dst_layout, dtype, target, repeat):
+    dev = tvm.cpu(0)
+    data = tvm.nd.array(np.random.uniform(size=shape).astype(dtype), dev)
+    results = []
+    outputs = []
+    for use_kernel in [False, True]:
+        func, out = build(shape, src_layout, dst_layout, dtype, target, use_kernel)
+        out_nd = tvm.nd.empty([int(dim) for dim in out.shape], dtype, dev)
+        timer = func.time_evaluator(func.entry_name, dev, number=10, repeat=repeat)
+        results.append(np.median(timer(data, out_nd).results) * 1e6)
+        outputs.append(out_nd.numpy())
+    np.testing.assert_equal(outputs[0], outputs[1])
+    nbytes = 2 * data.numpy().nbytes
+    print(
+        "%-20s %-8s -> %-8s generated %9.2f us  kernel %9.2f us  (%5.2fx, %6.2f GB/s)"
+        % (
+            "x".join(str(dim) for dim in shape),
+            src_layout,
+            dst_layout,
+            results[0],
+            results[1],
+            results[0] / results[1],
+            nbytes / results[1] / 1e3,
+        )
+    )
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--target", type=str, default="llvm", help="The compilation target.")
+    parser.add_argument("--dtype", type=str, default="float32", help="The data type.")
+    parser.add_argument("--repeat", type=int, default=5)
+    args = parser.parse_args()
+
+    for shape, src_layout, dst_layout in WORKLOADS:
+        evaluate(shape, src_layout, dst_layout, args.dtype, args.target, args.repeat)
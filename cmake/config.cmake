@@ -223,6 +223,9 @@ set(USE_ROCBLAS OFF)
 # Whether use contrib sort
 set(USE_SORT ON)
 
+# Whether use the contrib layout transform kernel
+set(USE_LAYOUT_TRANSFORM ON)
+
 # Whether to use Arm Compute Library (ACL) codegen
 # We provide 2 separate flags since we cannot build the ACL runtime on x86.
 # This is useful for cases where you want to cross-compile a relay graph
@@ -309,6 +312,11 @@ set(USE_PT_TVMDSOOP OFF)
 # Whether to use STL's std::unordered_map or TVM's POD compatible Map
 set(USE_FALLBACK_STL_MAP OFF)
 
+# Whether to allocate runtime objects from a thread-caching pool of fixed size classes
+# instead of the global new/delete. The pool can be bypassed at runtime by setting the
+# environment variable TVM_OBJECT_POOL=0.
+set(USE_POOLED_OBJ_ALLOCATOR OFF)
+
 # Whether to enable Hexagon support
 set(USE_HEXAGON OFF)
 set(USE_HEXAGON_SDK /path/to/sdk)
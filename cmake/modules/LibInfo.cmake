@@ -78,6 +78,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_HEXAGON_EXTERNAL_LIBS="${USE_HEXAGON_EXTERNAL_LIBS}"
     TVM_INFO_USE_IOS_RPC="${USE_IOS_RPC}"
     TVM_INFO_USE_KHRONOS_SPIRV="${USE_KHRONOS_SPIRV}"
+    TVM_INFO_USE_LAYOUT_TRANSFORM="${USE_LAYOUT_TRANSFORM}"
     TVM_INFO_USE_LIBBACKTRACE="${USE_LIBBACKTRACE}"
     TVM_INFO_USE_LIBTORCH="${USE_LIBTORCH}"
     TVM_INFO_USE_LLVM="${USE_LLVM}"
@@ -92,6 +93,7 @@ function(add_lib_info src_file)
     TVM_INFO_USE_OPENCL_GTEST="${USE_OPENCL_GTEST}"
     TVM_INFO_USE_OPENMP="${USE_OPENMP}"
     TVM_INFO_USE_PAPI="${USE_PAPI}"
+    TVM_INFO_USE_POOLED_OBJ_ALLOCATOR="${USE_POOLED_OBJ_ALLOCATOR}"
     TVM_INFO_USE_PROFILER="${USE_PROFILER}"
     TVM_INFO_USE_PT_TVMDSOOP="${USE_PT_TVMDSOOP}"
     TVM_INFO_USE_RANDOM="${USE_RANDOM}"
@@ -492,6 +492,8 @@ class ConstraintContext {
   Analyzer* analyzer_;
   /*! \brief The constraint */
   PrimExpr constraint_;
+  /*! \brief The memoization context entered by this scope, 0 if memoization is disabled */
+  uint64_t memo_context_{0};
   /*! \brief function to be called in recovery */
   std::vector<std::function<void()>> recovery_functions_;
 };
@@ -550,6 +552,19 @@ class IntSetAnalyzer {
   Impl* impl_;
 };
 
+/*!
+ * \brief Hit and miss counters of the memoization in Analyzer.
+ * \sa Analyzer::EnableMemoization
+ */
+struct AnalyzerMemoStats {
+  /*! \brief The number of queries answered from the memo table. */
+  int64_t hits{0};
+  /*! \brief The number of queries that were computed and recorded. */
+  int64_t misses{0};
+  /*! \brief The number of times the memo table was flushed because it was full. */
+  int64_t flushes{0};
+};
+
 /*!
  * \brief Analyzer that contains bunch of sub-analyzers.
  *
@@ -581,6 +596,8 @@ class TVM_DLL Analyzer {
   TransitiveComparisonAnalyzer transitive_comparisons;
   /*! \brief constructor */
   Analyzer();
+  /*! \brief destructor */
+  ~Analyzer();
   /*!
    * \brief Notify all the sub-analyzers that var
    *        is created and binded to expr.
@@ -675,6 +692,50 @@ class TVM_DLL Analyzer {
    * \note Analyzer will call into sub-analyzers to get the result.
    */
   PrimExpr Simplify(const PrimExpr& expr, int steps = 2);
+  /*!
+   * \brief Enable or disable memoization of Simplify, CanProve,
+   *        CanProveEqual, CanProveGreaterEqual and CanProveLess.
+   *
+   *  Results are keyed by the identity of the queried expressions and
+   *  by the set of facts known to the analyzer.  Binding a variable
+   *  through Analyzer::Bind, or entering a ConstraintContext, switches
+   *  to a new set of facts.  Leaving a ConstraintContext in which no
+   *  variable was bound returns to the enclosing set of facts, so the
+   *  results recorded before entering the scope are reused.
+   *
+   * \param enable Whether to enable memoization.  Disabling it drops
+   *        all recorded results.
+   *
+   * \note Facts provided by calling the Update or Bind method of a
+   *       sub-analyzer directly are not tracked.  Call InvalidateMemo
+   *       after doing so.
+   *
+   * \note The Simplify, LoopPartition and StorageRewrite passes enable
+   *       memoization of their analyzers when the pass config option
+   *       "arith.enable_memoization" is set.
+   */
+  void EnableMemoization(bool enable = true);
+  /*!
+   * \brief Drop all memoized results, as the known facts have changed.
+   */
+  void InvalidateMemo();
+  /*!
+   * \brief Get the hit and miss counters of memoization.
+   * \return The counters accumulated since memoization was enabled.
+   */
+  AnalyzerMemoStats GetMemoStats() const;
+
+ private:
+  friend class ConstraintContext;
+  class MemoTable;
+  /*!
+   * \brief Get the constant integer bound of the rewrite-simplified expression.
+   * \param expr The expression.
+   * \return The bound, memoized if memoization is enabled.
+   */
+  ConstIntBound SimplifiedConstIntBound(const PrimExpr& expr);
+  /*! \brief The memoized results, nullptr if memoization is disabled. */
+  std::unique_ptr<MemoTable> memo_;
 };
 
 }  // namespace arith
@@ -38,6 +38,7 @@
 #include <tvm/runtime/c_runtime_api.h>
 #include <tvm/te/schedule.h>
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -165,6 +166,8 @@ class AccessAnalyzer : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(AccessAnalyzer, ObjectRef, AccessAnalyzerNode);
 };
 
+class InferBoundCache;
+
 /*! \brief The auto-scheduler's computational graph and related program analyses. */
 class ComputeDAGNode : public Object {
  public:
@@ -181,6 +184,11 @@ class ComputeDAGNode : public Object {
   State init_state;
   /*! \brief The static read-write access analyzer. */
   AccessAnalyzer access_analyzer;
+  /*!
+   * \brief The schedules replayed from prefixes of transform steps, so that InferBound only
+   * replays the steps a state adds on top of a cached one. Nullptr means caching is disabled.
+   */
+  std::shared_ptr<InferBoundCache> infer_bound_cache;
 
   void VisitAttrs(tvm::AttrVisitor* v) {
     v->Visit("tensors", &tensors);
@@ -188,6 +196,7 @@ class ComputeDAGNode : public Object {
     v->Visit("flop_ct", &flop_ct);
     v->Visit("init_state", &init_state);
     v->Visit("access_analyzer", &access_analyzer);
+    // `infer_bound_cache` is not visited
   }
 
   static constexpr const char* _type_key = "auto_scheduler.ComputeDAG";
@@ -274,6 +283,8 @@ class ComputeDAG : public ObjectRef {
    * The states can lose complete bound information after some transform steps (e.g., compute_at).
    * We can call this function to infer and fill all the bound information.
    * This function calls TVM InferBound pass internally to get the bound.
+   * The transform steps are replayed incrementally on top of the schedule cached for the longest
+   * prefix of them, which is usually the parent state the input state is derived from.
    * The returned state of this function is guaranteed to have complete bound information.
    * \param state The input state.
    * \return The State with complete bound information
@@ -285,6 +296,7 @@ class ComputeDAG : public ObjectRef {
    * The states can lose complete bound information after some transform steps (e.g., compute_at).
    * We can call this function to infer and fill all the bound information.
    * This function calls TVM InferBound pass internally to get the bound.
+   * The states are processed in parallel by the persistent runtime thread pool.
    * The returned state of this function is guaranteed to have complete bound information.
    * \param states The input states.
    * \return The States with complete bound information.
@@ -293,6 +305,12 @@ class ComputeDAG : public ObjectRef {
    */
   Array<State> InferBound(const Array<State>& states) const;
 
+  /*!
+   * \brief Set the number of step prefixes whose replayed schedules are cached for InferBound.
+   * \param size The maximum number of cached schedules. 0 disables the cache.
+   */
+  void SetInferBoundCacheSize(int size) const;
+
   /*!
    * \brief Since some steps may change the ComputeDAG (e.g. CacheRead/CacheWrite), the initial
    * ComputeDAG may not be up-to-date. This function replays the given transform steps from the
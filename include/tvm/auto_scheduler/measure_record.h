@@ -134,6 +134,30 @@ void WriteMeasureRecords(std::ostream* os, const Array<MeasureInput>& inputs,
 void ReadMeasureRecord(const std::string& str, MeasureInputNode* inp, MeasureResultNode* res,
                        std::string* log_version);
 
+/*!
+ * \brief Load measure records from a log file with multiple threads.
+ * The file is memory mapped and split into chunks at line boundaries, each of which is parsed
+ * by a separate thread. When `workload_key` is given, the workload key of each line is extracted
+ * first and the records of other workloads are skipped without being fully deserialized.
+ * \param filename The name of the log file.
+ * \param workload_key If defined, only the records of this workload are loaded.
+ * \param num_threads The number of threads to use. -1 means using all hardware threads.
+ * \return The MeasureInputs and MeasureResults in the same order as they appear in the file.
+ */
+std::pair<Array<MeasureInput>, Array<MeasureResult>> LoadRecordsParallel(
+    const String& filename, const Optional<String>& workload_key = NullOpt, int num_threads = -1);
+
+/*!
+ * \brief Load a log file with multiple threads and build an index of the best valid record of
+ * each workload on each target.
+ * \param filename The name of the log file.
+ * \param num_threads The number of threads to use. -1 means using all hardware threads.
+ * \return A map from the workload key to the best (MeasureInput, MeasureResult) pairs of that
+ * workload, one per distinct target. Records with errors are ignored.
+ */
+Map<String, Array<Array<ObjectRef>>> LoadBestRecordsByWorkload(const String& filename,
+                                                               int num_threads = -1);
+
 }  // namespace auto_scheduler
 }  // namespace tvm
 
@@ -29,6 +29,7 @@
 #include <tvm/node/reflection.h>
 #include <tvm/runtime/container/string.h>
 
+#include <chrono>
 #include <utility>
 #include <vector>
 
@@ -151,6 +152,20 @@ class PassInstrument : public ObjectRef {
   TVM_DEFINE_OBJECT_REF_METHODS(PassInstrument, ObjectRef, PassInstrumentNode);
 };
 
+/*!
+ * \brief Report the time a function pass spent on one of the functions it transformed
+ *  concurrently, so that the PassTimingInstrument shows it under the pass.
+ *
+ * \param name The name of the function.
+ * \param start The time the function started being transformed.
+ * \param end The time the function was transformed.
+ *
+ * \note Must be called on the thread running the pass. It does nothing if the pass is not timed.
+ */
+TVM_DLL void RecordConcurrentFunctionTime(const String& name,
+                                          std::chrono::steady_clock::time_point start,
+                                          std::chrono::steady_clock::time_point end);
+
 }  // namespace instrument
 }  // namespace tvm
 
@@ -64,6 +64,7 @@
 #include <tvm/runtime/container/string.h>
 #include <tvm/support/with.h>
 
+#include <functional>
 #include <string>
 #include <utility>
 
@@ -291,12 +292,21 @@ class PassInfoNode : public Object {
   /*! \brief The passes that are required to perform the current pass. */
   Array<String> required;
 
+  /*!
+   * \brief Whether a function level pass can transform the functions of a module concurrently.
+   *
+   *  Such a pass must only read the function it transforms, not the other functions of the
+   *  module, so that the result does not depend on the order of the visits. See ForEachFunction.
+   */
+  bool thread_safe = false;
+
   PassInfoNode() = default;
 
   void VisitAttrs(AttrVisitor* v) {
     v->Visit("opt_level", &opt_level);
     v->Visit("name", &name);
     v->Visit("required", &required);
+    v->Visit("thread_safe", &thread_safe);
   }
 
   static constexpr const char* _type_key = "transform.PassInfo";
@@ -315,8 +325,10 @@ class PassInfo : public ObjectRef {
    * \param opt_level The optimization level
    * \param name Name of the pass.
    * \param required  The passes that are required to perform the current pass.
+   * \param thread_safe Whether a function level pass can transform functions concurrently.
    */
-  TVM_DLL PassInfo(int opt_level, String name, Array<runtime::String> required);
+  TVM_DLL PassInfo(int opt_level, String name, Array<runtime::String> required,
+                   bool thread_safe = false);
 
   TVM_DEFINE_OBJECT_REF_METHODS(PassInfo, ObjectRef, PassInfoNode);
 };
@@ -494,6 +506,44 @@ TVM_DLL Pass
 CreateModulePass(const runtime::TypedPackedFunc<IRModule(IRModule, PassContext)>& pass_func,
                  int opt_level, String name, Array<runtime::String> required);
 
+/*!
+ * \brief Run a function-local transformation over the functions of a module.
+ *
+ *  Function level passes (e.g. tir::transform::PrimFuncPass) use this to visit
+ *  the functions they transform. By default the functions are visited sequentially
+ *  in order. When the pass is marked as PassInfoNode::thread_safe and the config
+ *  "ir.function_pass_num_threads" of the pass context is greater than 1 (or -1 for all
+ *  hardware threads), the functions are visited concurrently by that many threads, each
+ *  of which sees `pass_ctx` as the current PassContext. The pass instruments are not
+ *  invoked again in the worker threads, the time spent on each function is reported to
+ *  the PassTimingInstrument instead.
+ *
+ *  When the visits run in parallel, `fvisit` must not modify shared state, such as
+ *  the module being transformed; results are expected to be written to a slot owned
+ *  by the visited index and merged by the caller afterwards.
+ *
+ * \param pass_ctx The pass context the function pass runs in.
+ * \param pass_info The information of the function pass.
+ * \param funcs The functions to visit.
+ * \param fvisit The visitor, taking the index of the function to visit.
+ *
+ * \note If the visitor throws, the exception of the lowest failing index is rethrown
+ *       after all the visits have finished.
+ */
+TVM_DLL void ForEachFunction(const PassContext& pass_ctx, const PassInfo& pass_info,
+                             const Array<GlobalVar>& funcs,
+                             const std::function<void(int)>& fvisit);
+
+/*!
+ * \brief Get the number of threads a function level pass uses to transform functions.
+ * \param pass_ctx The pass context the function pass runs in.
+ * \param pass_info The information of the function pass.
+ * \param num_funcs The number of functions to transform.
+ * \return The number of threads, 1 if the functions are transformed sequentially.
+ */
+TVM_DLL int GetFunctionPassNumThreads(const PassContext& pass_ctx, const PassInfo& pass_info,
+                                      int num_funcs);
+
 /*!
  * \brief A special trace pass that prints the header and IR to LOG(INFO).
  * \param header The header to be attached to the output.
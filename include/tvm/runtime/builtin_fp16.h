@@ -34,6 +34,41 @@ TVM_DLL float __gnu_h2f_ieee(uint16_t);
 TVM_DLL uint16_t __truncsfhf2(float v);
 TVM_DLL uint16_t __truncdfhf2(double v);
 TVM_DLL float __extendhfsf2(uint16_t v);
+
+/*!
+ * \brief Convert an array of fp32 values to fp16, rounding to nearest even.
+ *  The conversion uses the widest SIMD instructions available on the host and
+ *  falls back to scalar code otherwise.
+ * \param src The fp32 input.
+ * \param dst The fp16 output, stored as raw bits.
+ * \param n The number of elements.
+ */
+TVM_DLL void TVMFloatToHalf(const float* src, uint16_t* dst, int64_t n);
+
+/*!
+ * \brief Convert an array of fp16 values to fp32.
+ * \param src The fp16 input, stored as raw bits.
+ * \param dst The fp32 output.
+ * \param n The number of elements.
+ */
+TVM_DLL void TVMHalfToFloat(const uint16_t* src, float* dst, int64_t n);
+
+/*!
+ * \brief Convert an array of fp32 values to bf16, rounding to nearest even.
+ *  NaN inputs are converted to a quiet NaN.
+ * \param src The fp32 input.
+ * \param dst The bf16 output, stored as raw bits.
+ * \param n The number of elements.
+ */
+TVM_DLL void TVMFloatToBFloat16(const float* src, uint16_t* dst, int64_t n);
+
+/*!
+ * \brief Convert an array of bf16 values to fp32.
+ * \param src The bf16 input, stored as raw bits.
+ * \param dst The fp32 output.
+ * \param n The number of elements.
+ */
+TVM_DLL void TVMBFloat16ToFloat(const uint16_t* src, float* dst, int64_t n);
 }
 
 #endif  // TVM_RUNTIME_BUILTIN_FP16_H_
@@ -32,6 +32,16 @@
 #include <unordered_map>
 #include <utility>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TVM_MAP_USE_SSE2 1
+#else
+#define TVM_MAP_USE_SSE2 0
+#endif
+
 #include "./base.h"
 #include "./optional.h"
 
@@ -510,61 +520,40 @@ class SmallMapNode : public MapNode,
   friend class runtime::InplaceArrayBase<SmallMapNode, MapNode::KVType>;
 };
 
-/*! \brief A specialization of hash map that implements the idea of array-based hash map.
- * Another reference implementation can be found [1].
+/*! \brief A specialization of hash map that implements the idea of open addressing with grouped
+ * control bytes, in the spirit of [1].
  *
  * A. Overview
  *
- * DenseMapNode did several improvements over traditional separate chaining hash,
- * in terms of cache locality, memory footprints and data organization.
- *
- * A1. Implicit linked list. For better cache locality, instead of using linked list
- * explicitly for each bucket, we store list data into a single array that spans contiguously
- * in memory, and then carefully design access patterns to make sure most of them fall into
- * a single cache line.
+ * A1. Control bytes. There is only 1 byte overhead for each slot in the array, which is one of
+ * 1) (0b10000000)_2: the slot is empty;
+ * 2) (0b11111110)_2: the slot is deleted, i.e. it can be reused by insertion, but probing has to
+ * continue past it;
+ * 3) (0b0hhhhhhh)_2: the slot is full, and the lower 7 bits are 7 bits of the hash code of its key.
  *
- * A2. 1-byte metadata. There is only 1 byte overhead for each slot in the array to indexing and
- * traversal. This can be divided in 3 parts.
- * 1) Reserved code: (0b11111111)_2 indicates a slot is empty; (0b11111110)_2 indicates protected,
- * which means the slot is empty but not allowed to be written.
- * 2) If not empty or protected, the highest bit is used to indicate whether data in the slot is
- * head of a linked list.
- * 3) The rest 7 bits are used as the "next pointer" (i.e. pointer to the next element). On 64-bit
- * architecture, an ordinary pointer can take up to 8 bytes, which is not acceptable overhead when
- * dealing with 16-byte ObjectRef pairs. Based on a commonly noticed fact that the lists are
- * relatively short (length <= 3) in hash maps, we follow [1]'s idea that only allows the pointer to
- * be one of the 126 possible values, i.e. if the next element of i-th slot is (i + x)-th element,
- * then x must be one of the 126 pre-defined values.
- *
- * A3. Data blocking. We organize the array in the way that every 16 elements forms a data block.
- * The 16-byte metadata of those 16 elements are stored together, followed by the real data, i.e.
- * 16 key-value pairs.
+ * A2. Data blocking. Every 16 slots form a data block, which is also the unit of probing. The 16
+ * control bytes of those slots are stored together, followed by the real data, i.e. 16 key-value
+ * pairs. To look up a key in a block, the 7 hash bits of the key are compared against all 16
+ * control bytes at once (using SSE2 when available), and only the slots that match have their keys
+ * compared. With 7 bits a mismatch is filtered out with probability 127/128, so a successful lookup
+ * almost always compares exactly one key.
  *
  * B. Implementation details
  *
  * B1. Power-of-2 table size and Fibonacci Hashing. We use power-of-two as table size to avoid
- * modulo for more efficient arithmetics. To make the hash-to-slot mapping distribute more evenly,
- * we use the Fibonacci Hashing [2] trick.
- *
- * B2. Traverse a linked list in the array.
- * 1) List head. Assume Fibonacci Hashing maps a given key to slot i, if metadata at slot i
- * indicates that it is list head, then we found the head; otherwise the list is empty. No probing
- * is done in this procedure. 2) Next element. To find the next element of a non-empty slot i, we
- * look at the last 7 bits of the metadata at slot i. If they are all zeros, then it is the end of
- * list; otherwise, we know that the next element is (i + candidates[the-last-7-bits]).
+ * modulo for more efficient arithmetics. The hash code is mixed with the Fibonacci Hashing [2]
+ * trick: its top bits select the slot where probing starts, and the 7 bits right below them are
+ * stored in the control byte.
  *
- * B3. InsertMaybeReHash an element. Following B2, we first traverse the linked list to see if this
- * element is in the linked list, and if not, we put it at the end by probing the next empty
- * position in one of the 126 candidate positions. If the linked list does not even exist, but the
- * slot for list head has been occupied by another linked list, we should find this intruder another
- * place.
+ * B2. Quadratic probing with triangle numbers. Blocks are probed in the order of g, g + 1, g + 3,
+ * g + 6, ..., which is provable to traverse a power-of-2-sized table [3]. Probing stops at the
+ * first block that has an empty slot, because insertion would have used that slot.
  *
- * B4. Quadratic probing with triangle numbers. In open address hashing, it is provable that probing
- * with triangle numbers can traverse power-of-2-sized table [3]. In our algorithm, we follow the
- * suggestion in [1] that also use triangle numbers for "next pointer" as well as sparing for list
- * head.
+ * B3. Erasure. Following B2, if the block of an erased slot still has an empty slot, no probing has
+ * ever continued past this block, so the slot becomes empty again. Otherwise it is marked as
+ * deleted. Deleted slots are reused by insertion and dropped when the table is rehashed.
  *
- * [1] https://github.com/skarupke/flat_hash_map
+ * [1] https://abseil.io/about/design/swisstables
  * [2] https://programmingpraxis.com/2018/06/19/fibonacci-hash/
  * [3] https://fgiesen.wordpress.com/2015/02/22/triangular-numbers-mod-2n/
  */
@@ -572,16 +561,14 @@ class DenseMapNode : public MapNode {
  private:
   /*! \brief The number of elements in a memory block */
   static constexpr int kBlockCap = 16;
-  /*! \brief Maximum load factor of the hash map */
-  static constexpr double kMaxLoadFactor = 0.99;
+  /*! \brief Maximum load factor of the hash map, counting both full and deleted slots */
+  static constexpr double kMaxLoadFactor = 0.875;
   /*! \brief Binary representation of the metadata of an empty slot */
-  static constexpr uint8_t kEmptySlot = uint8_t(0b11111111);
-  /*! \brief Binary representation of the metadata of a protected slot */
-  static constexpr uint8_t kProtectedSlot = uint8_t(0b11111110);
-  /*! \brief Number of probing choices available */
-  static constexpr int kNumJumpDists = 126;
-  /*! \brief Head of the implicit linked list */
-  struct ListNode;
+  static constexpr uint8_t kEmptySlot = uint8_t(0b10000000);
+  /*! \brief Binary representation of the metadata of a deleted slot */
+  static constexpr uint8_t kDeletedSlot = uint8_t(0b11111110);
+  /*! \brief Index indicating that a key is not found */
+  static constexpr uint64_t kNotFound = ~uint64_t(0);
   /*! \brief POD type of a block of memory */
   struct Block {
     uint8_t bytes[kBlockCap + kBlockCap * sizeof(KVType)];
@@ -597,7 +584,7 @@ class DenseMapNode : public MapNode {
    */
   ~DenseMapNode() { this->Reset(); }
   /*! \return The number of elements of the key */
-  size_t count(const key_type& key) const { return !Search(key).IsNone(); }
+  size_t count(const key_type& key) const { return Search(key) != kNotFound; }
   /*!
    * \brief Index value associated with a key, throw exception if the key does not exist
    * \param key The indexing key
@@ -616,8 +603,8 @@ class DenseMapNode : public MapNode {
    * \return The iterator of the entry associated with the key, end iterator if not exists
    */
   iterator find(const key_type& key) const {
-    ListNode node = Search(key);
-    return node.IsNone() ? end() : iterator(node.index, this);
+    uint64_t index = Search(key);
+    return index == kNotFound ? end() : iterator(index, this);
   }
   /*!
    * \brief Erase the entry associated with the iterator
@@ -625,8 +612,8 @@ class DenseMapNode : public MapNode {
    */
   void erase(const iterator& position) {
     uint64_t index = position.index;
-    if (position.self != nullptr && index <= this->slots_) {
-      Erase(ListNode(index, this));
+    if (position.self != nullptr && index <= this->slots_ && IsFullSlot(Meta(index))) {
+      Erase(index);
     }
   }
   /*! \return begin iterator */
@@ -634,12 +621,7 @@ class DenseMapNode : public MapNode {
     if (slots_ == 0) {
       return iterator(0, this);
     }
-    for (uint64_t index = 0; index <= slots_; ++index) {
-      if (!ListNode(index, this).IsEmpty()) {
-        return iterator(index, this);
-      }
-    }
-    return iterator(slots_ + 1, this);
+    return iterator(NextFull(0), this);
   }
   /*! \return end iterator */
   iterator end() const { return slots_ == 0 ? iterator(0, this) : iterator(slots_ + 1, this); }
@@ -648,173 +630,144 @@ class DenseMapNode : public MapNode {
   /*!
    * \brief Search for the given key
    * \param key The key
-   * \return ListNode that associated with the key
+   * \return The index of the slot that holds the key, kNotFound if not exists
    */
-  ListNode Search(const key_type& key) const {
+  uint64_t Search(const key_type& key) const {
     if (this->size_ == 0) {
-      return ListNode();
+      return kNotFound;
     }
-    for (ListNode iter = GetListHead(ObjectHash()(key)); !iter.IsNone(); iter.MoveToNext(this)) {
-      if (ObjectEqual()(key, iter.Key())) {
-        return iter;
+    uint64_t mixed = MixHash(ObjectHash()(key));
+    uint8_t h2 = HashBits(mixed);
+    uint64_t n_blocks = NumBlocks();
+    uint64_t bi = BlockFromHash(mixed);
+    for (uint64_t step = 1; step <= n_blocks; ++step) {
+      const Block& block = data_[bi];
+      for (uint32_t mask = MatchByte(block.bytes, h2); mask != 0; mask &= mask - 1) {
+        int j = CountTrailingZeros(mask);
+        if (ObjectEqual()(key, BlockData(block, j)->first)) {
+          return bi * kBlockCap + j;
+        }
       }
+      if (MatchByte(block.bytes, kEmptySlot) != 0) {
+        return kNotFound;
+      }
+      bi = (bi + step) & (n_blocks - 1);
     }
-    return ListNode();
+    return kNotFound;
   }
   /*!
    * \brief Search for the given key, throw exception if not exists
    * \param key The key
-   * \return ListNode that associated with the key
+   * \return The value associated with the key
    */
   mapped_type& At(const key_type& key) const {
-    ListNode iter = Search(key);
-    ICHECK(!iter.IsNone()) << "IndexError: key is not in Map";
-    return iter.Val();
+    uint64_t index = Search(key);
+    ICHECK(index != kNotFound) << "IndexError: key is not in Map";
+    return DataAt(index)->second;
   }
   /*!
    * \brief Try to insert a key, or do nothing if already exists
    * \param key The indexing key
-   * \param result The linked-list entry found or just constructed
-   * \return A boolean, indicating if actual insertion happens
+   * \param result The index of the slot found or just constructed
+   * \return A boolean, indicating if the key is in the map after the call. If false, the map has
+   * to be rehashed to make space for the key.
    */
-  bool TryInsert(const key_type& key, ListNode* result) {
+  bool TryInsert(const key_type& key, uint64_t* result) {
     if (slots_ == 0) {
       return false;
     }
-    // required that `iter` to be the head of a linked list through which we can iterator
-    ListNode iter = IndexFromHash(ObjectHash()(key));
-    // `iter` can be: 1) empty; 2) body of an irrelevant list; 3) head of the relevant list
-    // Case 1: empty
-    if (iter.IsEmpty()) {
-      iter.NewHead(KVType(key, ObjectRef(nullptr)));
-      this->size_ += 1;
-      *result = iter;
-      return true;
-    }
-    // Case 2: body of an irrelevant list
-    if (!iter.IsHead()) {
-      // we move the elements around and construct the single-element linked list
-      return IsFull() ? false : TrySpareListHead(iter, key, result);
-    }
-    // Case 3: head of the relevant list
-    // we iterate through the linked list until the end
-    // make sure `iter` is the previous element of `next`
-    ListNode next = iter;
-    do {
-      // find equal item, do not insert
-      if (ObjectEqual()(key, next.Key())) {
-        *result = next;
-        return true;
+    uint64_t mixed = MixHash(ObjectHash()(key));
+    uint8_t h2 = HashBits(mixed);
+    uint64_t n_blocks = NumBlocks();
+    uint64_t bi = BlockFromHash(mixed);
+    // the first reusable slot on the probing sequence
+    uint64_t target = kNotFound;
+    for (uint64_t step = 1; step <= n_blocks; ++step) {
+      const Block& block = data_[bi];
+      for (uint32_t mask = MatchByte(block.bytes, h2); mask != 0; mask &= mask - 1) {
+        int j = CountTrailingZeros(mask);
+        if (ObjectEqual()(key, BlockData(block, j)->first)) {
+          *result = bi * kBlockCap + j;
+          return true;
+        }
       }
-      // make sure `iter` is the previous element of `next`
-      iter = next;
-    } while (next.MoveToNext(this));
-    // `iter` is the tail of the linked list
-    // always check capacity before insertion
-    if (IsFull()) {
-      return false;
+      if (target == kNotFound) {
+        uint32_t deleted = MatchByte(block.bytes, kDeletedSlot);
+        if (deleted != 0) {
+          target = bi * kBlockCap + CountTrailingZeros(deleted);
+        }
+      }
+      uint32_t empty = MatchByte(block.bytes, kEmptySlot);
+      if (empty != 0) {
+        if (target == kNotFound) {
+          // taking an empty slot consumes the capacity, which is checked before insertion
+          if (IsFull()) {
+            return false;
+          }
+          target = bi * kBlockCap + CountTrailingZeros(empty);
+        }
+        break;
+      }
+      bi = (bi + step) & (n_blocks - 1);
     }
-    // find the next empty slot
-    uint8_t jump;
-    if (!iter.GetNextEmpty(this, &jump, result)) {
+    if (target == kNotFound) {
       return false;
     }
-    result->NewTail(KVType(key, ObjectRef(nullptr)));
-    // link `iter` to `empty`, and move forward
-    iter.SetJump(jump);
+    if (Meta(target) == kDeletedSlot) {
+      this->n_deleted_ -= 1;
+    }
+    Meta(target) = h2;
+    new (DataAt(target)) KVType(key, ObjectRef(nullptr));
     this->size_ += 1;
+    *result = target;
     return true;
   }
   /*!
-   * \brief Spare an entry to be the head of a linked list.
-   * As described in B3, during insertion, it is possible that the entire linked list does not
-   * exist, but the slot of its head has been occupied by other linked lists. In this case, we need
-   * to spare the slot by moving away the elements to another valid empty one to make insertion
-   * possible.
-   * \param target The given entry to be spared
-   * \param key The indexing key
-   * \param result The linked-list entry constructed as the head
-   * \return A boolean, if actual insertion happens
-   */
-  bool TrySpareListHead(ListNode target, const key_type& key, ListNode* result) {
-    // `target` is not the head of the linked list
-    // move the original item of `target` (if any)
-    // and construct new item on the position `target`
-    // To make `target` empty, we
-    // 1) find `w` the previous element of `target` in the linked list
-    // 2) copy the linked list starting from `r = target`
-    // 3) paste them after `w`
-    // read from the linked list after `r`
-    ListNode r = target;
-    // write to the tail of `w`
-    ListNode w = target.FindPrev(this);
-    // after `target` is moved, we disallow writing to the slot
-    bool is_first = true;
-    uint8_t r_meta, jump;
-    ListNode empty;
-    do {
-      // `jump` describes how `w` is jumped to `empty`
-      // rehash if there is no empty space after `w`
-      if (!w.GetNextEmpty(this, &jump, &empty)) {
-        return false;
-      }
-      // move `r` to `empty`
-      empty.NewTail(std::move(r.Data()));
-      // clear the metadata of `r`
-      r_meta = r.Meta();
-      if (is_first) {
-        is_first = false;
-        r.SetProtected();
-      } else {
-        r.SetEmpty();
+   * \brief Insert an entry whose key is known not to be in the map, which has no deleted slots
+   * and enough capacity. This is used to populate a freshly rehashed map.
+   * \param kv The entry to be inserted
+   */
+  void InsertUnique(KVType&& kv) {
+    uint64_t mixed = MixHash(ObjectHash()(kv.first));
+    uint64_t n_blocks = NumBlocks();
+    uint64_t bi = BlockFromHash(mixed);
+    for (uint64_t step = 1;; ++step) {
+      uint32_t empty = MatchByte(data_[bi].bytes, kEmptySlot);
+      if (empty != 0) {
+        uint64_t index = bi * kBlockCap + CountTrailingZeros(empty);
+        Meta(index) = HashBits(mixed);
+        new (DataAt(index)) KVType(std::move(kv));
+        this->size_ += 1;
+        return;
       }
-      // link `w` to `empty`, and move forward
-      w.SetJump(jump);
-      w = empty;
-      // move `r` forward as well
-    } while (r.MoveToNext(this, r_meta));
-    // finally we have done moving the linked list
-    // fill data_ into `target`
-    target.NewHead(KVType(key, ObjectRef(nullptr)));
-    this->size_ += 1;
-    *result = target;
-    return true;
+      ICHECK_LT(step, n_blocks);
+      bi = (bi + step) & (n_blocks - 1);
+    }
   }
   /*!
-   * \brief Remove a ListNode
-   * \param iter The node to be removed
+   * \brief Remove the entry in a slot
+   * \param index The index of the slot to be removed
    */
-  void Erase(const ListNode& iter) {
+  void Erase(uint64_t index) {
     this->size_ -= 1;
-    if (!iter.HasNext()) {
-      // `iter` is the last
-      if (!iter.IsHead()) {
-        // cut the link if there is any
-        iter.FindPrev(this).SetJump(0);
-      }
-      iter.Data().KVType::~KVType();
-      iter.SetEmpty();
+    DataAt(index)->KVType::~KVType();
+    // see B3: the slot can be empty again if probing never goes past this block
+    if (MatchByte(data_[index / kBlockCap].bytes, kEmptySlot) != 0) {
+      Meta(index) = kEmptySlot;
     } else {
-      ListNode last = iter, prev = iter;
-      for (last.MoveToNext(this); last.HasNext(); prev = last, last.MoveToNext(this)) {
-      }
-      iter.Data() = std::move(last.Data());
-      last.SetEmpty();
-      prev.SetJump(0);
+      Meta(index) = kDeletedSlot;
+      this->n_deleted_ += 1;
     }
   }
   /*! \brief Clear the container to empty, release all entries and memory acquired */
   void Reset() {
-    uint64_t n_blocks = CalcNumBlocks(this->slots_);
+    uint64_t n_blocks = NumBlocks();
     for (uint64_t bi = 0; bi < n_blocks; ++bi) {
-      uint8_t* meta_ptr = data_[bi].bytes;
-      KVType* data_ptr = reinterpret_cast<KVType*>(data_[bi].bytes + kBlockCap);
-      for (int j = 0; j < kBlockCap; ++j, ++meta_ptr, ++data_ptr) {
-        uint8_t& meta = *meta_ptr;
-        if (meta != uint8_t(kProtectedSlot) && meta != uint8_t(kEmptySlot)) {
-          meta = uint8_t(kEmptySlot);
-          data_ptr->KVType::~KVType();
-        }
+      Block& block = data_[bi];
+      for (uint32_t mask = MatchFull(block.bytes); mask != 0; mask &= mask - 1) {
+        int j = CountTrailingZeros(mask);
+        block.bytes[j] = kEmptySlot;
+        BlockData(block, j)->KVType::~KVType();
       }
     }
     ReleaseMemory();
@@ -826,6 +779,7 @@ class DenseMapNode : public MapNode {
     data_ = nullptr;
     slots_ = 0;
     size_ = 0;
+    n_deleted_ = 0;
     fib_shift_ = 63;
   }
   /*!
@@ -836,14 +790,19 @@ class DenseMapNode : public MapNode {
    */
   static ObjectPtr<DenseMapNode> Empty(uint32_t fib_shift, uint64_t n_slots) {
     ICHECK_GT(n_slots, uint64_t(SmallMapNode::kMaxSize));
+    // the table holds at least one block
+    for (; n_slots < kBlockCap; n_slots <<= 1) {
+      fib_shift -= 1;
+    }
     ObjectPtr<DenseMapNode> p = make_object<DenseMapNode>();
-    uint64_t n_blocks = CalcNumBlocks(n_slots - 1);
+    uint64_t n_blocks = n_slots / kBlockCap;
     Block* block = p->data_ = new Block[n_blocks];
     p->slots_ = n_slots - 1;
     p->size_ = 0;
+    p->n_deleted_ = 0;
     p->fib_shift_ = fib_shift;
     for (uint64_t i = 0; i < n_blocks; ++i, ++block) {
-      std::fill(block->bytes, block->bytes + kBlockCap, uint8_t(kEmptySlot));
+      std::fill(block->bytes, block->bytes + kBlockCap, kEmptySlot);
     }
     return p;
   }
@@ -854,23 +813,19 @@ class DenseMapNode : public MapNode {
    */
   static ObjectPtr<DenseMapNode> CopyFrom(DenseMapNode* from) {
     ObjectPtr<DenseMapNode> p = make_object<DenseMapNode>();
-    uint64_t n_blocks = CalcNumBlocks(from->slots_);
+    uint64_t n_blocks = from->NumBlocks();
     p->data_ = new Block[n_blocks];
     p->slots_ = from->slots_;
     p->size_ = from->size_;
+    p->n_deleted_ = from->n_deleted_;
     p->fib_shift_ = from->fib_shift_;
     for (uint64_t bi = 0; bi < n_blocks; ++bi) {
-      uint8_t* meta_ptr_from = from->data_[bi].bytes;
-      KVType* data_ptr_from = reinterpret_cast<KVType*>(from->data_[bi].bytes + kBlockCap);
-      uint8_t* meta_ptr_to = p->data_[bi].bytes;
-      KVType* data_ptr_to = reinterpret_cast<KVType*>(p->data_[bi].bytes + kBlockCap);
-      for (int j = 0; j < kBlockCap;
-           ++j, ++meta_ptr_from, ++data_ptr_from, ++meta_ptr_to, ++data_ptr_to) {
-        uint8_t& meta = *meta_ptr_to = *meta_ptr_from;
-        ICHECK(meta != kProtectedSlot);
-        if (meta != uint8_t(kEmptySlot)) {
-          new (data_ptr_to) KVType(*data_ptr_from);
-        }
+      const Block& block_from = from->data_[bi];
+      Block& block_to = p->data_[bi];
+      std::copy(block_from.bytes, block_from.bytes + kBlockCap, block_to.bytes);
+      for (uint32_t mask = MatchFull(block_from.bytes); mask != 0; mask &= mask - 1) {
+        int j = CountTrailingZeros(mask);
+        new (BlockData(block_to, j)) KVType(*BlockData(block_from, j));
       }
     }
     return p;
@@ -882,52 +837,64 @@ class DenseMapNode : public MapNode {
    */
   static void InsertMaybeReHash(const KVType& kv, ObjectPtr<Object>* map) {
     DenseMapNode* map_node = static_cast<DenseMapNode*>(map->get());
-    ListNode iter;
+    uint64_t index;
     // Try to insert. If succeed, we simply return
-    if (map_node->TryInsert(kv.first, &iter)) {
-      iter.Val() = kv.second;
+    if (map_node->TryInsert(kv.first, &index)) {
+      map_node->DataAt(index)->second = kv.second;
       return;
     }
     ICHECK_GT(map_node->slots_, uint64_t(SmallMapNode::kMaxSize));
-    // Otherwise, start rehash
-    ObjectPtr<Object> p = Empty(map_node->fib_shift_ - 1, map_node->slots_ * 2 + 2);
-    // Insert the given `kv` into the new hash map
-    InsertMaybeReHash(kv, &p);
-    uint64_t n_blocks = CalcNumBlocks(map_node->slots_);
-    // Then Insert data from the original block.
+    // Otherwise, start rehash. The table is only grown if the live entries take up more than half
+    // of the capacity, otherwise rehashing in place is enough to drop the deleted slots.
+    uint64_t n_slots = map_node->slots_ + 1;
+    uint32_t fib_shift = map_node->fib_shift_;
+    if (map_node->size_ + 1 > n_slots * kMaxLoadFactor / 2) {
+      n_slots *= 2;
+      fib_shift -= 1;
+    }
+    ObjectPtr<DenseMapNode> p = Empty(fib_shift, n_slots);
+    // Then move data from the original blocks, whose keys are known to be distinct.
+    uint64_t n_blocks = map_node->NumBlocks();
     for (uint64_t bi = 0; bi < n_blocks; ++bi) {
-      uint8_t* meta_ptr = map_node->data_[bi].bytes;
-      KVType* data_ptr = reinterpret_cast<KVType*>(map_node->data_[bi].bytes + kBlockCap);
-      for (int j = 0; j < kBlockCap; ++j, ++meta_ptr, ++data_ptr) {
-        uint8_t& meta = *meta_ptr;
-        if (meta != uint8_t(kProtectedSlot) && meta != uint8_t(kEmptySlot)) {
-          meta = uint8_t(kEmptySlot);
-          KVType kv = std::move(*data_ptr);
-          InsertMaybeReHash(kv, &p);
-        }
+      Block& block = map_node->data_[bi];
+      for (uint32_t mask = MatchFull(block.bytes); mask != 0; mask &= mask - 1) {
+        int j = CountTrailingZeros(mask);
+        block.bytes[j] = kEmptySlot;
+        p->InsertUnique(std::move(*BlockData(block, j)));
       }
     }
+    // Finally insert the given `kv` into the new hash map
+    p->InsertUnique(KVType(kv));
     map_node->ReleaseMemory();
-    *map = p;
+    *map = std::move(p);
   }
   /*!
    * \brief Check whether the hash table is full
    * \return A boolean indicating whether hash table is full
    */
-  bool IsFull() const { return size_ + 1 > (slots_ + 1) * kMaxLoadFactor; }
+  bool IsFull() const { return size_ + n_deleted_ + 1 > (slots_ + 1) * kMaxLoadFactor; }
   /*!
-   * \brief Increment the pointer
-   * \param index The pointer to be incremented
-   * \return The increased pointer
+   * \brief Find the first full slot starting from the given index
+   * \param index The index to start from
+   * \return The index of the full slot, slots_ + 1 if there is none
    */
-  uint64_t IncItr(uint64_t index) const {
-    for (++index; index <= slots_; ++index) {
-      if (!ListNode(index, this).IsEmpty()) {
-        return index;
+  uint64_t NextFull(uint64_t index) const {
+    uint64_t n_slots = slots_ + 1;
+    while (index < n_slots) {
+      uint32_t mask = MatchFull(data_[index / kBlockCap].bytes) >> (index % kBlockCap);
+      if (mask != 0) {
+        return index + CountTrailingZeros(mask);
       }
+      index = (index / kBlockCap + 1) * kBlockCap;
     }
-    return slots_ + 1;
+    return n_slots;
   }
+  /*!
+   * \brief Increment the pointer
+   * \param index The pointer to be incremented
+   * \return The increased pointer
+   */
+  uint64_t IncItr(uint64_t index) const { return NextFull(index + 1); }
   /*!
    * \brief Decrement the pointer
    * \param index The pointer to be decremented
@@ -936,7 +903,7 @@ class DenseMapNode : public MapNode {
   uint64_t DecItr(uint64_t index) const {
     while (index != 0) {
       index -= 1;
-      if (!ListNode(index, this).IsEmpty()) {
+      if (IsFullSlot(Meta(index))) {
         return index;
       }
     }
@@ -947,20 +914,78 @@ class DenseMapNode : public MapNode {
    * \param index The pointer to be dereferenced
    * \return The result
    */
-  KVType* DeRefItr(uint64_t index) const { return &ListNode(index, this).Data(); }
-  /*! \brief Construct from hash code */
-  ListNode IndexFromHash(uint64_t hash_value) const {
-    return ListNode(FibHash(hash_value, fib_shift_), this);
+  KVType* DeRefItr(uint64_t index) const { return DataAt(index); }
+  /*! \brief The number of blocks in the hash table */
+  uint64_t NumBlocks() const { return data_ == nullptr ? 0 : (slots_ + 1) / kBlockCap; }
+  /*! \brief Metadata of a slot */
+  uint8_t& Meta(uint64_t index) const { return data_[index / kBlockCap].bytes[index % kBlockCap]; }
+  /*! \brief Data of a slot */
+  KVType* DataAt(uint64_t index) const {
+    return BlockData(data_[index / kBlockCap], index % kBlockCap);
+  }
+  /*! \brief Data of the j-th slot in a block */
+  static KVType* BlockData(const Block& block, int j) {
+    return reinterpret_cast<KVType*>(const_cast<uint8_t*>(block.bytes) + kBlockCap) + j;
   }
-  /*! \brief Construct from hash code if the position is head of list */
-  ListNode GetListHead(uint64_t hash_value) const {
-    ListNode node = IndexFromHash(hash_value);
-    return node.IsHead() ? node : ListNode();
+  /*! \brief If the metadata indicates a full slot */
+  static bool IsFullSlot(uint8_t meta) { return (meta & 0b10000000) == 0; }
+  /*! \brief The block where probing of a mixed hash code starts */
+  uint64_t BlockFromHash(uint64_t mixed) const { return (mixed >> fib_shift_) / kBlockCap; }
+  /*! \brief The 7 bits of a mixed hash code stored in the metadata */
+  uint8_t HashBits(uint64_t mixed) const {
+    return static_cast<uint8_t>((mixed >> (fib_shift_ - 7)) & 0b01111111);
+  }
+  /*!
+   * \brief Match the metadata of a block against a byte
+   * \param meta The metadata of the block
+   * \param byte The byte to be matched
+   * \return A bit mask whose j-th bit indicates whether the j-th slot matches
+   */
+  static uint32_t MatchByte(const uint8_t* meta, uint8_t byte) {
+#if TVM_MAP_USE_SSE2
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(meta));
+    __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(byte)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(match));
+#else
+    uint32_t mask = 0;
+    for (int j = 0; j < kBlockCap; ++j) {
+      mask |= static_cast<uint32_t>(meta[j] == byte) << j;
+    }
+    return mask;
+#endif  // TVM_MAP_USE_SSE2
+  }
+  /*!
+   * \brief Find the full slots of a block
+   * \param meta The metadata of the block
+   * \return A bit mask whose j-th bit indicates whether the j-th slot is full
+   */
+  static uint32_t MatchFull(const uint8_t* meta) {
+#if TVM_MAP_USE_SSE2
+    __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(meta));
+    return ~static_cast<uint32_t>(_mm_movemask_epi8(ctrl)) & 0xFFFFu;
+#else
+    uint32_t mask = 0;
+    for (int j = 0; j < kBlockCap; ++j) {
+      mask |= static_cast<uint32_t>(IsFullSlot(meta[j])) << j;
+    }
+    return mask;
+#endif  // TVM_MAP_USE_SSE2
   }
-  /*! \brief Construct the number of blocks in the hash table */
-  static uint64_t CalcNumBlocks(uint64_t n_slots_m1) {
-    uint64_t n_slots = n_slots_m1 > 0 ? n_slots_m1 + 1 : 0;
-    return (n_slots + kBlockCap - 1) / kBlockCap;
+  /*! \brief The index of the lowest set bit of a non-zero mask */
+  static int CountTrailingZeros(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long index;  // NOLINT(*)
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    int index = 0;
+    for (; (mask & 1) == 0; mask >>= 1) {
+      ++index;
+    }
+    return index;
+#endif
   }
   /*!
    * \brief Calculate the power-of-2 table size given the lower-bound of required capacity.
@@ -985,137 +1010,23 @@ class DenseMapNode : public MapNode {
     }
   }
   /*!
-   * \brief Fibonacci Hashing, maps a hash code to an index in a power-of-2-sized table.
+   * \brief Fibonacci Hashing, mixes a hash code so that its top bits distribute evenly.
    * See also: https://programmingpraxis.com/2018/06/19/fibonacci-hash/.
    * \param hash_value The raw hash value
-   * \param fib_shift The shift in Fibonacci Hashing
-   * \return An index calculated using Fibonacci Hashing
+   * \return The mixed hash code, whose top bits are used as an index into the table
    */
-  static uint64_t FibHash(uint64_t hash_value, uint32_t fib_shift) {
+  static uint64_t MixHash(uint64_t hash_value) {
     constexpr uint64_t coeff = 11400714819323198485ull;
-    return (coeff * hash_value) >> fib_shift;
+    return coeff * hash_value;
   }
-  /*! \brief The implicit in-place linked list used to index a chain */
-  struct ListNode {
-    /*! \brief Construct None */
-    ListNode() : index(0), block(nullptr) {}
-    /*! \brief Construct from position */
-    ListNode(uint64_t index, const DenseMapNode* self)
-        : index(index), block(self->data_ + (index / kBlockCap)) {}
-    /*! \brief Metadata on the entry */
-    uint8_t& Meta() const { return *(block->bytes + index % kBlockCap); }
-    /*! \brief Data on the entry */
-    KVType& Data() const {
-      return *(reinterpret_cast<KVType*>(block->bytes + kBlockCap +
-                                         (index % kBlockCap) * sizeof(KVType)));
-    }
-    /*! \brief Key on the entry */
-    key_type& Key() const { return Data().first; }
-    /*! \brief Value on the entry */
-    mapped_type& Val() const { return Data().second; }
-    /*! \brief If the entry is head of linked list */
-    bool IsHead() const { return (Meta() & 0b10000000) == 0b00000000; }
-    /*! \brief If the entry is none */
-    bool IsNone() const { return block == nullptr; }
-    /*! \brief If the entry is empty slot */
-    bool IsEmpty() const { return Meta() == uint8_t(kEmptySlot); }
-    /*! \brief If the entry is protected slot */
-    bool IsProtected() const { return Meta() == uint8_t(kProtectedSlot); }
-    /*! \brief Set the entry to be empty */
-    void SetEmpty() const { Meta() = uint8_t(kEmptySlot); }
-    /*! \brief Set the entry to be protected */
-    void SetProtected() const { Meta() = uint8_t(kProtectedSlot); }
-    /*! \brief Set the entry's jump to its next entry */
-    void SetJump(uint8_t jump) const { (Meta() &= 0b10000000) |= jump; }
-    /*! \brief Construct a head of linked list in-place */
-    void NewHead(KVType v) const {
-      Meta() = 0b00000000;
-      new (&Data()) KVType(std::move(v));
-    }
-    /*! \brief Construct a tail of linked list in-place */
-    void NewTail(KVType v) const {
-      Meta() = 0b10000000;
-      new (&Data()) KVType(std::move(v));
-    }
-    /*! \brief If the entry has next entry on the linked list */
-    bool HasNext() const { return NextProbeLocation(Meta() & 0b01111111) != 0; }
-    /*! \brief Move the entry to the next entry on the linked list */
-    bool MoveToNext(const DenseMapNode* self, uint8_t meta) {
-      uint64_t offset = NextProbeLocation(meta & 0b01111111);
-      if (offset == 0) {
-        index = 0;
-        block = nullptr;
-        return false;
-      }
-      index = (index + offset) & (self->slots_);
-      block = self->data_ + (index / kBlockCap);
-      return true;
-    }
-    /*! \brief Move the entry to the next entry on the linked list */
-    bool MoveToNext(const DenseMapNode* self) { return MoveToNext(self, Meta()); }
-    /*! \brief Get the previous entry on the linked list */
-    ListNode FindPrev(const DenseMapNode* self) const {
-      // start from the head of the linked list, which must exist
-      ListNode next = self->IndexFromHash(ObjectHash()(Key()));
-      // `prev` is always the previous item of `next`
-      ListNode prev = next;
-      for (next.MoveToNext(self); index != next.index; prev = next, next.MoveToNext(self)) {
-      }
-      return prev;
-    }
-    /*! \brief Get the next empty jump */
-    bool GetNextEmpty(const DenseMapNode* self, uint8_t* jump, ListNode* result) const {
-      for (uint8_t idx = 1; idx < kNumJumpDists; ++idx) {
-        ListNode candidate((index + NextProbeLocation(idx)) & (self->slots_), self);
-        if (candidate.IsEmpty()) {
-          *jump = idx;
-          *result = candidate;
-          return true;
-        }
-      }
-      return false;
-    }
-    /*! \brief Index on the real array */
-    uint64_t index;
-    /*! \brief Pointer to the actual block */
-    Block* block;
-  };
 
  protected:
   /*! \brief fib shift in Fibonacci Hashing */
   uint32_t fib_shift_;
+  /*! \brief number of deleted slots */
+  uint64_t n_deleted_;
   /*! \brief array of data blocks */
   Block* data_;
-  static uint64_t NextProbeLocation(size_t index) {
-    /* clang-format off */
-    /*! \brief Candidates of probing distance */
-    static const uint64_t kNextProbeLocation[kNumJumpDists] {
-      0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
-      // Quadratic probing with triangle numbers. See also:
-      // 1) https://en.wikipedia.org/wiki/Quadratic_probing
-      // 2) https://fgiesen.wordpress.com/2015/02/22/triangular-numbers-mod-2n/
-      // 3) https://github.com/skarupke/flat_hash_map
-      21, 28, 36, 45, 55, 66, 78, 91, 105, 120,
-      136, 153, 171, 190, 210, 231, 253, 276, 300, 325,
-      351, 378, 406, 435, 465, 496, 528, 561, 595, 630,
-      666, 703, 741, 780, 820, 861, 903, 946, 990, 1035,
-      1081, 1128, 1176, 1225, 1275, 1326, 1378, 1431, 1485, 1540,
-      1596, 1653, 1711, 1770, 1830, 1891, 1953, 2016, 2080, 2145,
-      2211, 2278, 2346, 2415, 2485, 2556, 2628,
-      // larger triangle numbers
-      8515, 19110, 42778, 96141, 216153,
-      486591, 1092981, 2458653, 5532801, 12442566,
-      27993903, 62983476, 141717030, 318844378, 717352503,
-      1614057336, 3631522476, 8170957530, 18384510628, 41364789378,
-      93070452520, 209408356380, 471168559170, 1060128894105, 2385289465695,
-      5366898840628, 12075518705635, 27169915244790, 61132312065111, 137547689707000,
-      309482283181501, 696335127828753, 1566753995631385, 3525196511162271, 7931691992677701,
-      17846306936293605, 40154190677507445, 90346928918121501, 203280589587557251,
-      457381325854679626, 1029107982097042876, 2315492959180353330, 5209859154120846435,
-    };
-    /* clang-format on */
-    return kNextProbeLocation[index];
-  }
   friend class MapNode;
 };
 
@@ -60,7 +60,8 @@ typedef struct TVMGraphExecutor TVMGraphExecutor;
 /*!
  * \brief Allocate a new GraphExecutor with TVMPlatformMemoryAllocate and initialize it.
  *
- * \param sym_json JSON-encoded graph.
+ * \param sym_json JSON-encoded graph, or a binary graph as described in graph_executor_binary.h.
+ *  A binary graph is copied without being parsed, so it need not outlive the executor.
  * \param module_handle TVM Module that exposes the functions to call.
  * \param devices runtime execution device.
  * \param executor Pointer which receives a pointer to the newly-created instance.
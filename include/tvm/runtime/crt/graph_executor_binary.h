@@ -0,0 +1,331 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file graph_executor_binary.h
+ * \brief Fixed-layout binary encoding of the graph executor's graph.
+ *
+ * The binary graph carries the same information as the graph JSON, laid out so that it can be
+ * used in place, e.g. directly from flash or from a memory mapped file, without any parsing.
+ * It is produced by tvm.contrib.graph_executor.graph_json_to_binary and is understood by both
+ * the C runtime and the C++ GraphExecutor.
+ *
+ * The blob starts with a TVMGraphBinaryHeader, followed by sections at the byte offsets given
+ * in the header. Every section starts at a multiple of 8 bytes from the beginning of the blob,
+ * and the blob itself must be 8-byte aligned. All integers are little-endian.
+ *
+ *  - nodes: TVMGraphBinaryNode[num_nodes]
+ *  - node_inputs: TVMGraphBinaryNodeEntry[num_node_inputs], the inputs of all nodes
+ *  - arg_nodes: uint32_t[num_arg_nodes]
+ *  - heads: TVMGraphBinaryNodeEntry[num_heads]
+ *  - node_row_ptr: uint32_t[num_nodes + 1]
+ *  - storage_id, ndim, shape_index: uint32_t[num_entries]
+ *  - device_index: uint32_t[num_entries], optional
+ *  - dltype: DLDataType[num_entries]
+ *  - storage_scope: uint32_t[num_entries] string offsets, optional
+ *  - shape: int64_t[num_shape_dims], entry i has shape[shape_index[i]:shape_index[i] + ndim[i]]
+ *  - strings: NUL-terminated strings, referred to by their offset in this section
+ *
+ * Optional sections have an offset of 0 when they are absent.
+ */
+#ifndef TVM_RUNTIME_CRT_GRAPH_EXECUTOR_BINARY_H_
+#define TVM_RUNTIME_CRT_GRAPH_EXECUTOR_BINARY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <dlpack/dlpack.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*! \brief Magic number of a binary graph, "TVMG" when read as bytes. */
+#define TVM_GRAPH_BINARY_MAGIC 0x474D5654U
+
+/*! \brief Version of the binary graph layout. */
+#define TVM_GRAPH_BINARY_VERSION 1U
+
+/*! \brief Header of a binary graph. */
+typedef struct TVMGraphBinaryHeader {
+  uint32_t magic;
+  uint32_t version;
+  /*! \brief Size of the whole blob in bytes, including the header. */
+  uint32_t total_size;
+  uint32_t reserved;
+  uint32_t num_nodes;
+  uint32_t num_node_inputs;
+  uint32_t num_arg_nodes;
+  uint32_t num_heads;
+  uint32_t num_entries;
+  uint32_t num_shape_dims;
+  uint32_t strings_size;
+  uint32_t nodes_offset;
+  uint32_t node_inputs_offset;
+  uint32_t arg_nodes_offset;
+  uint32_t heads_offset;
+  uint32_t node_row_ptr_offset;
+  uint32_t storage_id_offset;
+  uint32_t device_index_offset;
+  uint32_t dltype_offset;
+  uint32_t ndim_offset;
+  uint32_t shape_index_offset;
+  uint32_t shape_offset;
+  uint32_t storage_scope_offset;
+  uint32_t strings_offset;
+} TVMGraphBinaryHeader;
+
+/*! \brief A node of a binary graph, strings are offsets into the string section. */
+typedef struct TVMGraphBinaryNode {
+  uint32_t op_type;
+  uint32_t name;
+  uint32_t func_name;
+  uint32_t num_inputs;
+  uint32_t num_outputs;
+  uint32_t flatten_data;
+  /*! \brief Index of the first input of the node in the node_inputs section. */
+  uint32_t inputs_begin;
+  uint32_t inputs_count;
+} TVMGraphBinaryNode;
+
+/*! \brief A reference to an output of a node. */
+typedef struct TVMGraphBinaryNodeEntry {
+  uint32_t node_id;
+  uint32_t index;
+  uint32_t version;
+} TVMGraphBinaryNodeEntry;
+
+/*!
+ * \brief Check whether a buffer starts like a binary graph.
+ * \param data The buffer, which holds at least 4 bytes.
+ * \return 1 if the buffer starts with the binary graph magic number.
+ */
+static inline int TVMGraphBinary_IsBinary(const void* data) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  return bytes[0] == 'T' && bytes[1] == 'V' && bytes[2] == 'M' && bytes[3] == 'G';
+}
+
+static inline const void* TVMGraphBinary_Section(const TVMGraphBinaryHeader* graph,
+                                                 uint32_t offset) {
+  return offset == 0 ? NULL : (const uint8_t*)graph + offset;
+}
+
+static inline const TVMGraphBinaryNode* TVMGraphBinary_Nodes(const TVMGraphBinaryHeader* graph) {
+  return (const TVMGraphBinaryNode*)TVMGraphBinary_Section(graph, graph->nodes_offset);
+}
+
+static inline const TVMGraphBinaryNodeEntry* TVMGraphBinary_NodeInputs(
+    const TVMGraphBinaryHeader* graph) {
+  return (const TVMGraphBinaryNodeEntry*)TVMGraphBinary_Section(graph, graph->node_inputs_offset);
+}
+
+static inline const uint32_t* TVMGraphBinary_ArgNodes(const TVMGraphBinaryHeader* graph) {
+  return (const uint32_t*)TVMGraphBinary_Section(graph, graph->arg_nodes_offset);
+}
+
+static inline const TVMGraphBinaryNodeEntry* TVMGraphBinary_Heads(
+    const TVMGraphBinaryHeader* graph) {
+  return (const TVMGraphBinaryNodeEntry*)TVMGraphBinary_Section(graph, graph->heads_offset);
+}
+
+static inline const uint32_t* TVMGraphBinary_NodeRowPtr(const TVMGraphBinaryHeader* graph) {
+  return (const uint32_t*)TVMGraphBinary_Section(graph, graph->node_row_ptr_offset);
+}
+
+static inline const uint32_t* TVMGraphBinary_StorageId(const TVMGraphBinaryHeader* graph) {
+  return (const uint32_t*)TVMGraphBinary_Section(graph, graph->storage_id_offset);
+}
+
+static inline const uint32_t* TVMGraphBinary_DeviceIndex(const TVMGraphBinaryHeader* graph) {
+  return (const uint32_t*)TVMGraphBinary_Section(graph, graph->device_index_offset);
+}
+
+static inline const DLDataType* TVMGraphBinary_DLType(const TVMGraphBinaryHeader* graph) {
+  return (const DLDataType*)TVMGraphBinary_Section(graph, graph->dltype_offset);
+}
+
+static inline const uint32_t* TVMGraphBinary_NDim(const TVMGraphBinaryHeader* graph) {
+  return (const uint32_t*)TVMGraphBinary_Section(graph, graph->ndim_offset);
+}
+
+static inline const uint32_t* TVMGraphBinary_ShapeIndex(const TVMGraphBinaryHeader* graph) {
+  return (const uint32_t*)TVMGraphBinary_Section(graph, graph->shape_index_offset);
+}
+
+static inline const int64_t* TVMGraphBinary_Shape(const TVMGraphBinaryHeader* graph) {
+  return (const int64_t*)TVMGraphBinary_Section(graph, graph->shape_offset);
+}
+
+static inline const uint32_t* TVMGraphBinary_StorageScope(const TVMGraphBinaryHeader* graph) {
+  return (const uint32_t*)TVMGraphBinary_Section(graph, graph->storage_scope_offset);
+}
+
+/*!
+ * \brief Get a string of a binary graph.
+ * \param graph The binary graph.
+ * \param offset The offset of the string in the string section.
+ * \return The NUL-terminated string.
+ */
+static inline const char* TVMGraphBinary_String(const TVMGraphBinaryHeader* graph,
+                                                uint32_t offset) {
+  return (const char*)graph + graph->strings_offset + offset;
+}
+
+/*! \brief Check that a section of count elements of elem_size bytes lies within the blob. */
+static inline int TVMGraphBinary_SectionInBounds(const TVMGraphBinaryHeader* graph,
+                                                 uint32_t offset, uint32_t count,
+                                                 uint32_t elem_size) {
+  if (offset < sizeof(TVMGraphBinaryHeader) || offset % 8 != 0 || offset > graph->total_size) {
+    return 0;
+  }
+  return (uint64_t)count * elem_size <= (uint64_t)(graph->total_size - offset);
+}
+
+/*!
+ * \brief Validate a binary graph, so that it can then be used without bounds checks.
+ *
+ * Besides the layout of the sections, this checks every index stored in the graph: string
+ * offsets, node inputs, node entries, and shape ranges.
+ *
+ * \param data The blob, which must be 8-byte aligned.
+ * \param size The number of bytes available at data.
+ * \return NULL if the graph is valid, otherwise a description of the problem.
+ */
+static inline const char* TVMGraphBinary_Validate(const void* data, size_t size) {
+  const TVMGraphBinaryHeader* graph = (const TVMGraphBinaryHeader*)data;
+  const TVMGraphBinaryNode* nodes;
+  const TVMGraphBinaryNodeEntry* entries;
+  const uint32_t* words;
+  const uint32_t* ndim;
+  const uint32_t* shape_index;
+  uint32_t i;
+
+  if (((uintptr_t)data) % 8 != 0) {
+    return "binary graph is not 8-byte aligned";
+  }
+  if (size < sizeof(TVMGraphBinaryHeader) || !TVMGraphBinary_IsBinary(data)) {
+    return "not a binary graph";
+  }
+  if (graph->magic != TVM_GRAPH_BINARY_MAGIC) {
+    return "binary graph byte order does not match the host";
+  }
+  if (graph->version != TVM_GRAPH_BINARY_VERSION) {
+    return "unsupported binary graph version";
+  }
+  if (graph->total_size > size) {
+    return "binary graph is truncated";
+  }
+  if (!TVMGraphBinary_SectionInBounds(graph, graph->nodes_offset, graph->num_nodes,
+                                      sizeof(TVMGraphBinaryNode)) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->node_inputs_offset, graph->num_node_inputs,
+                                      sizeof(TVMGraphBinaryNodeEntry)) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->arg_nodes_offset, graph->num_arg_nodes,
+                                      sizeof(uint32_t)) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->heads_offset, graph->num_heads,
+                                      sizeof(TVMGraphBinaryNodeEntry)) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->node_row_ptr_offset, graph->num_nodes + 1,
+                                      sizeof(uint32_t)) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->storage_id_offset, graph->num_entries,
+                                      sizeof(uint32_t)) ||
+      (graph->device_index_offset != 0 &&
+       !TVMGraphBinary_SectionInBounds(graph, graph->device_index_offset, graph->num_entries,
+                                       sizeof(uint32_t))) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->dltype_offset, graph->num_entries,
+                                      sizeof(DLDataType)) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->ndim_offset, graph->num_entries,
+                                      sizeof(uint32_t)) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->shape_index_offset, graph->num_entries,
+                                      sizeof(uint32_t)) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->shape_offset, graph->num_shape_dims,
+                                      sizeof(int64_t)) ||
+      (graph->storage_scope_offset != 0 &&
+       !TVMGraphBinary_SectionInBounds(graph, graph->storage_scope_offset, graph->num_entries,
+                                       sizeof(uint32_t))) ||
+      !TVMGraphBinary_SectionInBounds(graph, graph->strings_offset, graph->strings_size, 1)) {
+    return "binary graph section out of bounds";
+  }
+  if (graph->strings_size == 0 ||
+      TVMGraphBinary_String(graph, graph->strings_size - 1)[0] != '\0') {
+    return "binary graph string section is not terminated";
+  }
+
+  words = TVMGraphBinary_NodeRowPtr(graph);
+  if (words[0] != 0 || words[graph->num_nodes] != graph->num_entries) {
+    return "binary graph node_row_ptr does not match the number of entries";
+  }
+  for (i = 0; i < graph->num_nodes; ++i) {
+    if (words[i] > words[i + 1]) {
+      return "binary graph node_row_ptr is not sorted";
+    }
+  }
+
+  nodes = TVMGraphBinary_Nodes(graph);
+  for (i = 0; i < graph->num_nodes; ++i) {
+    if (nodes[i].op_type >= graph->strings_size || nodes[i].name >= graph->strings_size ||
+        nodes[i].func_name >= graph->strings_size) {
+      return "binary graph node string out of bounds";
+    }
+    if (nodes[i].inputs_begin > graph->num_node_inputs ||
+        nodes[i].inputs_count > graph->num_node_inputs - nodes[i].inputs_begin) {
+      return "binary graph node inputs out of bounds";
+    }
+  }
+
+  entries = TVMGraphBinary_NodeInputs(graph);
+  for (i = 0; i < graph->num_node_inputs; ++i) {
+    if (entries[i].node_id >= graph->num_nodes ||
+        entries[i].index >= words[entries[i].node_id + 1] - words[entries[i].node_id]) {
+      return "binary graph node input out of bounds";
+    }
+  }
+  entries = TVMGraphBinary_Heads(graph);
+  for (i = 0; i < graph->num_heads; ++i) {
+    if (entries[i].node_id >= graph->num_nodes ||
+        entries[i].index >= words[entries[i].node_id + 1] - words[entries[i].node_id]) {
+      return "binary graph head out of bounds";
+    }
+  }
+  words = TVMGraphBinary_ArgNodes(graph);
+  for (i = 0; i < graph->num_arg_nodes; ++i) {
+    if (words[i] >= graph->num_nodes) {
+      return "binary graph argument node out of bounds";
+    }
+  }
+
+  ndim = TVMGraphBinary_NDim(graph);
+  shape_index = TVMGraphBinary_ShapeIndex(graph);
+  for (i = 0; i < graph->num_entries; ++i) {
+    if (shape_index[i] > graph->num_shape_dims ||
+        ndim[i] > graph->num_shape_dims - shape_index[i]) {
+      return "binary graph shape out of bounds";
+    }
+  }
+  words = TVMGraphBinary_StorageScope(graph);
+  for (i = 0; words != NULL && i < graph->num_entries; ++i) {
+    if (words[i] >= graph->strings_size) {
+      return "binary graph storage scope out of bounds";
+    }
+  }
+  return NULL;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_GRAPH_EXECUTOR_BINARY_H_
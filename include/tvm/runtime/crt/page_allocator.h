@@ -37,6 +37,29 @@ extern int vleak_size;
 
 typedef struct MemoryManagerInterface MemoryManagerInterface;
 
+/*! \brief Usage statistics of a memory manager. */
+typedef struct MemoryManagerStats {
+  /*! \brief Number of bytes managed, excluding the bookkeeping of the memory manager itself. */
+  size_t total_bytes;
+  /*! \brief Number of bytes currently allocated, including per-allocation overhead. */
+  size_t allocated_bytes;
+  /*! \brief Highest value of allocated_bytes seen so far. */
+  size_t peak_allocated_bytes;
+  /*! \brief Number of bytes currently free. */
+  size_t free_bytes;
+  /*!
+   * \brief Size of the largest free block, in bytes.
+   *
+   * An allocation of up to this size (less per-allocation overhead) succeeds. The external
+   * fragmentation of the pool is 1 - largest_free_block_bytes / free_bytes.
+   */
+  size_t largest_free_block_bytes;
+  /*! \brief Number of free blocks. */
+  size_t num_free_blocks;
+  /*! \brief Number of allocations that failed for lack of a large enough free block. */
+  size_t num_failed_allocations;
+} MemoryManagerStats;
+
 struct MemoryManagerInterface {
   /*!
    * \brief Allocate a chunk of memory.
@@ -59,6 +82,15 @@ struct MemoryManagerInterface {
    */
   tvm_crt_error_t (*Free)(MemoryManagerInterface* interface, void* ptr, DLDevice dev);
 
+  /*!
+   * \brief Get the usage statistics of the memory manager. NULL if it does not keep any.
+   *
+   * \param interface Pointer to this structure.
+   * \param stats Pointer to which the statistics are written.
+   * \return kTvmErrorNoError if successful; a descriptive error code otherwise.
+   */
+  tvm_crt_error_t (*GetStats)(MemoryManagerInterface* interface, MemoryManagerStats* stats);
+
   /*! \brief Used in testing; the number of allocated objects. */
   int vleak_size;
 };
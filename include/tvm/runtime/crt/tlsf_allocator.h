@@ -0,0 +1,60 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file tvm/runtime/crt/tlsf_allocator.h
+ * \brief A two-level segregated fit memory allocator for microcontrollers.
+ */
+
+#ifndef TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
+#define TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/page_allocator.h>
+
+/*!
+ * \brief Create a memory manager using two-level segregated fit (TLSF) allocation.
+ *
+ * Allocation and free run in constant time. Freed blocks are merged with their free neighbours,
+ * so the pool does not fragment with interleaved allocation sizes the way fixed-size pages do.
+ * The memory manager keeps usage statistics, see MemoryManagerInterface::GetStats.
+ *
+ * \param manager Pointer, initialized with the new MemoryManager.
+ * \param memory_pool Pointer to the global memory pool used by the CRT. The bookkeeping of the
+ *     memory manager is placed at the beginning of the pool.
+ * \param memory_pool_size_bytes Size of `memory_pool`, in bytes.
+ * \param alignment_bytes_log2 log2 of the alignment of allocations, in bytes. Allocation sizes
+ *     are rounded up to a multiple of the alignment, which is at least 4 pointers.
+ * \return kTvmErrorNoError on success.
+ */
+tvm_crt_error_t TLSFMemoryManagerCreate(MemoryManagerInterface** manager, uint8_t* memory_pool,
+                                        size_t memory_pool_size_bytes,
+                                        size_t alignment_bytes_log2);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_TLSF_ALLOCATOR_H_
@@ -26,6 +26,7 @@
 #include <tvm/runtime/object.h>
 
 #include <cstdlib>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -47,7 +48,6 @@ inline ObjectPtr<T> make_object(Args&&... args);
 //
 // Possible future allocator optimizations:
 // - Arena allocator that gives ownership of memory to arena (deleter_= nullptr)
-// - Thread-local object pools: one pool per size and alignment requirement.
 // - Can specialize by type of object to give the specific allocator to each object.
 
 /*!
@@ -191,15 +191,133 @@ class SimpleObjAllocator : public ObjAllocatorBase<SimpleObjAllocator> {
   };
 };
 
+/*! \brief The alignment of the memory returned by the object pool. */
+constexpr size_t kObjectPoolAlignment = 16;
+
+namespace detail {
+/*!
+ * \brief Allocate memory from the object pool.
+ *
+ * Small sizes are served from per-thread free lists of fixed size classes, which are refilled
+ * from and drained to a shared pool in batches, so that most allocations take no lock. Large
+ * sizes, or all sizes when the pool is disabled by setting the environment variable
+ * TVM_OBJECT_POOL=0, fall back to the global operator new.
+ *
+ * \param size The number of bytes to allocate.
+ * \return The memory, aligned to kObjectPoolAlignment.
+ */
+TVM_DLL void* ObjectPoolAlloc(size_t size);
+/*!
+ * \brief Return memory allocated by ObjectPoolAlloc to the object pool.
+ * \param ptr The memory to free.
+ * \param size The size passed to ObjectPoolAlloc.
+ */
+TVM_DLL void ObjectPoolFree(void* ptr, size_t size);
+}  // namespace detail
+
+/*!
+ * \brief Allocator that recycles the memory of objects through the thread-caching object pool.
+ *
+ * Objects with alignment requirements stricter than kObjectPoolAlignment are allocated with
+ * new/delete as in SimpleObjAllocator. Statistics of the pool are available through the global
+ * function "runtime.ObjectPoolStats".
+ */
+class PooledObjAllocator : public ObjAllocatorBase<PooledObjAllocator> {
+ public:
+  template <typename T>
+  class Handler {
+   public:
+    template <typename... Args>
+    static T* New(PooledObjAllocator*, Args&&... args) {
+      if constexpr (kPooled) {
+        void* data = detail::ObjectPoolAlloc(sizeof(T));
+        new (data) T(std::forward<Args>(args)...);
+        return reinterpret_cast<T*>(data);
+      } else {
+        return SimpleObjAllocator::Handler<T>::New(nullptr, std::forward<Args>(args)...);
+      }
+    }
+
+    static Object::FDeleter Deleter() {
+      if constexpr (kPooled) {
+        return Deleter_;
+      } else {
+        return SimpleObjAllocator::Handler<T>::Deleter();
+      }
+    }
+
+   private:
+    static constexpr bool kPooled = alignof(T) <= kObjectPoolAlignment;
+
+    static void Deleter_(Object* objptr) {
+      T* tptr = static_cast<T*>(objptr);
+      tptr->T::~T();
+      detail::ObjectPoolFree(tptr, sizeof(T));
+    }
+  };
+
+  // Array handler that records the allocated size in a header in front of the array object.
+  template <typename ArrayType, typename ElemType>
+  class ArrayHandler {
+   public:
+    static_assert(alignof(ArrayType) % alignof(ElemType) == 0 &&
+                      sizeof(ArrayType) % alignof(ElemType) == 0,
+                  "element alignment constraint");
+
+    template <typename... Args>
+    static ArrayType* New(PooledObjAllocator*, size_t num_elems, Args&&... args) {
+      if constexpr (kPooled) {
+        size_t size = kHeaderSize + sizeof(ArrayType) + num_elems * sizeof(ElemType);
+        char* data = static_cast<char*>(detail::ObjectPoolAlloc(size));
+        *reinterpret_cast<size_t*>(data) = size;
+        new (data + kHeaderSize) ArrayType(std::forward<Args>(args)...);
+        return reinterpret_cast<ArrayType*>(data + kHeaderSize);
+      } else {
+        return SimpleObjAllocator::ArrayHandler<ArrayType, ElemType>::New(
+            nullptr, num_elems, std::forward<Args>(args)...);
+      }
+    }
+
+    static Object::FDeleter Deleter() {
+      if constexpr (kPooled) {
+        return Deleter_;
+      } else {
+        return SimpleObjAllocator::ArrayHandler<ArrayType, ElemType>::Deleter();
+      }
+    }
+
+   private:
+    static constexpr bool kPooled = alignof(ArrayType) <= kObjectPoolAlignment;
+    static constexpr size_t kHeaderSize = kObjectPoolAlignment;
+
+    static void Deleter_(Object* objptr) {
+      ArrayType* tptr = static_cast<ArrayType*>(objptr);
+      tptr->ArrayType::~ArrayType();
+      char* data = reinterpret_cast<char*>(tptr) - kHeaderSize;
+      detail::ObjectPoolFree(data, *reinterpret_cast<size_t*>(data));
+    }
+  };
+};
+
+/*!
+ * \brief The allocator used by make_object and make_inplace_array_object. The pooled allocator is
+ * selected by building with USE_POOLED_OBJ_ALLOCATOR.
+ */
+#if TVM_USE_POOLED_OBJ_ALLOCATOR
+using DefaultObjAllocator = PooledObjAllocator;
+#else
+using DefaultObjAllocator = SimpleObjAllocator;
+#endif
+
 template <typename T, typename... Args>
 inline ObjectPtr<T> make_object(Args&&... args) {
-  return SimpleObjAllocator().make_object<T>(std::forward<Args>(args)...);
+  return DefaultObjAllocator().make_object<T>(std::forward<Args>(args)...);
 }
 
 template <typename ArrayType, typename ElemType, typename... Args>
 inline ObjectPtr<ArrayType> make_inplace_array_object(size_t num_elems, Args&&... args) {
-  return SimpleObjAllocator().make_inplace_array<ArrayType, ElemType>(num_elems,
-                                                                      std::forward<Args>(args)...);
+  return DefaultObjAllocator().make_inplace_array<ArrayType, ElemType>(num_elems,
+                                                                       std::forward<Args>(args)...);
 }
 
 }  // namespace runtime
@@ -269,6 +269,10 @@ constexpr const char* tvm_param_prefix = "__tvm_param__";
 constexpr const char* tvm_lookup_linked_param = "_lookup_linked_param";
 /*! \brief Model entrypoint generated as an interface to the AOT function outside of TIR */
 constexpr const char* tvm_entrypoint_suffix = "run";
+/*! \brief Prefix of the global string storing the direct-call signature of a compiled function. */
+constexpr const char* tvm_direct_call_signature_prefix = "__tvm_direct_sig__";
+/*! \brief Prefix of the name to query the direct-call entry of a function from a module. */
+constexpr const char* tvm_direct_call_query_prefix = "__tvm_direct_call__";
 }  // namespace symbol
 
 // implementations of inline functions.
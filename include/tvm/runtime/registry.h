@@ -45,6 +45,8 @@
 
 #include <tvm/runtime/packed_func.h>
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -314,6 +316,58 @@ class Registry {
    * \return The names
    */
   TVM_DLL static std::vector<std::string> ListNames();
+  /*!
+   * \brief Enable or disable counting the lookups of global functions by name.
+   *  Enabling the counters resets them.
+   * \param enable Whether to count the lookups.
+   */
+  TVM_DLL static void SetLookupCounting(bool enable);
+  /*!
+   * \brief Get the number of lookups of each global function name since counting was enabled,
+   *  including the lookups of names that are not registered.
+   * \return The pairs of the name and its number of lookups.
+   */
+  TVM_DLL static std::vector<std::pair<std::string, uint64_t>> LookupCounts();
+
+  /*!
+   * \brief A handle to a global function that resolves the name once and caches the result.
+   *
+   *  Looking up a handle again only checks whether the cached function is still registered,
+   *  and resolves the name anew after the function is removed or overridden. Handles are
+   *  meant to be function local statics on hot paths.
+   *
+   * \code
+   *
+   * static const Registry::Handle fcompile("tvm_callback_cuda_compile");
+   * if (const PackedFunc* f = fcompile.Get()) {
+   *   (*f)(code);
+   * }
+   *
+   * \endcode
+   */
+  class Handle {
+   public:
+    /*!
+     * \brief Create a handle of the global function.
+     * \param name The name of the function.
+     */
+    explicit Handle(std::string name) : name_(std::move(name)) {}
+    /*!
+     * \brief Get the global function.
+     * \return pointer to the registered function, nullptr if it does not exist.
+     */
+    TVM_DLL const PackedFunc* Get() const;
+    /*! \return The name of the function. */
+    const std::string& name() const { return name_; }
+
+   private:
+    /*! \brief name of the function */
+    std::string name_;
+    /*! \brief The resolved registry entry, nullptr if not resolved or not found. */
+    mutable std::atomic<Registry*> entry_{nullptr};
+    /*! \brief The registry version at which the name was last found missing. */
+    mutable std::atomic<uint64_t> miss_version_{0};
+  };
 
   // Internal class.
   struct Manager;
@@ -323,6 +377,10 @@ class Registry {
   std::string name_;
   /*! \brief internal packed function */
   PackedFunc func_;
+  /*! \brief Whether this entry is still the one registered under name_. */
+  std::atomic<bool> active_{true};
+  /*! \brief The number of lookups of this entry, updated only when counting is enabled. */
+  std::atomic<uint64_t> num_lookups_{0};
   friend struct Manager;
 };
 
@@ -146,6 +146,15 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
  */
 int32_t NumThreads();
 
+/*!
+ * \brief Set the number of threads used by the parallel loops launched from the calling thread.
+ *
+ * Each thread that launches parallel loops has its own pool, this only configures the pool of
+ * the calling thread, with the default affinity mode.
+ * \param nthreads The number of threads to use (0 = use all).
+ */
+TVM_DLL void SetNumThreads(int nthreads);
+
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
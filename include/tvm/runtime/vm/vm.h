@@ -24,6 +24,7 @@
 #ifndef TVM_RUNTIME_VM_VM_H_
 #define TVM_RUNTIME_VM_VM_H_
 
+#include <tvm/runtime/c_backend_api.h>
 #include <tvm/runtime/container/closure.h>
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/object.h>
@@ -33,6 +34,7 @@
 #include <tvm/runtime/vm/executable.h>
 #include <tvm/runtime/vm/memory_manager.h>
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -134,6 +136,8 @@ struct VMFrame {
         caller_return_register(0) {}
 };
 
+class PackedCallPool;
+
 /*!
  * \brief The virtual machine.
  *
@@ -198,9 +202,10 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
   /*!
    * \brief Read a VM register.
    * \param reg The register to read from.
-   * \return The read object.
+   * \return The read object, borrowed from the register file of the current frame. The
+   *  reference is invalidated when a frame is pushed or the register is written.
    */
-  ObjectRef ReadRegister(RegName reg) const;
+  const ObjectRef& ReadRegister(RegName reg) const;
 
   /*!
    * \brief Read a VM register and cast it to int32_t
@@ -326,13 +331,28 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
    *
    * \param instr Instruction that will be executed after this hook fires
    */
-  virtual void OpStartHook(Instruction instr);
+  virtual void OpStartHook(const Instruction& instr);
 
   /*!
    * \brief Internal hook for profiling the end of an op.
    */
   virtual void OpStopHook();
 
+  /*!
+   * \brief Whether independent packed calls may run concurrently at this point. Subclasses
+   *  whose InvokePacked is not thread safe can disable it.
+   */
+  virtual bool AllowConcurrentPackedCalls() const { return true; }
+
+  /*!
+   * \brief Set the number of threads running independent packed calls.
+   * \param num_threads The number of threads, 1 runs all calls in order and a non-positive
+   *  value uses all hardware threads.
+   *
+   * \note The packed functions must be safe to call concurrently.
+   */
+  void SetPackedConcurrency(int num_threads);
+
  private:
   /*!
    * \brief Get index of input tensor from its name.
@@ -409,6 +429,13 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
    */
   void WriteAllocatedTensor(const Instruction& instr);
 
+  /*!
+   * \brief Write new allocated tensor to register_file of frame.
+   * \param instr current instruction containing shape info.
+   * \param storage The storage to allocate the tensor from, already read from the register.
+   */
+  void WriteAllocatedTensor(const Instruction& instr, const Storage& storage);
+
   /*!
    * \brief 'set_outputs_enabled' is assumed true for using this method.
    * It is expected that result register has already contained tensor from outside,
@@ -420,9 +447,31 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
 
   bool FindIndex(const std::vector<Index>& indices, Index val) const;
 
+  /*!
+   * \brief Find the groups of InvokePacked instructions in the executable which can run
+   *  concurrently: the calls of a group do not depend on each other through registers, and are
+   *  only separated by allocations which do not depend on the calls either.
+   */
+  void AnalyzeConcurrentPackedCalls();
+
+  /*!
+   * \brief Defer a packed call of a concurrent group.
+   * \param instr The InvokePacked instruction.
+   * \param is_last Whether it is the last call of its group, which runs the whole group.
+   */
+  void DeferPackedCall(const Instruction& instr, bool is_last);
+
+  /*! \brief Run the deferred packed calls, concurrently when their tensors do not overlap. */
+  void RunDeferredPackedCalls();
+
  protected:
   /*! \brief The virtual machine's packed function table. */
   std::vector<PackedFunc> packed_funcs_;
+  /*!
+   * \brief The direct-call entries of the packed functions taking only tensors, nullptr if not
+   *  available. They skip the construction of TVMArgs and the checks of type codes.
+   */
+  std::vector<TVMBackendPackedCFunc> direct_funcs_;
   /*! \brief The current stack of call frames. */
   std::vector<VMFrame> frames_;
   /*! \brief The fuction table index of the current function. */
@@ -458,6 +507,24 @@ class TVM_DLL VirtualMachine : public runtime::ModuleNode {
    * object to avoid rellocation of constants during inference.
    */
   std::vector<ObjectRef> const_pool_;
+  /*!
+   * \brief Reused argument lists of InvokePacked instructions, one per nesting level since a
+   *  packed function may invoke this VM again. A deque keeps the outer lists in place.
+   */
+  std::deque<std::vector<ObjectRef>> packed_args_scratch_;
+  /*! \brief The number of InvokePacked instructions being run, i.e. the nesting level. */
+  size_t packed_call_depth_{0};
+  /*! \brief The number of threads running independent packed calls, 1 runs them in order. */
+  int packed_concurrency_{1};
+  /*! \brief The threads running independent packed calls, created on first use. */
+  std::shared_ptr<PackedCallPool> packed_call_pool_;
+  /*!
+   * \brief The InvokePacked instructions which can be deferred and run concurrently with the
+   *  other calls of their group, mapped to whether they are the last call of the group.
+   */
+  std::unordered_map<const Instruction*, bool> concurrent_packed_calls_;
+  /*! \brief The deferred calls of the current group with their arguments. */
+  std::vector<std::pair<const Instruction*, std::vector<ObjectRef>>> deferred_packed_calls_;
 };
 
 }  // namespace vm
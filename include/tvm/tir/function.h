@@ -323,6 +323,18 @@ constexpr const char* kIsEntryFunc = "tir.is_entry_func";
  */
 constexpr const char* kIsGlobalFunc = "tir.is_global_func";
 
+/*!
+ * \brief The kinds of the arguments of a function lowered to the packed API, one character per
+ *        argument: 'h' for handles, 'i' for integers and 'f' for floats.
+ *
+ * Type: String
+ *
+ * \note Such a function skips the type code checks of its arguments when it is called with
+ *       a null array of type codes. Code generators can export the signature so that runtimes
+ *       can call the function directly, without packing the arguments into TVMArgs.
+ */
+constexpr const char* kDirectCallSignature = "tir.direct_call_signature";
+
 }  // namespace attr
 }  // namespace tir
 }  // namespace tvm
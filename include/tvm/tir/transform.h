@@ -51,12 +51,13 @@ using tvm::transform::Sequential;
  * \param opt_level The optimization level of the function pass.
  * \param name The name of the function pass.
  * \param required The list of the passes that the function pass is dependent on.
+ * \param thread_safe Whether the pass may transform several functions concurrently.
  *
  * \return The created function pass.
  */
 TVM_DLL Pass CreatePrimFuncPass(
     const runtime::TypedPackedFunc<PrimFunc(PrimFunc, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required);
+    int opt_level, String name, tvm::Array<String> required, bool thread_safe = false);
 
 /*!
  * \brief Inject prefetch instructions into stmt.
@@ -65,6 +66,16 @@ TVM_DLL Pass CreatePrimFuncPass(
  */
 TVM_DLL Pass InjectPrefetch();
 
+/*!
+ * \brief Insert software prefetches for the streaming loads of innermost reduction loops.
+ *
+ *  Only applies to functions whose CPU target sets the sw-prefetch attribute. The prefetch
+ *  distance hides sw-prefetch-latency cycles given the estimated cost of an iteration.
+ *
+ * \return The pass.
+ */
+TVM_DLL Pass InjectSoftwarePrefetch();
+
 // TODO(tvm-team): consolidate configs to the PassContext
 /*!
  * \brief Flatten the multi-dimensional read/write
@@ -91,6 +91,9 @@ class Analyzer:
         self._int_set = _mod("int_set")
         self._enter_constraint_context = _mod("enter_constraint_context")
         self._can_prove_equal = _mod("can_prove_equal")
+        self._can_prove = _mod("can_prove")
+        self._enable_memoization = _mod("enable_memoization")
+        self._memo_stats = _mod("memo_stats")
 
     def const_int_bound(self, expr):
         """Find constant integer bound for expr.
@@ -270,3 +273,42 @@ class Analyzer:
             Whether we can prove that lhs == rhs
         """
         return self._can_prove_equal(lhs, rhs)
+
+    def can_prove(self, cond: "PrimExpr"):
+        """Whether we can prove that the condition holds
+
+        Parameters
+        ----------
+        cond: PrimExpr
+            The condition to be proved
+
+        Returns
+        -------
+        result: bool
+            Whether we can prove the condition
+        """
+        return self._can_prove(cond)
+
+    def enable_memoization(self, enable: bool = True):
+        """Enable or disable memoization of simplify and can_prove
+
+        Results are keyed by the identity of the queried expression and by the
+        currently known facts. They are reused until a variable is bound or a
+        constraint scope is entered, and again after that scope is exited.
+
+        Parameters
+        ----------
+        enable: bool
+            Whether to enable memoization. Disabling it drops all recorded results.
+        """
+        self._enable_memoization(enable)
+
+    def memo_stats(self):
+        """Get the hit and miss counters of memoization
+
+        Returns
+        -------
+        stats: Dict[str, int]
+            The number of "hits", "misses" and "flushes" since memoization was enabled.
+        """
+        return {str(k): int(v) for k, v in self._memo_stats().items()}
@@ -53,7 +53,9 @@ from .measure_record import (
     RecordReader,
     RecordToFile,
     load_best_record,
+    load_best_records,
     load_records,
+    load_records_parallel,
     save_records,
 )
 from .relay_integration import (
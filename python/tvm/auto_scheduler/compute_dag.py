@@ -203,6 +203,21 @@ class ComputeDAG(Object):
                 updated_state.stage_id_map[k] = v
         return updated_state
 
+    def set_infer_bound_cache_size(self, size):
+        """
+        Set the number of transform step prefixes whose replayed schedules are cached.
+
+        `infer_bound_from_state` replays the transform steps of a state on top of the cached
+        schedule of the longest prefix of them, which is usually the parent state it is derived
+        from, instead of replaying all the steps from scratch.
+
+        Parameters
+        ----------
+        size : int
+            The maximum number of cached schedules. 0 disables the cache.
+        """
+        _ffi_api.ComputeDAGSetInferBoundCacheSize(self, size)
+
     def rewrite_layout_from_state(self, state):
         """
         Rewrite the layout of the DAG according to the history transform steps of a state.
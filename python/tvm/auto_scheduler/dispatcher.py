@@ -33,7 +33,7 @@ from tvm.contrib.utils import tempdir
 from tvm.tir.expr import FloatImm
 from .cost_model import RandomModel, XGBModel
 from .measure import LocalRPCMeasureContext
-from .measure_record import RecordToFile, load_records
+from .measure_record import RecordToFile, load_best_records, load_records
 from .search_policy import PreloadMeasuredStates, SketchPolicy
 from .search_task import SearchTask, TuningOptions
 from .utils import calc_workload_dis_factor, decode_workload_key
@@ -208,8 +208,14 @@ class ApplyHistoryBest(DispatchContext):
                 rec = str(rec)
 
             if isinstance(rec, str):
-                rec = load_records(rec)
-                joint_records += rec
+                if n_lines is None:
+                    # Only the best record of a workload on a target can be selected below,
+                    # so let the multi-threaded loader drop the others while parsing.
+                    for pairs in load_best_records(rec).values():
+                        joint_records += pairs
+                else:
+                    rec = load_records(rec)
+                    joint_records += rec
             else:
                 if rec is not None:
                     joint_records.append(rec)
@@ -194,6 +194,58 @@ def load_records(filename):
     return zip(*RecordReader(filename).read_lines())
 
 
+def load_records_parallel(filename, workload_key=None, num_threads=-1):
+    """
+    Load measurement records from a file with multiple threads.
+
+    The file is split at line boundaries and the chunks are parsed concurrently.
+    When `workload_key` is given, records of other workloads are skipped
+    before they are fully deserialized.
+
+    Parameters
+    ----------
+    filename : str
+        File name to load log from.
+    workload_key : Optional[str]
+        If not None, only load the records of this workload.
+    num_threads : int = -1
+        The number of threads to use. -1 means using all hardware threads.
+
+    Returns
+    -------
+    inputs : List[auto_scheduler.measure.MeasureInput]
+        The MeasureInputs loaded from the log file, in file order.
+    results : List[auto_scheduler.measure.MeasureResult]
+        The MeasureResults loaded from the log file, in file order.
+    """
+    inputs, results = _ffi_api.LoadRecordsParallel(filename, workload_key, num_threads)
+    return inputs, results
+
+
+def load_best_records(filename, num_threads=-1):
+    """
+    Load a log file with multiple threads and index the best valid record of each workload.
+
+    Parameters
+    ----------
+    filename : str
+        File name to load log from.
+    num_threads : int = -1
+        The number of threads to use. -1 means using all hardware threads.
+
+    Returns
+    -------
+    best_records : Dict[str, List[Tuple[MeasureInput, MeasureResult]]]
+        A dict mapping each workload key to its best (MeasureInput, MeasureResult) pairs,
+        one pair per distinct target. Records with errors are ignored.
+    """
+    best_records = _ffi_api.LoadBestRecordsByWorkload(filename, num_threads)
+    return {
+        str(workload_key): [(pair[0], pair[1]) for pair in pairs]
+        for workload_key, pairs in best_records.items()
+    }
+
+
 def save_records(filename, inputs, results):
     """
     Append measure records to file.
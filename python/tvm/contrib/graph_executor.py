@@ -15,6 +15,9 @@
 # specific language governing permissions and limitations
 # under the License.
 """Minimum graph executor that executes graph containing TVM PackedFunc."""
+import json
+import struct
+
 import numpy as np
 import tvm._ffi
 
@@ -22,6 +25,135 @@ from tvm.rpc import _ffi_api as _rpc_ffi_api
 from tvm.rpc import base as rpc_base
 from tvm._ffi.base import string_types
 from tvm._ffi.runtime_ctypes import Device
+from tvm.runtime import DataType
+
+# Keep in sync with include/tvm/runtime/crt/graph_executor_binary.h.
+GRAPH_BINARY_MAGIC = 0x474D5654
+GRAPH_BINARY_VERSION = 1
+_GRAPH_BINARY_HEADER = struct.Struct("<24I")
+
+
+def graph_json_to_binary(graph_json):
+    """Encode a graph in the binary graph format.
+
+    The binary graph holds the same information as the graph JSON in a fixed layout that the
+    C runtime uses in place, e.g. directly from flash, without parsing it. Both the C runtime
+    and the C++ graph executor accept it wherever they accept the graph JSON. See
+    include/tvm/runtime/crt/graph_executor_binary.h for the layout.
+
+    Parameters
+    ----------
+    graph_json : str
+        The graph in json format, as output by relay.build.
+
+    Returns
+    -------
+    graph_binary : bytearray
+        The encoded graph.
+    """
+    graph = json.loads(graph_json)
+    strings = bytearray(b"\0")
+    string_offsets = {"": 0}
+
+    def intern(value):
+        if value not in string_offsets:
+            string_offsets[value] = len(strings)
+            strings.extend(value.encode("utf-8") + b"\0")
+        return string_offsets[value]
+
+    def entry(value):
+        return (value[0], value[1], value[2] if len(value) > 2 else 0)
+
+    nodes = bytearray()
+    node_inputs = []
+    for node in graph["nodes"]:
+        attrs = node.get("attrs", node.get("attr", {}))
+        inputs = [entry(i) for i in node["inputs"]]
+        nodes.extend(
+            struct.pack(
+                "<8I",
+                intern(node["op"]),
+                intern(node["name"]),
+                intern(attrs.get("func_name", "")),
+                int(attrs.get("num_inputs", 0)),
+                int(attrs.get("num_outputs", 0)),
+                int(attrs.get("flatten_data", 0)),
+                len(node_inputs),
+                len(inputs),
+            )
+        )
+        node_inputs.extend(inputs)
+
+    graph_attrs = graph["attrs"]
+    storage_id = graph_attrs["storage_id"][1]
+    if any(sid < 0 for sid in storage_id):
+        raise ValueError("The binary graph format requires every entry to have storage")
+    shapes = graph_attrs["shape"][1]
+    dltypes = []
+    for dtype in graph_attrs["dltype"][1]:
+        dtype = DataType(dtype)
+        dltypes.append(struct.pack("<BBH", dtype.type_code, dtype.bits, dtype.lanes))
+    shape_index = []
+    shape = []
+    for entry_shape in shapes:
+        shape_index.append(len(shape))
+        shape.extend(entry_shape)
+
+    def uint32s(values):
+        return struct.pack(f"<{len(values)}I", *values)
+
+    device_index = None
+    if "device_index" in graph_attrs:
+        device_index = uint32s(graph_attrs["device_index"][1])
+    storage_scope = None
+    if "storage_scope" in graph_attrs:
+        storage_scope = uint32s([intern(scope) for scope in graph_attrs["storage_scope"][1]])
+
+    # In the order of the offsets in the header, absent optional sections are None.
+    sections = [
+        bytes(nodes),
+        b"".join(struct.pack("<3I", *i) for i in node_inputs),
+        uint32s(graph["arg_nodes"]),
+        b"".join(struct.pack("<3I", *entry(h)) for h in graph["heads"]),
+        uint32s(graph["node_row_ptr"]),
+        uint32s(storage_id),
+        device_index,
+        b"".join(dltypes),
+        uint32s([len(s) for s in shapes]),
+        uint32s(shape_index),
+        struct.pack(f"<{len(shape)}q", *shape),
+        storage_scope,
+        bytes(strings),
+    ]
+
+    body = bytearray()
+    offsets = []
+    for data in sections:
+        if data is None:
+            offsets.append(0)
+            continue
+        offset = _GRAPH_BINARY_HEADER.size + len(body)
+        offset += -offset % 8
+        body.extend(b"\0" * (offset - _GRAPH_BINARY_HEADER.size - len(body)))
+        offsets.append(offset)
+        body.extend(data)
+    body.extend(b"\0" * (-(_GRAPH_BINARY_HEADER.size + len(body)) % 8))
+
+    header = _GRAPH_BINARY_HEADER.pack(
+        GRAPH_BINARY_MAGIC,
+        GRAPH_BINARY_VERSION,
+        _GRAPH_BINARY_HEADER.size + len(body),
+        0,
+        len(graph["nodes"]),
+        len(node_inputs),
+        len(graph["arg_nodes"]),
+        len(graph["heads"]),
+        len(storage_id),
+        len(shape),
+        len(strings),
+        *offsets,
+    )
+    return bytearray(header) + body
 
 
 def create(graph_json_str, libmod, device):
@@ -29,8 +161,9 @@ def create(graph_json_str, libmod, device):
 
     Parameters
     ----------
-    graph_json_str : str
-        The graph to be deployed in json format output by json graph.
+    graph_json_str : str or bytearray
+        The graph to be deployed in json format output by json graph,
+        or encoded by :py:func:`graph_json_to_binary`.
         The graph can contain operator(tvm_op) that points to the name
         of PackedFunc in the libmod.
 
@@ -54,7 +187,7 @@ def create(graph_json_str, libmod, device):
     for examples to directly construct a GraphModule from an exported
     relay compiled library.
     """
-    assert isinstance(graph_json_str, string_types)
+    assert isinstance(graph_json_str, (string_types, bytearray))
 
     dev, num_rpc_dev, device_type_id = get_device(libmod, device)
 
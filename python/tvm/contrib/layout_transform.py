@@ -0,0 +1,136 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+"""External function interface to the cache-blocked layout transform kernel."""
+import tvm
+from tvm import te
+from tvm.tir import IntImm, layout as _layout
+
+
+def get_transpose_view(shape, src_layout, dst_layout):
+    """Express a layout transform as a transpose of a refined view of the input.
+
+    A layout transform between layouts whose split factors divide each other, such as
+    NCHW, NHWC, NCHW8c and NCHW16c, only moves data around: viewing the input with every
+    primal axis split at all the factors used by either layout, the output is a transpose
+    of that view.
+
+    Parameters
+    ----------
+    shape : List[int]
+        The static shape of the input.
+    src_layout : str
+        The source layout.
+    dst_layout : str
+        The destination layout.
+
+    Returns
+    -------
+    view : Optional[Tuple[List[int], List[int], List[int]]]
+        The shape of the input view, the permutation from the input view to the output view and
+        the shape of the output, or None when the transform is not a pure transpose.
+    """
+    src = _layout(src_layout)
+    dst = _layout(dst_layout)
+    if src is None or dst is None or len(src) != len(shape):
+        return None
+    src_axes = [src[i] for i in range(len(src))]
+    dst_axes = [dst[i] for i in range(len(dst))]
+    src_primals = sorted(axis for axis in src_axes if axis.isupper())
+    if src_primals != sorted(axis for axis in dst_axes if axis.isupper()):
+        return None
+
+    # The pieces of each primal axis, outermost first, and the pieces each layout axis covers.
+    pieces = []
+    covers = {}
+    for primal in src_primals:
+        sub = primal.lower()
+        extent = shape[src_axes.index(primal)]
+        if sub in src_axes:
+            extent *= shape[src_axes.index(sub)]
+        src_factor = src.factor_of(sub) if sub in src_axes else 1
+        dst_factor = dst.factor_of(sub) if sub in dst_axes else 1
+        small, large = sorted([src_factor, dst_factor])
+        if large % small != 0 or extent % large != 0:
+            return None
+        base = len(pieces)
+        pieces.extend([extent // large, large // small, small])
+        for side, factor in [("src", src_factor), ("dst", dst_factor)]:
+            # The subordinate axis covers the innermost pieces, whose product is its factor.
+            if factor == 1:
+                num_outer = 3
+            elif factor == large:
+                num_outer = 1
+            else:
+                num_outer = 2
+            covers[(side, primal)] = list(range(base, base + num_outer))
+            covers[(side, sub)] = list(range(base + num_outer, base + 3))
+
+    src_order = [p for axis in src_axes for p in covers[("src", axis)]]
+    dst_order = [p for axis in dst_axes for p in covers[("dst", axis)]]
+    # Pieces of extent one do not move any data.
+    src_order = [p for p in src_order if pieces[p] != 1]
+    position = {p: i for i, p in enumerate(src_order)}
+    view_shape = [pieces[p] for p in src_order]
+    perm = [position[p] for p in dst_order if pieces[p] != 1]
+    out_shape = []
+    for axis in dst_axes:
+        extent = 1
+        for p in covers[("dst", axis)]:
+            extent *= pieces[p]
+        out_shape.append(extent)
+    return view_shape, perm, out_shape
+
+
+def layout_transform(data, src_layout, dst_layout, **kwargs):
+    """Create an extern op that transforms the layout of data with the layout transform kernel.
+
+    Parameters
+    ----------
+    data : tvm.te.Tensor
+        The input tensor, of a static shape.
+    src_layout : str
+        The source layout.
+    dst_layout : str
+        The destination layout.
+
+    Returns
+    -------
+    out : tvm.te.Tensor
+        The transformed tensor.
+    """
+    shape = [int(dim) for dim in data.shape]
+    view = get_transpose_view(shape, src_layout, dst_layout)
+    if view is None:
+        raise ValueError(
+            "Layout transform from {} to {} of shape {} is not a transpose".format(
+                src_layout, dst_layout, shape
+            )
+        )
+    view_shape, perm, out_shape = view
+    args = [IntImm("int32", len(view_shape))]
+    args += [IntImm("int64", dim) for dim in view_shape]
+    args += [IntImm("int32", axis) for axis in perm]
+    return te.extern(
+        out_shape,
+        [data],
+        lambda ins, outs: tvm.tir.call_packed(
+            "tvm.contrib.layout_transform.transpose", ins[0], outs[0], *args
+        ),
+        dtype=data.dtype,
+        name="T_layout_trans",
+        **kwargs,
+    )
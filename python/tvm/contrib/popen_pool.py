@@ -371,12 +371,20 @@ class PopenPoolExecutor:
             raise TypeError("initializer must be callable for PopenPoolExecutor")
 
     def __del__(self):
+        self.shutdown()
+
+    def shutdown(self):
+        """Kill all the worker processes and shut down the internal thread pool.
+
+        The executor can no longer be used after it is shut down.
+        """
         self._lock.acquire()
         for worker in self._worker_map.values():
             try:
                 worker.kill()
             except ImportError:
                 pass
+        self._worker_map.clear()
         self._lock.release()
         self._threadpool.shutdown()
 
@@ -255,3 +255,48 @@ class PassTimingInstrument(tvm.runtime.Object):
                 profiles = timing_inst.render()
         """
         return _ffi_instrument_api.RenderTimePassProfiles()
+
+
+class PassProfilingInstrument(tvm.runtime.Object):
+    """A wrapper to create a pass profiling instrument implemented in C++.
+
+    In addition to the nested timing of :py:class:`PassTimingInstrument`, it records
+    the resident memory of the process around each pass, the number of functions each
+    pass added or rewrote, and optionally the number of objects reachable from the module.
+
+    Parameters
+    ----------
+    count_objects : bool
+        Whether to count the objects reachable from the module before and after each pass.
+        This walks the whole module twice per pass, so it is disabled by default.
+    """
+
+    def __init__(self, count_objects=False):
+        self.__init_handle_by_constructor__(
+            _ffi_instrument_api.MakePassProfilingInstrument, count_objects
+        )
+
+    @staticmethod
+    def render():
+        """Retrieve the rendered profile of the most recently profiled PassContext.
+
+        Returns
+        -------
+        string : string
+            The hierarchical report, one line per pass with its total and self time,
+            the resident and peak memory (and their change), the number of functions
+            touched, and the object count when enabled.
+        """
+        return _ffi_instrument_api.RenderPassResourceProfiles()
+
+    @staticmethod
+    def export_flamegraph(path):
+        """Write the self time of each pass in the collapsed stack format accepted by
+        flamegraph.pl and speedscope, in microseconds.
+
+        Parameters
+        ----------
+        path : str
+            The file to write to.
+        """
+        _ffi_instrument_api.ExportPassResourceFlameGraph(path)
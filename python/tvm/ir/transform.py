@@ -43,10 +43,16 @@ class PassInfo(tvm.runtime.Object):
 
     required : List[str]
         The list of passes that are required by a certain pass.
+
+    thread_safe : bool
+        Whether the pass only reads the function it transforms, so that a function
+        level pass may transform several functions concurrently.
     """
 
-    def __init__(self, opt_level, name, required=None):
-        self.__init_handle_by_constructor__(_ffi_transform_api.PassInfo, opt_level, name, required)
+    def __init__(self, opt_level, name, required=None, thread_safe=False):
+        self.__init_handle_by_constructor__(
+            _ffi_transform_api.PassInfo, opt_level, name, required, thread_safe
+        )
 
 
 @tvm._ffi.register_object("transform.PassContext")
@@ -17,7 +17,8 @@
 """Local builder that compile on the local host"""
 import os
 import tempfile
-from typing import Callable, Dict, List, Optional, Union
+import traceback
+from typing import Callable, Dict, List, Optional, Tuple, Union
 
 from tvm._ffi import register_func
 from tvm.ir import IRModule
@@ -70,6 +71,14 @@ class LocalBuilder(PyBuilder):
     f_export : Union[None, str, T_EXPORT]
         Name of the export function to be used.
         Defaults to `meta_schedule.builder.default_export`.
+    persistent_workers : bool
+        Whether to keep the worker processes alive across `build` calls, so that the
+        TVM import, target initialization and registered functions stay warm.
+    max_worker_uses : Optional[int]
+        When using persistent workers, the number of batches a worker process builds
+        before it is recycled. None means never recycle.
+    batch_size : int
+        The number of candidates sent to a worker process in one round trip.
 
     Attributes
     ----------
@@ -106,6 +115,9 @@ class LocalBuilder(PyBuilder):
     initializer: Optional[Callable[[], None]]
     f_build: Union[None, str, T_BUILD]
     f_export: Union[None, str, T_EXPORT]
+    persistent_workers: bool
+    max_worker_uses: Optional[int]
+    batch_size: int
 
     def __init__(
         self,
@@ -115,6 +127,9 @@ class LocalBuilder(PyBuilder):
         f_build: Union[None, str, T_BUILD] = None,
         f_export: Union[None, str, T_EXPORT] = None,
         initializer: Optional[Callable[[], None]] = None,
+        persistent_workers: bool = False,
+        max_worker_uses: Optional[int] = None,
+        batch_size: int = 1,
     ) -> None:
         """Constructor.
 
@@ -133,6 +148,13 @@ class LocalBuilder(PyBuilder):
             Defaults to `meta_schedule.builder.default_export`.
         initializer : Optional[Callable[[], None]]
             The initializer to be used for the worker processes.
+        persistent_workers : bool
+            Whether to keep the worker processes alive across `build` calls.
+        max_worker_uses : Optional[int]
+            The number of batches a persistent worker builds before it is recycled.
+            None means never recycle.
+        batch_size : int
+            The number of candidates sent to a worker process in one round trip.
         """
         super().__init__()
 
@@ -145,56 +167,96 @@ class LocalBuilder(PyBuilder):
         self.initializer = initializer
         self.f_build = f_build
         self.f_export = f_export
+        self.persistent_workers = persistent_workers
+        self.max_worker_uses = max_worker_uses
+        self._pool: Optional[PopenPoolExecutor] = None
+        if batch_size < 1:
+            raise ValueError(f"LocalBuilder: batch_size must be positive, got {batch_size}")
+        self.batch_size = batch_size
         self._sanity_check()
 
     def build(self, build_inputs: List[BuilderInput]) -> List[BuilderResult]:
         results: List[BuilderResult] = []
         map_result: MapResult
 
-        # Here we restart the PopenPool everytime because of a known memory leak issue with the
-        # PopenPool workers after a couple times of usage. We don't apply the same to runners to
-        # avoid potential problem caused by async behaviour.
-        pool = PopenPoolExecutor(
-            max_workers=self.max_workers,
-            timeout=self.timeout_sec,
-            initializer=self.initializer,
-        )
-
-        # Dispatch the build inputs to the worker processes.
-        for map_result in pool.map_with_error_catching(
-            lambda x: _worker_func(*x),
-            [
-                (
-                    self.f_build,
-                    self.f_export,
-                    build_input.mod,
-                    build_input.target,
-                    _serialize_params(build_input.params),
-                )
-                for build_input in build_inputs
-            ],
+        pool = self._get_pool()
+        batches = [
+            build_inputs[i : i + self.batch_size]
+            for i in range(0, len(build_inputs), self.batch_size)
+        ]
+        # Dispatch the batches of build inputs to the worker processes.
+        for batch, map_result in zip(
+            batches,
+            pool.map_with_error_catching(
+                lambda x: _worker_batch_func(*x),
+                [
+                    (
+                        self.f_build,
+                        self.f_export,
+                        [
+                            (
+                                build_input.mod,
+                                build_input.target,
+                                _serialize_params(build_input.params),
+                            )
+                            for build_input in batch
+                        ],
+                    )
+                    for batch in batches
+                ],
+            ),
         ):
             if map_result.status == StatusKind.COMPLETE:
-                results.append(BuilderResult(map_result.value, None))
+                for artifact_path, error_msg in map_result.value:
+                    results.append(BuilderResult(artifact_path, error_msg))
             elif map_result.status == StatusKind.TIMEOUT:
-                results.append(
+                results.extend(
                     BuilderResult(
                         None,
-                        f"LocalBuilder: Timeout, killed after {self.timeout_sec} seconds",
+                        "LocalBuilder: Timeout, killed after "
+                        f"{self.timeout_sec * self.batch_size} seconds",
                     )
+                    for _ in batch
                 )
             elif map_result.status == StatusKind.EXCEPTION:
-                results.append(
+                results.extend(
                     BuilderResult(
                         None,
                         "LocalBuilder: An exception occurred\n" + str(map_result.value),
                     )
+                    for _ in batch
                 )
             else:
                 raise ValueError("Unreachable: unexpected result: {map_result}")
         del pool
         return results
 
+    def close(self) -> None:
+        """Shut down the persistent worker pool, if any. A later build starts a new one."""
+        if self._pool is not None:
+            self._pool.shutdown()
+            self._pool = None
+
+    def __del__(self):
+        self.close()
+
+    def _get_pool(self) -> PopenPoolExecutor:
+        # By default we restart the PopenPool everytime because of a known memory leak issue with
+        # the PopenPool workers after a couple times of usage. We don't apply the same to runners
+        # to avoid potential problem caused by async behaviour. Persistent workers are instead
+        # recycled after `max_worker_uses` batches.
+        if self.persistent_workers and self._pool is not None:
+            return self._pool
+        pool = PopenPoolExecutor(
+            max_workers=self.max_workers,
+            timeout=self.timeout_sec * self.batch_size,
+            initializer=self.initializer,
+            maximum_process_uses=self.max_worker_uses if self.persistent_workers else None,
+        )
+        if self.persistent_workers:
+            self._pool = pool
+        return pool
+
     def _sanity_check(self) -> None:
         def _check(f_build, f_export) -> None:
             get_global_func_with_default_on_worker(name=f_build, default=None)
@@ -234,6 +296,23 @@ def _worker_func(
     return artifact_path
 
 
+def _worker_batch_func(
+    _f_build: Union[None, str, T_BUILD],
+    _f_export: Union[None, str, T_EXPORT],
+    batch: List[Tuple[IRModule, Target, Optional[bytearray]]],
+) -> List[Tuple[Optional[str], Optional[str]]]:
+    results: List[Tuple[Optional[str], Optional[str]]] = []
+    for mod, target, params in batch:
+        # An error in one candidate should not fail the rest of the batch.
+        try:
+            results.append((_worker_func(_f_build, _f_export, mod, target, params), None))
+        except Exception:  # pylint: disable=broad-except
+            results.append(
+                (None, "LocalBuilder: An exception occurred\n" + traceback.format_exc())
+            )
+    return results
+
+
 @register_func("meta_schedule.builder.default_build")
 def default_build(mod: IRModule, target: Target, _params: Optional[Dict[str, NDArray]]) -> Module:
     """Default build function.
@@ -29,7 +29,7 @@ import tvm
 from tvm.ir.type import TupleType
 from tvm.micro import get_standalone_crt_dir
 from .._ffi import get_global_func
-from ..contrib import utils
+from ..contrib import graph_executor, utils
 from ..driver import build_module
 from ..relay.backend import executor_factory
 from ..relay.backend.name_transforms import to_c_variable_style, prefix_generated_name
@@ -358,7 +358,9 @@ def _is_module_names_unique(mods: typing.List[executor_factory.ExecutorFactoryMo
 
 
 def _export_graph_model_library_format(
-    mods: typing.List[executor_factory.ExecutorFactoryModule], tempdir: pathlib.Path
+    mods: typing.List[executor_factory.ExecutorFactoryModule],
+    tempdir: pathlib.Path,
+    graph_binary: bool = False,
 ):
     """Export a tvm.relay.build artifact in Model Library Format.
 
@@ -369,6 +371,8 @@ def _export_graph_model_library_format(
         which will be exported into Model Library Format.
     tempdir : pathlib.Path
         Temporary directory to populate with Model Library Format contents.
+    graph_binary : bool
+        Whether to also write the graph of graph executor modules in the binary graph format.
     """
 
     assert _is_module_names_unique(mods), "Multiple modules should have unique names."
@@ -451,6 +455,9 @@ def _export_graph_model_library_format(
                 graph_config_dir.mkdir(parents=True)
             with open(graph_config_dir / f"{mod.libmod_name}.graph", "w") as f:
                 f.write(mod.get_executor_config())
+            if graph_binary:
+                with open(graph_config_dir / f"{mod.libmod_name}.graph.bin", "wb") as f:
+                    f.write(graph_executor.graph_json_to_binary(mod.get_executor_config()))
 
 
 class NonStaticShapeError(Exception):
@@ -558,6 +565,7 @@ ExportableModule = typing.Union[
 def export_model_library_format(
     mods: typing.Union[ExportableModule, typing.List[ExportableModule]],
     file_name: typing.Union[str, pathlib.Path],
+    graph_binary: bool = False,
 ):
     """Export the build artifact in Model Library Format.
 
@@ -571,6 +579,10 @@ def export_model_library_format(
         The return value of tvm.build or tvm.relay.build.
     file_name : str
         Path to the .tar archive to generate.
+    graph_binary : bool
+        Whether to also write the graph of graph executor modules in the binary graph format, as
+        executor-config/graph/<model name>.graph.bin. The C runtime uses a binary graph in place,
+        without parsing it.
 
     Returns
     -------
@@ -601,7 +613,7 @@ def export_model_library_format(
             raise RuntimeError("Multiple operator is not supported.")
         _export_operator_model_library_format(modules[0], tempdir.path)
     elif graph_module_type:
-        _export_graph_model_library_format(modules, tempdir.path)
+        _export_graph_model_library_format(modules, tempdir.path, graph_binary)
     else:
         raise NotImplementedError(
             f"Don't know how to export module of type {modules[0].__class__!r}"
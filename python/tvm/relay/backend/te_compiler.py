@@ -19,6 +19,7 @@
 from __future__ import absolute_import
 
 import logging
+import numbers
 
 import numpy as np
 import tvm
@@ -280,6 +281,47 @@ def get_shape(shape):
     return ret
 
 
+def shape_buckets_from_profile(observed, max_buckets=4, coverage=0.9):
+    """Select the shape buckets to specialize dynamic shape kernels for from a profile.
+
+    The buckets are given to the "relay.backend.dynamic_shape_buckets" pass config option, the
+    kernels with dynamic shapes are then compiled again for the static shapes of each bucket
+    and dispatch to them at runtime.
+
+    Parameters
+    ----------
+    observed : List[Union[numbers.Integral, Tuple[numbers.Integral]]]
+        The values of the dynamic dimensions observed at runtime, one entry per call.
+
+    max_buckets : int
+        The maximum number of buckets, each of which adds a variant to every dynamic kernel.
+
+    coverage : float
+        The fraction of the observed calls after which no more buckets are selected.
+
+    Returns
+    -------
+    buckets : List[List[int]]
+        The most frequent values of the dynamic dimensions, most frequent first.
+    """
+    counts = {}
+    for dims in observed:
+        dims = (
+            (int(dims),) if isinstance(dims, numbers.Integral) else tuple(int(dim) for dim in dims)
+        )
+        counts[dims] = counts.get(dims, 0) + 1
+    # Ties are broken by the first observation, as dicts keep the insertion order.
+    ranked = sorted(counts.items(), key=lambda item: -item[1])
+    buckets = []
+    covered = 0
+    for dims, count in ranked:
+        if len(buckets) == max_buckets or covered >= coverage * len(observed):
+            break
+        buckets.append(list(dims))
+        covered += count
+    return buckets
+
+
 @tvm._ffi.register_func("relay.backend.lower_call")
 def lower_call(call, inputs, target, otype=None):
     """Lower the call expression to op implementation and tensor outputs."""
@@ -351,6 +351,13 @@ def build(
     raw_targets = Target.canon_multi_target_and_host(Target.target_or_current(target), target_host)
     assert len(raw_targets) > 0
     target_host = raw_targets[0].host
+    if runtime.name == "crt":
+        for tgt in raw_targets:
+            if tgt.attrs.get("layout-transform-kernel", False):
+                raise ValueError(
+                    "The layout transform kernel is not part of the CRT runtime, "
+                    "remove -layout-transform-kernel from target {}".format(tgt)
+                )
 
     # If current dispatch context is fallback context (the default root context),
     # then load pre-tuned parameters from TopHub
@@ -51,6 +51,11 @@ class MockCostEstimator(Object):
     def __init__(self, target_costs, max_estimates=0):
         self.__init_handle_by_constructor__(_ffi_api.MockCostEstimator, target_costs, max_estimates)
 
+    @property
+    def num_estimates(self):
+        """The number of candidates estimated so far."""
+        return _ffi_api.MockCostEstimatorNumEstimates(self)
+
 
 def arg_for(arg_type, device):
     """Returns a test argument of Relay arg_type on device"""
@@ -1081,6 +1081,33 @@ def sort_strategy(attrs, inputs, out_type, target):
     return strategy
 
 
+# layout_transform
+def wrap_compute_layout_transform(topi_compute):
+    """Wrap layout_transform topi compute"""
+
+    def _compute_layout_transform(attrs, inputs, _):
+        return [topi_compute(inputs[0], attrs.src_layout, attrs.dst_layout)]
+
+    return _compute_layout_transform
+
+
+@override_native_generic_func("layout_transform_strategy")
+def layout_transform_strategy(attrs, inputs, out_type, target):
+    """layout_transform generic strategy"""
+
+    def _schedule_layout_transform(attrs, outs, target):
+        with target:
+            return schedule_injective(attrs, outs, target)
+
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_layout_transform(topi.layout_transform),
+        _schedule_layout_transform,
+        name="layout_transform.generic",
+    )
+    return strategy
+
+
 # argsort
 def wrap_compute_argsort(topi_compute):
     """Wrap argsort topi compute"""
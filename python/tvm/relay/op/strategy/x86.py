@@ -21,6 +21,7 @@ import re
 
 from tvm import tir, topi
 from tvm.auto_scheduler import is_auto_scheduler_enabled
+from tvm.contrib.layout_transform import get_transpose_view
 from tvm.meta_schedule import is_meta_schedule_enabled
 from tvm.relay.ty import is_dynamic
 from tvm.target import Target
@@ -848,3 +849,38 @@ def batch_norm_strategy_cpu(attrs, inputs, out_type, target):
         name="batch_norm.cpu",
     )
     return strategy
+
+
+@layout_transform_strategy.register("cpu")
+def layout_transform_strategy_cpu(attrs, inputs, out_type, target):
+    """layout_transform x86 strategy"""
+    strategy = _op.OpStrategy()
+    strategy.add_implementation(
+        wrap_compute_layout_transform(topi.layout_transform),
+        wrap_topi_schedule(topi.x86.schedule_injective),
+        name="layout_transform.x86",
+    )
+    # Transforms that only move data, e.g. between NCHW, NHWC and NCHW[x]c, use the
+    # layout transform kernel of the runtime when the target opts in. Whether the runtime of
+    # the deployment has the kernel cannot be told from the compiling host.
+    data = inputs[0]
+    use_kernel = (
+        target.kind.name == "llvm"
+        and bool(target.attrs.get("layout-transform-kernel", False))
+        and all(isinstance(dim, tir.IntImm) for dim in data.shape)
+        and not is_dynamic(out_type)
+        and not is_auto_scheduler_enabled()
+        and not is_meta_schedule_enabled()
+        and get_transpose_view(
+            [int(dim) for dim in data.shape], attrs.src_layout, attrs.dst_layout
+        )
+        is not None
+    )
+    if use_kernel:
+        strategy.add_implementation(
+            wrap_compute_layout_transform(topi.x86.layout_transform_kernel),
+            wrap_topi_schedule(topi.x86.schedule_layout_transform_kernel),
+            name="layout_transform_kernel.x86",
+            plevel=15,
+        )
+    return strategy
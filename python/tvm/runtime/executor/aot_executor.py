@@ -67,6 +67,7 @@ class AotModule(object):
         self._get_num_outputs = module["get_num_outputs"]
         self._get_input_index = module["get_input_index"]
         self._get_num_inputs = module["get_num_inputs"]
+        self._create_context = module["create_context"]
 
     def set_input(self, key=None, value=None, **params):
         """Set inputs to the module via kwargs
@@ -164,6 +165,19 @@ class AotModule(object):
         """
         return self._get_input_index(name)
 
+    def create_context(self):
+        """Create another execution context of the same model.
+
+        The context shares the compiled code and the constants with this module, and has its own
+        inputs, outputs and workspace. Contexts can run concurrently, each in its own thread.
+
+        Returns
+        -------
+        context : AotModule
+            The new execution context.
+        """
+        return AotModule(self._create_context())
+
     def get_output(self, index, out=None):
         """Get index-th output to out
 
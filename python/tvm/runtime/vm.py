@@ -402,6 +402,7 @@ class VirtualMachine(object):
         self._set_input = self.module["set_input"]
         self._set_one_input = self.module["set_one_input"]
         self._set_outputs = self.module["set_outputs"]
+        self._set_packed_concurrency = self.module["set_packed_concurrency"]
         self._setup_device(device, memory_cfg)
 
     def _setup_device(self, dev, memory_cfg):
@@ -623,6 +624,22 @@ class VirtualMachine(object):
         """
         return self._get_input_index(input_name, func_name)
 
+    def set_packed_concurrency(self, num_threads):
+        """Set the number of threads running independent operators concurrently.
+
+        Consecutive operator calls which do not depend on each other are run on a
+        pool of threads when their tensors are on the host and do not share memory.
+        The operator library must be safe to call from several threads.
+        The parallel loops of each operator then use a share of the cores.
+
+        Parameters
+        ----------
+        num_threads : int
+            The number of threads. 1 (the default) runs all operators in order,
+            and a non-positive value uses all hardware threads.
+        """
+        self._set_packed_concurrency(num_threads)
+
     def benchmark(
         self,
         device,
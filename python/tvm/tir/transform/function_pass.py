@@ -70,6 +70,7 @@ def prim_func_pass(
     opt_level: int = None,
     name: Optional[str] = None,
     required: Optional[List[str]] = None,
+    thread_safe: bool = False,
 ) -> Union[Callable, PrimFuncPass]:
     """Decorate a function pass.
 
@@ -92,6 +93,11 @@ def prim_func_pass(
     required : Optional[List[str]]
         The list of passes that the function pass is dependent on.
 
+    thread_safe : bool
+        Whether the pass only reads the function it transforms. Only such passes
+        transform several functions concurrently when the config
+        "ir.function_pass_num_threads" is set.
+
     Returns
     -------
     create_function_pass : Union[Callable, FunctionPass]
@@ -148,7 +154,7 @@ def prim_func_pass(
     def create_function_pass(pass_arg):
         """Internal function that creates a function pass"""
         fname = name if name else pass_arg.__name__
-        info = PassInfo(opt_level, fname, required)
+        info = PassInfo(opt_level, fname, required, thread_safe)
         if inspect.isclass(pass_arg):
             return _wrap_class_function_pass(pass_arg, info)
         if not isinstance(pass_arg, (types.FunctionType, types.LambdaType)):
@@ -58,6 +58,20 @@ def InjectPrefetch():
     return _ffi_api.InjectPrefetch()  # type: ignore
 
 
+def InjectSoftwarePrefetch():
+    """Insert software prefetches for the streaming loads of innermost reduction loops.
+
+    Only applies to functions whose CPU target sets ``sw-prefetch``, e.g.
+    ``llvm -sw-prefetch=1 -sw-prefetch-latency=300``.
+
+    Returns
+    -------
+    fpass : tvm.transform.Pass
+        The result pass
+    """
+    return _ffi_api.InjectSoftwarePrefetch()  # type: ignore
+
+
 def ApplyLayoutTransforms():
     """Reshape buffers that appear in the "layout_transform_map"
     fucntion attribute.
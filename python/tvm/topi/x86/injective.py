@@ -17,7 +17,8 @@
 # pylint: disable=invalid-name
 """x86 declaration and schedules."""
 from tvm import te
-from tvm.topi import tag
+from tvm.contrib import layout_transform as layout_transform_contrib
+from tvm.topi import generic, tag
 from tvm.tir import IntImm
 from tvm.topi.generic.injective import (
     schedule_injective_from_existing as schedule_injective_for_concat,
@@ -77,11 +78,35 @@ def schedule_injective(outs):
     s = te.create_schedule([x.op for x in outs])
     te.schedule.AutoInlineInjective(s)
     for x in outs:
-        if not is_empty_shape(x.shape):
+        # An extern op, such as the layout transform kernel, can be fused into the group.
+        if not is_empty_shape(x.shape) and not isinstance(x.op, te.ExternOp):
             schedule_injective_from_existing(s, x)
     return s
 
 
+def layout_transform_kernel(data, src_layout, dst_layout):
+    """Compute layout_transform with the cache-blocked layout transform kernel.
+    Parameters
+    ----------
+    data: Tensor
+          The input tensor, of a static shape.
+    src_layout: str
+          The source layout.
+    dst_layout: str
+          The destination layout.
+    Returns
+    -------
+    out: Tensor
+        The transformed tensor.
+    """
+    return layout_transform_contrib.layout_transform(data, src_layout, dst_layout)
+
+
+def schedule_layout_transform_kernel(outs):
+    """X86 schedule for layout_transform_kernel, with injective ops fused after it."""
+    return generic.schedule_extern(outs)
+
+
 def schedule_concatenate(outs):
     """X86 schedule for concatenate op.
     Parameters
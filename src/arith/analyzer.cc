@@ -21,13 +21,165 @@
  * \file tvm/arith/analyzer.cc
  */
 #include <tvm/arith/analyzer.h>
+#include <tvm/ir/transform.h>
 #include <tvm/runtime/registry.h>
 #include <tvm/tir/expr.h>
 #include <tvm/tir/op.h>
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../support/utils.h"
+
 namespace tvm {
 namespace arith {
 
+/*!
+ * \brief Memoized results of analyzer queries.
+ *
+ *  Each distinct set of known facts is identified by a context id.
+ *  Results are recorded under the id of the facts they were derived from,
+ *  so they never need to be erased when the facts change.
+ */
+class Analyzer::MemoTable {
+ public:
+  /*! \brief The kind of memoized query. */
+  enum class Query : int {
+    kSimplify = 0,
+    kCanProve = 1,
+    kSimplifiedBound = 2,
+    kCanProveEqual = 3,
+  };
+
+  /*!
+   * \brief Look up a recorded result.
+   * \param expr The queried expression.
+   * \param query The kind of query.
+   * \param arg Additional parameters of the query that affect the result.
+   * \param other The second queried expression of binary queries.
+   * \return The recorded result, nullptr if not found.
+   */
+  const ObjectRef* Find(const PrimExpr& expr, Query query, int64_t arg,
+                        const PrimExpr& other = PrimExpr()) {
+    auto it = table_.find(Key{expr.get(), other.get(), context_, query, arg});
+    if (it == table_.end()) {
+      ++stats_.misses;
+      return nullptr;
+    }
+    ++stats_.hits;
+    return &it->second.result;
+  }
+
+  /*!
+   * \brief Record the result of a query.
+   * \param expr The queried expression.
+   * \param query The kind of query.
+   * \param arg Additional parameters of the query that affect the result.
+   * \param result The result to be recorded.
+   * \param other The second queried expression of binary queries.
+   */
+  void Insert(const PrimExpr& expr, Query query, int64_t arg, ObjectRef result,
+              const PrimExpr& other = PrimExpr()) {
+    if (table_.size() >= kMaxEntries) {
+      table_.clear();
+      ++stats_.flushes;
+    }
+    table_[Key{expr.get(), other.get(), context_, query, arg}] =
+        Entry{expr, other, std::move(result)};
+  }
+
+  /*! \brief Switch to a new set of facts that never appeared before. */
+  void Invalidate() { context_ = ++last_context_; }
+
+  /*!
+   * \brief Start entering a constraint scope.
+   *
+   *  Until ActivateScope is called, results are recorded under a
+   *  transient id, as the sub-analyzers are only partially updated.
+   *
+   * \return The id of the facts inside the scope.
+   */
+  uint64_t EnterScope() {
+    uint64_t inner = ++last_context_;
+    scopes_.emplace_back(context_, inner);
+    Invalidate();
+    return inner;
+  }
+
+  /*!
+   * \brief Finish entering a constraint scope.
+   * \param inner The id returned by the corresponding EnterScope.
+   */
+  void ActivateScope(uint64_t inner) { context_ = inner; }
+
+  /*!
+   * \brief Exit a constraint scope.
+   * \param inner The id returned by the corresponding EnterScope.
+   */
+  void ExitScope(uint64_t inner) {
+    // The enclosing facts are restored only if nothing else changed inside the scope,
+    // and the scopes are exited in the reverse order of entering.
+    if (!scopes_.empty() && scopes_.back().second == inner && context_ == inner) {
+      context_ = scopes_.back().first;
+      scopes_.pop_back();
+      return;
+    }
+    for (auto it = scopes_.begin(); it != scopes_.end(); ++it) {
+      if (it->second == inner) {
+        scopes_.erase(it);
+        break;
+      }
+    }
+    Invalidate();
+  }
+
+  /*! \brief The hit and miss counters. */
+  AnalyzerMemoStats stats_;
+
+ private:
+  /*! \brief The key of a recorded result. */
+  struct Key {
+    const Object* expr;
+    const Object* other;
+    uint64_t context;
+    Query query;
+    int64_t arg;
+
+    bool operator==(const Key& key) const {
+      return expr == key.expr && other == key.other && context == key.context &&
+             query == key.query && arg == key.arg;
+    }
+  };
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      uint64_t hash = reinterpret_cast<uintptr_t>(key.expr);
+      hash = support::HashCombine(hash, reinterpret_cast<uintptr_t>(key.other));
+      hash = support::HashCombine(hash, key.context);
+      hash = support::HashCombine(hash, static_cast<uint64_t>(key.query));
+      return support::HashCombine(hash, static_cast<uint64_t>(key.arg));
+    }
+  };
+  /*! \brief A recorded result. */
+  struct Entry {
+    /*! \brief The queried expressions, held so that their addresses are not reused. */
+    PrimExpr expr;
+    PrimExpr other;
+    /*! \brief The result of the query. */
+    ObjectRef result;
+  };
+  /*! \brief The maximum number of recorded results before the table is flushed. */
+  static constexpr size_t kMaxEntries = 1 << 16;
+  /*! \brief The id of the current set of facts. */
+  uint64_t context_{0};
+  /*! \brief The last id that was handed out. */
+  uint64_t last_context_{0};
+  /*! \brief The (enclosing, inner) ids of the active constraint scopes. */
+  std::vector<std::pair<uint64_t, uint64_t>> scopes_;
+  /*! \brief The recorded results. */
+  std::unordered_map<Key, Entry, KeyHash> table_;
+};
+
 Analyzer::Analyzer()
     : const_int_bound(this),
       modular_set(this),
@@ -35,6 +187,26 @@ Analyzer::Analyzer()
       canonical_simplify(this),
       int_set(this) {}
 
+Analyzer::~Analyzer() = default;
+
+void Analyzer::EnableMemoization(bool enable) {
+  if (!enable) {
+    memo_.reset();
+  } else if (memo_ == nullptr) {
+    memo_ = std::make_unique<MemoTable>();
+  }
+}
+
+void Analyzer::InvalidateMemo() {
+  if (memo_ != nullptr) {
+    memo_->Invalidate();
+  }
+}
+
+AnalyzerMemoStats Analyzer::GetMemoStats() const {
+  return memo_ != nullptr ? memo_->stats_ : AnalyzerMemoStats();
+}
+
 void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   PrimExpr new_expr = expr;
   new_expr = this->canonical_simplify(new_expr);
@@ -46,6 +218,7 @@ void Analyzer::Bind(const Var& var, const PrimExpr& expr, bool allow_override) {
   this->canonical_simplify.Update(var, new_expr, allow_override);
   this->int_set.Update(var, this->int_set(new_expr), allow_override);
   this->transitive_comparisons.Bind(var, expr, allow_override);
+  this->InvalidateMemo();
 }
 
 void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
@@ -56,6 +229,7 @@ void Analyzer::Bind(const Var& var, const Range& range, bool allow_override) {
     this->const_int_bound.Bind(var, range, allow_override);
     this->int_set.Bind(var, range, allow_override);
     this->transitive_comparisons.Bind(var, range, allow_override);
+    this->InvalidateMemo();
   }
   // skip modular_set
   // skip rewrite simplify
@@ -69,12 +243,18 @@ void Analyzer::Bind(const Map<Var, Range>& variables, bool allow_override) {
 
 void ConstraintContext::EnterWithScope() {
   ICHECK(recovery_functions_.size() == 0);
+  if (analyzer_->memo_ != nullptr) {
+    memo_context_ = analyzer_->memo_->EnterScope();
+  }
   // entering the scope.
   recovery_functions_.push_back(analyzer_->const_int_bound.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->modular_set.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->rewrite_simplify.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->int_set.EnterConstraint(constraint_));
   recovery_functions_.push_back(analyzer_->transitive_comparisons.EnterConstraint(constraint_));
+  if (analyzer_->memo_ != nullptr && memo_context_ != 0) {
+    analyzer_->memo_->ActivateScope(memo_context_);
+  }
 }
 
 void ConstraintContext::ExitWithScope() {
@@ -85,13 +265,35 @@ void ConstraintContext::ExitWithScope() {
     }
     recovery_functions_.pop_back();
   }
+  if (analyzer_->memo_ != nullptr) {
+    if (memo_context_ != 0) {
+      analyzer_->memo_->ExitScope(memo_context_);
+    } else {
+      // Memoization was enabled inside the scope.
+      analyzer_->memo_->Invalidate();
+    }
+  }
+}
+
+ConstIntBound Analyzer::SimplifiedConstIntBound(const PrimExpr& expr) {
+  int64_t extensions = this->rewrite_simplify.GetEnabledExtensions();
+  if (memo_ != nullptr) {
+    if (const ObjectRef* res = memo_->Find(expr, MemoTable::Query::kSimplifiedBound, extensions)) {
+      return Downcast<ConstIntBound>(*res);
+    }
+  }
+  ConstIntBound bd = this->const_int_bound(this->rewrite_simplify(expr));
+  if (memo_ != nullptr) {
+    memo_->Insert(expr, MemoTable::Query::kSimplifiedBound, extensions, bd);
+  }
+  return bd;
 }
 
 bool Analyzer::CanProveGreaterEqual(const PrimExpr& expr, int64_t lower_bound) {
   if (const auto* ptr = expr.as<tir::IntImmNode>()) {
     return ptr->value >= lower_bound;
   }
-  auto bd = this->const_int_bound(this->rewrite_simplify(expr));
+  auto bd = this->SimplifiedConstIntBound(expr);
   if (bd->min_value >= lower_bound) return true;
   return false;
 }
@@ -100,7 +302,7 @@ bool Analyzer::CanProveLess(const PrimExpr& expr, int64_t upper_bound) {
   if (const auto* ptr = expr.as<tir::IntImmNode>()) {
     return ptr->value < upper_bound;
   }
-  auto bd = this->const_int_bound(this->rewrite_simplify(expr));
+  auto bd = this->SimplifiedConstIntBound(expr);
   if (bd->max_value < upper_bound) return true;
   return false;
 }
@@ -112,7 +314,19 @@ bool Analyzer::CanProveEqual(const PrimExpr& lhs, const PrimExpr& rhs) {
   if (lhs->dtype.is_handle() || rhs->dtype.is_handle()) {
     return lhs.same_as(rhs);
   }
-  return CanProve(lhs - rhs == 0);
+  // The difference is a new expression on every call, so the operands are the key.
+  int64_t extensions = this->rewrite_simplify.GetEnabledExtensions();
+  if (memo_ != nullptr) {
+    if (const ObjectRef* res =
+            memo_->Find(lhs, MemoTable::Query::kCanProveEqual, extensions, rhs)) {
+      return Downcast<Integer>(*res)->value != 0;
+    }
+  }
+  bool proved = CanProve(lhs - rhs == 0);
+  if (memo_ != nullptr) {
+    memo_->Insert(lhs, MemoTable::Query::kCanProveEqual, extensions, Integer(proved), rhs);
+  }
+  return proved;
 }
 
 bool Analyzer::CanProve(const PrimExpr& expr) {
@@ -121,17 +335,37 @@ bool Analyzer::CanProve(const PrimExpr& expr) {
     return ptr->value != 0;
   }
 
+  int64_t extensions = this->rewrite_simplify.GetEnabledExtensions();
+  if (memo_ != nullptr) {
+    if (const ObjectRef* res = memo_->Find(expr, MemoTable::Query::kCanProve, extensions)) {
+      return Downcast<Integer>(*res)->value != 0;
+    }
+  }
+
   PrimExpr simplified = Simplify(expr);
   const int64_t* as_int = tir::as_const_int(simplified);
-  return as_int && *as_int;
+  bool proved = as_int && *as_int;
+  if (memo_ != nullptr) {
+    memo_->Insert(expr, MemoTable::Query::kCanProve, extensions, Integer(proved));
+  }
+  return proved;
 }
 
 PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
+  // The enabled extensions of rewrite_simplify are part of the key, as they change the result.
+  int64_t memo_arg = (static_cast<int64_t>(this->rewrite_simplify.GetEnabledExtensions()) << 32) |
+                     static_cast<uint32_t>(steps);
+  if (memo_ != nullptr && !tir::is_const_int(expr)) {
+    if (const ObjectRef* res = memo_->Find(expr, MemoTable::Query::kSimplify, memo_arg)) {
+      return Downcast<PrimExpr>(*res);
+    }
+  }
+
   PrimExpr res = expr;
 
   for (int i = 0; i < steps; ++i) {
     if (tir::is_const_int(res)) {
-      return res;
+      break;
     }
     if (i % 2 == 0) {
       res = this->rewrite_simplify(res);
@@ -140,9 +374,14 @@ PrimExpr Analyzer::Simplify(const PrimExpr& expr, int steps) {
     }
   }
 
+  if (memo_ != nullptr && !tir::is_const_int(expr)) {
+    memo_->Insert(expr, MemoTable::Query::kSimplify, memo_arg, res);
+  }
   return res;
 }
 
+TVM_REGISTER_PASS_CONFIG_OPTION("arith.enable_memoization", Bool);
+
 TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValue* ret) {
   using runtime::PackedFunc;
   using runtime::TypedPackedFunc;
@@ -157,6 +396,7 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
     } else if (name == "const_int_bound_update") {
       return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
         self->const_int_bound.Update(args[0], args[1], args[2]);
+        self->InvalidateMemo();
       });
     } else if (name == "Simplify") {
       return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
@@ -197,6 +437,18 @@ TVM_REGISTER_GLOBAL("arith.CreateAnalyzer").set_body([](TVMArgs args, TVMRetValu
     } else if (name == "can_prove_equal") {
       return PackedFunc(
           [self](TVMArgs args, TVMRetValue* ret) { *ret = self->CanProveEqual(args[0], args[1]); });
+    } else if (name == "can_prove") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) { *ret = self->CanProve(args[0]); });
+    } else if (name == "enable_memoization") {
+      return PackedFunc(
+          [self](TVMArgs args, TVMRetValue* ret) { self->EnableMemoization(args[0]); });
+    } else if (name == "memo_stats") {
+      return PackedFunc([self](TVMArgs args, TVMRetValue* ret) {
+        AnalyzerMemoStats stats = self->GetMemoStats();
+        *ret = Map<String, Integer>{{"hits", Integer(stats.hits)},
+                                    {"misses", Integer(stats.misses)},
+                                    {"flushes", Integer(stats.flushes)}};
+      });
     }
     return PackedFunc();
   };
@@ -37,13 +37,19 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <queue>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "../arith/pattern_match.h"
 #include "../relay/transforms/auto_scheduler_layout_rewrite.h"
+#include "../support/utils.h"
 #include "search_policy/utils.h"
 #include "utils.h"
 
@@ -680,6 +686,174 @@ void CheckComputeValidity(const te::Schedule& sch) {
   }
 }
 
+/*! \brief The default number of step prefixes cached for InferBound of a ComputeDAG. */
+constexpr int kDefaultInferBoundCacheSize = 256;
+
+/*!
+ * \brief An LRU cache of the te::Schedule replayed from prefixes of transform steps.
+ *
+ * The states generated during the search share the Step objects with the states they are derived
+ * from, so a state usually finds the schedule of its parent here and only replays the last few
+ * steps on a copy of it. The cached schedules are never mutated after insertion, so they can be
+ * copied by multiple threads concurrently.
+ */
+class InferBoundCache {
+ public:
+  explicit InferBoundCache(int capacity) : capacity_(capacity) {}
+
+  /*! \brief Set the maximum number of cached schedules, evicting the extra ones. */
+  void SetCapacity(int capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = std::max(capacity, 0);
+    EvictExtraEntries();
+  }
+
+  /*!
+   * \brief Apply the transform steps to get a TVM schedule, starting from the schedule cached for
+   * the longest prefix of the steps.
+   * \param dag The ComputeDAG the steps are applied on.
+   * \param transform_steps Transform steps of a state.
+   * \param stages The list of stages after applying the steps.
+   * \param stage_to_axes The map that stores all axes for one stage.
+   * \return The TVM schedule after applying the steps.
+   */
+  te::Schedule ApplySteps(const ComputeDAG& dag, const Array<Step>& transform_steps,
+                          Array<te::Stage>* stages, StageToAxesMap* stage_to_axes) {
+    size_t n = transform_steps.size();
+    // prefix_hashes[i] is the hash of the first i steps
+    std::vector<uint64_t> prefix_hashes(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+      prefix_hashes[i + 1] =
+          support::HashCombine(prefix_hashes[i], ObjectPtrHash()(transform_steps[i]));
+    }
+    size_t start = 0;
+    std::shared_ptr<const Entry> entry = Lookup(transform_steps, prefix_hashes, &start);
+    te::Schedule sch;
+    if (entry == nullptr) {
+      sch = dag.ApplySteps(transform_steps, stages, stage_to_axes).first;
+    } else {
+      sch = entry->Restore(stages, stage_to_axes);
+      for (size_t i = start; i < n; ++i) {
+        StepApplyToSchedule(transform_steps[i], stages, stage_to_axes, &sch, transform_steps);
+      }
+    }
+    if (n != 0 && start != n) {
+      Insert(prefix_hashes[n], std::make_shared<const Entry>(transform_steps, sch, *stages,
+                                                             *stage_to_axes));
+    }
+    return sch;
+  }
+
+ private:
+  /*! \brief A schedule replayed from a list of steps, together with its stage information. */
+  struct Entry {
+    Entry(Array<Step> steps, te::Schedule sch, Array<te::Stage> stages,
+          StageToAxesMap stage_to_axes)
+        : steps(std::move(steps)),
+          sch(std::move(sch)),
+          stages(std::move(stages)),
+          stage_to_axes(std::move(stage_to_axes)) {}
+
+    /*! \brief Whether the steps are exactly the first `num_steps` steps of `transform_steps`. */
+    bool IsPrefixOf(const Array<Step>& transform_steps, size_t num_steps) const {
+      if (steps.size() != num_steps) {
+        return false;
+      }
+      for (size_t i = 0; i < num_steps; ++i) {
+        if (!steps[i].same_as(transform_steps[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /*! \brief Copy the cached schedule and map the stage information onto the copy. */
+    te::Schedule Restore(Array<te::Stage>* out_stages, StageToAxesMap* out_stage_to_axes) const {
+      te::Schedule new_sch = sch.copy();
+      std::unordered_map<te::Stage, te::Stage, ObjectPtrHash, ObjectPtrEqual> stage_map;
+      for (size_t i = 0; i < sch->stages.size(); ++i) {
+        stage_map.emplace(sch->stages[i], new_sch->stages[i]);
+      }
+      for (size_t i = 0; i < sch->groups.size(); ++i) {
+        stage_map.emplace(sch->groups[i], new_sch->groups[i]);
+      }
+      for (const te::Stage& stage : stages) {
+        auto it = stage_map.find(stage);
+        ICHECK(it != stage_map.end()) << "Cannot find the stage " << stage << " in the schedule";
+        out_stages->push_back(it->second);
+      }
+      for (const auto& kv : stage_to_axes) {
+        auto it = stage_map.find(kv.first);
+        // Stages replaced by the steps can be left in the map, but are never looked up
+        if (it != stage_map.end()) {
+          out_stage_to_axes->Set(it->second, kv.second);
+        }
+      }
+      return new_sch;
+    }
+
+    /*! \brief The transform steps applied. */
+    Array<Step> steps;
+    /*! \brief The schedule after applying the steps. */
+    te::Schedule sch;
+    /*! \brief The list of stages after applying the steps. */
+    Array<te::Stage> stages;
+    /*! \brief The map that stores all axes for one stage. */
+    StageToAxesMap stage_to_axes;
+  };
+
+  using EntryList = std::list<std::pair<uint64_t, std::shared_ptr<const Entry>>>;
+
+  /*! \brief Find the entry of the longest prefix of the steps and mark it as recently used. */
+  std::shared_ptr<const Entry> Lookup(const Array<Step>& transform_steps,
+                                      const std::vector<uint64_t>& prefix_hashes,
+                                      size_t* num_steps) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = prefix_hashes.size() - 1; i > 0; --i) {
+      auto it = index_.find(prefix_hashes[i]);
+      if (it != index_.end() && it->second->second->IsPrefixOf(transform_steps, i)) {
+        entries_.splice(entries_.begin(), entries_, it->second);
+        *num_steps = i;
+        return it->second->second;
+      }
+    }
+    return nullptr;
+  }
+
+  /*! \brief Insert an entry as the most recently used one. */
+  void Insert(uint64_t hash, std::shared_ptr<const Entry> entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+      return;
+    }
+    auto it = index_.find(hash);
+    if (it != index_.end()) {
+      // Either the same steps were replayed by another thread, or a hash collision
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+    entries_.emplace_front(hash, std::move(entry));
+    index_.emplace(hash, entries_.begin());
+    EvictExtraEntries();
+  }
+
+  void EvictExtraEntries() {
+    while (entries_.size() > static_cast<size_t>(capacity_)) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+  }
+
+  /*! \brief The maximum number of cached schedules. */
+  int capacity_;
+  /*! \brief The cached entries, from the most recently used to the least recently used. */
+  EntryList entries_;
+  /*! \brief The index from the hash of the steps to the entries. */
+  std::unordered_map<uint64_t, EntryList::iterator> index_;
+  /*! \brief The mutex protecting the entries. */
+  std::mutex mutex_;
+};
+
 ComputeDAG::ComputeDAG(Array<te::Tensor> tensors) {
   auto node = make_object<ComputeDAGNode>();
   node->tensors = std::move(tensors);
@@ -701,6 +875,7 @@ ComputeDAG::ComputeDAG(Array<te::Tensor> tensors) {
 
   node->flop_ct = FlopEstimator().EstimateFlop(node->ops);
   node->init_state = State(node->ops);
+  node->infer_bound_cache = std::make_shared<InferBoundCache>(kDefaultInferBoundCacheSize);
   data_ = std::move(node);
 }
 
@@ -728,6 +903,7 @@ ComputeDAG::ComputeDAG(const te::Schedule& sch) {
   node->access_analyzer = AccessAnalyzer(node->tensors);
   node->flop_ct = FlopEstimator().EstimateFlop(node->ops);
   node->init_state = State(node->ops);
+  node->infer_bound_cache = std::make_shared<InferBoundCache>(kDefaultInferBoundCacheSize);
   data_ = std::move(node);
 }
 
@@ -1326,8 +1502,14 @@ State ComputeDAG::InferBound(const State& state) const {
   Array<te::Stage> stages;
   StageToAxesMap stage_to_axes;
   // Replay steps to tvm::Schedule
-  auto [sch, tensors] = ApplySteps(pstate->transform_steps, &stages, &stage_to_axes);
-  (void)tensors;  // https://gcc.gnu.org/bugzilla/show_bug.cgi?id=81767
+  te::Schedule sch;
+  if (operator->()->infer_bound_cache != nullptr) {
+    sch = operator->()->infer_bound_cache->ApplySteps(*this, pstate->transform_steps, &stages,
+                                                      &stage_to_axes);
+  } else {
+    sch = ApplySteps(pstate->transform_steps, &stages, &stage_to_axes).first;
+  }
+  // The replayed schedule may be cached, `normalize_for_feature_extraction` works on a copy
   sch = sch.normalize_for_feature_extraction();
   // Get bound information from TVM schedule
   Map<IterVar, Range> bounds = te::InferBound(sch);
@@ -1365,19 +1547,28 @@ State ComputeDAG::InferBound(const State& state) const {
 }
 
 Array<State> ComputeDAG::InferBound(const Array<State>& states) const {
-  Array<State> out_states(states.size(), State());
-
-  support::parallel_for(0, states.size(), [this, &states, &out_states](int i) {
-    try {
-      out_states.Set(i, (states[i].defined()) ? this->InferBound(states[i]) : states[i]);
-    } catch (Error& e) {
-      LOG(WARNING) << "InferBound fails on the state:\n"
-                   << states[i] << "\n"
-                   << "with: " << e.what() << std::endl;
-    }
-  });
+  std::vector<State> out_states(states.size());
+  // The threads are not taken from the runtime thread pool: this may run inside one of its tasks,
+  // e.g. a search callback, and should not compete with the kernels being measured. The cost of a
+  // state varies a lot, so the states are claimed one by one.
+  int num_threads = std::min<int>(std::thread::hardware_concurrency(), states.size());
+  support::parallel_for_dynamic(
+      0, states.size(), std::max(1, num_threads), [this, &states, &out_states](int, int i) {
+        try {
+          out_states[i] = states[i].defined() ? this->InferBound(states[i]) : states[i];
+        } catch (Error& e) {
+          LOG(WARNING) << "InferBound fails on the state:\n"
+                       << states[i] << "\n"
+                       << "with: " << e.what() << std::endl;
+        }
+      });
+  return Array<State>(out_states.begin(), out_states.end());
+}
 
-  return out_states;
+void ComputeDAG::SetInferBoundCacheSize(int size) const {
+  ICHECK(operator->()->infer_bound_cache != nullptr)
+      << "The InferBound cache is not available on this ComputeDAG";
+  operator->()->infer_bound_cache->SetCapacity(size);
 }
 
 ComputeDAG ComputeDAG::ReplayAndGetDAG(const Array<Step>& transform_steps) const {
@@ -1499,6 +1690,9 @@ TVM_REGISTER_GLOBAL("auto_scheduler.ComputeDAGInferBoundFromState")
       return dag.InferBound(state);
     });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.ComputeDAGSetInferBoundCacheSize")
+    .set_body_typed([](const ComputeDAG& dag, int size) { dag.SetInferBoundCacheSize(size); });
+
 TVM_REGISTER_GLOBAL("auto_scheduler.ComputeDAGRewriteLayoutFromState")
     .set_body_typed([](const ComputeDAG& dag, const State& state) {
       Array<Step>* transform_steps = const_cast<Array<Step>*>(&state->transform_steps);
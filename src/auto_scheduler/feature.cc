@@ -1456,8 +1456,9 @@ void GetPerStoreFeaturesFromFile(const std::string& filename, int max_lines, int
   // task_id -> min_cost
   std::vector<float> min_costs;
 
-  const auto* workload_key_to_tensors =
-      tvm::runtime::Registry::Get("auto_scheduler.workload_key_to_tensors");
+  static const tvm::runtime::Registry::Handle fworkload_key_to_tensors(
+      "auto_scheduler.workload_key_to_tensors");
+  const auto* workload_key_to_tensors = fworkload_key_to_tensors.Get();
   ICHECK(workload_key_to_tensors != nullptr);
 
   // read from file
@@ -1525,8 +1526,9 @@ void GetPerStoreFeaturesFromMeasurePairs(const Array<MeasureInput>& inputs,
   // task_id -> min_cost
   std::vector<float> min_costs;
 
-  const auto* workload_key_to_tensors =
-      tvm::runtime::Registry::Get("auto_scheduler.workload_key_to_tensors");
+  static const tvm::runtime::Registry::Handle fworkload_key_to_tensors(
+      "auto_scheduler.workload_key_to_tensors");
+  const auto* workload_key_to_tensors = fworkload_key_to_tensors.Get();
   ICHECK(workload_key_to_tensors != nullptr);
 
   tasks.reserve(inputs.size());
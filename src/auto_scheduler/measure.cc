@@ -115,7 +115,8 @@ LocalBuilder::LocalBuilder(int timeout, int n_parallel, const String& build_func
 }
 
 Array<BuildResult> LocalBuilderNode::Build(const Array<MeasureInput>& inputs, int verbose) {
-  if (const auto* f = runtime::Registry::Get("auto_scheduler.local_builder.build")) {
+  static const runtime::Registry::Handle fbuild("auto_scheduler.local_builder.build");
+  if (const auto* f = fbuild.Get()) {
     Array<BuildResult> results = (*f)(inputs, timeout, n_parallel, build_func, verbose);
     return results;
   }
@@ -141,7 +142,8 @@ LocalRunner::LocalRunner(int timeout, int number, int repeat, int min_repeat_ms,
 
 Array<MeasureResult> LocalRunnerNode::Run(const Array<MeasureInput>& inputs,
                                           const Array<BuildResult>& build_results, int verbose) {
-  if (const auto* f = runtime::Registry::Get("auto_scheduler.local_runner.run")) {
+  static const runtime::Registry::Handle frun("auto_scheduler.local_runner.run");
+  if (const auto* f = frun.Get()) {
     Array<MeasureResult> results =
         (*f)(inputs, build_results, timeout, number, repeat, min_repeat_ms, cooldown_interval,
              enable_cpu_cache_flush, verbose, device);
@@ -175,7 +177,8 @@ RPCRunner::RPCRunner(const String& key, const String& host, int port, int priori
 
 Array<MeasureResult> RPCRunnerNode::Run(const Array<MeasureInput>& inputs,
                                         const Array<BuildResult>& build_results, int verbose) {
-  if (const auto* f = runtime::Registry::Get("auto_scheduler.rpc_runner.run")) {
+  static const runtime::Registry::Handle frun("auto_scheduler.rpc_runner.run");
+  if (const auto* f = frun.Get()) {
     Array<MeasureResult> results =
         (*f)(inputs, build_results, key, host, port, priority, n_parallel, timeout, number, repeat,
              min_repeat_ms, cooldown_interval, enable_cpu_cache_flush, verbose, device);
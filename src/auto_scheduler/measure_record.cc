@@ -27,13 +27,20 @@
 #include <tvm/auto_scheduler/measure_record.h>
 #include <tvm/auto_scheduler/transform_step.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "../support/mapped_file.h"
 #include "utils.h"
 
 // Json serialization handler for MeasureInput, MeasureResult
@@ -403,6 +410,209 @@ std::pair<Array<MeasureInput>, Array<MeasureResult>> RecordReaderNode::ReadLines
   return std::make_pair(inputs, results);
 }
 
+/*! \brief Whether a line of the log file is a comment or blank line that should be skipped. */
+inline bool IsSkippedRecordLine(const char* begin, const char* end) {
+  // skip comment lines begin with '#' or ' ', and empty lines
+  return begin == end || *begin == '#' || *begin == ' ' || *begin == '\r';
+}
+
+/*!
+ * \brief Extract the workload key of a record without deserializing the rest of it.
+ * \param line The record string.
+ * \param workload_key The extracted workload key, used as output.
+ * \return Whether the record starts with the measure input, i.e. `{"i": [["<key>", ...`.
+ * The caller falls back to full deserialization when this layout is not found.
+ */
+bool PeekRecordWorkloadKey(const std::string& line, std::string* workload_key) {
+  std::istringstream ss(line);
+  dmlc::JSONReader reader(&ss);
+  std::string key;
+  reader.BeginObject();
+  if (!reader.NextObjectItem(&key) || key != "i") {
+    return false;
+  }
+  reader.BeginArray();
+  if (!reader.NextArrayItem()) {
+    return false;
+  }
+  reader.BeginArray();
+  if (!reader.NextArrayItem()) {
+    return false;
+  }
+  reader.ReadString(workload_key);
+  return true;
+}
+
+/*!
+ * \brief Split a log file into chunks at line boundaries, so that they can be parsed in parallel.
+ * \param file The content of the log file.
+ * \param num_threads The number of threads that will parse the chunks.
+ * \return The [begin, end) ranges of the chunks, in file order.
+ */
+std::vector<std::pair<const char*, const char*>> SplitRecordChunks(
+    const support::MappedFile& file, int num_threads) {
+  const char* data = file.data();
+  size_t size = file.size();
+  if (size == 0) {
+    return {};
+  }
+  // Over-decompose so that threads stay busy even if record sizes are skewed,
+  // but do not bother splitting small files.
+  constexpr size_t kMinChunkBytes = 1 << 20;
+  size_t num_chunks = std::min<size_t>(static_cast<size_t>(num_threads) * 4,
+                                       (size + kMinChunkBytes - 1) / kMinChunkBytes);
+  num_chunks = std::max<size_t>(num_chunks, 1);
+  std::vector<std::pair<const char*, const char*>> chunks;
+  const char* begin = data;
+  for (size_t i = 1; i <= num_chunks && begin < data + size; ++i) {
+    const char* end = data + size;
+    if (i < num_chunks) {
+      // Move the boundary to the beginning of the next line.
+      const char* pos = std::max(data + size * i / num_chunks, begin);
+      const char* eol = static_cast<const char*>(memchr(pos, '\n', data + size - pos));
+      end = eol == nullptr ? data + size : eol + 1;
+    }
+    chunks.emplace_back(begin, end);
+    begin = end;
+  }
+  return chunks;
+}
+
+/*!
+ * \brief Visit the non-comment lines of a chunk in order.
+ * \param chunk The [begin, end) range of the chunk.
+ * \param f The visitor.
+ */
+void ForEachRecordLine(const std::pair<const char*, const char*>& chunk,
+                       const std::function<void(const std::string& line)>& f) {
+  const char* cur = chunk.first;
+  const char* end = chunk.second;
+  while (cur < end) {
+    const char* eol = static_cast<const char*>(memchr(cur, '\n', end - cur));
+    const char* line_end = eol == nullptr ? end : eol;
+    if (!IsSkippedRecordLine(cur, line_end)) {
+      f(std::string(cur, line_end));
+    }
+    cur = line_end + 1;
+  }
+}
+
+/*! \brief Get the number of threads used to load records, -1 means all hardware threads. */
+inline int GetRecordLoadingThreads(int num_threads) {
+  if (num_threads > 0) {
+    return num_threads;
+  }
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+std::pair<Array<MeasureInput>, Array<MeasureResult>> LoadRecordsParallel(
+    const String& filename, const Optional<String>& workload_key, int num_threads) {
+  num_threads = GetRecordLoadingThreads(num_threads);
+  support::MappedFile file(filename, /*allow_missing=*/true);
+  std::vector<std::pair<const char*, const char*>> chunks = SplitRecordChunks(file, num_threads);
+  int num_chunks = chunks.size();
+  // A small file has fewer chunks than threads, do not start idle workers for it.
+  num_threads = std::max(1, std::min(num_threads, num_chunks));
+  std::vector<std::vector<MeasureInput>> chunk_inputs(num_chunks);
+  std::vector<std::vector<MeasureResult>> chunk_results(num_chunks);
+  support::parallel_for_dynamic(0, num_chunks, num_threads, [&](int thread_id, int chunk_id) {
+    ForEachRecordLine(chunks[chunk_id], [&](const std::string& line) {
+      if (workload_key.defined()) {
+        std::string key;
+        if (PeekRecordWorkloadKey(line, &key) && key != workload_key.value()) {
+          return;
+        }
+      }
+      auto inp = make_object<MeasureInputNode>();
+      auto res = make_object<MeasureResultNode>();
+      std::string log_version;
+      ReadMeasureRecord(line, inp.get(), res.get(), &log_version);
+      if (workload_key.defined() && inp->task->workload_key != workload_key.value()) {
+        return;
+      }
+      chunk_inputs[chunk_id].push_back(MeasureInput(inp));
+      chunk_results[chunk_id].push_back(MeasureResult(res));
+    });
+  });
+  Array<MeasureInput> inputs;
+  Array<MeasureResult> results;
+  for (int i = 0; i < num_chunks; ++i) {
+    inputs.insert(inputs.end(), chunk_inputs[i].begin(), chunk_inputs[i].end());
+    results.insert(results.end(), chunk_results[i].begin(), chunk_results[i].end());
+  }
+  return std::make_pair(inputs, results);
+}
+
+Map<String, Array<Array<ObjectRef>>> LoadBestRecordsByWorkload(const String& filename,
+                                                               int num_threads) {
+  /*! \brief The best record of a (workload key, target) pair found so far. */
+  struct BestRecord {
+    MeasureInput inp;
+    MeasureResult res;
+    double cost;
+  };
+  using RecordKey = std::pair<std::string, std::string>;
+  /*! \brief The best records of a chunk, kept in the order of first appearance. */
+  struct ChunkIndex {
+    std::unordered_map<RecordKey, size_t> key2idx;
+    std::vector<std::pair<RecordKey, BestRecord>> records;
+
+    void Update(RecordKey key, BestRecord record) {
+      auto it = key2idx.find(key);
+      if (it == key2idx.end()) {
+        key2idx.emplace(key, records.size());
+        records.emplace_back(std::move(key), std::move(record));
+      } else if (record.cost < records[it->second].second.cost) {
+        records[it->second].second = std::move(record);
+      }
+    }
+  };
+
+  num_threads = GetRecordLoadingThreads(num_threads);
+  support::MappedFile file(filename, /*allow_missing=*/true);
+  std::vector<std::pair<const char*, const char*>> chunks = SplitRecordChunks(file, num_threads);
+  int num_chunks = chunks.size();
+  // A small file has fewer chunks than threads, do not start idle workers for it.
+  num_threads = std::max(1, std::min(num_threads, num_chunks));
+  std::vector<ChunkIndex> chunk_indices(num_chunks);
+  support::parallel_for_dynamic(0, num_chunks, num_threads, [&](int thread_id, int chunk_id) {
+    ForEachRecordLine(chunks[chunk_id], [&](const std::string& line) {
+      auto inp = make_object<MeasureInputNode>();
+      auto res = make_object<MeasureResultNode>();
+      std::string log_version;
+      ReadMeasureRecord(line, inp.get(), res.get(), &log_version);
+      if (res->error_no != static_cast<int>(MeasureErrorNO::kNoError)) {
+        return;
+      }
+      double cost = FloatArrayMean(res->costs);
+      RecordKey key{inp->task->workload_key, inp->task->target->str()};
+      chunk_indices[chunk_id].Update(std::move(key),
+                                     BestRecord{MeasureInput(inp), MeasureResult(res), cost});
+    });
+  });
+  // Merge the chunks in file order, so that ties are resolved as a sequential scan would do.
+  ChunkIndex merged;
+  for (int i = 0; i < num_chunks; ++i) {
+    for (auto& kv : chunk_indices[i].records) {
+      merged.Update(std::move(kv.first), std::move(kv.second));
+    }
+  }
+  std::unordered_map<std::string, Array<Array<ObjectRef>>> best;
+  std::vector<std::string> workload_keys;
+  for (const auto& kv : merged.records) {
+    const std::string& workload_key = kv.first.first;
+    if (!best.count(workload_key)) {
+      workload_keys.push_back(workload_key);
+    }
+    best[workload_key].push_back(Array<ObjectRef>{kv.second.inp, kv.second.res});
+  }
+  Map<String, Array<Array<ObjectRef>>> ret;
+  for (const std::string& workload_key : workload_keys) {
+    ret.Set(workload_key, best.at(workload_key));
+  }
+  return ret;
+}
+
 TVM_REGISTER_GLOBAL("auto_scheduler.RecordToFile").set_body_typed([](const String& filename) {
   return RecordToFile(filename);
 });
@@ -427,6 +637,15 @@ TVM_REGISTER_GLOBAL("auto_scheduler.RecordReaderReadNext").set_body_typed([](Rec
   }
 });
 
+TVM_REGISTER_GLOBAL("auto_scheduler.LoadRecordsParallel")
+    .set_body_typed([](String filename, Optional<String> workload_key, int num_threads) {
+      const auto& res = LoadRecordsParallel(filename, workload_key, num_threads);
+      return Array<ObjectRef>{res.first, res.second};
+    });
+
+TVM_REGISTER_GLOBAL("auto_scheduler.LoadBestRecordsByWorkload")
+    .set_body_typed(LoadBestRecordsByWorkload);
+
 TVM_REGISTER_GLOBAL("auto_scheduler.ReadMeasureRecord").set_body_typed([](const std::string& str) {
   auto inp = make_object<MeasureInputNode>();
   auto res = make_object<MeasureResultNode>();
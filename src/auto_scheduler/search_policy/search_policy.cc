@@ -36,8 +36,8 @@ TVM_REGISTER_OBJECT_TYPE(SearchPolicyNode);
 TVM_REGISTER_OBJECT_TYPE(PreloadMeasuredStatesNode);
 
 void SearchPolicyNode::PreloadMeasuredStates(const String& log_file) {
-  RecordReader reader = RecordReader(log_file);
-  const auto& res = reader->ReadLines(-1);
+  // Records of other workloads are skipped before being fully deserialized.
+  const auto& res = LoadRecordsParallel(log_file, search_task->workload_key);
   size_t log_size = res.first.size();
   ICHECK_EQ(log_size, res.second.size());
   if (log_size) {
@@ -542,6 +542,7 @@ transform::Sequential MixedModulePassManager(IRModule mixed_mod, Target target)
   mixed_pass_list.push_back(tir::transform::BindTarget(target));
 
   mixed_pass_list.push_back(tir::transform::VerifyMemory());
+  mixed_pass_list.push_back(tir::transform::InjectSoftwarePrefetch());
 
   if (ShouldAnnotateEntryFunc(mixed_mod)) {
     mixed_pass_list.push_back(tir::transform::AnnotateEntryFunc());
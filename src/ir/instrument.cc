@@ -27,7 +27,17 @@
 #include <tvm/node/repr_printer.h>
 #include <tvm/runtime/registry.h>
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <stack>
+#include <unordered_set>
 
 namespace tvm {
 namespace instrument {
@@ -216,6 +226,8 @@ struct PassProfile {
   Duration duration;
   /*! \brief PassProfiles for all sub-passes invoked during the execution of the pass. */
   std::vector<PassProfile> children;
+  /*! \brief Whether this is a function transformed concurrently with its siblings. */
+  bool concurrent{false};
 
   explicit PassProfile(String name)
       : name(name), start(Clock::now()), end(Clock::now()), children() {}
@@ -263,6 +275,21 @@ PassProfile* PassProfile::Current() {
   }
 }
 
+void RecordConcurrentFunctionTime(const String& name, PassProfile::Time start,
+                                  PassProfile::Time end) {
+  PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
+  if (entry->profile_stack.empty()) {
+    return;
+  }
+  PassProfile* cur = entry->profile_stack.top();
+  cur->children.emplace_back(name);
+  PassProfile& profile = cur->children.back();
+  profile.start = start;
+  profile.end = end;
+  profile.duration = std::chrono::duration_cast<PassProfile::Duration>(end - start);
+  profile.concurrent = true;
+}
+
 String RenderPassProfiles() {
   PassProfileThreadLocalEntry* entry = PassProfileThreadLocalStore::Get();
   CHECK(entry->profile_stack.empty()) << "cannot print pass profile while still in a pass!";
@@ -296,17 +323,20 @@ String RenderPassProfiles() {
       os << "\t";
     }
 
-    // calculate time spent in pass itself (excluding sub-passes), and push children
+    // calculate time spent in pass itself (excluding sub-passes), and push children. Functions
+    // transformed concurrently overlap, so they are not subtracted.
     PassProfile::Duration self_duration = profile->duration;
     for (auto it = profile->children.rbegin(); it != profile->children.rend(); ++it) {
-      self_duration -= it->duration;
+      if (!it->concurrent) {
+        self_duration -= it->duration;
+      }
       profiles.push(std::make_tuple(depth + 1, profile->duration, &*it));
     }
 
     double parent_pct = profile->duration.count() / parent_duration.count() * 100.0;
     double total_pct = profile->duration.count() / top_dur.count() * 100.0;
 
-    os << profile->name << ": ";
+    os << profile->name << (profile->concurrent ? " (concurrent)" : "") << ": ";
     os << std::setprecision(0);
     os << profile->duration.count() << "us [" << self_duration.count() << "us] ";
     os << std::setprecision(2) << "(" << total_pct << "%; " << parent_pct << "%)\n";
@@ -334,5 +364,269 @@ TVM_REGISTER_GLOBAL("instrument.MakePassTimingInstrument").set_body_typed([]() {
                             run_before_pass, run_after_pass);
 });
 
+/*!
+ * \brief PassResourceProfile stores the time and memory usage of a given pass and its
+ *  sub-passes, as recorded by the PassProfilingInstrument.
+ */
+struct PassResourceProfile {
+  /*! \brief The name of the pass being profiled. */
+  String name;
+  /*! \brief The time when the pass was entered. */
+  PassProfile::Time start;
+  /*! \brief The total duration of the pass. */
+  PassProfile::Duration duration{0};
+  /*! \brief The resident set size of the process before and after the pass, in bytes. */
+  int64_t rss_before{0};
+  int64_t rss_after{0};
+  /*! \brief The peak resident set size of the process before and after the pass, in bytes. */
+  int64_t peak_rss_before{0};
+  int64_t peak_rss_after{0};
+  /*! \brief The number of objects reachable from the module before and after the pass, -1 if
+   * object counting is disabled. */
+  int64_t objects_before{-1};
+  int64_t objects_after{-1};
+  /*! \brief The number of functions in the module after the pass. */
+  int64_t num_funcs{0};
+  /*! \brief The number of functions added or rewritten by the pass. */
+  int64_t num_funcs_touched{0};
+  /*! \brief The functions of the module before the pass, released once the pass is done. */
+  Map<GlobalVar, BaseFunc> funcs_before;
+  /*! \brief PassResourceProfiles for all sub-passes invoked during the execution of the pass. */
+  std::vector<PassResourceProfile> children;
+
+  explicit PassResourceProfile(String name) : name(name), start(PassProfile::Clock::now()) {}
+};
+
+struct PassResourceProfileThreadLocalEntry {
+  /*! \brief The placeholder top-level PassResourceProfile. */
+  PassResourceProfile root;
+  /*! \brief The stack of PassResourceProfiles for nested passes currently running. */
+  std::stack<PassResourceProfile*> profile_stack;
+
+  PassResourceProfileThreadLocalEntry() : root("root") {}
+};
+
+/*! \brief Thread local store to hold the pass resource profiling data. */
+typedef dmlc::ThreadLocalStore<PassResourceProfileThreadLocalEntry>
+    PassResourceProfileThreadLocalStore;
+
+/*! \return The resident set size of the current process in bytes, 0 if unavailable. */
+int64_t CurrentRSSBytes() {
+#if defined(__linux__)
+  std::ifstream is("/proc/self/statm");
+  int64_t total_pages = 0, resident_pages = 0;
+  if (is >> total_pages >> resident_pages) {
+    return resident_pages * static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+/*! \return The peak resident set size of the current process in bytes, 0 if unavailable. */
+int64_t PeakRSSBytes() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    return static_cast<int64_t>(usage.ru_maxrss);
+#else
+    return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+  }
+#endif
+  return 0;
+}
+
+/*!
+ * \brief Count the distinct objects reachable from a root object through reflection,
+ *  which approximates the number of IR nodes a module keeps alive.
+ */
+class ReachableObjectCounter : public AttrVisitor {
+ public:
+  int64_t Count(const ObjectRef& root) {
+    Push(root.get());
+    while (!stack_.empty()) {
+      const Object* node = stack_.back();
+      stack_.pop_back();
+      if (const auto* arr = node->as<ArrayNode>()) {
+        for (const ObjectRef& elem : *arr) {
+          Push(elem.get());
+        }
+      } else if (const auto* map = node->as<MapNode>()) {
+        for (const auto& kv : *map) {
+          Push(kv.first.get());
+          Push(kv.second.get());
+        }
+      } else {
+        ReflectionVTable::Global()->VisitAttrs(const_cast<Object*>(node), this);
+      }
+    }
+    return static_cast<int64_t>(visited_.size());
+  }
+
+  void Visit(const char* key, double* value) final {}
+  void Visit(const char* key, int64_t* value) final {}
+  void Visit(const char* key, uint64_t* value) final {}
+  void Visit(const char* key, int* value) final {}
+  void Visit(const char* key, bool* value) final {}
+  void Visit(const char* key, std::string* value) final {}
+  void Visit(const char* key, void** value) final {}
+  void Visit(const char* key, DataType* value) final {}
+  void Visit(const char* key, runtime::NDArray* value) final { Push(value->get()); }
+  void Visit(const char* key, ObjectRef* value) final { Push(value->get()); }
+
+ private:
+  void Push(const Object* node) {
+    if (node != nullptr && visited_.insert(node).second) {
+      stack_.push_back(node);
+    }
+  }
+
+  std::vector<const Object*> stack_;
+  std::unordered_set<const Object*> visited_;
+};
+
+void EnterPassResourceProfile(const IRModule& mod, const transform::PassInfo& pass_info,
+                              bool count_objects) {
+  PassResourceProfileThreadLocalEntry* entry = PassResourceProfileThreadLocalStore::Get();
+  PassResourceProfile* cur =
+      entry->profile_stack.empty() ? &entry->root : entry->profile_stack.top();
+  cur->children.emplace_back(pass_info->name);
+  PassResourceProfile* profile = &cur->children.back();
+  entry->profile_stack.push(profile);
+
+  profile->funcs_before = mod->functions;
+  if (count_objects) {
+    profile->objects_before = ReachableObjectCounter().Count(mod);
+  }
+  profile->rss_before = CurrentRSSBytes();
+  profile->peak_rss_before = PeakRSSBytes();
+  // Start the clock last so that the bookkeeping above is not attributed to the pass.
+  profile->start = PassProfile::Clock::now();
+}
+
+void ExitPassResourceProfile(const IRModule& mod, bool count_objects) {
+  PassResourceProfileThreadLocalEntry* entry = PassResourceProfileThreadLocalStore::Get();
+  ICHECK(!entry->profile_stack.empty()) << "mismatched enter/exit for pass profiling";
+  PassResourceProfile* profile = entry->profile_stack.top();
+  profile->duration = std::chrono::duration_cast<PassProfile::Duration>(
+      PassProfile::Clock::now() - profile->start);
+  profile->rss_after = CurrentRSSBytes();
+  profile->peak_rss_after = PeakRSSBytes();
+
+  profile->num_funcs = static_cast<int64_t>(mod->functions.size());
+  for (const auto& kv : mod->functions) {
+    Optional<BaseFunc> before = profile->funcs_before.Get(kv.first);
+    if (!before.defined() || !before.value().same_as(kv.second)) {
+      ++profile->num_funcs_touched;
+    }
+  }
+  profile->funcs_before = Map<GlobalVar, BaseFunc>();
+  if (count_objects) {
+    profile->objects_after = ReachableObjectCounter().Count(mod);
+  }
+  entry->profile_stack.pop();
+}
+
+/*! \brief Visit the recorded profiles in depth-first pre-order, along with their ancestors. */
+void VisitPassResourceProfiles(
+    const std::function<void(const std::vector<const PassResourceProfile*>&)>& fvisit) {
+  PassResourceProfileThreadLocalEntry* entry = PassResourceProfileThreadLocalStore::Get();
+  CHECK(entry->profile_stack.empty()) << "cannot render pass profile while still in a pass!";
+  std::vector<const PassResourceProfile*> path;
+  std::function<void(const PassResourceProfile&)> visit = [&](const PassResourceProfile& p) {
+    path.push_back(&p);
+    fvisit(path);
+    for (const PassResourceProfile& child : p.children) {
+      visit(child);
+    }
+    path.pop_back();
+  };
+  for (const PassResourceProfile& profile : entry->root.children) {
+    visit(profile);
+  }
+}
+
+/*! \return The time spent in the pass itself, excluding sub-passes. */
+PassProfile::Duration SelfDuration(const PassResourceProfile& profile) {
+  PassProfile::Duration self_duration = profile.duration;
+  for (const PassResourceProfile& child : profile.children) {
+    self_duration -= child.duration;
+  }
+  return self_duration;
+}
+
+String RenderPassResourceProfiles() {
+  if (PassResourceProfileThreadLocalStore::Get()->root.children.empty()) {
+    LOG(WARNING) << "no passes have been profiled, did you enable pass profiling?";
+  }
+  auto mb = [](int64_t bytes) { return static_cast<double>(bytes) / (1 << 20); };
+  std::ostringstream os;
+  os << std::fixed;
+  VisitPassResourceProfiles([&](const std::vector<const PassResourceProfile*>& path) {
+    const PassResourceProfile& p = *path.back();
+    for (size_t i = 1; i < path.size(); ++i) {
+      os << "\t";
+    }
+    os << p.name << ": " << std::setprecision(0) << p.duration.count() << "us ["
+       << SelfDuration(p).count() << "us] " << std::setprecision(2) << "rss: " << mb(p.rss_after)
+       << "MB (" << std::showpos << mb(p.rss_after - p.rss_before) << std::noshowpos
+       << "MB) peak: " << mb(p.peak_rss_after) << "MB (" << std::showpos
+       << mb(p.peak_rss_after - p.peak_rss_before) << std::noshowpos
+       << "MB) funcs: " << p.num_funcs_touched << "/" << p.num_funcs;
+    if (p.objects_after >= 0) {
+      os << " objects: " << p.objects_after << " (" << std::showpos
+         << p.objects_after - p.objects_before << std::noshowpos << ")";
+    }
+    os << "\n";
+  });
+  return os.str();
+}
+
+void ExportPassResourceFlameGraph(String path) {
+  std::ofstream os(path);
+  CHECK(os.good()) << "ValueError: Cannot open file: " << path;
+  // The collapsed stack format of flamegraph.pl: frames separated by ';', then the sample count.
+  VisitPassResourceProfiles([&](const std::vector<const PassResourceProfile*>& stack) {
+    for (size_t i = 0; i < stack.size(); ++i) {
+      std::string frame = stack[i]->name;
+      std::replace(frame.begin(), frame.end(), ';', ':');
+      os << (i == 0 ? "" : ";") << frame;
+    }
+    os << " " << static_cast<int64_t>(std::max(SelfDuration(*stack.back()).count(), 0.0)) << "\n";
+  });
+}
+
+TVM_REGISTER_GLOBAL("instrument.RenderPassResourceProfiles")
+    .set_body_typed(RenderPassResourceProfiles);
+
+TVM_REGISTER_GLOBAL("instrument.ExportPassResourceFlameGraph")
+    .set_body_typed(ExportPassResourceFlameGraph);
+
+TVM_REGISTER_GLOBAL("instrument.MakePassProfilingInstrument")
+    .set_body_typed([](bool count_objects) {
+      auto enter_pass_ctx = []() {
+        // Keep the results of the previous context around until a new one is profiled, so they
+        // can be rendered after exiting. Nested contexts inside a profiled pass keep accumulating.
+        PassResourceProfileThreadLocalEntry* entry = PassResourceProfileThreadLocalStore::Get();
+        if (entry->profile_stack.empty()) {
+          entry->root.children.clear();
+        }
+      };
+
+      auto run_before_pass = [count_objects](const IRModule& mod,
+                                             const transform::PassInfo& pass_info) {
+        EnterPassResourceProfile(mod, pass_info, count_objects);
+      };
+
+      auto run_after_pass = [count_objects](const IRModule& mod, const transform::PassInfo&) {
+        ExitPassResourceProfile(mod, count_objects);
+      };
+
+      return BasePassInstrument("PassProfilingInstrument", enter_pass_ctx,
+                                /* exit_pass_ctx */ nullptr, /* should_run */ nullptr,
+                                run_before_pass, run_after_pass);
+    });
+
 }  // namespace instrument
 }  // namespace tvm
@@ -27,10 +27,14 @@
 #include <tvm/node/structural_hash.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/support/parallel_for.h>
 
+#include <algorithm>
 #include <chrono>
+#include <exception>
 #include <iomanip>
 #include <stack>
+#include <thread>
 #include <unordered_set>
 
 #include "../runtime/object_internal.h"
@@ -43,6 +47,7 @@ using tvm::runtime::TVMArgs;
 using tvm::runtime::TVMRetValue;
 
 TVM_REGISTER_PASS_CONFIG_OPTION("testing.immutable_module", Bool);
+TVM_REGISTER_PASS_CONFIG_OPTION("ir.function_pass_num_threads", Integer);
 
 struct PassContextThreadLocalEntry {
   /*! \brief The default pass context. */
@@ -82,6 +87,68 @@ PassContext PassContext::Current() {
   }
 }
 
+int GetFunctionPassNumThreads(const PassContext& pass_ctx, const PassInfo& pass_info,
+                              int num_funcs) {
+  if (!pass_info->thread_safe) {
+    return 1;
+  }
+  int num_threads = pass_ctx->GetConfig<Integer>("ir.function_pass_num_threads", Integer(1))
+                        .value()
+                        ->value;
+  if (num_threads < 0) {
+    num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  return std::max(1, std::min(num_threads, num_funcs));
+}
+
+void ForEachFunction(const PassContext& pass_ctx, const PassInfo& pass_info,
+                     const Array<GlobalVar>& funcs, const std::function<void(int)>& fvisit) {
+  int num_funcs = funcs.size();
+  int num_threads = GetFunctionPassNumThreads(pass_ctx, pass_info, num_funcs);
+  if (num_threads <= 1) {
+    for (int i = 0; i < num_funcs; ++i) {
+      fvisit(i);
+    }
+    return;
+  }
+
+  using Clock = std::chrono::steady_clock;
+  std::vector<std::exception_ptr> errors(num_funcs);
+  std::vector<std::pair<Clock::time_point, Clock::time_point>> func_times(num_funcs);
+  Clock::time_point start = Clock::now();
+  support::parallel_for_dynamic(0, num_funcs, num_threads, [&](int thread_id, int i) {
+    // Make the pass context current in the worker thread, without running the instruments
+    // that were already run when the context was entered on the calling thread.
+    PassContextThreadLocalEntry* entry = RelayPassContextThreadLocalStore::Get();
+    entry->context_stack.push(pass_ctx);
+    func_times[i].first = Clock::now();
+    try {
+      fvisit(i);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+    func_times[i].second = Clock::now();
+    entry->context_stack.pop();
+  });
+  double wall_secs = std::chrono::duration<double>(Clock::now() - start).count();
+
+  double total_secs = 0.0;
+  for (int i = 0; i < num_funcs; ++i) {
+    instrument::RecordConcurrentFunctionTime(funcs[i]->name_hint, func_times[i].first,
+                                             func_times[i].second);
+    total_secs += std::chrono::duration<double>(func_times[i].second - func_times[i].first).count();
+  }
+  VLOG(1) << "Function pass " << pass_info->name << " visited " << num_funcs
+          << " functions with " << num_threads << " threads: wall " << wall_secs * 1e3
+          << " ms, total " << total_secs * 1e3 << " ms";
+
+  for (const std::exception_ptr& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
 // linearly scan the pass array to match pass_name
 bool PassArrayContains(const Array<runtime::String>& pass_array, const std::string& pass_name) {
   for (auto x : pass_array) {
@@ -341,11 +408,13 @@ class ModulePass : public Pass {
   TVM_DEFINE_OBJECT_REF_METHODS(ModulePass, Pass, ModulePassNode);
 };
 
-PassInfo::PassInfo(int opt_level, String name, tvm::Array<runtime::String> required) {
+PassInfo::PassInfo(int opt_level, String name, tvm::Array<runtime::String> required,
+                   bool thread_safe) {
   auto pass_info = make_object<PassInfoNode>();
   pass_info->opt_level = opt_level;
   pass_info->name = std::move(name);
   pass_info->required = std::move(required);
+  pass_info->thread_safe = thread_safe;
   data_ = std::move(pass_info);
 }
 
@@ -464,8 +533,9 @@ Pass CreateModulePass(const runtime::TypedPackedFunc<IRModule(IRModule, PassCont
 TVM_REGISTER_NODE_TYPE(PassInfoNode);
 
 TVM_REGISTER_GLOBAL("transform.PassInfo")
-    .set_body_typed([](int opt_level, String name, tvm::Array<String> required) {
-      return PassInfo(opt_level, name, required);
+    .set_body_typed([](int opt_level, String name, tvm::Array<String> required,
+                       bool thread_safe) {
+      return PassInfo(opt_level, name, required, thread_safe);
     });
 
 TVM_REGISTER_GLOBAL("transform.Info").set_body([](TVMArgs args, TVMRetValue* ret) {
@@ -104,6 +104,8 @@
 #include <tvm/runtime/registry.h>
 #include <tvm/te/schedule.h>
 #include <tvm/te/schedule_pass.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 #include <tvm/topi/tags.h>
 
@@ -403,50 +405,7 @@ class TECompilerImpl : public TECompilerNode {
         value->cached_func->funcs->Add(value->cached_func->prim_fn_var, kv.second);
       }
     } else {
-      // NOTE: array will copy on write.
-      Array<te::Tensor> all_args = Array<te::Tensor>(value->cached_func->inputs);
-      for (te::Tensor arg : value->cached_func->outputs) {
-        all_args.push_back(arg);
-      }
-      Array<runtime::NDArray> all_consts;
-      for (auto kv : value->cached_func->constant_tensors) {
-        all_args.push_back(kv.second);
-        all_consts.push_back(kv.first->data);
-      }
-      // lower the function
-      std::unordered_map<te::Tensor, tir::Buffer> binds;
-
-      // If we have memory scopes, need to create tir::Buffer knowing this info
-      size_t i = 0;  // for corresponding from tensor array
-      for (Var param : key->source_func->params) {
-        if (!param->virtual_device()->memory_scope.empty()) {
-          for (const auto& ttype : FlattenTupleType(param->checked_type())) {
-            te::Tensor x_ref = value->cached_func->inputs[i];
-            // verification if we have synced params and tensors
-            ICHECK(ttype->dtype == x_ref->dtype && ttype->shape.size() == x_ref->shape.size())
-                << "function parameter does not correspond to prepared tensor";
-            binds[x_ref] =
-                tir::BufferWithOffsetAlignment(x_ref->shape, x_ref->dtype, x_ref->op->name, -1, 0,
-                                               false, param->virtual_device()->memory_scope);
-          }
-        }
-        i++;
-      }
-      if (key->virtual_device != VirtualDevice::FullyUnconstrained() &&
-          !key->virtual_device->memory_scope.empty() &&
-          key->virtual_device->memory_scope != "global") {
-        ICHECK(value->cached_func->outputs.size() == 1)
-            << "Expect only one output for defined memory scope";
-        te::Tensor x_ref = value->cached_func->outputs[0];
-        binds[x_ref] =
-            tir::BufferWithOffsetAlignment(x_ref->shape, x_ref->dtype, x_ref->op->name, -1, 0,
-                                           false, key->virtual_device->memory_scope);
-      }
-      auto func_name = value->cached_func->prim_fn_var->name_hint;
-      VLOG(1) << "scheduling";
-      IRModule scheduled_module = tvm::LowerSchedule(value->cached_func->schedule, all_args,
-                                                     func_name, binds, global_var_supply);
-      scheduled_module->Update(tir::transform::BindParams(all_consts)(scheduled_module));
+      IRModule scheduled_module = ScheduleCachedFunc(key, value->cached_func, global_var_supply);
       for (const auto& kv : scheduled_module->functions) {
         GlobalVar global_var = kv.first;
         auto func = kv.second;
@@ -461,6 +420,7 @@ class TECompilerImpl : public TECompilerNode {
       ICHECK(value->cached_func->funcs->Lookup(value->cached_func->prim_fn_var)
                  .as<tir::PrimFuncNode>());
     }
+    SpecializeShapeBuckets(key, value);
     VLOG(1) << "lowered to name:" << std::endl
             << PrettyPrint(value->cached_func->prim_fn_var) << std::endl
             << "with definitions:" << std::endl
@@ -469,6 +429,211 @@ class TECompilerImpl : public TECompilerNode {
     return value;
   }
 
+  /*!
+   * \brief Specialize the lowered primitive of a function with dynamic shapes for the shape
+   * buckets of "relay.backend.dynamic_shape_buckets".
+   *
+   * Each bucket gives the values of the Any dimensions of the function parameters, in order, or
+   * a single value for all of them. The function is compiled again for the static shapes of each
+   * bucket, so that the tuning records of those shapes apply, and the variants are merged into
+   * the generic primitive behind a dispatch on its symbolic dimensions. Calls of the primitive,
+   * e.g. by the VM, are unchanged and fall back to the generic code for other shapes.
+   */
+  void SpecializeShapeBuckets(const CCacheKey& key, const CCacheValue& value) {
+    Array<Array<Integer>> buckets =
+        transform::PassContext::Current()
+            ->GetConfig<Array<Array<Integer>>>("relay.backend.dynamic_shape_buckets",
+                                               Array<Array<Integer>>())
+            .value();
+    const Function& source_func = key->source_func;
+    size_t num_any = 0;
+    for (const Var& param : source_func->params) {
+      for (const auto& ttype : FlattenTupleType(param->checked_type())) {
+        for (const PrimExpr& dim : ttype->shape) {
+          num_any += dim.as<AnyNode>() != nullptr;
+        }
+      }
+    }
+    if (buckets.empty() || num_any == 0) return;
+    const auto* generic_node =
+        value->cached_func->funcs->Lookup(value->cached_func->prim_fn_var).as<tir::PrimFuncNode>();
+    if (generic_node == nullptr) return;
+    tir::PrimFunc generic = GetRef<tir::PrimFunc>(generic_node);
+
+    tir::Stmt body = generic->body;
+    // The first bucket is tested first, so it is the outermost branch.
+    for (auto it = buckets.rbegin(); it != buckets.rend(); ++it) {
+      Array<Integer> bucket = *it;
+      if (bucket.size() != 1 && bucket.size() != num_any) {
+        LOG(WARNING) << "Shape bucket " << bucket << " does not match the " << num_any
+                     << " dynamic dimensions of " << value->cached_func->prim_fn_var->name_hint
+                     << ", skipping it.";
+        continue;
+      }
+      Optional<tir::PrimFunc> variant = LowerShapeBucket(key, bucket);
+      if (!variant.defined()) continue;
+      Optional<tir::Stmt> dispatch = MergeShapeBucket(generic, variant.value(), body);
+      if (!dispatch.defined()) {
+        LOG(WARNING) << "Cannot dispatch " << value->cached_func->prim_fn_var->name_hint
+                     << " to its variant for shape bucket " << bucket << ", skipping it.";
+        continue;
+      }
+      body = dispatch.value();
+    }
+    if (!body.same_as(generic->body)) {
+      generic.CopyOnWrite()->body = body;
+      value->cached_func->funcs->Update(value->cached_func->prim_fn_var, generic);
+    }
+  }
+
+  /*!
+   * \brief Lower the function of \p key with its Any dimensions set to the values of \p bucket.
+   * \return The lowered primitive, or NullOpt if the shapes of the function stay dynamic.
+   */
+  Optional<tir::PrimFunc> LowerShapeBucket(const CCacheKey& key, const Array<Integer>& bucket) {
+    const Function& source_func = key->source_func;
+    size_t next = 0;
+    std::function<Type(const Type&)> specialize = [&](const Type& type) -> Type {
+      if (const auto* tuple_type = type.as<TupleTypeNode>()) {
+        Array<Type> fields;
+        for (const Type& field : tuple_type->fields) {
+          fields.push_back(specialize(field));
+        }
+        return TupleType(fields);
+      }
+      const auto* tensor_type = type.as<TensorTypeNode>();
+      ICHECK(tensor_type) << "Unexpected parameter type " << PrettyPrint(type);
+      Array<PrimExpr> shape;
+      for (const PrimExpr& dim : tensor_type->shape) {
+        if (dim.as<AnyNode>()) {
+          const Integer& dim_value = bucket[bucket.size() == 1 ? 0 : next++];
+          shape.push_back(IntImm(dim.dtype(), dim_value->value));
+        } else {
+          shape.push_back(dim);
+        }
+      }
+      return TensorType(shape, tensor_type->dtype);
+    };
+    Array<Var> params;
+    Map<Var, Expr> bind_map;
+    for (const Var& param : source_func->params) {
+      Var specialized = WithFields(Var(param->vid, specialize(param->checked_type()), param->span),
+                                   /*opt_vid=*/{}, /*opt_type_annotation=*/{},
+                                   param->virtual_device());
+      params.push_back(specialized);
+      bind_map.Set(param, specialized);
+    }
+    Function func(params, Bind(source_func->body, bind_map), Type(), {}, source_func->attrs,
+                  source_func->span);
+    IRModule mod = transform::InferType()(IRModule::FromExpr(func));
+    func = Downcast<Function>(mod->Lookup("main"));
+    if (IsDynamic(func->ret_type)) return NullOpt;
+
+    // The variant is only an implementation of the generic primitive, keep its names private.
+    GlobalVarSupply variant_supply(NameSupply(""));
+    CachedFunc cached_func = PrimFuncFor(func, key->target, variant_supply, constant_name_supply_);
+    IRModule lowered;
+    if (cached_func->prim_func.defined()) {
+      lowered = tvm::LowerPrimFunc(cached_func->prim_func.value(),
+                                   cached_func->prim_fn_var->name_hint, false);
+    } else {
+      lowered = ScheduleCachedFunc(CCacheKey(func, key->target, key->virtual_device), cached_func,
+                                   variant_supply);
+    }
+    ICHECK_EQ(lowered->functions.size(), 1);
+    return Downcast<tir::PrimFunc>(lowered->Lookup(cached_func->prim_fn_var->name_hint));
+  }
+
+  /*!
+   * \brief Dispatch to the body of \p variant when the symbolic dimensions of \p generic match
+   * the static shapes of the variant, and to \p fallback otherwise.
+   * \return The dispatch, or NullOpt if the parameters of the primitives do not correspond.
+   */
+  Optional<tir::Stmt> MergeShapeBucket(const tir::PrimFunc& generic, const tir::PrimFunc& variant,
+                                       const tir::Stmt& fallback) {
+    if (generic->params.size() != variant->params.size()) return NullOpt;
+    Map<tir::Var, PrimExpr> vmap;
+    PrimExpr cond = tir::const_true();
+    for (size_t i = 0; i < generic->params.size(); ++i) {
+      const tir::Var& generic_param = generic->params[i];
+      const tir::Var& variant_param = variant->params[i];
+      if (generic_param.dtype() != variant_param.dtype()) return NullOpt;
+      vmap.Set(variant_param, generic_param);
+      Optional<tir::Buffer> generic_buffer = generic->buffer_map.Get(generic_param);
+      Optional<tir::Buffer> variant_buffer = variant->buffer_map.Get(variant_param);
+      if (generic_buffer.defined() != variant_buffer.defined()) return NullOpt;
+      if (!generic_buffer.defined()) continue;
+      const tir::Buffer& gb = generic_buffer.value();
+      const tir::Buffer& vb = variant_buffer.value();
+      if (gb->dtype != vb->dtype || gb->shape.size() != vb->shape.size()) return NullOpt;
+      vmap.Set(vb->data, gb->data);
+      for (size_t d = 0; d < gb->shape.size(); ++d) {
+        const auto* extent = vb->shape[d].as<IntImmNode>();
+        if (extent == nullptr) return NullOpt;
+        if (!gb->shape[d]->IsInstance<IntImmNode>()) {
+          cond = cond && (gb->shape[d] == tir::make_const(gb->shape[d].dtype(), extent->value));
+        }
+      }
+    }
+    return tir::IfThenElse(cond, tir::Substitute(variant->body, vmap), fallback);
+  }
+
+  /*!
+   * \brief Schedule the TE of a cached function to TIR, binding its constants.
+   * \param key The cache key of the source function, which gives the memory scopes.
+   * \param cached_func The cached function with the TE schedule.
+   * \param global_var_supply The supply of the global vars of the lowered functions.
+   * \return The scheduled module.
+   */
+  IRModule ScheduleCachedFunc(const CCacheKey& key, const CachedFunc& cached_func,
+                              GlobalVarSupply global_var_supply) {
+    // NOTE: array will copy on write.
+    Array<te::Tensor> all_args = Array<te::Tensor>(cached_func->inputs);
+    for (te::Tensor arg : cached_func->outputs) {
+      all_args.push_back(arg);
+    }
+    Array<runtime::NDArray> all_consts;
+    for (auto kv : cached_func->constant_tensors) {
+      all_args.push_back(kv.second);
+      all_consts.push_back(kv.first->data);
+    }
+    // lower the function
+    std::unordered_map<te::Tensor, tir::Buffer> binds;
+
+    // If we have memory scopes, need to create tir::Buffer knowing this info
+    size_t i = 0;  // for corresponding from tensor array
+    for (Var param : key->source_func->params) {
+      if (!param->virtual_device()->memory_scope.empty()) {
+        for (const auto& ttype : FlattenTupleType(param->checked_type())) {
+          te::Tensor x_ref = cached_func->inputs[i];
+          // verification if we have synced params and tensors
+          ICHECK(ttype->dtype == x_ref->dtype && ttype->shape.size() == x_ref->shape.size())
+              << "function parameter does not correspond to prepared tensor";
+          binds[x_ref] =
+              tir::BufferWithOffsetAlignment(x_ref->shape, x_ref->dtype, x_ref->op->name, -1, 0,
+                                             false, param->virtual_device()->memory_scope);
+        }
+      }
+      i++;
+    }
+    if (key->virtual_device != VirtualDevice::FullyUnconstrained() &&
+        !key->virtual_device->memory_scope.empty() &&
+        key->virtual_device->memory_scope != "global") {
+      ICHECK(cached_func->outputs.size() == 1)
+          << "Expect only one output for defined memory scope";
+      te::Tensor x_ref = cached_func->outputs[0];
+      binds[x_ref] =
+          tir::BufferWithOffsetAlignment(x_ref->shape, x_ref->dtype, x_ref->op->name, -1, 0,
+                                         false, key->virtual_device->memory_scope);
+    }
+    auto func_name = cached_func->prim_fn_var->name_hint;
+    VLOG(1) << "scheduling";
+    IRModule scheduled_module = tvm::LowerSchedule(cached_func->schedule, all_args,
+                                                   func_name, binds, global_var_supply);
+    scheduled_module->Update(tir::transform::BindParams(all_consts)(scheduled_module));
+    return scheduled_module;
+  }
+
   // implement lowered shape func
   CCacheValue LowerShapeFuncInternal(const CCacheKey& key) {
     VLOG(1) << "lowering dynamic shape function for:" << std::endl
@@ -552,6 +717,7 @@ TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_auto_scheduler", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule", Bool);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.use_meta_schedule_dispatch", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.tir_converter", String);
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.backend.dynamic_shape_buckets", Array<Array<Integer>>);
 
 TVM_REGISTER_GLOBAL("relay.backend._TECompilerGlobal").set_body_typed([]() {
   return TECompiler::Global();
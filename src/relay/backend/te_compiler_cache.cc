@@ -506,8 +506,9 @@ class ScheduleBuilder : public ExprVisitor {
     // No need to register schedule for device copy op.
     if (anchor_attrs_.as<DeviceCopyAttrs>() == nullptr) {
       if (use_auto_scheduler_) {
-        const auto* fauto_schedule =
-            runtime::Registry::Get("auto_scheduler.relay_integration.auto_schedule_topi_compute");
+        static const runtime::Registry::Handle fauto_schedule_handle(
+            "auto_scheduler.relay_integration.auto_schedule_topi_compute");
+        const auto* fauto_schedule = fauto_schedule_handle.Get();
         ICHECK(fauto_schedule != nullptr)
             << "auto_scheduler.relay_integration.auto_schedule_topi_compute is not registered";
         ObjectRef obj = (*fauto_schedule)(prim_fn_var->name_hint, tensor_outs);
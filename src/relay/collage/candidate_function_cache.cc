@@ -44,6 +44,22 @@ GlobalVar CandidateFunctionCache::GetGlobalSymbol(const Function& function) {
   return GetEntry(/*label=*/"", function).global_symbol;
 }
 
+Cost CandidateFunctionCache::LookupPersistentCost(const Function& function,
+                                                  const Target& target) const {
+  if (persistent_cost_cache_ == nullptr) {
+    return Cost::Unknown();
+  }
+  return persistent_cost_cache_->Lookup(function, target);
+}
+
+void CandidateFunctionCache::SetCost(Entry* entry, const Function& function, const Target& target,
+                                     Cost cost) {
+  entry->cost = cost;
+  if (persistent_cost_cache_ != nullptr) {
+    persistent_cost_cache_->Record(function, target, cost);
+  }
+}
+
 }  // namespace collage
 }  // namespace relay
 }  // namespace tvm
@@ -35,6 +35,7 @@
 #include "../transforms/compiler_function_utils.h"
 #include "./cost.h"
 #include "./name_supply.h"
+#include "./persistent_cost_cache.h"
 
 namespace tvm {
 namespace relay {
@@ -49,8 +50,15 @@ namespace collage {
  */
 class CandidateFunctionCache : public transform::GlobalSymbolCache {
  public:
-  explicit CandidateFunctionCache(std::shared_ptr<NameSupply> name_supply)
-      : name_supply_(std::move(name_supply)) {}
+  /*!
+   * \brief Constructs the cache. If \p persistent_cost_cache is given, costs it recorded in earlier
+   * runs are reused, and all newly estimated costs are recorded in it.
+   */
+  explicit CandidateFunctionCache(
+      std::shared_ptr<NameSupply> name_supply,
+      std::shared_ptr<PersistentCostCache> persistent_cost_cache = nullptr)
+      : name_supply_(std::move(name_supply)),
+        persistent_cost_cache_(std::move(persistent_cost_cache)) {}
 
   struct Entry {
     GlobalVar global_symbol;
@@ -67,8 +75,21 @@ class CandidateFunctionCache : public transform::GlobalSymbolCache {
 
   GlobalVar GetGlobalSymbol(const Function& function) final;
 
+  /*!
+   * \brief Returns the cost of \p function on \p target recorded in the persistent cost cache,
+   * or unknown if there is no such cost.
+   */
+  Cost LookupPersistentCost(const Function& function, const Target& target) const;
+
+  /*!
+   * \brief Sets the estimated cost of \p function on \p target for its \p entry, and records it
+   * in the persistent cost cache.
+   */
+  void SetCost(Entry* entry, const Function& function, const Target& target, Cost cost);
+
  private:
   std::shared_ptr<NameSupply> name_supply_;
+  std::shared_ptr<PersistentCostCache> persistent_cost_cache_;
   std::unordered_map<Function, Entry, StructuralHash, StructuralEqual> cache_;
 };
 
@@ -167,37 +167,15 @@ Cost CandidatePartitionNode::EstimatedCost(
     const DataflowGraph& dataflow_graph, const CostEstimator& cost_estimator,
     const std::shared_ptr<CandidateFunctionCache>& cache) const {
   if (cost_.is_unknown()) {
-    VLOG_CONTEXT << "spec " << partition_spec_name();
-    Function extracted_function = sub_graph_->ExtractAsFunction(dataflow_graph);
-    VLOG(2) << "Extracted function:" << std::endl << PrettyPrint(extracted_function);
-    extracted_function = EtaExpandTuples(extracted_function);
-    VLOG(2) << "Validating function:" << std::endl << PrettyPrint(extracted_function);
-    String error = partition_spec()->validate_sub_graph_func_(extracted_function);
-    if (!error.empty()) {
-      cost_ = Cost::Invalid();
-      VLOG(1) << "Unable to rewrite function: " << error;
-    } else {
-      // The extracted function may be the eta-expansion of a "Primitive" function.
-      // If so we want the cached external name and cost to be w.r.t. that function
-      // rather than the outer so that we'll get a cache hit when we outline functions
-      // in the final program.
-      Function primitive_function = GetPrimitiveFunction(extracted_function);
-      CandidateFunctionCache::Entry& entry =
-          cache->GetEntry(sub_graph_->label_, primitive_function);
-      if (entry.cost.is_unknown()) {
-        IRModule mod = IRModule::FromExpr(extracted_function);
-        VLOG(1) << "Outlining:" << std::endl << PrettyPrint(mod);
-        mod = OutlineCompilerFunctions(cache)(mod);
-        VLOG(1) << "Estimating cost of:" << std::endl
-                << PrettyPrint(mod) << std::endl
-                << "using target " << target()->ToDebugString();
-        entry.cost = cost_estimator->Estimate(mod, target());
-        VLOG(1) << "Measured cost as " << entry.cost.ToString();
-      } else {
-        VLOG(1) << "Reusing cost " << entry.cost.ToString()
-                << " cached in candidate function cache";
-      }
-      cost_ = entry.cost;
+    std::optional<PendingEstimate> pending = PrepareEstimate(dataflow_graph, cache);
+    if (pending) {
+      VLOG(1) << "Estimating cost of:" << std::endl
+              << PrettyPrint(pending->mod) << std::endl
+              << "using target " << pending->target->ToDebugString();
+      cache->SetCost(pending->entry, pending->function, pending->target,
+                     cost_estimator->Estimate(pending->mod, pending->target));
+      VLOG(1) << "Measured cost as " << pending->entry->cost.ToString();
+      cost_ = pending->entry->cost;
     }
   } else {
     VLOG(1) << "Reusing cost " << cost_.ToString() << " cached in candidate";
@@ -205,6 +183,47 @@ Cost CandidatePartitionNode::EstimatedCost(
   return cost_;
 }
 
+std::optional<CandidatePartitionNode::PendingEstimate> CandidatePartitionNode::PrepareEstimate(
+    const DataflowGraph& dataflow_graph,
+    const std::shared_ptr<CandidateFunctionCache>& cache) const {
+  if (!cost_.is_unknown()) {
+    return std::nullopt;
+  }
+  VLOG_CONTEXT << "spec " << partition_spec_name();
+  Function extracted_function = sub_graph_->ExtractAsFunction(dataflow_graph);
+  VLOG(2) << "Extracted function:" << std::endl << PrettyPrint(extracted_function);
+  extracted_function = EtaExpandTuples(extracted_function);
+  VLOG(2) << "Validating function:" << std::endl << PrettyPrint(extracted_function);
+  String error = partition_spec()->validate_sub_graph_func_(extracted_function);
+  if (!error.empty()) {
+    cost_ = Cost::Invalid();
+    VLOG(1) << "Unable to rewrite function: " << error;
+    return std::nullopt;
+  }
+  // The extracted function may be the eta-expansion of a "Primitive" function.
+  // If so we want the cached external name and cost to be w.r.t. that function
+  // rather than the outer so that we'll get a cache hit when we outline functions
+  // in the final program.
+  Function primitive_function = GetPrimitiveFunction(extracted_function);
+  CandidateFunctionCache::Entry& entry = cache->GetEntry(sub_graph_->label_, primitive_function);
+  if (entry.cost.is_unknown()) {
+    entry.cost = cache->LookupPersistentCost(primitive_function, target());
+    if (!entry.cost.is_unknown()) {
+      VLOG(1) << "Reusing cost " << entry.cost.ToString() << " recorded in persistent cost cache";
+    }
+  } else {
+    VLOG(1) << "Reusing cost " << entry.cost.ToString() << " cached in candidate function cache";
+  }
+  if (!entry.cost.is_unknown()) {
+    cost_ = entry.cost;
+    return std::nullopt;
+  }
+  IRModule mod = IRModule::FromExpr(extracted_function);
+  VLOG(1) << "Outlining:" << std::endl << PrettyPrint(mod);
+  mod = OutlineCompilerFunctions(cache)(mod);
+  return PendingEstimate{primitive_function, mod, target(), &entry};
+}
+
 CandidatePartition::CandidatePartition(String rule_name, SubGraph sub_graph,
                                        ObjectRef /* actually PartitionSpec */ spec, Cost cost) {
   auto node = runtime::make_object<CandidatePartitionNode>();
@@ -29,6 +29,7 @@
 #include <tvm/target/compilation_config.h>
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -103,6 +104,31 @@ class CandidatePartitionNode : public Object {
   Cost EstimatedCost(const DataflowGraph& dataflow_graph, const CostEstimator& cost_estimator,
                      const std::shared_ptr<CandidateFunctionCache>& cache) const;
 
+  /*! \brief The module whose cost must be estimated to learn the cost of a candidate. */
+  struct PendingEstimate {
+    /*! \brief The primitive function of the candidate, which \p entry is keyed by. */
+    Function function;
+    /*! \brief The module to pass to the cost estimator. */
+    IRModule mod;
+    /*! \brief The target to estimate for. */
+    Target target;
+    /*! \brief The cache entry to hold the estimated cost. */
+    CandidateFunctionCache::Entry* entry;
+  };
+
+  /*!
+   * \brief Does all the work of \p EstimatedCost short of invoking the cost estimator. Returns
+   * nothing if the cost is already known, either from the candidate, from the function's entry
+   * in \p cache or from its persistent cost cache. Otherwise returns the module to estimate, whose
+   * cost should be set with \p CandidateFunctionCache::SetCost before calling \p EstimatedCost.
+   *
+   * Since cost estimation is independent between modules, this allows the estimator to be
+   * invoked for many candidates in parallel.
+   */
+  std::optional<PendingEstimate> PrepareEstimate(
+      const DataflowGraph& dataflow_graph,
+      const std::shared_ptr<CandidateFunctionCache>& cache) const;
+
   /*!
    * \brief Returns a brief description of candidate suitable for debugging output.
    */
@@ -24,6 +24,11 @@
 
 #include "./candidate_partition_index.h"
 
+#include <tvm/support/parallel_for.h>
+
+#include <algorithm>
+#include <unordered_set>
+
 #include "./gather_partition_specs.h"
 #include "./prune_candidates.h"
 #include "./utils.h"
@@ -51,7 +56,32 @@ void CandidatePartitionIndex::Index(const Array<PartitionSpec>& partition_specs)
 }
 
 void CandidatePartitionIndex::EstimateAllCosts(
-    const CostEstimator cost_estimator, const std::shared_ptr<CandidateFunctionCache>& cache) {
+    const CostEstimator cost_estimator, const std::shared_ptr<CandidateFunctionCache>& cache,
+    int num_threads) {
+  // Prepare the modules to estimate. This touches the shared cache, so is done serially.
+  std::vector<CandidatePartitionNode::PendingEstimate> pending;
+  std::unordered_set<const CandidateFunctionCache::Entry*> pending_entries;
+  for (PostDfsIndex index = 0; index < dataflow_graph_->size(); ++index) {
+    for (const auto& candidate : first_inside_index_to_candidates_[index]) {
+      auto estimate = candidate->PrepareEstimate(*dataflow_graph_, cache);
+      // Structurally equal candidates share their cache entry and thus need only one estimate.
+      if (estimate && pending_entries.insert(estimate->entry).second) {
+        pending.push_back(std::move(*estimate));
+      }
+    }
+  }
+  // The estimates are independent, so can be made in parallel.
+  VLOG(1) << "Estimating cost of " << pending.size() << " distinct candidate functions with "
+          << num_threads << " thread(s)";
+  std::vector<Cost> costs(pending.size(), Cost::Unknown());
+  support::parallel_for_dynamic(
+      0, static_cast<int>(pending.size()), std::max(num_threads, 1),
+      [&](int /*thread_id*/, int task_id) {
+        costs[task_id] = cost_estimator->Estimate(pending[task_id].mod, pending[task_id].target);
+      });
+  for (size_t i = 0; i < pending.size(); ++i) {
+    cache->SetCost(pending[i].entry, pending[i].function, pending[i].target, costs[i]);
+  }
   size_t n = 0;
   for (PostDfsIndex index = 0; index < dataflow_graph_->size(); ++index) {
     for (const auto& candidate : first_inside_index_to_candidates_[index]) {
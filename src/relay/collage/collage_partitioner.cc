@@ -44,6 +44,7 @@
 #include "./name_supply.h"
 #include "./partition_rule.h"
 #include "./partition_spec.h"
+#include "./persistent_cost_cache.h"
 #include "./priority_queue.h"
 #include "./sub_graph.h"
 #include "./utils.h"
@@ -55,6 +56,10 @@ namespace {
 
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.tvm_max_depth", Integer);
 TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.byoc_max_depth", Integer);
+/*! \brief Number of threads to estimate the costs of candidates with. Defaults to 1. */
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.num_estimate_threads", Integer);
+/*! \brief If given, path to a file used to persist estimated costs across runs. */
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.collage.cost_cache_path", String);
 
 /*!
  * \brief Represents the overall expression after some number of non-overlapping candidate
@@ -126,12 +131,13 @@ class Partitioner {
   explicit Partitioner(Array<PartitionSpec> partition_specs,
                        const std::unordered_map<const ExprNode*, VirtualDevice>* virtual_devices,
                        CostEstimator cost_estimator, std::shared_ptr<CandidateFunctionCache> cache,
-                       Expr expr)
+                       Expr expr, int num_estimate_threads = 1)
       : partition_specs_(std::move(partition_specs)),
         virtual_devices_(virtual_devices),
         cost_estimator_(std::move(cost_estimator)),
         cache_(std::move(cache)),
-        expr_(std::move(expr)) {}
+        expr_(std::move(expr)),
+        num_estimate_threads_(num_estimate_threads) {}
 
   Expr Partition() {
     // Establish core data structures.
@@ -150,10 +156,10 @@ class Partitioner {
     //  - There are no paths in which the candidate does not intersect candidates already
     //    applied on the path.
     //  - The Dijkstra search terminates early with a least cost path.
-    // So eager may result in more estimation overhead. However, eager could be made
+    // So eager may result in more estimation overhead. However, eager estimation is
     // embarrassingly parallel.
     VLOG(1) << "Beginning eager cost estimation";
-    index_->EstimateAllCosts(cost_estimator_, cache_);
+    index_->EstimateAllCosts(cost_estimator_, cache_, num_estimate_threads_);
     VLOG(1) << "Finished eager cost estimation";
 
     // Setup initial state.
@@ -300,6 +306,8 @@ class Partitioner {
   std::shared_ptr<CandidateFunctionCache> cache_;
   /*! \brief The expression we will be partitioning. */
   Expr expr_;
+  /*! \brief Number of threads to use for eager cost estimation. */
+  int num_estimate_threads_;
   /*! \brief Dataflow graph for overall expression. */
   std::unique_ptr<DataflowGraph> dataflow_graph_;
   /*! \brief Index of all avoilable candidates we are searching over. */
@@ -322,8 +330,15 @@ transform::Pass CollagePartition(CompilationConfig config, CostEstimator cost_es
         Array<PartitionSpec> partition_specs = GatherPartitionSpecs(config);
         VLOG(1) << "Gathered " << partition_specs.size() << " partition specs";
 
-        auto cache =
-            std::make_shared<CandidateFunctionCache>(std::make_shared<NameSupply>("collage"));
+        int num_estimate_threads =
+            ctxt->GetConfig("relay.collage.num_estimate_threads", Integer(1)).value()->value;
+        std::shared_ptr<PersistentCostCache> persistent_cost_cache;
+        if (Optional<String> path = ctxt->GetConfig<String>("relay.collage.cost_cache_path")) {
+          persistent_cost_cache =
+              std::make_shared<PersistentCostCache>(path.value(), cost_estimator->GetTypeKey());
+        }
+        auto cache = std::make_shared<CandidateFunctionCache>(
+            std::make_shared<NameSupply>("collage"), std::move(persistent_cost_cache));
 
         IRModule out_mod = mod->ShallowCopy();
         for (const auto& kv : mod->functions) {
@@ -332,7 +347,7 @@ transform::Pass CollagePartition(CompilationConfig config, CostEstimator cost_es
             std::unordered_map<const ExprNode*, VirtualDevice> virtual_devices =
                 transform::RecoverVirtualDeviceMap(mod, function);
             Partitioner partitioner(partition_specs, &virtual_devices, cost_estimator, cache,
-                                    function);
+                                    function, num_estimate_threads);
             Function result = Downcast<Function>(partitioner.Partition());
             out_mod->Add(kv.first, result);
           }
@@ -27,6 +27,8 @@
 
 #include <tvm/relay/function.h>
 
+#include <atomic>
+
 #include "./cost.h"
 #include "./cost_estimator.h"
 
@@ -56,6 +58,9 @@ class MockCostEstimatorNode : public CostEstimatorNode {
  public:
   Cost Estimate(const IRModule& mod, const Target& target) const override;
 
+  /*! \brief Returns the number of calls to Estimate so far. */
+  size_t num_estimates() const { return num_estimates_; }
+
   static constexpr const char* _type_key = "relay.collage.MockCostEstimator";
   TVM_DECLARE_FINAL_OBJECT_INFO(MockCostEstimatorNode, CostEstimatorNode);
 
@@ -71,8 +76,8 @@ class MockCostEstimatorNode : public CostEstimatorNode {
    */
   Integer max_estimates_;
 
-  /*! \brief Number of calls to Estimate. */
-  mutable size_t num_estimates_ = 0;
+  /*! \brief Number of calls to Estimate, which may be made concurrently. */
+  mutable std::atomic<size_t> num_estimates_{0};
 
   friend class MockCostEstimator;
 };
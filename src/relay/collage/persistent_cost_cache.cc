@@ -0,0 +1,137 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/collage/persistent_cost_cache.cc
+ * \brief An on-disk cache of the estimated costs of candidate partition functions.
+ */
+
+#include "./persistent_cost_cache.h"
+
+#include <tvm/ir/module.h>
+#include <tvm/node/structural_hash.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "../../support/str_escape.h"
+
+namespace tvm {
+namespace relay {
+namespace collage {
+
+PersistentCostCache::PersistentCostCache(std::string path, std::string estimator)
+    : path_(std::move(path)), estimator_(std::move(estimator)) {
+  std::ifstream is(path_);
+  std::string line;
+  size_t num_records = 0;
+  while (std::getline(is, line)) {
+    // Fields are "<hash>\t<cost>\t<estimator>\t<target>\t<function>".
+    std::vector<std::string> fields;
+    size_t pos = 0;
+    while (fields.size() < 4) {
+      size_t tab = line.find('\t', pos);
+      if (tab == std::string::npos) {
+        break;
+      }
+      fields.push_back(line.substr(pos, tab - pos));
+      pos = tab + 1;
+    }
+    if (fields.size() < 4) {
+      // Skip records truncated by an interrupted run.
+      continue;
+    }
+    if (fields[2] != estimator_) {
+      continue;
+    }
+    const std::string& cost_str = fields[1];
+    char* end = nullptr;
+    double cost = std::strtod(cost_str.c_str(), &end);
+    if (end == cost_str.c_str() || *end != '\0') {
+      continue;
+    }
+    costs_[fields[0] + "\t" + fields[2] + "\t" + fields[3]] = RecordedCost{cost, line.substr(pos)};
+    ++num_records;
+  }
+  VLOG(1) << "Loaded " << num_records << " costs estimated by " << estimator_
+          << " from persistent cost cache '" << path_ << "'";
+}
+
+std::string PersistentCostCache::Key(const Function& function, const Target& target) const {
+  std::ostringstream os;
+  os << std::hex << std::setw(16) << std::setfill('0') << StructuralHash()(function) << "\t"
+     << estimator_ << "\t" << target->str();
+  return os.str();
+}
+
+std::string PersistentCostCache::FunctionText(const Function& function) {
+  // Print without spans, types or other annotations, which do not change the cost, and escape
+  // the text onto a single line.
+  std::string text =
+      AsText(function, /*show_meta_data=*/false, [](const ObjectRef&) { return String(""); });
+  return support::StrEscape(text.data(), text.size());
+}
+
+Cost PersistentCostCache::Lookup(const Function& function, const Target& target) const {
+  std::string key = Key(function, target);
+  std::string function_text = FunctionText(function);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = costs_.find(key);
+  if (itr == costs_.end()) {
+    return Cost::Unknown();
+  }
+  if (itr->second.function_text != function_text) {
+    VLOG(1) << "Ignoring cost recorded for a different function with the same structural hash";
+    return Cost::Unknown();
+  }
+  double cost = itr->second.cost;
+  return std::isinf(cost) ? Cost::Invalid() : Cost::Value(cost);
+}
+
+void PersistentCostCache::Record(const Function& function, const Target& target, Cost cost) {
+  if (cost.is_unknown()) {
+    return;
+  }
+  double value = cost.is_invalid() ? std::numeric_limits<double>::infinity() : cost.value();
+  std::string key = Key(function, target);
+  std::string function_text = FunctionText(function);
+  size_t tab = key.find('\t');
+  std::ostringstream os;
+  os << key.substr(0, tab) << "\t" << std::setprecision(17) << value << "\t"
+     << key.substr(tab + 1) << "\t" << function_text << "\n";
+  std::lock_guard<std::mutex> lock(mutex_);
+  costs_[key] = RecordedCost{value, std::move(function_text)};
+  // Write each record with a single call so concurrent runs are unlikely to tear lines.
+  std::ofstream out(path_, std::ios::app);
+  if (!out) {
+    LOG(WARNING) << "Unable to append to persistent cost cache '" << path_ << "'";
+    return;
+  }
+  out << os.str();
+  out.flush();
+}
+
+}  // namespace collage
+}  // namespace relay
+}  // namespace tvm
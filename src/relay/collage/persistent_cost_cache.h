@@ -0,0 +1,91 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file src/relay/collage/persistent_cost_cache.h
+ * \brief An on-disk cache of the estimated costs of candidate partition functions.
+ */
+
+#ifndef TVM_RELAY_COLLAGE_PERSISTENT_COST_CACHE_H_
+#define TVM_RELAY_COLLAGE_PERSISTENT_COST_CACHE_H_
+
+#include <tvm/relay/function.h>
+#include <tvm/target/target.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "./cost.h"
+
+namespace tvm {
+namespace relay {
+namespace collage {
+
+/*!
+ * \brief A cache of estimated costs which persists across Collage runs, so that partitioning
+ * related models does not measure the same candidate functions again.
+ *
+ * Costs are keyed by the structural hash of the candidate function together with the name of
+ * the cost estimator and the target string. Each record also holds the text of the function,
+ * which must match on lookup so that a hash collision is treated as a miss rather than reusing the
+ * cost of an unrelated function. The cache is a text file with one tab separated
+ * "<hash>\t<cost>\t<estimator>\t<target>\t<function>" record per line, which is loaded on
+ * construction and appended to as costs are recorded. Records from concurrent runs may
+ * interleave, in which case the later record for a key wins.
+ */
+class PersistentCostCache {
+ public:
+  /*!
+   * \brief Loads the cache from \p path, which need not exist yet. Only the costs previously
+   * recorded by the estimator named \p estimator are used.
+   */
+  PersistentCostCache(std::string path, std::string estimator);
+
+  /*! \brief Returns the recorded cost of \p function on \p target, or unknown if none. */
+  Cost Lookup(const Function& function, const Target& target) const;
+
+  /*! \brief Records the cost of \p function on \p target. Unknown costs are not recorded. */
+  void Record(const Function& function, const Target& target, Cost cost);
+
+ private:
+  /*! \brief A recorded cost together with the text of the function it was estimated for. */
+  struct RecordedCost {
+    double cost;
+    std::string function_text;
+  };
+
+  std::string Key(const Function& function, const Target& target) const;
+  static std::string FunctionText(const Function& function);
+
+  /*! \brief Path to the cache file. */
+  std::string path_;
+  /*! \brief Name of the cost estimator the costs are estimated by. */
+  std::string estimator_;
+  /*! \brief All the costs loaded or recorded so far. */
+  std::unordered_map<std::string, RecordedCost> costs_;
+  /*! \brief Guards \p costs_ and the cache file. */
+  mutable std::mutex mutex_;
+};
+
+}  // namespace collage
+}  // namespace relay
+}  // namespace tvm
+
+#endif  // TVM_RELAY_COLLAGE_PERSISTENT_COST_CACHE_H_
@@ -127,13 +127,19 @@ IRModule FunctionPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   IRModule updated_mod = mod->ShallowCopy();
 
   std::vector<std::pair<GlobalVar, Function>> updates;
+  Array<GlobalVar> gvars;
   for (const auto& kv : mod->functions) {
     // only process optimizable Relay Functions
     if (const auto* function_node = AsOptimizableFunctionNode(kv.second)) {
-      Function updated_func = pass_func(GetRef<Function>(function_node), updated_mod, pass_ctx);
-      updates.push_back({kv.first, std::move(updated_func)});
+      updates.push_back({kv.first, GetRef<Function>(function_node)});
+      gvars.push_back(kv.first);
     }
   }
+  // The functions of a thread-safe pass may be visited concurrently if enabled by the pass
+  // context, `updated_mod` is only read until all of them are done.
+  tvm::transform::ForEachFunction(pass_ctx, pass_info, gvars, [&](int i) {
+    updates[i].second = pass_func(updates[i].second, updated_mod, pass_ctx);
+  });
 
   for (const auto& pair : updates) {
     updated_mod->Add(pair.first, pair.second, true);
@@ -20,6 +20,8 @@
 /*!
  * \file constant_folding.cc
  */
+#include <tvm/node/structural_equal.h>
+#include <tvm/node/structural_hash.h>
 #include <tvm/relay/analysis.h>
 #include <tvm/relay/attrs/annotation.h>
 #include <tvm/relay/attrs/transform.h>
@@ -32,6 +34,12 @@
 #include <tvm/runtime/ndarray.h>
 #include <tvm/runtime/object.h>
 
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "../op/memory/on_device.h"
 #include "./pattern_utils.h"
 
@@ -39,6 +47,8 @@ namespace tvm {
 namespace relay {
 namespace transform {
 
+TVM_REGISTER_PASS_CONFIG_OPTION("relay.FoldConstant.batch_evaluation", Bool);
+
 namespace {
 /*!
  * \brief Returns whether \p expr is a literal \p Constant, optionally wrapped by an "on_device"
@@ -63,6 +73,91 @@ bool IsComplexConstant(const Expr& expr) {
   }
 }
 
+/*!
+ * \brief Finds the roots of the maximal sub-expressions which only consist of evaluable calls
+ * over constants, i.e. the evaluable calls which are used by anything but another evaluable call.
+ */
+class ConstantSubgraphCollector : private MixedModeVisitor {
+ public:
+  explicit ConstantSubgraphCollector(std::function<bool(const Op&)> fcan_evaluate_op)
+      : fcan_evaluate_op_(std::move(fcan_evaluate_op)) {}
+
+  std::vector<Call> Collect(const Expr& expr) {
+    VisitExpr(expr);
+    std::vector<Call> roots;
+    for (const Call& call : evaluable_calls_) {
+      auto it = evaluable_uses_.find(call.get());
+      size_t num_evaluable_uses = it == evaluable_uses_.end() ? 0 : it->second;
+      if (visit_counter_[call.get()] > num_evaluable_uses) {
+        roots.push_back(call);
+      }
+    }
+    return roots;
+  }
+
+ private:
+  using MixedModeVisitor::VisitExpr_;
+
+  void VisitExpr_(const FunctionNode* function_node) final {
+    // Calls inside primitive functions are never folded.
+    if (!function_node->HasNonzeroAttr(attr::kPrimitive)) {
+      MixedModeVisitor::VisitExpr_(function_node);
+    }
+  }
+
+  void VisitExpr_(const CallNode* call_node) final {
+    // The arguments have already been visited.
+    const auto* op_node = call_node->op.as<OpNode>();
+    if (call_node->args.empty() || op_node == nullptr || !fcan_evaluate_op_(GetRef<Op>(op_node))) {
+      return;
+    }
+    for (const Expr& arg : call_node->args) {
+      if (!IsComplexConstant(arg) && !evaluable_.count(arg.get())) {
+        return;
+      }
+    }
+    for (const Expr& arg : call_node->args) {
+      if (evaluable_.count(arg.get())) {
+        ++evaluable_uses_[arg.get()];
+      }
+    }
+    evaluable_.insert(call_node);
+    evaluable_calls_.push_back(GetRef<Call>(call_node));
+  }
+
+  std::function<bool(const Op&)> fcan_evaluate_op_;
+  /*! \brief The evaluable calls in post-order. */
+  std::vector<Call> evaluable_calls_;
+  std::unordered_set<const Object*> evaluable_;
+  /*! \brief The number of uses of an evaluable call as the argument of another evaluable call. */
+  std::unordered_map<const Object*, size_t> evaluable_uses_;
+};
+
+/*! \brief Replaces the given calls by their folded values. */
+class ConstantSubgraphReplacer : public ExprRewriter {
+ public:
+  explicit ConstantSubgraphReplacer(std::unordered_map<const CallNode*, Expr> replacements)
+      : replacements_(std::move(replacements)) {}
+
+  Expr Rewrite(const Expr& pre, const Expr& post) final {
+    Expr result = ExprRewriter::Rewrite(pre, post);
+    // Folding does not change types, carry them over to the rebuilt ancestors of the roots and
+    // to the folded values, as the folding of shape_of and ndarray_size relies on them.
+    if (!result->checked_type_.defined()) {
+      result->checked_type_ = pre->checked_type_;
+    }
+    return result;
+  }
+
+  Expr Rewrite_(const CallNode* pre, const Expr& post) final {
+    auto it = replacements_.find(pre);
+    return it == replacements_.end() ? post : it->second;
+  }
+
+ private:
+  std::unordered_map<const CallNode*, Expr> replacements_;
+};
+
 // TODO(tvm-team) consider combine dead-code with constant folder.
 // or make a more powerful partial evaluator.
 class ConstantFolder : public MixedModeMutator {
@@ -76,6 +171,66 @@ class ConstantFolder : public MixedModeMutator {
         cast_op_(Op::Get("cast")),
         ndarray_size_op_(Op::Get("ndarray_size")) {}
 
+  /*!
+   * \brief Evaluates all the maximal constant sub-expressions of \p expr in one batch and
+   * replaces them by their values. The sub-expressions are lowered and built as a single module
+   * instead of once per call, and structurally equal sub-expressions are only evaluated once.
+   * Constants exposed by other rewrites (let-bindings, ifs, shape_of...) are left to the
+   * regular folding. If the batch fails to evaluate the sub-expressions are evaluated one at a
+   * time, and those which still fail are left unfolded.
+   */
+  Expr FoldConstantSubgraphs(const Expr& expr) {
+    std::vector<Call> roots =
+        ConstantSubgraphCollector([this](const Op& op) { return CanEvaluateOp(op); })
+            .Collect(expr);
+    if (roots.empty()) {
+      return expr;
+    }
+    std::unordered_map<Expr, size_t, StructuralHash, StructuralEqual> field_indices;
+    Array<Expr> fields;
+    std::vector<size_t> root_fields;
+    for (const Call& root : roots) {
+      auto it = field_indices.emplace(root, fields.size()).first;
+      if (it->second == fields.size()) {
+        fields.push_back(root);
+      }
+      root_fields.push_back(it->second);
+    }
+    VLOG(1) << "Evaluating " << fields.size() << " distinct constant sub-expressions for "
+            << roots.size() << " roots in one batch";
+    Array<Expr> results;
+    try {
+      results = Downcast<Tuple>(ConstEvaluate(Tuple(fields)))->fields;
+    } catch (std::exception& e) {
+      LOG(WARNING) << "Unable to evaluate " << fields.size()
+                   << " constant sub-expressions in one batch, evaluating them one at a time: "
+                   << e.what();
+      for (const Expr& field : fields) {
+        Expr result;
+        try {
+          result = ConstEvaluate(field);
+        } catch (std::exception& error) {
+          VLOG(1) << "Leaving unfolded constant sub-expression which fails to evaluate:"
+                  << std::endl
+                  << PrettyPrint(field) << std::endl
+                  << error.what();
+        }
+        results.push_back(result);
+      }
+    }
+    std::unordered_map<const CallNode*, Expr> replacements;
+    for (size_t i = 0; i < roots.size(); ++i) {
+      const Expr& result = results[root_fields[i]];
+      if (result.defined()) {
+        replacements.emplace(roots[i].get(), result);
+      } else {
+        unevaluable_calls_.insert(roots[i].get());
+      }
+    }
+    ConstantSubgraphReplacer replacer(std::move(replacements));
+    return PostOrderRewrite(expr, &replacer);
+  }
+
  private:
   using ExprMutator::VisitExpr_;
 
@@ -165,11 +320,6 @@ class ConstantFolder : public MixedModeMutator {
       return std::move(post_call);
     }
     Op op = GetRef<Op>(op_node);
-    static auto op_stateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
-    if (op_stateful.get(op, false)) {
-      // skip stateful ops.
-      return std::move(post_call);
-    }
     // Try to evaluate shape_of and ndarray_size ops
     // Use the original call rather than new_call here since it still has valid checked_type
     // fields. These operators don't care about the value of their argument anyway.
@@ -181,25 +331,45 @@ class ConstantFolder : public MixedModeMutator {
     if (Optional<Expr> opt_result = EvaluateNdarraySize(pre_call)) {
       return opt_result.value();
     }
+    if (!CanEvaluateOp(op)) {
+      return std::move(post_call);
+    }
+    if (!std::all_of(post_call->args.begin(), post_call->args.end(), IsComplexConstant)) {
+      // At least one non-constant argument.
+      return std::move(post_call);
+    }
+    if (unevaluable_calls_.count(pre_call_node)) {
+      // Already failed to evaluate as the root of a batch.
+      return std::move(post_call);
+    }
+    // During evaluation we have obviously lost all on_device annotations. However any
+    // on_device wrapping this call will be left in place.
+    return ConstEvaluate(post_call);
+  }
+
+  /*!
+   * \brief Returns whether calls to \p op with constant arguments can be replaced by the result
+   * of evaluating them.
+   */
+  bool CanEvaluateOp(const Op& op) const {
+    static auto op_stateful = Op::GetAttrMap<TOpIsStateful>("TOpIsStateful");
+    if (op_stateful.get(op, false)) {
+      // skip stateful ops.
+      return false;
+    }
     static auto fnoncomputational = Op::GetAttrMap<TNonComputational>("TNonComputational");
     static auto qnn_canonicalize = Op::GetAttrMap<FTVMLegalize>("FTVMQnnCanonicalize");
     bool is_no_qnn_canonicalized = !qnn_canonicalize.count(op);
     bool is_no_computational = fnoncomputational.count(op) && fnoncomputational[op];
     if (is_no_computational && (is_no_qnn_canonicalized || !fold_qnn_)) {
-      return std::move(post_call);
+      return false;
     }
     if (op == device_copy_op_ || op == shape_of_op_ || op == vm_shape_of_op_ ||
         op == ndarray_size_op_) {
       // We should think about potentially constant evaluation over these ops too.
-      return std::move(post_call);
-    }
-    if (!std::all_of(post_call->args.begin(), post_call->args.end(), IsComplexConstant)) {
-      // At least one non-constant argument.
-      return std::move(post_call);
+      return false;
     }
-    // During evaluation we have obviously lost all on_device annotations. However any
-    // on_device wrapping this call will be left in place.
-    return ConstEvaluate(post_call);
+    return true;
   }
 
   Expr VisitExpr_(const IfNode* if_node) final {
@@ -412,6 +582,9 @@ class ConstantFolder : public MixedModeMutator {
 
   // True if currently within a "primitive" Relay Function.
   bool inside_primitive_ = false;
+
+  // The roots of batched constant sub-expressions which failed to evaluate.
+  std::unordered_set<const CallNode*> unevaluable_calls_;
 };
 
 }  // namespace
@@ -421,7 +594,11 @@ TVM_REGISTER_GLOBAL("relay.analysis.check_constant").set_body_typed(IsComplexCon
 Expr FoldConstantExpr(const Expr& expr, const IRModule& mod, bool fold_qnn) {
   VLOG_CONTEXT << "FoldConstantExpr";
   VLOG(1) << "folding:" << std::endl << PrettyPrint(expr);
-  Expr result = ConstantFolder(mod, fold_qnn).VisitExpr(expr);
+  ConstantFolder folder(mod, fold_qnn);
+  bool batch_evaluation = transform::PassContext::Current()
+                              ->GetConfig<Bool>("relay.FoldConstant.batch_evaluation", Bool(false))
+                              .value();
+  Expr result = folder.VisitExpr(batch_evaluation ? folder.FoldConstantSubgraphs(expr) : expr);
   VLOG(1) << "folded to:" << std::endl << PrettyPrint(result);
   return result;
 }
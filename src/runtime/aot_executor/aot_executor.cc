@@ -31,66 +31,116 @@
 
 #include <limits>
 #include <memory>
+#include <utility>
 
 #include "../meta_data.h"
 
 namespace tvm {
 namespace runtime {
 
-AotExecutor::AotExecutor(tvm::runtime::Module module, const std::vector<Device>& devs)
-    : module_{module}, devices_{devs} {
+// Immutable once the first context of a model has been created.
+struct AotExecutor::SharedState {
+  /*! \brief Metadata provided to the runtime from the compiler. */
+  metadata::Metadata metadata;
+  /*! \brief Runtime module which contains the AOT top-level function. */
+  Module module;
+  /*! \brief The devices which should be used to execute the computations. */
+  std::vector<Device> devices;
+  /*! \brief The AOT top-level function, nullptr if the module does not define it. */
+  PackedFunc main;
+  /*! \brief All constants merged into one array, undefined when USMP is not used. */
+  NDArray constant_pool;
+};
+
+AotExecutor::AotExecutor(tvm::runtime::Module module, const std::vector<Device>& devs) {
+  auto shared = std::make_shared<SharedState>();
+  shared->module = module;
+  shared->devices = devs;
   auto fmetadata = module->GetFunction("get_metadata");
   CHECK(fmetadata != nullptr) << "Expected a module with PackedFunc get_metadata";
   auto ret_value = fmetadata();
-  metadata_ = ret_value.AsObjectRef<tvm::runtime::metadata::Metadata>();
+  shared->metadata = ret_value.AsObjectRef<tvm::runtime::metadata::Metadata>();
+  const metadata::Metadata& metadata = shared->metadata;
+  const std::vector<Device>& devices = shared->devices;
 
-  ICHECK_EQ(devices_.size(), 1) << "Expect exactly 1 device passed.";
+  ICHECK_EQ(devices.size(), 1) << "Expect exactly 1 device passed.";
   DLDevice expected_device{kDLCPU, 0};
-  ICHECK_EQ(devices_[0].device_id, expected_device.device_id)
+  ICHECK_EQ(devices[0].device_id, expected_device.device_id)
       << "At this time, AOTExecutor supports only execution on kDLCPU 0";
   // TODO(tvm-team): Temporary hack since Hexagon is defined different than kDLCPU.
   bool is_valid_device =
-      (devices_[0].device_type == kDLHexagon) || (devices_[0].device_type == kDLCPU);
+      (devices[0].device_type == kDLHexagon) || (devices[0].device_type == kDLCPU);
   CHECK(is_valid_device)
       << "At this time, AOTExecutor supports only execution on kDLCPU 0 or kDLHexagon 0";
 
-  for (auto input : metadata_->inputs()) {
-    // TODO(areusch): Encode device information in Metadata.
-    args_.emplace_back(NDArray::Empty(ShapeTuple(input->shape().begin(), input->shape().end()),
-                                      input->dtype(), devices_[0]));
-  }
-
-  for (auto output : metadata_->outputs()) {
-    args_.emplace_back(NDArray::Empty(ShapeTuple(output->shape().begin(), output->shape().end()),
-                                      output->dtype(), devices_[0]));
-  }
+  // Resolve the entry point once, so that contexts running concurrently only read the module.
+  shared->main = module.GetFunction(
+      get_name_mangled(metadata->mod_name(), ::tvm::runtime::symbol::tvm_module_main),
+      true /* query_imports */);
 
   // USMP is used
-  if (metadata_->num_workspace_pools()) {
+  if (metadata->num_workspace_pools()) {
     // merge all constants into one ndarray
     int64_t blob_len = 0;
-    for (const auto& c : metadata_->constant_pools()) {
+    for (const auto& c : metadata->constant_pools()) {
       auto data = c->data();
       int64_t byte_size = GetDataSize(*data.operator->()) + c->byte_offset();
       blob_len = blob_len > byte_size ? blob_len : byte_size;
     }
     ICHECK(blob_len < std::numeric_limits<int32_t>::max());
-    NDArray ci = NDArray::Empty({blob_len}, DataType::UInt(8), devices_[0]);
-    for (const auto& c : metadata_->constant_pools()) {
+    NDArray ci = NDArray::Empty({blob_len}, DataType::UInt(8), devices[0]);
+    for (const auto& c : metadata->constant_pools()) {
       auto data = c->data();
       data.CopyToBytes(static_cast<uint8_t*>(ci->data) + c->byte_offset(),
                        GetDataSize(*data.operator->()));
     }
+    shared->constant_pool = ci;
+  }
+
+  shared_ = std::move(shared);
+  AllocateArgs();
+}
+
+AotExecutor::AotExecutor(std::shared_ptr<const SharedState> shared) : shared_{std::move(shared)} {
+  AllocateArgs();
+}
+
+void AotExecutor::AllocateArgs() {
+  const metadata::Metadata& metadata = shared_->metadata;
+  const Device& device = shared_->devices[0];
+  for (auto input : metadata->inputs()) {
+    // TODO(areusch): Encode device information in Metadata.
+    args_.emplace_back(NDArray::Empty(ShapeTuple(input->shape().begin(), input->shape().end()),
+                                      input->dtype(), device));
+  }
+
+  for (auto output : metadata->outputs()) {
+    args_.emplace_back(NDArray::Empty(ShapeTuple(output->shape().begin(), output->shape().end()),
+                                      output->dtype(), device));
+  }
+
+  if (metadata->num_workspace_pools()) {
     // Emplace constant node pool only if workspace pools supplied
-    args_.emplace_back(ci);
+    args_.emplace_back(shared_->constant_pool);
 
     int32_t pool_len = 0;
-    for (auto pool : metadata_->workspace_pools()) {
-      pool_len =
-          GetDataSize(*NDArray::Empty({pool->shape()}, pool->dtype(), devices_[0]).operator->());
-      args_.emplace_back(NDArray::Empty({pool_len}, DataType::UInt(8), devices_[0]));
+    for (auto pool : metadata->workspace_pools()) {
+      pool_len = GetDataSize(*NDArray::Empty({pool->shape()}, pool->dtype(), device).operator->());
+      args_.emplace_back(NDArray::Empty({pool_len}, DataType::UInt(8), device));
     }
   }
+
+  // The arrays are only ever copied into, so the call arguments can be set up once.
+  for (const NDArray& arg : args_) {
+    TVMValue value;
+    value.v_handle = const_cast<DLTensor*>(arg.operator->());
+    call_values_.push_back(value);
+    call_type_codes_.push_back(kTVMDLTensorHandle);
+  }
+}
+
+Module AotExecutor::CreateContext() const {
+  return Module(make_object<AotExecutor>(shared_));
 }
 
 PackedFunc AotExecutor::GetFunction(const std::string& name,
@@ -151,6 +201,9 @@ PackedFunc AotExecutor::GetFunction(const std::string& name,
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
   } else if (name == "run") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
+  } else if (name == "create_context") {
+    return PackedFunc(
+        [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->CreateContext(); });
   } else if (name == "get_input_index") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
       CHECK(String::CanConvertFrom(args[0])) << "Input key is not a string";
@@ -162,27 +215,15 @@ PackedFunc AotExecutor::GetFunction(const std::string& name,
 }
 
 void AotExecutor::Run() {
-  auto pf = module_.GetFunction(
-      get_name_mangled(metadata_->mod_name(), ::tvm::runtime::symbol::tvm_module_main),
-      true /* query_imports */);
-  ICHECK(pf != nullptr) << "Module entrypoint is not defined";
-
-  const int num_args = args_.size();
-  auto call_values = ::std::make_unique<TVMValue[]>(num_args);
-  auto call_type_codes = ::std::make_unique<int[]>(num_args);
-  for (int i = 0; i < num_args; ++i) {
-    auto managed = args_[i].ToDLPack();
-    call_values.get()[i].v_handle = &managed->dl_tensor;
-    call_type_codes.get()[i] = kTVMDLTensorHandle;
-  }
-
-  TVMArgs args{call_values.get(), call_type_codes.get(), num_args};
+  ICHECK(shared_->main != nullptr) << "Module entrypoint is not defined";
+  TVMArgs args{call_values_.data(), call_type_codes_.data(),
+               static_cast<int>(call_values_.size())};
   TVMRetValue rv;
-  pf.CallPacked(args, &rv);
+  shared_->main.CallPacked(args, &rv);
 }
 
 int AotExecutor::GetInputIndex(const std::string& name) {
-  auto inputs = metadata_->inputs();
+  auto inputs = shared_->metadata->inputs();
   for (unsigned int i = 0; i < inputs.size(); i++) {
     if (inputs[i]->name() == name) {
       return i;
@@ -192,7 +233,7 @@ int AotExecutor::GetInputIndex(const std::string& name) {
 }
 
 int AotExecutor::GetOutputIndex(const std::string& name) {
-  auto outputs = metadata_->outputs();
+  auto outputs = shared_->metadata->outputs();
   for (unsigned int i = 0; i < outputs.size(); i++) {
     if (outputs[i]->name() == name) {
       return i;
@@ -211,13 +252,15 @@ void AotExecutor::SetOutputZeroCopy(int index, DLTensor* data_ref) {
   ICHECK(false) << "not implemented";
 }
 
-int AotExecutor::NumOutputs() const { return metadata_->num_outputs(); }
+int AotExecutor::NumOutputs() const { return shared_->metadata->num_outputs(); }
 
-int AotExecutor::NumInputs() const { return metadata_->num_inputs(); }
+int AotExecutor::NumInputs() const { return shared_->metadata->num_inputs(); }
 
 NDArray AotExecutor::GetInput(int index) const { return args_[index]; }
 
-NDArray AotExecutor::GetOutput(int index) const { return args_[metadata_->num_inputs() + index]; }
+NDArray AotExecutor::GetOutput(int index) const {
+  return args_[shared_->metadata->num_inputs() + index];
+}
 
 void AotExecutor::CopyOutputTo(int index, DLTensor* data_out) { GetOutput(index).CopyTo(data_out); }
 
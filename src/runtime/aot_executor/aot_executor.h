@@ -30,6 +30,7 @@
 #include <tvm/runtime/object.h>
 #include <tvm/runtime/packed_func.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -62,6 +63,26 @@ class TVM_DLL AotExecutor : public ModuleNode {
    */
   AotExecutor(tvm::runtime::Module module, const std::vector<Device>& devs);
 
+  /*!
+   * \brief Create another execution context of the same model.
+   *
+   * The context shares the module and the constant pool with this executor, and has its own
+   * inputs, outputs and workspace pools. Different contexts can therefore run concurrently, each
+   * used by one thread at a time.
+   * \return The new context, an AotExecutor module.
+   */
+  Module CreateContext() const;
+
+  /*! \brief The state shared by all execution contexts of a model. */
+  struct SharedState;
+
+  /*!
+   * \brief Create an execution context from the state of an existing one.
+   * \param shared The state shared with the other contexts of the model.
+   * \sa CreateContext
+   */
+  explicit AotExecutor(std::shared_ptr<const SharedState> shared);
+
   /*!
    * \brief Get the input index given the name of input.
    * \param name The name of the input.
@@ -128,17 +149,18 @@ class TVM_DLL AotExecutor : public ModuleNode {
   void CopyOutputTo(int index, DLTensor* data_out);
 
  private:
-  /*! \brief Metadata provided to the runtime from the compiler. */
-  metadata::Metadata metadata_;
+  /*! \brief Allocate the inputs, outputs and workspace pools of this context. */
+  void AllocateArgs();
 
-  /*! \brief Runtime module which contains the AOT top-level function. */
-  Module module_;
-
-  /*! \brief The devices which should be used to execute the computations. */
-  std::vector<Device> devices_;
+  /*! \brief The state shared with the other contexts of the model. */
+  std::shared_ptr<const SharedState> shared_;
 
   /*! \brief Holds one NDArray per function argument in the same order. */
   std::vector<NDArray> args_;
+
+  /*! \brief The arguments of the top-level function, which point to args_. */
+  std::vector<TVMValue> call_values_;
+  std::vector<int> call_type_codes_;
 };
 
 }  // namespace runtime
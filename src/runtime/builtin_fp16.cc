@@ -22,7 +22,21 @@
  * \brief Functions for conversion between fp32 and fp16
  */
 #include <builtin_fp16.h>
+#include <tvm/runtime/builtin_fp16.h>
 #include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/data_type.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(_MSC_VER)
+#define TVM_FP16_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define TVM_FP16_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
 
 extern "C" {
 
@@ -57,3 +71,247 @@ TVM_DLL uint16_t __truncdfhf2(double a) {
 
 #endif
 }
+
+namespace {
+
+// Scalar conversions, which also handle the tails of the vectorized loops.
+
+void FloatToHalfScalar(const float* src, uint16_t* dst, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dst[i] = __truncXfYf2__<float, uint32_t, 23, uint16_t, uint16_t, 10>(src[i]);
+  }
+}
+
+void HalfToFloatScalar(const uint16_t* src, float* dst, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    dst[i] = __extendXfYf2__<uint16_t, uint16_t, 10, float, uint32_t, 23>(src[i]);
+  }
+}
+
+void FloatToBFloat16Scalar(const float* src, uint16_t* dst, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    uint32_t bits;
+    std::memcpy(&bits, src + i, sizeof(bits));
+    if ((bits & 0x7FFFFFFFU) > 0x7F800000U) {
+      dst[i] = 0x7FC0;
+    } else {
+      uint32_t rounding_bias = ((bits >> 16) & 1) + 0x7FFFU;
+      dst[i] = static_cast<uint16_t>((bits + rounding_bias) >> 16);
+    }
+  }
+}
+
+void BFloat16ToFloatScalar(const uint16_t* src, float* dst, int64_t n) {
+  for (int64_t i = 0; i < n; ++i) {
+    uint32_t bits = static_cast<uint32_t>(src[i]) << 16;
+    std::memcpy(dst + i, &bits, sizeof(bits));
+  }
+}
+
+#if TVM_FP16_SIMD_X86
+
+__attribute__((target("avx,f16c"))) void FloatToHalfF16C(const float* src, uint16_t* dst,
+                                                         int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), half);
+  }
+  FloatToHalfScalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx,f16c"))) void HalfToFloatF16C(const uint16_t* src, float* dst,
+                                                         int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(half));
+  }
+  HalfToFloatScalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void FloatToHalfAVX512(const float* src, uint16_t* dst,
+                                                          int64_t n) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256i half = _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), half);
+  }
+  FloatToHalfScalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx512f"))) void HalfToFloatAVX512(const uint16_t* src, float* dst,
+                                                          int64_t n) {
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256i half = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(half));
+  }
+  HalfToFloatScalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) void FloatToBFloat16AVX2(const float* src, uint16_t* dst,
+                                                         int64_t n) {
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i bias = _mm256_set1_epi32(0x7FFF);
+  const __m256i abs_mask = _mm256_set1_epi32(0x7FFFFFFF);
+  const __m256i inf = _mm256_set1_epi32(0x7F800000);
+  const __m256i nan = _mm256_set1_epi32(0x7FC0);
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i bits = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i rounding_bias =
+        _mm256_add_epi32(_mm256_and_si256(_mm256_srli_epi32(bits, 16), one), bias);
+    __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, rounding_bias), 16);
+    __m256i is_nan = _mm256_cmpgt_epi32(_mm256_and_si256(bits, abs_mask), inf);
+    __m256i result = _mm256_blendv_epi8(rounded, nan, is_nan);
+    // Narrow to 16 bits, packus works within each 128-bit half so the halves are reordered.
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(result, result), 0xD8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(packed));
+  }
+  FloatToBFloat16Scalar(src + i, dst + i, n - i);
+}
+
+__attribute__((target("avx2"))) void BFloat16ToFloatAVX2(const uint16_t* src, float* dst,
+                                                         int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i bf16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m256i bits = _mm256_slli_epi32(_mm256_cvtepu16_epi32(bf16), 16);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bits);
+  }
+  BFloat16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+#elif TVM_FP16_SIMD_NEON
+
+void FloatToHalfNEON(const float* src, uint16_t* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+  }
+  FloatToHalfScalar(src + i, dst + i, n - i);
+}
+
+void HalfToFloatNEON(const uint16_t* src, float* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+  }
+  HalfToFloatScalar(src + i, dst + i, n - i);
+}
+
+void FloatToBFloat16NEON(const float* src, uint16_t* dst, int64_t n) {
+  const uint32x4_t one = vdupq_n_u32(1);
+  const uint32x4_t bias = vdupq_n_u32(0x7FFF);
+  const uint32x4_t abs_mask = vdupq_n_u32(0x7FFFFFFF);
+  const uint32x4_t inf = vdupq_n_u32(0x7F800000);
+  const uint16x4_t nan = vdup_n_u16(0x7FC0);
+  int64_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    uint32x4_t bits = vreinterpretq_u32_f32(vld1q_f32(src + i));
+    uint32x4_t rounding_bias = vaddq_u32(vandq_u32(vshrq_n_u32(bits, 16), one), bias);
+    uint16x4_t rounded = vshrn_n_u32(vaddq_u32(bits, rounding_bias), 16);
+    uint16x4_t is_nan = vmovn_u32(vcgtq_u32(vandq_u32(bits, abs_mask), inf));
+    vst1_u16(dst + i, vbsl_u16(is_nan, nan, rounded));
+  }
+  FloatToBFloat16Scalar(src + i, dst + i, n - i);
+}
+
+void BFloat16ToFloatNEON(const uint16_t* src, float* dst, int64_t n) {
+  int64_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_u32(reinterpret_cast<uint32_t*>(dst + i), vshll_n_u16(vld1_u16(src + i), 16));
+  }
+  BFloat16ToFloatScalar(src + i, dst + i, n - i);
+}
+
+#endif
+
+/*! \brief The conversion kernels selected for the CPU the runtime runs on. */
+struct ConvertKernels {
+  void (*float_to_half)(const float*, uint16_t*, int64_t) = FloatToHalfScalar;
+  void (*half_to_float)(const uint16_t*, float*, int64_t) = HalfToFloatScalar;
+  void (*float_to_bfloat16)(const float*, uint16_t*, int64_t) = FloatToBFloat16Scalar;
+  void (*bfloat16_to_float)(const uint16_t*, float*, int64_t) = BFloat16ToFloatScalar;
+
+  ConvertKernels() {
+#if TVM_FP16_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      float_to_half = FloatToHalfAVX512;
+      half_to_float = HalfToFloatAVX512;
+    } else if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c")) {
+      float_to_half = FloatToHalfF16C;
+      half_to_float = HalfToFloatF16C;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      float_to_bfloat16 = FloatToBFloat16AVX2;
+      bfloat16_to_float = BFloat16ToFloatAVX2;
+    }
+#elif TVM_FP16_SIMD_NEON
+    float_to_half = FloatToHalfNEON;
+    half_to_float = HalfToFloatNEON;
+    float_to_bfloat16 = FloatToBFloat16NEON;
+    bfloat16_to_float = BFloat16ToFloatNEON;
+#endif
+  }
+
+  static const ConvertKernels& Global() {
+    static ConvertKernels inst;
+    return inst;
+  }
+};
+
+}  // namespace
+
+extern "C" {
+
+TVM_DLL void TVMFloatToHalf(const float* src, uint16_t* dst, int64_t n) {
+  ConvertKernels::Global().float_to_half(src, dst, n);
+}
+
+TVM_DLL void TVMHalfToFloat(const uint16_t* src, float* dst, int64_t n) {
+  ConvertKernels::Global().half_to_float(src, dst, n);
+}
+
+TVM_DLL void TVMFloatToBFloat16(const float* src, uint16_t* dst, int64_t n) {
+  ConvertKernels::Global().float_to_bfloat16(src, dst, n);
+}
+
+TVM_DLL void TVMBFloat16ToFloat(const uint16_t* src, float* dst, int64_t n) {
+  ConvertKernels::Global().bfloat16_to_float(src, dst, n);
+}
+}
+
+namespace tvm {
+namespace runtime {
+
+TVM_REGISTER_GLOBAL("runtime.ConvertFloatTensor").set_body_typed([](DLTensor* from, DLTensor* to) {
+  ICHECK(from->device.device_type == kDLCPU && to->device.device_type == kDLCPU)
+      << "ConvertFloatTensor only supports CPU tensors";
+  ICHECK(IsContiguous(*from) && IsContiguous(*to))
+      << "ConvertFloatTensor only supports contiguous tensors";
+  int64_t n = GetDataSize(*from) / ((from->dtype.bits * from->dtype.lanes + 7) / 8);
+  ICHECK_EQ(n * ((to->dtype.bits * to->dtype.lanes + 7) / 8), GetDataSize(*to))
+      << "ConvertFloatTensor: the number of elements must match";
+  DataType from_dtype(from->dtype);
+  DataType to_dtype(to->dtype);
+  const void* src = static_cast<const char*>(from->data) + from->byte_offset;
+  void* dst = static_cast<char*>(to->data) + to->byte_offset;
+  if (from_dtype.is_float() && from_dtype.bits() == 32 && to_dtype.is_float16()) {
+    TVMFloatToHalf(static_cast<const float*>(src), static_cast<uint16_t*>(dst), n);
+  } else if (from_dtype.is_float16() && to_dtype.is_float() && to_dtype.bits() == 32) {
+    TVMHalfToFloat(static_cast<const uint16_t*>(src), static_cast<float*>(dst), n);
+  } else if (from_dtype.is_float() && from_dtype.bits() == 32 && to_dtype.is_bfloat16()) {
+    TVMFloatToBFloat16(static_cast<const float*>(src), static_cast<uint16_t*>(dst), n);
+  } else if (from_dtype.is_bfloat16() && to_dtype.is_float() && to_dtype.bits() == 32) {
+    TVMBFloat16ToFloat(static_cast<const uint16_t*>(src), static_cast<float*>(dst), n);
+  } else {
+    LOG(FATAL) << "ConvertFloatTensor does not support converting " << from_dtype << " to "
+               << to_dtype;
+  }
+});
+
+}  // namespace runtime
+}  // namespace tvm
@@ -0,0 +1,331 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file layout_transform.cc
+ * \brief Cache-blocked, multi-threaded kernel for layout transforms.
+ *
+ * Every layout transform between layouts such as NCHW, NHWC and NCHW[x]c, whose split factors
+ * divide each other, is a transpose of a common refined view of the tensor. For example NCHW to
+ * NCHW16c views the input as [N, C/16, 16, H, W] and permutes it with [0, 1, 3, 4, 2]. The
+ * compiler passes the view and the permutation, and the kernel reduces them to a batch of 2D
+ * transposes between the innermost source and destination dimensions.
+ */
+#include <dlpack/dlpack.h>
+#include <tvm/runtime/c_backend_api.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#define TVM_LAYOUT_TRANSFORM_SSE 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define TVM_LAYOUT_TRANSFORM_NEON 1
+#endif
+
+namespace tvm {
+namespace contrib {
+
+using namespace runtime;
+
+namespace {
+
+/*! \brief The tile size, in elements, of the 2D transposes. */
+constexpr int64_t kTile = 16;
+/*! \brief Transforms that move fewer bytes than this run on the calling thread. */
+constexpr int64_t kParallelBytes = 1 << 18;
+
+/*! \brief A dimension of the view, with its strides in elements on both sides. */
+struct ViewDim {
+  int64_t extent;
+  int64_t src_stride;
+  int64_t dst_stride;
+};
+
+/*!
+ * \brief The transform reduced to a batch of 2D copies.
+ *
+ * `batch` holds the dimensions other than the innermost source dimension `a` and the innermost
+ * destination dimension `l`. When both are the same dimension the copy is a batch of contiguous
+ * rows and `a` has an extent of one.
+ */
+struct TransposePlan {
+  std::vector<ViewDim> batch;
+  ViewDim a{1, 0, 0};
+  ViewDim l{1, 1, 1};
+  int64_t elem_bytes{0};
+  int64_t num_batch{1};
+  int64_t num_a_tiles{1};
+};
+
+/*!
+ * \brief Build the plan from the view shape and the permutation.
+ *  Unit dimensions are dropped and dimensions that stay adjacent in both layouts are merged.
+ */
+TransposePlan MakePlan(const std::vector<int64_t>& shape, const std::vector<int64_t>& perm,
+                       int64_t elem_bytes) {
+  int ndim = static_cast<int>(shape.size());
+  std::vector<int64_t> src_stride(ndim, 1);
+  for (int i = ndim - 2; i >= 0; --i) {
+    src_stride[i] = src_stride[i + 1] * shape[i + 1];
+  }
+  std::vector<ViewDim> dims(ndim);
+  int64_t dst_stride = 1;
+  for (int j = ndim - 1; j >= 0; --j) {
+    int64_t v = perm[j];
+    dims[j] = ViewDim{shape[v], src_stride[v], dst_stride};
+    dst_stride *= shape[v];
+  }
+  std::vector<ViewDim> merged;
+  for (const ViewDim& dim : dims) {
+    if (dim.extent == 1) continue;
+    if (!merged.empty() && merged.back().src_stride == dim.extent * dim.src_stride) {
+      merged.back().extent *= dim.extent;
+      merged.back().src_stride = dim.src_stride;
+      merged.back().dst_stride = dim.dst_stride;
+    } else {
+      merged.push_back(dim);
+    }
+  }
+
+  TransposePlan plan;
+  plan.elem_bytes = elem_bytes;
+  if (merged.empty()) {
+    return plan;
+  }
+  plan.l = merged.back();
+  merged.pop_back();
+  if (plan.l.src_stride != 1) {
+    auto it = std::find_if(merged.begin(), merged.end(),
+                           [](const ViewDim& dim) { return dim.src_stride == 1; });
+    ICHECK(it != merged.end()) << "LayoutTransform: the view has no contiguous source dimension";
+    plan.a = *it;
+    merged.erase(it);
+  }
+  plan.batch = std::move(merged);
+  for (const ViewDim& dim : plan.batch) {
+    plan.num_batch *= dim.extent;
+  }
+  plan.num_a_tiles = (plan.a.extent + kTile - 1) / kTile;
+  return plan;
+}
+
+/*! \brief Transpose a 4x4 block of 32-bit elements, dst[i][j] = src[j][i]. */
+inline void Transpose4x4(const uint32_t* src, int64_t src_stride, uint32_t* dst,
+                         int64_t dst_stride) {
+#if TVM_LAYOUT_TRANSFORM_SSE
+  __m128 r0 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+  __m128 r1 =
+      _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + src_stride)));
+  __m128 r2 =
+      _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * src_stride)));
+  __m128 r3 =
+      _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * src_stride)));
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_castps_si128(r0));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + dst_stride), _mm_castps_si128(r1));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * dst_stride), _mm_castps_si128(r2));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * dst_stride), _mm_castps_si128(r3));
+#elif TVM_LAYOUT_TRANSFORM_NEON
+  uint32x4x2_t t01 = vtrnq_u32(vld1q_u32(src), vld1q_u32(src + src_stride));
+  uint32x4x2_t t23 = vtrnq_u32(vld1q_u32(src + 2 * src_stride), vld1q_u32(src + 3 * src_stride));
+  vst1q_u32(dst, vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+  vst1q_u32(dst + dst_stride, vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+  vst1q_u32(dst + 2 * dst_stride,
+            vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+  vst1q_u32(dst + 3 * dst_stride,
+            vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+#else
+  for (int i = 0; i < 4; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      dst[i * dst_stride + j] = src[j * src_stride + i];
+    }
+  }
+#endif
+}
+
+/*!
+ * \brief Transpose a tile, dst[i * dst_stride + j] = src[j * src_stride + i] for i < rows and
+ *  j < cols.
+ */
+template <typename T>
+void TransposeTile(const T* src, int64_t src_stride, T* dst, int64_t dst_stride, int64_t rows,
+                   int64_t cols) {
+  int64_t i = 0;
+  if (sizeof(T) == 4) {
+    for (; i + 4 <= rows; i += 4) {
+      int64_t j = 0;
+      for (; j + 4 <= cols; j += 4) {
+        Transpose4x4(reinterpret_cast<const uint32_t*>(src + j * src_stride + i), src_stride,
+                     reinterpret_cast<uint32_t*>(dst + i * dst_stride + j), dst_stride);
+      }
+      for (; j < cols; ++j) {
+        for (int64_t k = i; k < i + 4; ++k) {
+          dst[k * dst_stride + j] = src[j * src_stride + k];
+        }
+      }
+    }
+  }
+  for (; i < rows; ++i) {
+    for (int64_t j = 0; j < cols; ++j) {
+      dst[i * dst_stride + j] = src[j * src_stride + i];
+    }
+  }
+}
+
+/*! \brief An element of a size without a native type, copied with memcpy. */
+template <int kBytes>
+struct Bytes {
+  char data[kBytes];
+};
+
+/*! \brief Run the work items in [begin, end), each of which is a batch index and an `a` tile. */
+template <typename T>
+void RunTranspose(const TransposePlan& plan, const char* src, char* dst, int64_t begin,
+                  int64_t end) {
+  const T* src_base = reinterpret_cast<const T*>(src);
+  T* dst_base = reinterpret_cast<T*>(dst);
+  for (int64_t item = begin; item < end; ++item) {
+    int64_t batch = item / plan.num_a_tiles;
+    int64_t a_begin = (item % plan.num_a_tiles) * kTile;
+    int64_t src_offset = a_begin * plan.a.src_stride;
+    int64_t dst_offset = a_begin * plan.a.dst_stride;
+    for (auto it = plan.batch.rbegin(); it != plan.batch.rend(); ++it) {
+      int64_t index = batch % it->extent;
+      batch /= it->extent;
+      src_offset += index * it->src_stride;
+      dst_offset += index * it->dst_stride;
+    }
+    const T* src_ptr = src_base + src_offset;
+    T* dst_ptr = dst_base + dst_offset;
+    if (plan.a.extent == 1) {
+      std::memcpy(dst_ptr, src_ptr, plan.l.extent * sizeof(T));
+      continue;
+    }
+    int64_t rows = std::min(kTile, plan.a.extent - a_begin);
+    for (int64_t l = 0; l < plan.l.extent; l += kTile) {
+      int64_t cols = std::min(kTile, plan.l.extent - l);
+      TransposeTile(src_ptr + l * plan.l.src_stride, plan.l.src_stride, dst_ptr + l,
+                    plan.a.dst_stride, rows, cols);
+    }
+  }
+}
+
+void RunTranspose(const TransposePlan& plan, const char* src, char* dst, int64_t begin,
+                  int64_t end) {
+  switch (plan.elem_bytes) {
+    case 1:
+      return RunTranspose<uint8_t>(plan, src, dst, begin, end);
+    case 2:
+      return RunTranspose<uint16_t>(plan, src, dst, begin, end);
+    case 4:
+      return RunTranspose<uint32_t>(plan, src, dst, begin, end);
+    case 8:
+      return RunTranspose<uint64_t>(plan, src, dst, begin, end);
+    case 16:
+      return RunTranspose<Bytes<16>>(plan, src, dst, begin, end);
+    default:
+      LOG(FATAL) << "LayoutTransform: unsupported element size " << plan.elem_bytes;
+  }
+}
+
+struct ParallelTask {
+  static int RunTask(int task_id, TVMParallelGroupEnv* penv, void* cdata) {
+    ParallelTask* task = static_cast<ParallelTask*>(cdata);
+    int64_t num_items = task->plan->num_batch * task->plan->num_a_tiles;
+    int64_t chunk = (num_items + penv->num_task - 1) / penv->num_task;
+    int64_t begin = std::min(num_items, task_id * chunk);
+    int64_t end = std::min(num_items, begin + chunk);
+    RunTranspose(*task->plan, task->src, task->dst, begin, end);
+    return 0;
+  }
+
+  const TransposePlan* plan;
+  const char* src;
+  char* dst;
+};
+
+}  // namespace
+
+/*!
+ * \brief Copy `src` into `dst` so that dst = transpose(reshape(src, shape), perm).
+ * \param src The input tensor.
+ * \param dst The output tensor, of the same dtype and number of elements.
+ * \param shape The shape of the view of `src`.
+ * \param perm The permutation of the view, dimension j of the output view is dimension
+ *  perm[j] of the input view.
+ */
+void LayoutTransform(DLTensor* src, DLTensor* dst, const std::vector<int64_t>& shape,
+                     const std::vector<int64_t>& perm) {
+  ICHECK(src->device.device_type == kDLCPU && dst->device.device_type == kDLCPU)
+      << "LayoutTransform only supports CPU tensors";
+  ICHECK(IsContiguous(*src) && IsContiguous(*dst))
+      << "LayoutTransform only supports contiguous tensors";
+  ICHECK(DataType(src->dtype) == DataType(dst->dtype))
+      << "LayoutTransform: the input and output dtypes differ";
+  ICHECK_EQ(shape.size(), perm.size());
+  int64_t elem_bytes = (src->dtype.bits * src->dtype.lanes + 7) / 8;
+  int64_t num_elems = 1;
+  std::vector<bool> seen(perm.size(), false);
+  for (size_t i = 0; i < shape.size(); ++i) {
+    num_elems *= shape[i];
+    ICHECK(perm[i] >= 0 && perm[i] < static_cast<int64_t>(perm.size()) && !seen[perm[i]])
+        << "LayoutTransform: invalid permutation";
+    seen[perm[i]] = true;
+  }
+  ICHECK_EQ(num_elems * elem_bytes, GetDataSize(*src));
+  ICHECK_EQ(num_elems * elem_bytes, GetDataSize(*dst));
+
+  TransposePlan plan = MakePlan(shape, perm, elem_bytes);
+  const char* src_data = static_cast<const char*>(src->data) + src->byte_offset;
+  char* dst_data = static_cast<char*>(dst->data) + dst->byte_offset;
+  int64_t num_items = plan.num_batch * plan.num_a_tiles;
+  if (num_elems * elem_bytes < kParallelBytes || num_items == 1) {
+    RunTranspose(plan, src_data, dst_data, 0, num_items);
+    return;
+  }
+  ParallelTask task{&plan, src_data, dst_data};
+  int ret = TVMBackendParallelLaunch(ParallelTask::RunTask, &task, 0);
+  ICHECK_EQ(ret, 0) << "LayoutTransform: TVMBackendParallelLaunch failed";
+}
+
+// Arguments: src, dst, ndim, shape[0..ndim), perm[0..ndim)
+TVM_REGISTER_GLOBAL("tvm.contrib.layout_transform.transpose")
+    .set_body([](TVMArgs args, TVMRetValue* ret) {
+      DLTensor* src = args[0];
+      DLTensor* dst = args[1];
+      int ndim = args[2];
+      ICHECK_EQ(args.num_args, 3 + 2 * ndim)
+          << "LayoutTransform: expects the view shape and the permutation";
+      std::vector<int64_t> shape(ndim), perm(ndim);
+      for (int i = 0; i < ndim; ++i) {
+        shape[i] = args[3 + i];
+        perm[i] = args[3 + ndim + i];
+      }
+      LayoutTransform(src, dst, shape, perm);
+    });
+
+}  // namespace contrib
+}  // namespace tvm
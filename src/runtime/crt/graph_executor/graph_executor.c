@@ -37,7 +37,7 @@
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 #endif  // MAX
 
-uint32_t Shape_Accumulate(int64_t* shape, uint32_t ndim) {
+uint32_t Shape_Accumulate(const int64_t* shape, uint32_t ndim) {
   int64_t accum = 1;
   uint32_t idx;
   for (idx = 0; idx < ndim; idx++) {
@@ -723,10 +723,80 @@ int TVMGraphExecutor_Load(TVMGraphExecutor* executor, JSONReader* reader) {
   return status;
 }
 
+int TVMGraphExecutor_LoadBinary(TVMGraphExecutor* executor, const void* graph, size_t graph_size) {
+  // The graph is copied into an 8-byte aligned buffer owned by the executor: the caller's buffer
+  // need not be aligned, and may be released once the executor is created, e.g. an RPC argument.
+  DLDevice dev = {kDLCPU, 0};
+  void* storage;
+  tvm_crt_error_t err = TVMPlatformMemoryAllocate(graph_size + 7, dev, &storage);
+  if (err != kTvmErrorNoError) {
+    fprintf(stderr, "memory allocate error: %08x", err);
+    return -1;
+  }
+  void* copy = (void*)(((uintptr_t)storage + 7) & ~(uintptr_t)7);
+  memcpy(copy, graph, graph_size);
+  const char* error = TVMGraphBinary_Validate(copy, graph_size);
+  if (error != NULL) {
+    fprintf(stderr, "%s\n", error);
+    TVMPlatformMemoryFree(storage, dev);
+    return -1;
+  }
+  // The graph is only read: the casts let the binary sections stand in for the arrays the JSON
+  // loader would otherwise allocate.
+  const TVMGraphBinaryHeader* header = (const TVMGraphBinaryHeader*)copy;
+  executor->graph_storage = storage;
+  executor->graph = header;
+  executor->nodes = NULL;
+  executor->nodes_count = header->num_nodes;
+  executor->input_nodes = (uint32_t*)TVMGraphBinary_ArgNodes(header);
+  executor->input_nodes_count = header->num_arg_nodes;
+  executor->node_row_ptr = (uint32_t*)TVMGraphBinary_NodeRowPtr(header);
+  executor->node_row_ptr_count = header->num_nodes + 1;
+  executor->outputs = (TVMGraphExecutorNodeEntry*)TVMGraphBinary_Heads(header);
+  executor->outputs_count = header->num_heads;
+
+  TVMGraphExecutorGraphAttr* attrs = &(executor->attrs);
+  attrs->storage_id = (uint32_t*)TVMGraphBinary_StorageId(header);
+  attrs->device_index = (uint32_t*)TVMGraphBinary_DeviceIndex(header);
+  attrs->dltype = NULL;
+  attrs->dltype_count = header->num_entries;
+  attrs->shape = NULL;
+  attrs->ndim = (uint32_t*)TVMGraphBinary_NDim(header);
+  attrs->shape_count = header->num_entries;
+  return 0;
+}
+
 uint32_t TVMGraphExecutor_GetEntryId(TVMGraphExecutor* executor, uint32_t nid, uint32_t index) {
   return executor->node_row_ptr[nid] + index;
 }
 
+/*!
+ * \brief Get the shape of a node entry.
+ * \param executor The graph executor.
+ * \param eid The node entry id.
+ * \return The shape, which holds attrs.ndim[eid] dimensions.
+ */
+static int64_t* TVMGraphExecutor_GetEntryShape(TVMGraphExecutor* executor, uint32_t eid) {
+  if (executor->graph != NULL) {
+    const int64_t* shape = TVMGraphBinary_Shape(executor->graph);
+    return (int64_t*)(shape + TVMGraphBinary_ShapeIndex(executor->graph)[eid]);
+  }
+  return executor->attrs.shape + eid * TVM_CRT_MAX_NDIM;
+}
+
+/*!
+ * \brief Get the name of a node.
+ * \param executor The graph executor.
+ * \param nid The node id.
+ * \return The name of the node.
+ */
+static const char* TVMGraphExecutor_GetNodeName(TVMGraphExecutor* executor, uint32_t nid) {
+  if (executor->graph != NULL) {
+    return TVMGraphBinary_String(executor->graph, TVMGraphBinary_Nodes(executor->graph)[nid].name);
+  }
+  return executor->nodes[nid].name;
+}
+
 /*!
  * \brief Get the number of input tensors allocated.
  * \param executor The graph executor.
@@ -747,7 +817,7 @@ int TVMGraphExecutor_GetInputIndex(TVMGraphExecutor* executor, const char* name)
   int32_t rv = -1;
   for (i = 0; i < executor->input_nodes_count; ++i) {
     uint32_t nid = executor->input_nodes[i];
-    if (!strcmp(executor->nodes[nid].name, name)) {
+    if (!strcmp(TVMGraphExecutor_GetNodeName(executor, nid), name)) {
       rv = i;
       break;
     }
@@ -934,14 +1004,19 @@ int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
   TVMGraphExecutorGraphAttr* attrs = &(executor->attrs);
   DLDataType* vtype = NULL;
   DLDevice alloc_dev = {kDLCPU, 0};
-  tvm_crt_error_t err = TVMPlatformMemoryAllocate(sizeof(DLDataType) * attrs->dltype_count,
-                                                  alloc_dev, (void**)&vtype);
-  if (err != kTvmErrorNoError) {
-    fprintf(stderr, "memory allocate error: %08x", err);
-    return -1;
-  }
-  for (idx = 0; idx < attrs->dltype_count; idx++) {
-    vtype[idx] = String2DLDataType(attrs->dltype + idx * TVM_CRT_MAX_STRLEN_DLTYPE);
+  tvm_crt_error_t err;
+  if (executor->graph != NULL) {
+    vtype = (DLDataType*)TVMGraphBinary_DLType(executor->graph);
+  } else {
+    err = TVMPlatformMemoryAllocate(sizeof(DLDataType) * attrs->dltype_count, alloc_dev,
+                                    (void**)&vtype);
+    if (err != kTvmErrorNoError) {
+      fprintf(stderr, "memory allocate error: %08x", err);
+      return -1;
+    }
+    for (idx = 0; idx < attrs->dltype_count; idx++) {
+      vtype[idx] = String2DLDataType(attrs->dltype + idx * TVM_CRT_MAX_STRLEN_DLTYPE);
+    }
   }
 
   // Size and device type of each storage pool entry.
@@ -959,7 +1034,8 @@ int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
     int storage_id = attrs->storage_id[idx];
     // Use the fallback device if no device index is available.
     int device_type = executor->devices[0].device_type;
-    uint32_t size = Shape_Accumulate(attrs->shape + idx * TVM_CRT_MAX_NDIM, attrs->ndim[idx]);
+    uint32_t size =
+        Shape_Accumulate(TVMGraphExecutor_GetEntryShape(executor, idx), attrs->ndim[idx]);
     DLDataType t = vtype[idx];
     uint32_t bits = t.bits * t.lanes;
     size_t bytes = ((bits + 7U) / 8U) * size;
@@ -995,7 +1071,7 @@ int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
         tensor->data = linked_param_data;
         tensor->device = dev;
         tensor->ndim = attrs->ndim[pit.entry_id];
-        tensor->shape = attrs->shape + idx * TVM_CRT_MAX_NDIM;
+        tensor->shape = TVMGraphExecutor_GetEntryShape(executor, pit.entry_id);
         tensor->strides = NULL;
         tensor->byte_offset = 0;
         did_find_linked_param = 1;
@@ -1028,18 +1104,20 @@ int TVMGraphExecutor_SetupStorage(TVMGraphExecutor* executor) {
     uint32_t storage_id = attrs->storage_id[idx];
     CHECK(storage_id < executor->storage_pool_count);
     int status = TVMNDArray_CreateView(&(executor->storage_pool[storage_id].array),
-                                       attrs->shape + idx * TVM_CRT_MAX_NDIM, attrs->ndim[idx],
-                                       vtype[idx], &executor->data_entry[idx]);
+                                       TVMGraphExecutor_GetEntryShape(executor, idx),
+                                       attrs->ndim[idx], vtype[idx], &executor->data_entry[idx]);
     CHECK_EQ(status, 0, "fail to create for node with idx=%d, storage_id=%u\n", idx, storage_id);
 
     TVMNDArray_IncrementReference(&executor->data_entry[idx]);
   }
 
   // Release memory
-  err = TVMPlatformMemoryFree(vtype, alloc_dev);
-  if (err != kTvmErrorNoError) {
-    fprintf(stderr, "memory free error: %08x", err);
-    return err;
+  if (executor->graph == NULL) {
+    err = TVMPlatformMemoryFree(vtype, alloc_dev);
+    if (err != kTvmErrorNoError) {
+      fprintf(stderr, "memory free error: %08x", err);
+      return err;
+    }
   }
 
   err = TVMPlatformMemoryFree(pool_entry, alloc_dev);
@@ -1063,38 +1141,62 @@ int TVMGraphExecutor_SetupOpExecs(TVMGraphExecutor* executor) {
     status = -1;
     return status;
   }
+  // Scratch parameters of binary graph nodes, which store their function name as a string offset.
+  TVMOpParam binary_param;
   for (nid = 0; nid < executor->nodes_count; nid++) {
-    const TVMGraphExecutorNode* inode = executor->nodes + nid;
-    if (strcmp(inode->op_type, "null")) {
+    const char* op_type;
+    const TVMGraphExecutorNodeEntry* inputs;
+    size_t inputs_count;
+    const TVMOpParam* param;
+    if (executor->graph != NULL) {
+      const TVMGraphBinaryNode* bnode = TVMGraphBinary_Nodes(executor->graph) + nid;
+      op_type = TVMGraphBinary_String(executor->graph, bnode->op_type);
+      inputs = (const TVMGraphExecutorNodeEntry*)TVMGraphBinary_NodeInputs(executor->graph) +
+               bnode->inputs_begin;
+      inputs_count = bnode->inputs_count;
+      snprintf(binary_param.func_name, sizeof(binary_param.func_name), "%s",
+               TVMGraphBinary_String(executor->graph, bnode->func_name));
+      binary_param.num_inputs = bnode->num_inputs;
+      binary_param.num_outputs = bnode->num_outputs;
+      binary_param.flatten_data = bnode->flatten_data;
+      param = &binary_param;
+    } else {
+      const TVMGraphExecutorNode* inode = executor->nodes + nid;
+      op_type = inode->op_type;
+      inputs = inode->inputs;
+      inputs_count = inode->inputs_count;
+      param = &(inode->param);
+    }
+    if (strcmp(op_type, "null")) {
       DLTensorPtr args[TVM_CRT_MAX_ARGS];
       uint32_t args_count = 0;
-      for (idx = 0; idx < inode->inputs_count; idx++) {
-        const TVMGraphExecutorNodeEntry* entry = inode->inputs + idx;
+      if (strcmp(op_type, "tvm_op")) {
+        fprintf(stderr, "Can only take tvm_op as op, but \"%s\" is found.\n", op_type);
+        status = -1;
+        break;
+      }
+      if (inputs_count + param->num_outputs >= TVM_CRT_MAX_ARGS) {
+        fprintf(stderr, "too many arguments: expected less than %d args, but got %d.\n",
+                TVM_CRT_MAX_ARGS, (int)(inputs_count + param->num_outputs));
+        status = -1;
+        break;
+      }
+      for (idx = 0; idx < inputs_count; idx++) {
+        const TVMGraphExecutorNodeEntry* entry = inputs + idx;
         uint32_t eid = TVMGraphExecutor_GetEntryId(executor, entry->node_id, entry->index);
         args[idx] = &(executor->data_entry[eid].dl_tensor);
         args_count++;
       }
-      for (idx = 0; idx < inode->param.num_outputs; idx++) {
+      for (idx = 0; idx < param->num_outputs; idx++) {
         uint32_t eid = TVMGraphExecutor_GetEntryId(executor, nid, idx);
         args[args_count] = &(executor->data_entry[eid].dl_tensor);
         args_count++;
       }
-      if (strcmp(inode->op_type, "tvm_op")) {
-        fprintf(stderr, "Can only take tvm_op as op, but \"%s\" is found.\n", inode->op_type);
-        status = -1;
-        break;
-      }
-      if (args_count >= TVM_CRT_MAX_ARGS) {
-        fprintf(stderr, "too many arguments: expected less than %d args, but got %d.\n",
-                TVM_CRT_MAX_ARGS, args_count);
-        status = -1;
-        break;
-      }
 #if TVM_CRT_DEBUG
-      printf("tvm_op: creating %s with node_id=%d\n", inode->param.func_name, nid);
+      printf("tvm_op: creating %s with node_id=%d\n", param->func_name, nid);
 #endif  // TVM_CRT_DEBUG
       TVMPackedFunc pf;
-      TVMGraphExecutor_CreateTVMOp(executor, &(inode->param), args, args_count, &pf);
+      TVMGraphExecutor_CreateTVMOp(executor, param, args, args_count, &pf);
       executor->op_execs[nid] = pf;
     } else {
       memset(&executor->op_execs[nid], 0, sizeof(TVMPackedFunc));
@@ -1154,7 +1256,8 @@ int32_t TVMGraphExecutor_CreateTVMOp(TVMGraphExecutor* executor, const TVMOpPara
 
 /*!
  * \brief Initialize the graph executor with graph and device.
- * \param graph_json The execution graph.
+ * \param graph_json The execution graph, either JSON or a binary graph. A binary graph is copied
+ * without being parsed, it need not outlive the executor.
  * \param module_handle The module containing the compiled functions for the host
  * processor.
  * \param devs The device of the host and devices where graph nodes will be
@@ -1163,21 +1266,32 @@ int32_t TVMGraphExecutor_CreateTVMOp(TVMGraphExecutor* executor, const TVMOpPara
  */
 int TVMGraphExecutor_Init(TVMGraphExecutor* executor, const char* graph_json,
                           TVMModuleHandle module_handle, const DLDevice* devs) {
-  JSONReader reader;
-  tvm_crt_error_t err = JSONReader_Create(graph_json, &reader);
-  if (err != kTvmErrorNoError) {
-    return -1;
-  }
+  int status;
+  if (TVMGraphBinary_IsBinary(graph_json)) {
+    // The binary graph records its own size in the header, which may not be aligned yet.
+    uint32_t total_size;
+    memcpy(&total_size, graph_json + offsetof(TVMGraphBinaryHeader, total_size),
+           sizeof(total_size));
+    status = TVMGraphExecutor_LoadBinary(executor, graph_json, total_size);
+  } else {
+    JSONReader reader;
+    tvm_crt_error_t err = JSONReader_Create(graph_json, &reader);
+    if (err != kTvmErrorNoError) {
+      return -1;
+    }
 
-  TVMGraphExecutor_Load(executor, &reader);
-  err = JSONReader_Release(&reader);
-  if (err != kTvmErrorNoError) {
-    return -1;
+    status = TVMGraphExecutor_Load(executor, &reader);
+    err = JSONReader_Release(&reader);
+    if (err != kTvmErrorNoError) {
+      return -1;
+    }
+  }
+  if (status != 0) {
+    return status;
   }
   executor->module_handle = module_handle;
   executor->devices[0] = devs[0];
 
-  int status;
   status = TVMGraphExecutor_SetupStorage(executor);
   if (status != 0) {
     return status;
@@ -1205,20 +1319,24 @@ int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
   int status = 0;
   int32_t idx;
   TVMGraphExecutor* executor = (TVMGraphExecutor*)(*pptr);
-  for (idx = 0; idx < executor->nodes_count; ++idx) {
-    status = TVMGraphExecutorNodeRelease(&(executor->nodes[idx]));
+  // The graph structure of a binary graph points into its copy rather than being allocated.
+  int owns_graph = executor->graph == NULL;
+  DLDevice dev = {kDLCPU, 0};
+  if (owns_graph) {
+    for (idx = 0; idx < executor->nodes_count; ++idx) {
+      status = TVMGraphExecutorNodeRelease(&(executor->nodes[idx]));
+      if (status != 0) {
+        return status;
+      }
+    }
+    status = TVMPlatformMemoryFree(executor->nodes, dev);
+    if (status != 0) {
+      return status;
+    }
+    status = TVMGraphExecutorGraphAttr_Release(&(executor->attrs));
     if (status != 0) {
       return status;
     }
-  }
-  DLDevice dev = {kDLCPU, 0};
-  status = TVMPlatformMemoryFree(executor->nodes, dev);
-  if (status != 0) {
-    return status;
-  }
-  status = TVMGraphExecutorGraphAttr_Release(&(executor->attrs));
-  if (status != 0) {
-    return status;
   }
   for (idx = 0; idx < executor->storage_pool_count; ++idx) {
     if (executor->storage_pool[idx].is_linked_param == 0) {
@@ -1234,17 +1352,19 @@ int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
       return status;
     }
   }
-  status = TVMPlatformMemoryFree(executor->input_nodes, dev);
-  if (status != 0) {
-    return status;
-  }
-  status = TVMPlatformMemoryFree(executor->node_row_ptr, dev);
-  if (status != 0) {
-    return status;
-  }
-  status = TVMPlatformMemoryFree(executor->outputs, dev);
-  if (status != 0) {
-    return status;
+  if (owns_graph) {
+    status = TVMPlatformMemoryFree(executor->input_nodes, dev);
+    if (status != 0) {
+      return status;
+    }
+    status = TVMPlatformMemoryFree(executor->node_row_ptr, dev);
+    if (status != 0) {
+      return status;
+    }
+    status = TVMPlatformMemoryFree(executor->outputs, dev);
+    if (status != 0) {
+      return status;
+    }
   }
   status = TVMPlatformMemoryFree(executor->storage_pool, dev);
   if (status != 0) {
@@ -1258,6 +1378,12 @@ int TVMGraphExecutor_Release(TVMGraphExecutor** pptr) {
   if (status != 0) {
     return status;
   }
+  if (executor->graph_storage != NULL) {
+    status = TVMPlatformMemoryFree(executor->graph_storage, dev);
+    if (status != 0) {
+      return status;
+    }
+  }
   status = TVMPlatformMemoryFree(*pptr, dev);
   if (status != 0) {
     return status;
@@ -24,6 +24,7 @@
  * \brief wrap graph_executor into a TVMModule for use with RPC.
  */
 
+#include <string.h>
 #include <tvm/runtime/crt/func_registry.h>
 #include <tvm/runtime/crt/graph_executor.h>
 #include <tvm/runtime/crt/graph_executor_module.h>
@@ -48,8 +49,8 @@ int32_t TVMGraphExecutorModule_Create(TVMValue* args, int* tcodes, int nargs, TV
     return kTvmErrorFunctionCallNumArguments;
   }
 
-  if (tcodes[0] != kTVMStr || tcodes[1] != kTVMModuleHandle || tcodes[2] != kTVMArgInt ||
-      tcodes[3] != kTVMArgInt) {
+  if ((tcodes[0] != kTVMStr && tcodes[0] != kTVMBytes) || tcodes[1] != kTVMModuleHandle ||
+      tcodes[2] != kTVMArgInt || tcodes[3] != kTVMArgInt) {
     return kTvmErrorFunctionCallWrongArgType;
   }
 
@@ -57,9 +58,27 @@ int32_t TVMGraphExecutorModule_Create(TVMValue* args, int* tcodes, int nargs, TV
     return kTvmErrorExecutorModuleBadContext;
   }
 
+  // A binary graph arrives as bytes, since it may contain NUL characters. The executor copies it,
+  // so it may live in the RPC arena, which is neither aligned nor kept after this call.
+  const char* graph = args[0].v_str;
+  if (tcodes[0] == kTVMBytes) {
+    const TVMByteArray* graph_bytes = (const TVMByteArray*)args[0].v_handle;
+    uint32_t total_size;
+    if (graph_bytes->size < sizeof(TVMGraphBinaryHeader) ||
+        !TVMGraphBinary_IsBinary(graph_bytes->data)) {
+      return kTvmErrorFunctionCallInvalidArg;
+    }
+    memcpy(&total_size, graph_bytes->data + offsetof(TVMGraphBinaryHeader, total_size),
+           sizeof(total_size));
+    if (total_size > graph_bytes->size) {
+      return kTvmErrorFunctionCallInvalidArg;
+    }
+    graph = graph_bytes->data;
+  }
+
   DLDevice dev = {(DLDeviceType)args[2].v_int64, (int)args[3].v_int64};
   int ret_value =
-      TVMGraphExecutor_Create(args[0].v_str, args[1].v_handle, &dev, &graph_executor.executor);
+      TVMGraphExecutor_Create(graph, args[1].v_handle, &dev, &graph_executor.executor);
   if (ret_value != 0) {
     return ret_value;
   }
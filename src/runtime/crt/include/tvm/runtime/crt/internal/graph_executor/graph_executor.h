@@ -29,6 +29,7 @@ extern "C" {
 #endif
 
 #include <tvm/runtime/crt/graph_executor.h>
+#include <tvm/runtime/crt/graph_executor_binary.h>
 #include <tvm/runtime/crt/internal/common/ndarray.h>
 #include <tvm/runtime/crt/internal/graph_executor/load_json.h>
 #include <tvm/runtime/crt/module.h>
@@ -45,8 +46,6 @@ typedef struct TVMGraphExecutorNodeEntry {
   uint32_t node_id;
   uint32_t index;
   uint32_t version;
-  // JSON Loader
-  void (*Load)(JSONReader* reader);
 } TVMGraphExecutorNodeEntry;
 
 // Storage entry.
@@ -76,6 +75,15 @@ typedef struct TVMGraphExecutorNode {
 } TVMGraphExecutorNode;
 
 typedef struct TVMGraphExecutor {
+  /*!
+   * \brief The binary graph, NULL if the graph was loaded from JSON.
+   *
+   * When set, nodes is NULL and input_nodes, node_row_ptr, outputs and the arrays in attrs point
+   * into the binary graph instead of being allocated one by one.
+   */
+  const TVMGraphBinaryHeader* graph;
+  /*! \brief The allocation holding the aligned copy of the binary graph, NULL for JSON. */
+  void* graph_storage;
   /*! \brief The graph nodes. */
   TVMGraphExecutorNode* nodes;
   /*! \brief The graph nodes counter. */
@@ -122,6 +130,7 @@ int32_t TVMGraphExecutor_CreateTVMOp(TVMGraphExecutor* executor, const TVMOpPara
                                      DLTensorPtr* args, const uint32_t args_count,
                                      TVMPackedFunc* pf);
 int TVMGraphExecutor_Load(TVMGraphExecutor* executor, JSONReader* reader);
+int TVMGraphExecutor_LoadBinary(TVMGraphExecutor* executor, const void* graph, size_t graph_size);
 
 #ifdef __cplusplus
 }
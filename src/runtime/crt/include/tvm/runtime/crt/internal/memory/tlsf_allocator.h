@@ -0,0 +1,109 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file runtime/crt/include/tvm/runtime/crt/internal/memory/tlsf_allocator.h
+ * \brief Defines data types and functions used in the TLSF memory manager.
+ *     Exposed for testing.
+ */
+
+#ifndef TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
+#define TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
+
+#include <stdint.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief log2 of the number of second-level size classes per first-level class. */
+#define TLSF_SL_INDEX_COUNT_LOG2 4
+/*! \brief Number of second-level size classes per first-level class. */
+#define TLSF_SL_INDEX_COUNT (1 << TLSF_SL_INDEX_COUNT_LOG2)
+/*!
+ * \brief Number of first-level size classes.
+ *
+ * Sizes are counted in units of the alignment; the first class holds the sizes below
+ * TLSF_SL_INDEX_COUNT units, each following class doubles the size range.
+ */
+#define TLSF_FL_INDEX_COUNT 24
+
+/*! \brief Flag of TLSFBlock::size_and_flags set when the block is free. */
+#define TLSF_BLOCK_FREE ((size_t)1)
+
+/*!
+ * \brief A block of memory in the pool. Blocks tile the pool without gaps.
+ *
+ * The allocated memory starts right after `size_and_flags`. The free list links are only
+ * present in free blocks, where they overlap the memory that is handed out when allocated.
+ */
+typedef struct TLSFBlock {
+  /*! \brief The block just before this one in memory, NULL for the first block. */
+  struct TLSFBlock* prev_phys;
+  /*! \brief Size of the block including its header, with TLSF_BLOCK_FREE in the low bit. */
+  size_t size_and_flags;
+  /*! \brief Next block in the same free list. */
+  struct TLSFBlock* next_free;
+  /*! \brief Previous block in the same free list. */
+  struct TLSFBlock* prev_free;
+} TLSFBlock;
+
+/*! \brief Size of the part of TLSFBlock present in allocated blocks. */
+#define TLSF_BLOCK_HEADER_SIZE (sizeof(TLSFBlock*) + sizeof(size_t))
+
+/*! \brief The TLSF memory manager. */
+typedef struct TLSFMemoryManager {
+  /*! \brief Public interface for this object. */
+  MemoryManagerInterface interface;
+  /*! \brief The alignment of allocations; block sizes are multiples of it. */
+  size_t alignment_bytes;
+  /*! \brief log2 of alignment_bytes. */
+  size_t alignment_bytes_log2;
+  /*! \brief The first block of the pool. */
+  TLSFBlock* first_block;
+  /*! \brief The zero-sized block marking the end of the pool, never free. */
+  TLSFBlock* sentinel;
+  /*! \brief Bit i is set when the free lists of first-level class i are not all empty. */
+  uint32_t fl_bitmap;
+  /*! \brief Bit j of entry i is set when free_lists[i][j] is not empty. */
+  uint32_t sl_bitmap[TLSF_FL_INDEX_COUNT];
+  /*! \brief The free blocks by size class. */
+  TLSFBlock* free_lists[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];
+  /*! \brief Usage statistics; largest_free_block_bytes is computed on request. */
+  MemoryManagerStats stats;
+} TLSFMemoryManager;
+
+/*!
+ * \brief Compute the size class of a block.
+ * \param mgr The memory manager.
+ * \param size_bytes Size of the block, a multiple of the alignment.
+ * \param fl Pointer to which the first-level index is written.
+ * \param sl Pointer to which the second-level index is written.
+ */
+void TLSFMemoryManager_MappingInsert(const TLSFMemoryManager* mgr, size_t size_bytes, int* fl,
+                                     int* sl);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // TVM_RUNTIME_CRT_INCLUDE_TVM_RUNTIME_CRT_INTERNAL_MEMORY_TLSF_ALLOCATOR_H_
@@ -300,6 +300,7 @@ tvm_crt_error_t PageMemoryManagerCreate(MemoryManagerInterface** interface, uint
 
   manager->interface.Allocate = PageMemoryManager_Allocate;
   manager->interface.Free = PageMemoryManager_Free;
+  manager->interface.GetStats = NULL;
   manager->ptable.memory_pool = memory_pool;
 
   /* handle PageTable member functions */
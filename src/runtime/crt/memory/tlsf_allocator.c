@@ -0,0 +1,346 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+// LINT_C_FILE
+
+/*!
+ * \file tlsf_allocator.c
+ * \brief Two-level segregated fit (TLSF) memory manager.
+ *
+ * Free blocks are kept in segregated free lists indexed by a two-level size class: the
+ * first level is the power of two of the size, the second level splits each power of two into
+ * TLSF_SL_INDEX_COUNT linear ranges. Two levels of bitmaps locate a non-empty list of large
+ * enough blocks in constant time. Freed blocks are merged with free neighbours right away.
+ *
+ * To maximize portability, thread-safe feature has been dropped for now.
+ */
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <tvm/runtime/c_runtime_api.h>
+#include <tvm/runtime/crt/error_codes.h>
+#include <tvm/runtime/crt/internal/memory/tlsf_allocator.h>
+#include <tvm/runtime/crt/logging.h>
+#include <tvm/runtime/crt/platform.h>
+
+#define TLSF_ALIGN_UP(value, alignment) (((value) + (alignment)-1) & ~((alignment)-1))
+
+static int TLSF_FindLastSet(uint32_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 31 - __builtin_clz(word);
+#else
+  int bit = -1;
+  while (word != 0) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+static int TLSF_FindFirstSet(uint32_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(word);
+#else
+  int bit = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+static size_t TLSFBlock_Size(const TLSFBlock* block) {
+  return block->size_and_flags & ~TLSF_BLOCK_FREE;
+}
+
+static bool TLSFBlock_IsFree(const TLSFBlock* block) {
+  return (block->size_and_flags & TLSF_BLOCK_FREE) != 0;
+}
+
+static TLSFBlock* TLSFBlock_Next(const TLSFBlock* block) {
+  return (TLSFBlock*)((uint8_t*)block + TLSFBlock_Size(block));  // NOLINT(*)
+}
+
+// Whether block is linked with its physical neighbours, as every block tiling the pool is.
+static bool TLSFMemoryManager_IsLinkedBlock(const TLSFMemoryManager* mgr, const TLSFBlock* block) {
+  size_t size = TLSFBlock_Size(block);
+  if (size == 0 || (size & (mgr->alignment_bytes - 1)) != 0 ||
+      size > (size_t)((uint8_t*)mgr->sentinel - (uint8_t*)block)) {
+    return false;
+  }
+  if (TLSFBlock_Next(block)->prev_phys != block) {
+    return false;
+  }
+  if (block == mgr->first_block) {
+    return block->prev_phys == NULL;
+  }
+  const TLSFBlock* prev = block->prev_phys;
+  return prev >= mgr->first_block && prev < block && TLSFBlock_Next(prev) == block;
+}
+
+void TLSFMemoryManager_MappingInsert(const TLSFMemoryManager* mgr, size_t size_bytes, int* fl,
+                                     int* sl) {
+  uint32_t units = (uint32_t)(size_bytes >> mgr->alignment_bytes_log2);
+  if (units < TLSF_SL_INDEX_COUNT) {
+    *fl = 0;
+    *sl = (int)units;
+  } else {
+    int msb = TLSF_FindLastSet(units);
+    *fl = msb - TLSF_SL_INDEX_COUNT_LOG2 + 1;
+    *sl = (int)((units >> (msb - TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT);
+  }
+}
+
+// Size class from which any free block is at least size_bytes large.
+static void TLSFMemoryManager_MappingSearch(const TLSFMemoryManager* mgr, size_t size_bytes,
+                                            int* fl, int* sl) {
+  uint32_t units = (uint32_t)(size_bytes >> mgr->alignment_bytes_log2);
+  if (units >= TLSF_SL_INDEX_COUNT) {
+    units += (1u << (TLSF_FindLastSet(units) - TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+  }
+  TLSFMemoryManager_MappingInsert(mgr, (size_t)units << mgr->alignment_bytes_log2, fl, sl);
+}
+
+static void TLSFMemoryManager_InsertFree(TLSFMemoryManager* mgr, TLSFBlock* block) {
+  int fl, sl;
+  TLSFMemoryManager_MappingInsert(mgr, TLSFBlock_Size(block), &fl, &sl);
+  TLSFBlock* head = mgr->free_lists[fl][sl];
+  block->prev_free = NULL;
+  block->next_free = head;
+  if (head != NULL) {
+    head->prev_free = block;
+  }
+  mgr->free_lists[fl][sl] = block;
+  mgr->fl_bitmap |= 1u << fl;
+  mgr->sl_bitmap[fl] |= 1u << sl;
+  mgr->stats.num_free_blocks++;
+}
+
+static void TLSFMemoryManager_RemoveFree(TLSFMemoryManager* mgr, TLSFBlock* block) {
+  int fl, sl;
+  TLSFMemoryManager_MappingInsert(mgr, TLSFBlock_Size(block), &fl, &sl);
+  if (block->prev_free != NULL) {
+    block->prev_free->next_free = block->next_free;
+  } else {
+    mgr->free_lists[fl][sl] = block->next_free;
+    if (block->next_free == NULL) {
+      mgr->sl_bitmap[fl] &= ~(1u << sl);
+      if (mgr->sl_bitmap[fl] == 0) {
+        mgr->fl_bitmap &= ~(1u << fl);
+      }
+    }
+  }
+  if (block->next_free != NULL) {
+    block->next_free->prev_free = block->prev_free;
+  }
+  mgr->stats.num_free_blocks--;
+}
+
+// Find a free block of at least size_bytes, or NULL.
+static TLSFBlock* TLSFMemoryManager_FindFree(TLSFMemoryManager* mgr, size_t size_bytes) {
+  int fl, sl;
+  TLSFMemoryManager_MappingSearch(mgr, size_bytes, &fl, &sl);
+  if (fl < TLSF_FL_INDEX_COUNT) {
+    uint32_t sl_map = mgr->sl_bitmap[fl] & (~0u << sl);
+    if (sl_map == 0) {
+      uint32_t fl_map = fl + 1 < 32 ? mgr->fl_bitmap & (~0u << (fl + 1)) : 0;
+      if (fl_map != 0) {
+        fl = TLSF_FindFirstSet(fl_map);
+        sl_map = mgr->sl_bitmap[fl];
+      }
+    }
+    if (sl_map != 0) {
+      return mgr->free_lists[fl][TLSF_FindFirstSet(sl_map)];
+    }
+  }
+  // Blocks of the size class of the request may still be large enough. They are only searched
+  // when no larger class has a free block, so the common path stays constant time.
+  TLSFMemoryManager_MappingInsert(mgr, size_bytes, &fl, &sl);
+  for (TLSFBlock* block = mgr->free_lists[fl][sl]; block != NULL; block = block->next_free) {
+    if (TLSFBlock_Size(block) >= size_bytes) {
+      return block;
+    }
+  }
+  return NULL;
+}
+
+tvm_crt_error_t TLSFMemoryManager_Allocate(MemoryManagerInterface* interface, size_t num_bytes,
+                                           DLDevice dev, void** out_ptr) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+  *out_ptr = NULL;
+  if (num_bytes == 0) {
+    num_bytes = 1;
+  }
+  if (num_bytes > mgr->stats.free_bytes) {
+    mgr->stats.num_failed_allocations++;
+    return kTvmErrorPlatformNoMemory;
+  }
+  size_t size = TLSF_ALIGN_UP(num_bytes + TLSF_BLOCK_HEADER_SIZE, mgr->alignment_bytes);
+  TLSFBlock* block = TLSFMemoryManager_FindFree(mgr, size);
+  if (block == NULL) {
+#if TVM_CRT_DEBUG > 1
+    TVMLogf("insufficient memory, size=%zu, free=%zu", size, mgr->stats.free_bytes);
+#endif
+    mgr->stats.num_failed_allocations++;
+    return kTvmErrorPlatformNoMemory;
+  }
+  TLSFMemoryManager_RemoveFree(mgr, block);
+
+  size_t block_size = TLSFBlock_Size(block);
+  if (block_size - size >= mgr->alignment_bytes) {
+    // Return the tail of the block to the free lists.
+    TLSFBlock* rest = (TLSFBlock*)((uint8_t*)block + size);  // NOLINT(*)
+    rest->prev_phys = block;
+    rest->size_and_flags = (block_size - size) | TLSF_BLOCK_FREE;
+    TLSFBlock_Next(rest)->prev_phys = rest;
+    TLSFMemoryManager_InsertFree(mgr, rest);
+    block_size = size;
+  }
+  block->size_and_flags = block_size;
+
+  mgr->stats.allocated_bytes += block_size;
+  mgr->stats.free_bytes -= block_size;
+  if (mgr->stats.allocated_bytes > mgr->stats.peak_allocated_bytes) {
+    mgr->stats.peak_allocated_bytes = mgr->stats.allocated_bytes;
+  }
+  mgr->interface.vleak_size++;
+  *out_ptr = (uint8_t*)block + TLSF_BLOCK_HEADER_SIZE;
+#if TVM_CRT_DEBUG > 1
+  TVMLogf("allocate: addr=%p, size=%zu, vleak=%d\n", *out_ptr, block_size,
+          mgr->interface.vleak_size);
+#endif
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t TLSFMemoryManager_Free(MemoryManagerInterface* interface, void* ptr,
+                                       DLDevice dev) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+  uint8_t* data = (uint8_t*)ptr;
+  // Reject pointers that cannot have been returned by Allocate.
+  if (data < (uint8_t*)mgr->first_block + TLSF_BLOCK_HEADER_SIZE ||
+      data >= (uint8_t*)mgr->sentinel ||
+      ((uintptr_t)data & (mgr->alignment_bytes - 1)) != 0) {
+    return kTvmErrorPlatformMemoryManagerBadFree;
+  }
+  TLSFBlock* block = (TLSFBlock*)(data - TLSF_BLOCK_HEADER_SIZE);  // NOLINT(*)
+  // Double frees and pointers into an allocation are detected on a best-effort basis only: the
+  // header must be marked allocated and be linked with its physical neighbours. The header of a
+  // block merged on free stays in memory; once that memory is allocated again, a matching stale
+  // header, e.g. when the same block is handed out again, cannot be told from a live block.
+  if (TLSFBlock_IsFree(block) || !TLSFMemoryManager_IsLinkedBlock(mgr, block)) {
+    return kTvmErrorPlatformMemoryManagerBadFree;
+  }
+  size_t size = TLSFBlock_Size(block);
+  mgr->stats.allocated_bytes -= size;
+  mgr->stats.free_bytes += size;
+  mgr->interface.vleak_size--;
+
+  TLSFBlock* next = TLSFBlock_Next(block);
+  if (TLSFBlock_IsFree(next)) {
+    TLSFMemoryManager_RemoveFree(mgr, next);
+    size += TLSFBlock_Size(next);
+  }
+  TLSFBlock* prev = block->prev_phys;
+  if (prev != NULL && TLSFBlock_IsFree(prev)) {
+    TLSFMemoryManager_RemoveFree(mgr, prev);
+    size += TLSFBlock_Size(prev);
+    // The header of the absorbed block stays in memory, mark it free so that freeing the same
+    // pointer again is rejected.
+    block->size_and_flags |= TLSF_BLOCK_FREE;
+    block = prev;
+  }
+  block->size_and_flags = size | TLSF_BLOCK_FREE;
+  TLSFBlock_Next(block)->prev_phys = block;
+  TLSFMemoryManager_InsertFree(mgr, block);
+#if TVM_CRT_DEBUG > 1
+  TVMLogf("release: addr=%p, vleak=%d", ptr, mgr->interface.vleak_size);
+#endif
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t TLSFMemoryManager_GetStats(MemoryManagerInterface* interface,
+                                           MemoryManagerStats* stats) {
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)interface;
+  *stats = mgr->stats;
+  stats->largest_free_block_bytes = 0;
+  if (mgr->fl_bitmap != 0) {
+    // The largest block is in the highest non-empty size class.
+    int fl = TLSF_FindLastSet(mgr->fl_bitmap);
+    int sl = TLSF_FindLastSet(mgr->sl_bitmap[fl]);
+    for (TLSFBlock* block = mgr->free_lists[fl][sl]; block != NULL; block = block->next_free) {
+      if (TLSFBlock_Size(block) > stats->largest_free_block_bytes) {
+        stats->largest_free_block_bytes = TLSFBlock_Size(block);
+      }
+    }
+  }
+  return kTvmErrorNoError;
+}
+
+tvm_crt_error_t TLSFMemoryManagerCreate(MemoryManagerInterface** interface, uint8_t* memory_pool,
+                                        size_t memory_pool_size_bytes,
+                                        size_t alignment_bytes_log2) {
+  size_t alignment_bytes = (size_t)1 << alignment_bytes_log2;
+  // Every block, including the smallest one split off, must be able to hold the free list links.
+  if (alignment_bytes < sizeof(TLSFBlock)) {
+    return kTvmErrorPlatformCheckFailure;
+  }
+  uintptr_t pool_begin = (uintptr_t)memory_pool;
+  uintptr_t pool_end = pool_begin + memory_pool_size_bytes;
+  uintptr_t mgr_begin = TLSF_ALIGN_UP(pool_begin, sizeof(void*));
+  // The first allocation starts at the first aligned address after the header of its block.
+  uintptr_t first_block =
+      TLSF_ALIGN_UP(mgr_begin + sizeof(TLSFMemoryManager) + TLSF_BLOCK_HEADER_SIZE,
+                    alignment_bytes) -
+      TLSF_BLOCK_HEADER_SIZE;
+  if (first_block + alignment_bytes + TLSF_BLOCK_HEADER_SIZE > pool_end) {
+    return kTvmErrorPlatformNoMemory;
+  }
+  size_t usable_bytes = (pool_end - TLSF_BLOCK_HEADER_SIZE - first_block) & ~(alignment_bytes - 1);
+  // Blocks must fit in the size classes.
+  size_t max_units = ((size_t)1 << (TLSF_FL_INDEX_COUNT + TLSF_SL_INDEX_COUNT_LOG2 - 1)) - 1;
+  if ((usable_bytes >> alignment_bytes_log2) > max_units) {
+    usable_bytes = max_units << alignment_bytes_log2;
+  }
+
+  TLSFMemoryManager* mgr = (TLSFMemoryManager*)mgr_begin;
+  memset(mgr, 0, sizeof(TLSFMemoryManager));
+  mgr->interface.Allocate = TLSFMemoryManager_Allocate;
+  mgr->interface.Free = TLSFMemoryManager_Free;
+  mgr->interface.GetStats = TLSFMemoryManager_GetStats;
+  mgr->interface.vleak_size = 0;
+  mgr->alignment_bytes = alignment_bytes;
+  mgr->alignment_bytes_log2 = alignment_bytes_log2;
+
+  mgr->first_block = (TLSFBlock*)first_block;
+  mgr->first_block->prev_phys = NULL;
+  mgr->first_block->size_and_flags = usable_bytes | TLSF_BLOCK_FREE;
+  mgr->sentinel = TLSFBlock_Next(mgr->first_block);
+  mgr->sentinel->prev_phys = mgr->first_block;
+  mgr->sentinel->size_and_flags = 0;
+  TLSFMemoryManager_InsertFree(mgr, mgr->first_block);
+
+  mgr->stats.total_bytes = usable_bytes;
+  mgr->stats.free_bytes = usable_bytes;
+  *interface = &mgr->interface;
+  return kTvmErrorNoError;
+}
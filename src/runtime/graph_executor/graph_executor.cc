@@ -24,6 +24,7 @@
 
 #include <tvm/runtime/container/map.h>
 #include <tvm/runtime/container/string.h>
+#include <tvm/runtime/crt/graph_executor_binary.h>
 #include <tvm/runtime/data_type.h>
 #include <tvm/runtime/device_api.h>
 #include <tvm/runtime/ndarray.h>
@@ -33,6 +34,7 @@
 #include <tvm/runtime/serializer.h>
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <numeric>
@@ -42,6 +44,7 @@
 #include <vector>
 
 #include "../file_utils.h"
+#include "../library_module.h"
 #include "../texture.h"
 
 namespace tvm {
@@ -67,7 +70,7 @@ void GraphExecutor::Run() {
 
 /*!
  * \brief Initialize the graph executor with graph and device.
- * \param graph_json The execution graph.
+ * \param graph_json The execution graph, either in JSON or in the binary graph format.
  * \param module The module containing the compiled functions for the host
  * processor.
  * \param devs The devices of the host and devices where graph nodes will be
@@ -77,9 +80,14 @@ void GraphExecutor::Run() {
 void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module module,
                          const std::vector<Device>& devs,
                          const PackedFunc lookup_linked_param_func) {
-  std::istringstream is(graph_json);
-  dmlc::JSONReader reader(&is);
-  this->Load(&reader);
+  if (graph_json.size() >= sizeof(TVMGraphBinaryHeader) &&
+      TVMGraphBinary_IsBinary(graph_json.data())) {
+    this->LoadBinary(graph_json);
+  } else {
+    std::istringstream is(graph_json);
+    dmlc::JSONReader reader(&is);
+    this->Load(&reader);
+  }
   module_ = module;
   devices_ = devs;
   lookup_linked_param_ = lookup_linked_param_func;
@@ -103,6 +111,69 @@ void GraphExecutor::Init(const std::string& graph_json, tvm::runtime::Module mod
   }
 }
 
+void GraphExecutor::LoadBinary(const std::string& graph) {
+  // The sections of a binary graph are 8-byte aligned relative to an 8-byte aligned start.
+  std::vector<uint64_t> buffer((graph.size() + 7) / 8);
+  std::memcpy(buffer.data(), graph.data(), graph.size());
+  const char* error = TVMGraphBinary_Validate(buffer.data(), graph.size());
+  ICHECK(error == nullptr) << "Invalid binary graph: " << error;
+  const auto* header = reinterpret_cast<const TVMGraphBinaryHeader*>(buffer.data());
+
+  auto make_entry = [](const TVMGraphBinaryNodeEntry& entry) {
+    return NodeEntry{entry.node_id, entry.index, entry.version};
+  };
+  const TVMGraphBinaryNode* nodes = TVMGraphBinary_Nodes(header);
+  const TVMGraphBinaryNodeEntry* node_inputs = TVMGraphBinary_NodeInputs(header);
+  nodes_.resize(header->num_nodes);
+  for (uint32_t nid = 0; nid < header->num_nodes; ++nid) {
+    const TVMGraphBinaryNode& src = nodes[nid];
+    Node& node = nodes_[nid];
+    node.op_type = TVMGraphBinary_String(header, src.op_type);
+    node.name = TVMGraphBinary_String(header, src.name);
+    node.param.func_name = TVMGraphBinary_String(header, src.func_name);
+    node.param.num_inputs = src.num_inputs;
+    node.param.num_outputs = src.num_outputs;
+    node.param.flatten_data = src.flatten_data;
+    node.inputs.clear();
+    for (uint32_t i = 0; i < src.inputs_count; ++i) {
+      node.inputs.push_back(make_entry(node_inputs[src.inputs_begin + i]));
+    }
+  }
+  const uint32_t* arg_nodes = TVMGraphBinary_ArgNodes(header);
+  input_nodes_.assign(arg_nodes, arg_nodes + header->num_arg_nodes);
+  const uint32_t* node_row_ptr = TVMGraphBinary_NodeRowPtr(header);
+  node_row_ptr_.assign(node_row_ptr, node_row_ptr + header->num_nodes + 1);
+  const TVMGraphBinaryNodeEntry* heads = TVMGraphBinary_Heads(header);
+  outputs_.clear();
+  for (uint32_t i = 0; i < header->num_heads; ++i) {
+    outputs_.push_back(make_entry(heads[i]));
+  }
+
+  uint32_t num_entries = header->num_entries;
+  const uint32_t* storage_id = TVMGraphBinary_StorageId(header);
+  attrs_.storage_id.assign(storage_id, storage_id + num_entries);
+  attrs_.device_index.clear();
+  if (const uint32_t* device_index = TVMGraphBinary_DeviceIndex(header)) {
+    attrs_.device_index.assign(device_index, device_index + num_entries);
+  }
+  attrs_.storage_scope.clear();
+  if (const uint32_t* storage_scope = TVMGraphBinary_StorageScope(header)) {
+    for (uint32_t i = 0; i < num_entries; ++i) {
+      attrs_.storage_scope.push_back(TVMGraphBinary_String(header, storage_scope[i]));
+    }
+  }
+  const DLDataType* dltype = TVMGraphBinary_DLType(header);
+  const uint32_t* ndim = TVMGraphBinary_NDim(header);
+  const uint32_t* shape_index = TVMGraphBinary_ShapeIndex(header);
+  const int64_t* shape = TVMGraphBinary_Shape(header);
+  attrs_.dltype.resize(num_entries);
+  attrs_.shape.resize(num_entries);
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    attrs_.dltype[i] = DLDataType2String(dltype[i]);
+    attrs_.shape[i].assign(shape + shape_index[i], shape + shape_index[i] + ndim[i]);
+  }
+}
+
 /*!
  * \brief Get the input index given the name of input.
  * \param name The name of the input.
@@ -465,6 +536,7 @@ void GraphExecutor::SetupStorage() {
 
 void GraphExecutor::SetupOpExecs() {
   op_execs_.resize(this->GetNumOfNodes());
+  num_direct_call_ops_ = 0;
   input_dltensors_.resize(num_node_entries());
   output_dltensors_.resize(num_node_entries());
   both_output_opinput_dltensors_.resize(num_node_entries());
@@ -562,6 +634,19 @@ std::pair<std::function<void()>, std::shared_ptr<GraphExecutor::OpArgs>> GraphEx
   tvm::runtime::PackedFunc pf = module_.GetFunction(param.func_name, true);
   ICHECK(pf != nullptr) << "no such function in module: " << param.func_name;
 
+  // All the arguments are DLTensors, so a kernel taking only handles can be called through its
+  // direct-call entry, which skips the construction of TVMArgs and the checks of type codes.
+  // The entry stays valid as long as module_ is alive.
+  std::string signature;
+  TVMBackendPackedCFunc faddr = GetDirectCallFunc(module_, param.func_name, &signature);
+  if (faddr != nullptr && signature == std::string(arg_ptr->arg_values.size(), 'h')) {
+    auto fexec = [arg_ptr, faddr]() {
+      CallDirect(faddr, arg_ptr->arg_values.data(), static_cast<int>(arg_ptr->arg_values.size()));
+    };
+    ++num_direct_call_ops_;
+    return {fexec, arg_ptr};
+  }
+
   auto fexec = [arg_ptr, pf]() {
     TVMRetValue rv;
     TVMArgs targs(arg_ptr->arg_values.data(), arg_ptr->arg_tcodes.data(),
@@ -627,6 +712,10 @@ PackedFunc GraphExecutor::GetFunction(const std::string& name,
   } else if (name == "get_num_inputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { *rv = this->NumInputs(); });
+  } else if (name == "get_num_direct_call_ops") {
+    return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) {
+      *rv = this->num_direct_call_ops_;
+    });
   } else if (name == "run") {
     return PackedFunc([sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { this->Run(); });
   } else if (name == "run_from_inputs") {
@@ -407,6 +407,12 @@ class TVM_DLL GraphExecutor : public ModuleNode {
     }
     ICHECK_EQ(bitmask, 1 | 2 | 4 | 8 | 16) << "invalid format";
   }
+  /*!
+   * \brief Load the graph from the binary encoding described in
+   *  tvm/runtime/crt/graph_executor_binary.h, which fills the same fields as the JSON loader.
+   * \param graph The binary graph.
+   */
+  void LoadBinary(const std::string& graph);
   /*! \brief PackedFunc to lookup a linked paramter from a local Module. */
   void DefaultLookupLinkedParam(TVMArgs args, TVMRetValue* rv);
   /*! \brief Delete NDArray::Container with linked (i.e. static) data. */
@@ -469,6 +475,8 @@ class TVM_DLL GraphExecutor : public ModuleNode {
   std::vector<size_t> data_alignment_;
   /*! \brief Operator on each node. */
   std::vector<std::function<void()>> op_execs_;
+  /*! \brief The number of operators calling their kernel through its direct-call entry. */
+  int num_direct_call_ops_ = 0;
   /*! \brief Linked parameter lookup function. */
   PackedFunc lookup_linked_param_;
   /*! \brief Module's _lookup_linked_param function, used by DefaultLookupLinkedParam. */
@@ -27,6 +27,7 @@
 #include <tvm/runtime/module.h>
 #include <tvm/runtime/registry.h>
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -44,6 +45,12 @@ class LibraryModuleNode final : public ModuleNode {
 
   PackedFunc GetFunction(const std::string& name, const ObjectPtr<Object>& sptr_to_self) final {
     TVMBackendPackedCFunc faddr;
+    const std::string query_prefix = runtime::symbol::tvm_direct_call_query_prefix;
+    if (name.compare(0, query_prefix.size(), query_prefix) == 0) {
+      return MakeDirectCallQuery(
+          name.substr(query_prefix.size()),
+          [this](const char* symbol) { return lib_->GetSymbol(symbol); }, sptr_to_self);
+    }
     if (name == runtime::symbol::tvm_module_main) {
       const char* entry_name =
           reinterpret_cast<const char*>(lib_->GetSymbol(runtime::symbol::tvm_module_main));
@@ -84,6 +91,37 @@ PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>&
   });
 }
 
+/*! \brief The direct-call entry returned by the query function. */
+struct DirectCallInfo {
+  TVMBackendPackedCFunc faddr;
+  const char* signature;
+};
+
+PackedFunc MakeDirectCallQuery(const std::string& name,
+                               const std::function<void*(const char*)>& fgetsymbol,
+                               const ObjectPtr<Object>& sptr_to_self) {
+  DirectCallInfo info;
+  info.faddr = reinterpret_cast<TVMBackendPackedCFunc>(fgetsymbol(name.c_str()));
+  info.signature = reinterpret_cast<const char*>(
+      fgetsymbol((runtime::symbol::tvm_direct_call_signature_prefix + name).c_str()));
+  if (info.faddr == nullptr || info.signature == nullptr) return PackedFunc();
+  auto pinfo = std::make_shared<DirectCallInfo>(info);
+  return PackedFunc([pinfo, sptr_to_self](TVMArgs args, TVMRetValue* rv) {
+    *rv = static_cast<void*>(pinfo.get());
+  });
+}
+
+TVMBackendPackedCFunc GetDirectCallFunc(Module mod, const std::string& name,
+                                        std::string* signature) {
+  PackedFunc query =
+      mod.GetFunction(runtime::symbol::tvm_direct_call_query_prefix + name, /*query_imports=*/true);
+  if (query == nullptr) return nullptr;
+  void* handle = query();
+  const auto* info = static_cast<const DirectCallInfo*>(handle);
+  *signature = info->signature;
+  return info->faddr;
+}
+
 void InitContextFunctions(std::function<void*(const char*)> fgetsymbol) {
 #define TVM_INIT_CONTEXT_FUNC(FuncName)                                                \
   if (auto* fp = reinterpret_cast<decltype(&FuncName)*>(fgetsymbol("__" #FuncName))) { \
@@ -72,6 +72,47 @@ class Library : public Object {
  */
 PackedFunc WrapPackedFunc(TVMBackendPackedCFunc faddr, const ObjectPtr<Object>& mptr);
 
+/*!
+ * \brief Create the query function of the direct-call entry of a compiled function.
+ *
+ * Functions lowered to the packed API export their direct-call signature, see
+ * tir::attr::kDirectCallSignature. Such functions can be called with a null array of type
+ * codes, which skips the checks of the type codes and the construction of TVMArgs.
+ *
+ * \param name The name of the function.
+ * \param fgetsymbol A symbol lookup function of the library containing the function.
+ * \param mptr The module pointer node.
+ * \return The query function used by GetDirectCallFunc, nullptr if the function
+ *  or its signature is not found.
+ */
+PackedFunc MakeDirectCallQuery(const std::string& name,
+                               const std::function<void*(const char*)>& fgetsymbol,
+                               const ObjectPtr<Object>& mptr);
+
+/*!
+ * \brief Get the direct-call entry of a compiled function.
+ * \param mod The module, whose imports are looked up as well.
+ * \param name The name of the function.
+ * \param signature The signature of the function, one character per argument.
+ * \return The function address, nullptr if the function does not have a direct-call entry.
+ * \note The address is only valid while the module is alive.
+ */
+TVMBackendPackedCFunc GetDirectCallFunc(Module mod, const std::string& name,
+                                        std::string* signature);
+
+/*!
+ * \brief Call a function through its direct-call entry.
+ * \param faddr The function address returned by GetDirectCallFunc.
+ * \param args The argument values, where DLTensor arguments are passed as DLTensor*.
+ * \param num_args The number of arguments.
+ */
+inline void CallDirect(TVMBackendPackedCFunc faddr, TVMValue* args, int num_args) {
+  TVMValue ret_value;
+  int ret_type_code = kTVMNullptr;
+  int ret = (*faddr)(args, nullptr, num_args, &ret_value, &ret_type_code, nullptr);
+  ICHECK_EQ(ret, 0) << TVMGetLastError();
+}
+
 /*!
  * \brief Utility to initialize conext function symbols during startup
  * \param fgetsymbol A symbol lookup function.
@@ -0,0 +1,339 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * \file src/runtime/object_pool.cc
+ * \brief Thread-caching size-class pool backing PooledObjAllocator.
+ */
+#include <tvm/runtime/logging.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/registry.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+/*! \brief The granularity of the size classes. */
+constexpr size_t kSizeClassStep = kObjectPoolAlignment;
+/*! \brief Allocations larger than this go to operator new directly. */
+constexpr size_t kMaxPooledSize = 1024;
+constexpr size_t kNumSizeClasses = kMaxPooledSize / kSizeClassStep;
+/*! \brief The size of the chunks the shared pool carves blocks from. */
+constexpr size_t kChunkSize = 64 * 1024;
+
+inline size_t SizeClassOf(size_t size) { return (std::max<size_t>(size, 1) - 1) / kSizeClassStep; }
+
+inline size_t BlockSizeOf(size_t size_class) { return (size_class + 1) * kSizeClassStep; }
+
+/*! \brief The number of blocks moved between a thread cache and the shared pool at once. */
+inline size_t BatchSizeOf(size_t size_class) {
+  return std::clamp<size_t>(kChunkSize / 16 / BlockSizeOf(size_class), 4, 64);
+}
+
+inline void* LargeAlloc(size_t size) {
+  return ::operator new(size, std::align_val_t(kObjectPoolAlignment));
+}
+
+inline void LargeFree(void* ptr) { ::operator delete(ptr, std::align_val_t(kObjectPoolAlignment)); }
+
+/*! \brief Whether the pool is enabled, i.e. TVM_OBJECT_POOL is not set to 0. */
+bool PoolEnabled() {
+  static const bool enabled = [] {
+    const char* val = getenv("TVM_OBJECT_POOL");
+    return val == nullptr || std::strcmp(val, "0") != 0;
+  }();
+  return enabled;
+}
+
+/*! \brief A free block, linked through its first bytes. */
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+/*! \brief Counters of one size class, each only written by the owning thread. */
+struct SizeClassCounters {
+  std::atomic<uint64_t> num_allocs{0};
+  std::atomic<uint64_t> num_frees{0};
+  std::atomic<uint64_t> num_refills{0};
+};
+
+/*! \brief Increment a counter that has a single writer without a locked instruction. */
+inline void Bump(std::atomic<uint64_t>* counter) {
+  counter->store(counter->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+class ThreadCache;
+
+/*! \brief The pool shared by all threads. Its memory is never returned to the system. */
+class SharedPool {
+ public:
+  static SharedPool* Global() {
+    // Leaked on purpose, objects may be freed during static destruction.
+    static SharedPool* inst = new SharedPool();
+    return inst;
+  }
+
+  /*! \brief Fetch up to \p n blocks of \p size_class, carving a new chunk if none are free. */
+  FreeBlock* Fetch(size_t size_class, size_t n, size_t* num_fetched) {
+    SizeClass& sc = classes_[size_class];
+    std::lock_guard<std::mutex> lock(sc.mutex);
+    if (sc.head == nullptr) {
+      Carve(size_class, &sc);
+    }
+    FreeBlock* head = sc.head;
+    FreeBlock* tail = head;
+    size_t count = 1;
+    while (count < n && tail->next != nullptr) {
+      tail = tail->next;
+      ++count;
+    }
+    sc.head = tail->next;
+    sc.num_free -= count;
+    tail->next = nullptr;
+    *num_fetched = count;
+    return head;
+  }
+
+  /*! \brief Return a list of \p n blocks of \p size_class. */
+  void Release(size_t size_class, FreeBlock* head, FreeBlock* tail, size_t n) {
+    SizeClass& sc = classes_[size_class];
+    std::lock_guard<std::mutex> lock(sc.mutex);
+    tail->next = sc.head;
+    sc.head = head;
+    sc.num_free += n;
+  }
+
+  void Register(ThreadCache* cache) {
+    std::lock_guard<std::mutex> lock(caches_mutex_);
+    caches_.insert(cache);
+  }
+
+  /*! \brief Unregister a thread cache, keeping its counters. */
+  void Retire(ThreadCache* cache);
+
+  /*! \brief Render the statistics of the pool as a JSON string. */
+  std::string StatsJSON();
+
+  /*! \brief Counters of the allocations bypassing the size classes. */
+  std::atomic<uint64_t> num_large_allocs{0};
+  std::atomic<uint64_t> num_large_frees{0};
+
+ private:
+  struct SizeClass {
+    std::mutex mutex;
+    FreeBlock* head{nullptr};
+    size_t num_free{0};
+    size_t num_reserved{0};
+  };
+
+  void Carve(size_t size_class, SizeClass* sc) {
+    size_t block_size = BlockSizeOf(size_class);
+    size_t num_blocks = kChunkSize / block_size;
+    char* chunk = static_cast<char*>(LargeAlloc(num_blocks * block_size));
+    for (size_t i = num_blocks; i > 0; --i) {
+      FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * block_size);
+      block->next = sc->head;
+      sc->head = block;
+    }
+    sc->num_free += num_blocks;
+    sc->num_reserved += num_blocks;
+  }
+
+  SizeClass classes_[kNumSizeClasses];
+  std::mutex caches_mutex_;
+  /*! \brief The caches of the live threads. */
+  std::unordered_set<ThreadCache*> caches_;
+  /*! \brief The counters of the exited threads. */
+  uint64_t retired_[kNumSizeClasses][3] = {};
+};
+
+/*! \brief Per-thread free lists of each size class. */
+class ThreadCache {
+ public:
+  ThreadCache() { SharedPool::Global()->Register(this); }
+
+  ~ThreadCache() {
+    for (size_t i = 0; i < kNumSizeClasses; ++i) {
+      Drain(i, num_free_[i]);
+    }
+    SharedPool::Global()->Retire(this);
+    destroyed_ = true;
+  }
+
+  void* Alloc(size_t size_class) {
+    if (heads_[size_class] == nullptr) {
+      size_t n = 0;
+      heads_[size_class] = SharedPool::Global()->Fetch(size_class, BatchSizeOf(size_class), &n);
+      num_free_[size_class] = n;
+      Bump(&counters_[size_class].num_refills);
+    }
+    FreeBlock* block = heads_[size_class];
+    heads_[size_class] = block->next;
+    --num_free_[size_class];
+    Bump(&counters_[size_class].num_allocs);
+    return block;
+  }
+
+  void Free(void* ptr, size_t size_class) {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = heads_[size_class];
+    heads_[size_class] = block;
+    Bump(&counters_[size_class].num_frees);
+    size_t batch = BatchSizeOf(size_class);
+    if (++num_free_[size_class] > 4 * batch) {
+      Drain(size_class, 2 * batch);
+    }
+  }
+
+  /*! \brief Whether the cache of this thread has been destroyed at thread exit. */
+  static bool Destroyed() { return destroyed_; }
+
+  static ThreadCache* Get() {
+    static thread_local ThreadCache cache;
+    return &cache;
+  }
+
+  const SizeClassCounters& counters(size_t size_class) const { return counters_[size_class]; }
+
+ private:
+  /*! \brief Return the first \p n cached blocks of \p size_class to the shared pool. */
+  void Drain(size_t size_class, size_t n) {
+    if (n == 0) {
+      return;
+    }
+    FreeBlock* head = heads_[size_class];
+    FreeBlock* tail = head;
+    for (size_t i = 1; i < n; ++i) {
+      tail = tail->next;
+    }
+    heads_[size_class] = tail->next;
+    num_free_[size_class] -= n;
+    SharedPool::Global()->Release(size_class, head, tail, n);
+  }
+
+  FreeBlock* heads_[kNumSizeClasses] = {};
+  size_t num_free_[kNumSizeClasses] = {};
+  SizeClassCounters counters_[kNumSizeClasses];
+  // Trivially destructible, so it stays valid after the cache itself is destroyed.
+  static thread_local bool destroyed_;
+};
+
+thread_local bool ThreadCache::destroyed_ = false;
+
+void SharedPool::Retire(ThreadCache* cache) {
+  std::lock_guard<std::mutex> lock(caches_mutex_);
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    const SizeClassCounters& counters = cache->counters(i);
+    retired_[i][0] += counters.num_allocs.load(std::memory_order_relaxed);
+    retired_[i][1] += counters.num_frees.load(std::memory_order_relaxed);
+    retired_[i][2] += counters.num_refills.load(std::memory_order_relaxed);
+  }
+  caches_.erase(cache);
+}
+
+std::string SharedPool::StatsJSON() {
+  uint64_t totals[kNumSizeClasses][3];
+  {
+    std::lock_guard<std::mutex> lock(caches_mutex_);
+    std::memcpy(totals, retired_, sizeof(totals));
+    for (ThreadCache* cache : caches_) {
+      for (size_t i = 0; i < kNumSizeClasses; ++i) {
+        const SizeClassCounters& counters = cache->counters(i);
+        totals[i][0] += counters.num_allocs.load(std::memory_order_relaxed);
+        totals[i][1] += counters.num_frees.load(std::memory_order_relaxed);
+        totals[i][2] += counters.num_refills.load(std::memory_order_relaxed);
+      }
+    }
+  }
+  std::ostringstream os;
+  uint64_t bytes_reserved = 0;
+  os << "{\"enabled\": " << (PoolEnabled() ? "true" : "false")
+     << ", \"num_large_allocs\": " << num_large_allocs.load()
+     << ", \"num_large_frees\": " << num_large_frees.load() << ", \"size_classes\": [";
+  bool first = true;
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    size_t num_reserved, num_free;
+    {
+      std::lock_guard<std::mutex> lock(classes_[i].mutex);
+      num_reserved = classes_[i].num_reserved;
+      num_free = classes_[i].num_free;
+    }
+    if (num_reserved == 0) {
+      continue;
+    }
+    bytes_reserved += num_reserved * BlockSizeOf(i);
+    os << (first ? "" : ", ") << "{\"block_size\": " << BlockSizeOf(i)
+       << ", \"num_allocs\": " << totals[i][0] << ", \"num_frees\": " << totals[i][1]
+       << ", \"num_refills\": " << totals[i][2] << ", \"num_reserved\": " << num_reserved
+       << ", \"num_free_shared\": " << num_free << "}";
+    first = false;
+  }
+  os << "], \"bytes_reserved\": " << bytes_reserved << "}";
+  return os.str();
+}
+
+}  // namespace
+
+namespace detail {
+
+void* ObjectPoolAlloc(size_t size) {
+  if (size > kMaxPooledSize || !PoolEnabled()) {
+    SharedPool::Global()->num_large_allocs.fetch_add(1, std::memory_order_relaxed);
+    return LargeAlloc(size);
+  }
+  size_t size_class = SizeClassOf(size);
+  if (ThreadCache::Destroyed()) {
+    size_t n = 0;
+    return SharedPool::Global()->Fetch(size_class, 1, &n);
+  }
+  return ThreadCache::Get()->Alloc(size_class);
+}
+
+void ObjectPoolFree(void* ptr, size_t size) {
+  if (size > kMaxPooledSize || !PoolEnabled()) {
+    SharedPool::Global()->num_large_frees.fetch_add(1, std::memory_order_relaxed);
+    LargeFree(ptr);
+    return;
+  }
+  size_t size_class = SizeClassOf(size);
+  if (ThreadCache::Destroyed()) {
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    SharedPool::Global()->Release(size_class, block, block, 1);
+    return;
+  }
+  ThreadCache::Get()->Free(ptr, size_class);
+}
+
+}  // namespace detail
+
+TVM_REGISTER_GLOBAL("runtime.ObjectPoolStats").set_body_typed([]() {
+  return String(SharedPool::Global()->StatsJSON());
+});
+
+}  // namespace runtime
+}  // namespace tvm
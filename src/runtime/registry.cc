@@ -27,8 +27,10 @@
 #include <tvm/runtime/registry.h>
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <string_view>
 #include <unordered_map>
 
 #include "runtime_base.h"
@@ -37,6 +39,25 @@ namespace tvm {
 namespace runtime {
 
 struct Registry::Manager {
+  /*!
+   * \brief An immutable copy of fmap that is read without holding the mutex.
+   *  The keys refer to the names owned by the entries, which are never freed.
+   */
+  struct Snapshot {
+    /*! \brief The version of fmap this snapshot was taken from. */
+    uint64_t version;
+    /*! \brief The functions by name. */
+    std::unordered_map<std::string_view, Registry*> fmap;
+  };
+
+  /*! \brief The snapshot used by the current thread. */
+  struct ThreadSnapshot {
+    std::shared_ptr<const Snapshot> snapshot;
+    ~ThreadSnapshot() { destroyed = true; }
+    // Lookups from the destructors of other thread locals or statics fall back to the mutex.
+    static thread_local bool destroyed;
+  };
+
   // map storing the functions.
   // We deliberately used raw pointer.
   // This is because PackedFunc can contain callbacks into the host language (Python) and the
@@ -45,6 +66,14 @@ struct Registry::Manager {
   std::unordered_map<std::string, Registry*> fmap;
   // mutex
   std::mutex mutex;
+  // The version of fmap, bumped under the mutex on every change.
+  std::atomic<uint64_t> version{1};
+  // The latest snapshot of fmap, nullptr if it has to be rebuilt. Guarded by the mutex.
+  std::shared_ptr<const Snapshot> snapshot;
+  // Whether lookups are counted.
+  std::atomic<bool> count_lookups{false};
+  // The number of lookups of names that are not registered. Guarded by the mutex.
+  std::unordered_map<std::string, uint64_t> miss_counts;
 
   Manager() {}
 
@@ -55,8 +84,61 @@ struct Registry::Manager {
     static Manager* inst = new Manager();
     return inst;
   }
+
+  // Publish a change of fmap, must be called with the mutex held.
+  void Updated() {
+    snapshot = nullptr;
+    version.fetch_add(1, std::memory_order_release);
+  }
+
+  // Get the snapshot of the current thread, rebuilding it if fmap has changed since.
+  const Snapshot* GetSnapshot() {
+    static thread_local ThreadSnapshot local;
+    if (ThreadSnapshot::destroyed) return nullptr;
+    if (local.snapshot == nullptr ||
+        local.snapshot->version != version.load(std::memory_order_acquire)) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (snapshot == nullptr) {
+        auto fresh = std::make_shared<Snapshot>();
+        fresh->version = version.load(std::memory_order_relaxed);
+        fresh->fmap.reserve(fmap.size());
+        for (const auto& kv : fmap) {
+          fresh->fmap.emplace(kv.second->name_, kv.second);
+        }
+        snapshot = std::move(fresh);
+      }
+      local.snapshot = snapshot;
+    }
+    return local.snapshot.get();
+  }
+
+  Registry* Lookup(const std::string& name) {
+    Registry* r = nullptr;
+    if (const Snapshot* s = GetSnapshot()) {
+      auto it = s->fmap.find(name);
+      if (it != s->fmap.end()) r = it->second;
+    } else {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = fmap.find(name);
+      if (it != fmap.end()) r = it->second;
+    }
+    CountLookup(name, r);
+    return r;
+  }
+
+  void CountLookup(const std::string& name, Registry* r) {
+    if (!count_lookups.load(std::memory_order_relaxed)) return;
+    if (r != nullptr) {
+      r->num_lookups_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++miss_counts[name];
+    }
+  }
 };
 
+thread_local bool Registry::Manager::ThreadSnapshot::destroyed = false;
+
 Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
   func_ = f;
   return *this;
@@ -65,13 +147,16 @@ Registry& Registry::set_body(PackedFunc f) {  // NOLINT(*)
 Registry& Registry::Register(const std::string& name, bool can_override) {  // NOLINT(*)
   Manager* m = Manager::Global();
   std::lock_guard<std::mutex> lock(m->mutex);
-  if (m->fmap.count(name)) {
+  auto it = m->fmap.find(name);
+  if (it != m->fmap.end()) {
     ICHECK(can_override) << "Global PackedFunc " << name << " is already registered";
+    it->second->active_.store(false, std::memory_order_release);
   }
 
   Registry* r = new Registry();
   r->name_ = name;
   m->fmap[name] = r;
+  m->Updated();
   return *r;
 }
 
@@ -80,16 +165,37 @@ bool Registry::Remove(const std::string& name) {
   std::lock_guard<std::mutex> lock(m->mutex);
   auto it = m->fmap.find(name);
   if (it == m->fmap.end()) return false;
+  it->second->active_.store(false, std::memory_order_release);
   m->fmap.erase(it);
+  m->Updated();
   return true;
 }
 
 const PackedFunc* Registry::Get(const std::string& name) {
+  Registry* r = Manager::Global()->Lookup(name);
+  return r != nullptr ? &(r->func_) : nullptr;
+}
+
+const PackedFunc* Registry::Handle::Get() const {
   Manager* m = Manager::Global();
-  std::lock_guard<std::mutex> lock(m->mutex);
-  auto it = m->fmap.find(name);
-  if (it == m->fmap.end()) return nullptr;
-  return &(it->second->func_);
+  Registry* r = entry_.load(std::memory_order_acquire);
+  if (r != nullptr && r->active_.load(std::memory_order_acquire)) {
+    m->CountLookup(name_, r);
+    return &(r->func_);
+  }
+  // Read the version before the lookup, so that a registration racing with it is not missed.
+  uint64_t version = m->version.load(std::memory_order_acquire);
+  if (r == nullptr && miss_version_.load(std::memory_order_acquire) == version) {
+    m->CountLookup(name_, nullptr);
+    return nullptr;
+  }
+  r = m->Lookup(name_);
+  entry_.store(r, std::memory_order_release);
+  if (r == nullptr) {
+    miss_version_.store(version, std::memory_order_release);
+    return nullptr;
+  }
+  return &(r->func_);
 }
 
 std::vector<std::string> Registry::ListNames() {
@@ -103,6 +209,30 @@ std::vector<std::string> Registry::ListNames() {
   return keys;
 }
 
+void Registry::SetLookupCounting(bool enable) {
+  Manager* m = Manager::Global();
+  std::lock_guard<std::mutex> lock(m->mutex);
+  if (enable) {
+    for (const auto& kv : m->fmap) {
+      kv.second->num_lookups_.store(0, std::memory_order_relaxed);
+    }
+    m->miss_counts.clear();
+  }
+  m->count_lookups.store(enable, std::memory_order_relaxed);
+}
+
+std::vector<std::pair<std::string, uint64_t>> Registry::LookupCounts() {
+  Manager* m = Manager::Global();
+  std::lock_guard<std::mutex> lock(m->mutex);
+  // A name can have both hits and misses when it is registered after being looked up.
+  std::unordered_map<std::string, uint64_t> counts = m->miss_counts;
+  for (const auto& kv : m->fmap) {
+    uint64_t count = kv.second->num_lookups_.load(std::memory_order_relaxed);
+    if (count != 0) counts[kv.first] += count;
+  }
+  return std::vector<std::pair<std::string, uint64_t>>(counts.begin(), counts.end());
+}
+
 /*!
  * \brief Execution environment specific API registry.
  *
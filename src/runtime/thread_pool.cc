@@ -467,6 +467,14 @@ TVM_DLL void Configure(tvm::runtime::threading::ThreadGroup::AffinityMode mode,
 #endif
 }
 int32_t NumThreads() { return tvm::runtime::ThreadPool::ThreadLocal()->NumThreads(); }
+void SetNumThreads(int nthreads) {
+#if !TVM_THREADPOOL_USE_OPENMP
+  tvm::runtime::ThreadPool::ThreadLocal()->UpdateWorkerConfiguration(
+      tvm::runtime::threading::ThreadGroup::kBig, nthreads, {});
+#else
+  omp_set_num_threads(nthreads > 0 ? nthreads : MaxConcurrency());
+#endif
+}
 }  // namespace threading
 }  // namespace runtime
 }  // namespace tvm
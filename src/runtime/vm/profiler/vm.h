@@ -51,8 +51,10 @@ class VirtualMachineDebug : public VirtualMachine {
  private:
   void InvokePacked(Index packed_index, const PackedFunc& func, Index arg_count, Index output_size,
                     const std::vector<ObjectRef>& args) final;
-  void OpStartHook(Instruction instr) final;
+  void OpStartHook(const Instruction& instr) final;
   void OpStopHook() final;
+  /*! \brief The profiler is not thread safe, so packed calls run in order while profiling. */
+  bool AllowConcurrentPackedCalls() const final { return !(prof_ && prof_->IsRunning()); }
 
   std::unordered_map<Index, std::string> packed_index_map_;
   std::optional<profiling::Profiler> prof_;
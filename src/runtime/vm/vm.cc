@@ -29,15 +29,24 @@
 #include <tvm/runtime/logging.h>
 #include <tvm/runtime/memory.h>
 #include <tvm/runtime/object.h>
+#include <tvm/runtime/threading_backend.h>
 #include <tvm/runtime/vm/vm.h>
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "../file_utils.h"
+#include "../library_module.h"
 
 using namespace tvm::runtime;
 
@@ -124,7 +133,7 @@ std::vector<int64_t> ToShape(NDArray shape_tensor) {
   return shape;
 }
 
-void VirtualMachine::OpStartHook(Instruction instr) {}
+void VirtualMachine::OpStartHook(const Instruction& instr) {}
 void VirtualMachine::OpStopHook() {}
 
 PackedFunc VirtualMachine::GetFunction(const std::string& name,
@@ -137,7 +146,9 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
       auto git = exec_->global_map.find(func_name);
       ICHECK(git != exec_->global_map.end())
           << "Cannot find function " << func_name << " in the executable";
-      auto func = exec_->functions[git->second];
+      // Refer to the function in the executable rather than a copy, instructions are looked up by
+      // address for the concurrent packed calls.
+      const auto& func = exec_->functions[git->second];
       if (func.params.empty()) {
         *rv = Invoke(func, {});
       } else {
@@ -202,6 +213,11 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
         return 1;
       }
     });
+  } else if (name == "get_num_direct_call_funcs") {
+    return TypedPackedFunc<int64_t(void)>([sptr_to_self, this]() -> int64_t {
+      return std::count_if(direct_funcs_.begin(), direct_funcs_.end(),
+                           [](TVMBackendPackedCFunc faddr) { return faddr != nullptr; });
+    });
   } else if (name == "get_input_index") {
     return TypedPackedFunc<int64_t(std::string, std::string)>(
         [this](std::string input_name, std::string func_name) {
@@ -235,6 +251,9 @@ PackedFunc VirtualMachine::GetFunction(const std::string& name,
   } else if (name == "set_outputs") {
     return PackedFunc(
         [sptr_to_self, this](TVMArgs args, TVMRetValue* rv) { SetOutputs(args[0], args); });
+  } else if (name == "set_packed_concurrency") {
+    return TypedPackedFunc<void(int)>(
+        [sptr_to_self, this](int num_threads) { SetPackedConcurrency(num_threads); });
   } else if (name == "load_late_bound_consts") {
     return PackedFunc([this](TVMArgs args, TVMRetValue* rv) {
       CHECK_EQ(args.size(), 1);
@@ -426,8 +445,11 @@ void VirtualMachine::InvokeGlobal(const VMFunction& func, const std::vector<Obje
 }
 
 ObjectRef VirtualMachine::Invoke(const VMFunction& func, const std::vector<ObjectRef>& args) {
+  // A packed function run by this VM may invoke it again, the outer run then resumes at its pc.
+  Index pc = pc_;
   PrintInfoAndSetInputArgs(func, args);
   RunLoop();
+  pc_ = pc;
   return return_register_;
 }
 
@@ -442,9 +464,11 @@ ObjectRef VirtualMachine::Invoke(const std::string& name, const std::vector<Obje
 
 ObjectRef VirtualMachine::Invoke(const VMFunction& func, const std::vector<ObjectRef>& input_args,
                                  const std::vector<ObjectRef>& output_args) {
+  Index pc = pc_;
   PrintInfoAndSetInputArgs(func, input_args);
   SetOutputTensorsToRegister(func.name, output_args);
   RunLoop(output_tensor_reg_indices_[func.name]);
+  pc_ = pc;
   return return_register_;
 }
 
@@ -459,9 +483,22 @@ void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, In
     }
   }
 
-  std::vector<TVMValue> values(arity);
-  std::vector<int> codes(arity);
-  runtime::TVMArgsSetter setter(values.data(), codes.data());
+  // Most kernels take a few arguments, which are kept on the stack to avoid two heap allocations
+  // per kernel.
+  constexpr size_t kNumStackArgs = 16;
+  TVMValue stack_values[kNumStackArgs];
+  int stack_codes[kNumStackArgs];
+  std::vector<TVMValue> heap_values;
+  std::vector<int> heap_codes;
+  TVMValue* values = stack_values;
+  int* codes = stack_codes;
+  if (arity > kNumStackArgs) {
+    heap_values.resize(arity);
+    heap_codes.resize(arity);
+    values = heap_values.data();
+    codes = heap_codes.data();
+  }
+  runtime::TVMArgsSetter setter(values, codes);
   int idx = 0;
   bool is_empty_output = false;
   for (Index i = 0; i < arg_count; i++) {
@@ -487,10 +524,285 @@ void VirtualMachine::InvokePacked(Index packed_index, const PackedFunc& func, In
     }
   }
 
-  if (!is_empty_output) {
+  if (is_empty_output) {
+    return;
+  }
+  if (static_cast<size_t>(packed_index) < direct_funcs_.size() &&
+      direct_funcs_[packed_index] != nullptr && func.same_as(packed_funcs_[packed_index])) {
+    CallDirect(direct_funcs_[packed_index], values, static_cast<int>(arity));
+  } else {
     TVMRetValue rv;
-    func.CallPacked(TVMArgs(values.data(), codes.data(), arity), &rv);
+    func.CallPacked(TVMArgs(values, codes, arity), &rv);
+  }
+}
+
+/*!
+ * \brief A fixed set of threads running the independent packed calls of the VM.
+ *
+ * The calls are run as whole tasks, the kernels keep using the TVM thread pool of the thread
+ * that runs them for their own parallel loops. Each of these pools is limited to a share of the
+ * cores so that the concurrent kernels do not oversubscribe them, the calling thread only waits
+ * and keeps its own pool for the other kernels.
+ */
+class PackedCallPool {
+ public:
+  /*! \param num_threads The number of threads running the calls. */
+  explicit PackedCallPool(int num_threads) {
+    int kernel_threads = std::max(1, threading::MaxConcurrency() / num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this, kernel_threads]() {
+        threading::SetNumThreads(kernel_threads);
+        this->WorkerLoop();
+      });
+    }
+  }
+
+  ~PackedCallPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  /*! \return The number of threads running the calls. */
+  int num_threads() const { return static_cast<int>(threads_.size()); }
+
+  /*!
+   * \brief Run the tasks on the pool, and wait for all of them.
+   * The first exception in task order is rethrown.
+   */
+  void Run(int num_tasks, const std::function<void(int)>& ftask) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ftask_ = &ftask;
+      num_tasks_ = num_tasks;
+      next_task_ = 0;
+      num_pending_ = num_tasks;
+      errors_.assign(num_tasks, nullptr);
+      ++generation_;
+    }
+    wake_.notify_all();
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this]() { return num_pending_ == 0; });
+      ftask_ = nullptr;
+    }
+    for (const std::exception_ptr& error : errors_) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+ private:
+  void WorkerLoop() {
+    uint64_t seen_generation = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&]() { return stop_ || generation_ != seen_generation; });
+        if (stop_) {
+          return;
+        }
+        seen_generation = generation_;
+      }
+      RunTasks(seen_generation);
+    }
+  }
+
+  void RunTasks(uint64_t generation) {
+    while (true) {
+      int task_id;
+      const std::function<void(int)>* ftask;
+      {
+        // Claim the task under the lock, so that a late worker never runs a task of a newer job.
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (generation_ != generation || next_task_ >= num_tasks_) {
+          return;
+        }
+        task_id = next_task_++;
+        ftask = ftask_;
+      }
+      try {
+        (*ftask)(task_id);
+      } catch (...) {
+        errors_[task_id] = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--num_pending_ == 0) {
+        done_.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  bool stop_{false};
+  uint64_t generation_{0};
+  const std::function<void(int)>* ftask_{nullptr};
+  int num_tasks_{0};
+  int next_task_{0};
+  int num_pending_{0};
+  std::vector<std::exception_ptr> errors_;
+};
+
+void VirtualMachine::SetPackedConcurrency(int num_threads) {
+  if (num_threads <= 0) {
+    num_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  packed_concurrency_ = num_threads;
+  if (packed_call_pool_ && packed_call_pool_->num_threads() != num_threads) {
+    packed_call_pool_.reset();
+  }
+}
+
+void VirtualMachine::AnalyzeConcurrentPackedCalls() {
+  concurrent_packed_calls_.clear();
+  for (const VMFunction& func : exec_->functions) {
+    const std::vector<Instruction>& code = func.instructions;
+    size_t pc = 0;
+    while (pc < code.size()) {
+      if (code[pc].op != Opcode::InvokePacked) {
+        ++pc;
+        continue;
+      }
+      // Grow a group of packed calls which do not depend on each other. The calls of a group are
+      // deferred until its last call, so the allocations in between are effectively hoisted
+      // above the earlier calls of the group.
+      std::unordered_set<RegName> read, written;
+      std::vector<size_t> calls;
+      for (size_t i = pc; i < code.size(); ++i) {
+        const Instruction& instr = code[i];
+        if (instr.op == Opcode::InvokePacked) {
+          Index num_inputs = instr.arity - instr.output_size;
+          bool independent = true;
+          for (Index j = 0; j < instr.arity; ++j) {
+            RegName reg = instr.packed_args[j];
+            independent &= !written.count(reg) && (j < num_inputs || !read.count(reg));
+          }
+          if (!independent) {
+            break;
+          }
+          for (Index j = 0; j < instr.arity; ++j) {
+            (j < num_inputs ? read : written).insert(instr.packed_args[j]);
+          }
+          calls.push_back(i);
+        } else if (instr.op == Opcode::AllocStorage || instr.op == Opcode::AllocTensor) {
+          std::vector<RegName> uses;
+          if (instr.op == Opcode::AllocStorage) {
+            uses = {instr.alloc_storage.allocation_size};
+          } else {
+            uses = {instr.alloc_tensor.storage, instr.alloc_tensor.offset};
+          }
+          bool hoistable = !read.count(instr.dst) && !written.count(instr.dst);
+          for (RegName reg : uses) {
+            hoistable &= !written.count(reg);
+          }
+          if (!hoistable) {
+            break;
+          }
+        } else {
+          break;
+        }
+      }
+      if (calls.size() > 1) {
+        for (size_t i : calls) {
+          concurrent_packed_calls_[&code[i]] = i == calls.back();
+        }
+      }
+      pc = calls.back() + 1;
+    }
+  }
+}
+
+void VirtualMachine::DeferPackedCall(const Instruction& instr, bool is_last) {
+  std::vector<ObjectRef> args;
+  args.reserve(instr.arity);
+  for (Index i = 0; i < instr.arity; ++i) {
+    args.push_back(ReadRegister(instr.packed_args[i]));
+  }
+  deferred_packed_calls_.emplace_back(&instr, std::move(args));
+  if (is_last) {
+    RunDeferredPackedCalls();
+  }
+}
+
+void VirtualMachine::RunDeferredPackedCalls() {
+  std::vector<std::pair<const Instruction*, std::vector<ObjectRef>>> calls;
+  std::swap(calls, deferred_packed_calls_);
+
+  // The registers of the calls are independent, but different tensors may still share memory.
+  // Only run the calls concurrently when every tensor is on the host and no call writes memory
+  // accessed by another call, otherwise run them in order.
+  struct ByteRange {
+    const char* begin;
+    const char* end;
+    size_t call;
+    bool is_output;
+  };
+  std::vector<ByteRange> ranges;
+  bool concurrent = true;
+  for (size_t c = 0; c < calls.size() && concurrent; ++c) {
+    const Instruction& instr = *calls[c].first;
+    Index num_inputs = instr.arity - instr.output_size;
+    auto add_range = [&](const ObjectRef& obj, bool is_output) {
+      const auto* tensor = obj.as<NDArray::ContainerType>();
+      if (tensor == nullptr || tensor->dl_tensor.device.device_type != kDLCPU) {
+        concurrent = false;
+        return;
+      }
+      const char* begin =
+          static_cast<const char*>(tensor->dl_tensor.data) + tensor->dl_tensor.byte_offset;
+      ranges.push_back({begin, begin + GetDataSize(tensor->dl_tensor), c, is_output});
+    };
+    for (Index i = 0; i < instr.arity; ++i) {
+      const ObjectRef& arg = calls[c].second[i];
+      if (const auto* adt = arg.as<ADTObj>()) {
+        for (size_t fi = 0; fi < adt->size; ++fi) {
+          add_range((*adt)[fi], i >= num_inputs);
+        }
+      } else {
+        add_range(arg, i >= num_inputs);
+      }
+    }
+  }
+  for (const ByteRange& out : ranges) {
+    if (!concurrent) {
+      break;
+    }
+    if (!out.is_output) {
+      continue;
+    }
+    for (const ByteRange& other : ranges) {
+      if (other.call != out.call && out.begin < other.end && other.begin < out.end) {
+        concurrent = false;
+        break;
+      }
+    }
+  }
+
+  auto invoke = [&](int c) {
+    const Instruction& instr = *calls[c].first;
+    InvokePacked(instr.packed_index, packed_funcs_[instr.packed_index], instr.arity,
+                 instr.output_size, calls[c].second);
+  };
+  if (!concurrent) {
+    for (size_t c = 0; c < calls.size(); ++c) {
+      invoke(c);
+    }
+    return;
   }
+  if (!packed_call_pool_) {
+    packed_call_pool_ = std::make_shared<PackedCallPool>(packed_concurrency_);
+  }
+  VLOG(2) << "Running " << calls.size() << " independent packed calls concurrently";
+  packed_call_pool_->Run(static_cast<int>(calls.size()), invoke);
 }
 
 void VirtualMachine::LoadExecutable(const ObjectPtr<Executable>& exec) {
@@ -514,10 +826,28 @@ void VirtualMachine::LoadExecutable(const ObjectPtr<Executable>& exec) {
     tvm::runtime::PackedFunc pf = lib.GetFunction(packed_name, /*query_imports=*/true);
     ICHECK(pf != nullptr) << "Cannot find function in module: " << packed_name;
     packed_funcs_[packed_index] = pf;
+    // The arguments of InvokePacked are always tensors, the entry is valid as long as exec_ is.
+    if (direct_funcs_.size() <= packed_index) {
+      direct_funcs_.resize(packed_index + 1, nullptr);
+    }
+    std::string signature;
+    TVMBackendPackedCFunc faddr = GetDirectCallFunc(lib, packed_name, &signature);
+    bool all_handles =
+        std::all_of(signature.begin(), signature.end(), [](char c) { return c == 'h'; });
+    direct_funcs_[packed_index] = all_handles ? faddr : nullptr;
   }
   for (size_t i = 0; i < packed_funcs_.size(); ++i) {
     ICHECK(packed_funcs_[i] != nullptr) << "Packed function " << i << " is not initialized";
   }
+  // Validate the opcodes once so that the dispatch loop can index its jump table directly.
+  for (const VMFunction& func : exec_->functions) {
+    for (const Instruction& instr : func.instructions) {
+      ICHECK_LE(static_cast<size_t>(instr.op), static_cast<size_t>(Opcode::KillRegister))
+          << "Unknown instruction opcode " << static_cast<int>(instr.op) << " in function "
+          << func.name;
+    }
+  }
+  AnalyzeConcurrentPackedCalls();
 }
 
 void VirtualMachine::Init(const std::vector<Device>& physical_devices,
@@ -552,12 +882,13 @@ inline void VirtualMachine::WriteRegister(Index r, const ObjectRef& val) {
   frames_.back().register_file[r] = val;
 }
 
-ObjectRef VirtualMachine::ReadRegister(Index r) const { return frames_.back().register_file[r]; }
+const ObjectRef& VirtualMachine::ReadRegister(Index r) const {
+  return frames_.back().register_file[r];
+}
 
 int64_t VirtualMachine::LoadScalarInt(Index r) const {
   int64_t result = 0;
-  const auto& obj = ReadRegister(r);
-  NDArray array = Downcast<NDArray>(CopyTo(obj, GetDevice(exec_->host_device_index)));
+  NDArray array = Downcast<NDArray>(CopyTo(ReadRegister(r), GetDevice(exec_->host_device_index)));
 
   switch (array->dtype.bits) {
     case 1: {
@@ -624,106 +955,168 @@ std::vector<Index> VirtualMachine::GetOutputTensorRegIndices() {
   return reg_indices;
 }
 
+/*
+ * With computed goto, every handler ends with its own indirect jump to the next handler
+ * (threaded dispatch), which is much easier for the branch predictor than a single shared
+ * switch. The opcodes are validated once in LoadExecutable, so the dispatch needs no range
+ * check. Other compilers fall back to the switch.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define TVM_VM_USE_COMPUTED_GOTO 1
+#else
+#define TVM_VM_USE_COMPUTED_GOTO 0
+#endif
+
+#if TVM_VM_USE_COMPUTED_GOTO
+#define TVM_VM_OP(name) op_##name:
+#define TVM_VM_DISPATCH()                                     \
+  {                                                           \
+    VLOG(2) << "Executing(" << pc_ << "): " << code_[pc_];    \
+    goto* kDispatchTable[static_cast<size_t>(code_[pc_].op)]; \
+  }
+#else
+#define TVM_VM_OP(name) case Opcode::name:
+#define TVM_VM_DISPATCH() goto main_loop
+#endif
+
 void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices) {
   ICHECK(this->exec_);
   ICHECK(this->code_);
   pc_ = 0;
   Index frame_start = frames_.size();
+  // Drop the calls left behind by an earlier run which did not complete.
+  deferred_packed_calls_.clear();
+#if TVM_VM_USE_COMPUTED_GOTO
+  // Must be kept in the order of Opcode.
+  static void* const kDispatchTable[] = {
+      &&op_Move,          &&op_Ret,          &&op_Invoke,         &&op_InvokeClosure,
+      &&op_InvokePacked,  &&op_AllocTensor,  &&op_AllocTensorReg, &&op_AllocADT,
+      &&op_AllocClosure,  &&op_GetField,     &&op_If,             &&op_LoadConst,
+      &&op_Goto,          &&op_GetTag,       &&op_LoadConsti,     &&op_Fatal,
+      &&op_AllocStorage,  &&op_ShapeOf,      &&op_ReshapeTensor,  &&op_DeviceCopy,
+      &&op_KillRegister,
+  };
+  static_assert(sizeof(kDispatchTable) / sizeof(kDispatchTable[0]) ==
+                    static_cast<size_t>(Opcode::KillRegister) + 1,
+                "The dispatch table must cover all opcodes");
+  while (true) {
+    TVM_VM_DISPATCH();
+    {
+#else
   while (true) {
   main_loop:
-    auto const& instr = code_[this->pc_];
-    VLOG(2) << "Executing(" << pc_ << "): " << instr;
-
-    switch (instr.op) {
-      case Opcode::Move: {
-        ObjectRef from_obj;
-        from_obj = ReadRegister(instr.from);
-        WriteRegister(instr.dst, from_obj);
+    VLOG(2) << "Executing(" << pc_ << "): " << code_[pc_];
+    switch (code_[pc_].op) {
+#endif
+      TVM_VM_OP(Move) {
+        const Instruction& instr = code_[pc_];
+        WriteRegister(instr.dst, ReadRegister(instr.from));
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::Fatal: {
-        throw std::runtime_error("VM encountered fatal error");
-      }
-      case Opcode::LoadConst: {
+      TVM_VM_OP(Fatal) { throw std::runtime_error("VM encountered fatal error"); }
+      TVM_VM_OP(LoadConst) {
+        const Instruction& instr = code_[pc_];
         bool is_not_cached = const_pool_.size() <= static_cast<size_t>(instr.const_index) ||
                              !const_pool_[instr.const_index].defined();
         if (is_not_cached) {
           OpStartHook(instr);
-        }
-        auto constant_obj = exec_->constants[instr.const_index];
-        // We cache the allocated object in the constant pool. To measure, the
-        // first iteration will set the pool up. The other iterations will
-        // directly reuse the allocated objects.
-        if (const_pool_.size() <= static_cast<size_t>(instr.const_index)) {
-          const_pool_.resize(instr.const_index + 1);
-        }
-
-        if (!const_pool_[instr.const_index].defined()) {
+          // We cache the allocated object in the constant pool. To measure, the
+          // first iteration will set the pool up. The other iterations will
+          // directly reuse the allocated objects.
+          if (const_pool_.size() <= static_cast<size_t>(instr.const_index)) {
+            const_pool_.resize(instr.const_index + 1);
+          }
           Device dev = GetDevice(exec_->const_device_indexes[instr.const_index]);
-          const_pool_[instr.const_index] = CopyTo(constant_obj, dev);
+          const_pool_[instr.const_index] = CopyTo(exec_->constants[instr.const_index], dev);
         }
         WriteRegister(instr.dst, const_pool_[instr.const_index]);
         if (is_not_cached) {
           OpStopHook();
         }
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::LoadConsti: {
+      TVM_VM_OP(LoadConsti) {
+        const Instruction& instr = code_[pc_];
         auto tensor = NDArray::Empty({1}, {kDLInt, 64, 1}, GetDevice(exec_->host_device_index));
         reinterpret_cast<int64_t*>(tensor->data)[0] = instr.load_consti.val;
         WriteRegister(instr.dst, tensor);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::Invoke: {
+      TVM_VM_OP(Invoke) {
+        const Instruction& instr = code_[pc_];
         std::vector<ObjectRef> args;
+        args.reserve(instr.num_args);
         for (Index i = 0; i < instr.num_args; ++i) {
           args.push_back(ReadRegister(instr.invoke_args_registers[i]));
         }
         InvokeGlobal(exec_->functions[instr.func_index], args);
         frames_.back().caller_return_register = instr.dst;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::InvokePacked: {
+      TVM_VM_OP(InvokePacked) {
+        const Instruction& instr = code_[pc_];
+        if (packed_concurrency_ > 1 && AllowConcurrentPackedCalls()) {
+          auto it = concurrent_packed_calls_.find(&instr);
+          if (it != concurrent_packed_calls_.end()) {
+            DeferPackedCall(instr, /*is_last=*/it->second);
+            pc_++;
+            TVM_VM_DISPATCH();
+          }
+        }
         ICHECK_LE(instr.packed_index, packed_funcs_.size());
         const auto& func = packed_funcs_[instr.packed_index];
         const auto& arity = instr.arity;
-        std::vector<ObjectRef> args;
+        // The argument list is reused across calls to avoid a heap allocation per kernel. A nested
+        // invocation of this VM from the kernel uses the list of the next level.
+        if (packed_call_depth_ == packed_args_scratch_.size()) {
+          packed_args_scratch_.emplace_back();
+        }
+        std::vector<ObjectRef>& args = packed_args_scratch_[packed_call_depth_];
+        args.clear();
         for (Index i = 0; i < arity; ++i) {
-          auto arg = ReadRegister(instr.packed_args[i]);
-          args.push_back(arg);
+          args.push_back(ReadRegister(instr.packed_args[i]));
 #if TVM_LOG_DEBUG
-          if (i < arity) {
-            const bool is_input = i < arity - instr.output_size;
-            VLOG(2) << (is_input ? "input" : "placeholder") << " arg " << i << " = "
-                    << RuntimeObject2String(arg, GetDevice(exec_->host_device_index),
-                                            /*show_contents=*/is_input);
-          }
+          const bool is_input = i < arity - instr.output_size;
+          VLOG(2) << (is_input ? "input" : "placeholder") << " arg " << i << " = "
+                  << RuntimeObject2String(args.back(), GetDevice(exec_->host_device_index),
+                                          /*show_contents=*/is_input);
 #endif
         }
 
         // We no longer need to write the registers back, we write directly
         // through the registers mutably.
-        InvokePacked(instr.packed_index, func, arity, instr.output_size, args);
+        {
+          ++packed_call_depth_;
+          struct DepthGuard {
+            size_t* depth;
+            ~DepthGuard() { --*depth; }
+          } guard{&packed_call_depth_};
+          InvokePacked(instr.packed_index, func, arity, instr.output_size, args);
+        }
+        args.clear();
 
 #if TVM_LOG_DEBUG
         for (Index i = arity - instr.output_size; i < arity; ++i) {
-          auto arg = ReadRegister(instr.packed_args[i]);
           VLOG(2) << "output arg " << i << " = "
-                  << RuntimeObject2String(arg, GetDevice(exec_->host_device_index));
+                  << RuntimeObject2String(ReadRegister(instr.packed_args[i]),
+                                          GetDevice(exec_->host_device_index));
         }
 #endif
 
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::InvokeClosure: {
-        auto object = ReadRegister(instr.closure);
+      TVM_VM_OP(InvokeClosure) {
+        const Instruction& instr = code_[pc_];
+        // Hold the closure by value, the register file may move when the new frame is pushed.
+        ObjectRef object = ReadRegister(instr.closure);
         const auto* closure = object.as<VMClosureObj>();
         ICHECK(closure);
         std::vector<ObjectRef> args;
+        args.reserve(closure->free_vars.size() + instr.num_closure_args);
         for (auto free_var : closure->free_vars) {
           args.push_back(free_var);
         }
@@ -732,31 +1125,34 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         }
         InvokeGlobal(exec_->functions[closure->func_index], args);
         frames_.back().caller_return_register = instr.dst;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::GetField: {
-        auto object = ReadRegister(instr.object);
-        const auto& tuple = Downcast<ADT>(object);
-        auto field = tuple[instr.field_index];
+      TVM_VM_OP(GetField) {
+        const Instruction& instr = code_[pc_];
+        const auto* tuple = ReadRegister(instr.object).as<ADTObj>();
+        ICHECK(tuple) << "GetField expects an ADT";
+        ObjectRef field = (*tuple)[instr.field_index];
         WriteRegister(instr.dst, field);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::GetTag: {
-        auto object = ReadRegister(instr.get_tag.object);
-        const auto& adt = Downcast<ADT>(object);
-        auto tag = adt.tag();
+      TVM_VM_OP(GetTag) {
+        const Instruction& instr = code_[pc_];
+        const auto* adt = ReadRegister(instr.get_tag.object).as<ADTObj>();
+        ICHECK(adt) << "GetTag expects an ADT";
+        auto tag = adt->tag;
         auto tag_tensor = NDArray::Empty({1}, {kDLInt, 32, 1}, GetDevice(exec_->host_device_index));
         reinterpret_cast<int32_t*>(tag_tensor->data)[0] = tag;
         WriteRegister(instr.dst, tag_tensor);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::Goto: {
-        pc_ += instr.pc_offset;
-        goto main_loop;
+      TVM_VM_OP(Goto) {
+        pc_ += code_[pc_].pc_offset;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::If: {
+      TVM_VM_OP(If) {
+        const Instruction& instr = code_[pc_];
         int32_t test_val = LoadScalarInt(instr.if_op.test);
         int32_t target_val = LoadScalarInt(instr.if_op.target);
 
@@ -768,9 +1164,10 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
           pc_ += instr.if_op.false_offset;
         }
 
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocTensor: {
+      TVM_VM_OP(AllocTensor) {
+        const Instruction& instr = code_[pc_];
         OpStartHook(instr);
         if (!output_tensor_reg_indices.empty() && FindIndex(output_tensor_reg_indices, instr.dst)) {
           WriteAllocatedTensorFromOutside(instr);
@@ -779,16 +1176,16 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         }
         OpStopHook();
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocTensorReg: {
+      TVM_VM_OP(AllocTensorReg) {
+        const Instruction& instr = code_[pc_];
         OpStartHook(instr);
         Device cpu_dev = GetDevice(exec_->host_device_index);
-        auto shape_obj = ReadRegister(instr.alloc_tensor_reg.shape_register);
-        NDArray shape_tensor = Downcast<NDArray>(CopyTo(shape_obj, cpu_dev));
+        NDArray shape_tensor =
+            Downcast<NDArray>(CopyTo(ReadRegister(instr.alloc_tensor_reg.shape_register), cpu_dev));
         auto shape = ToShape(shape_tensor);
-        auto storage_obj = ReadRegister(instr.alloc_tensor_reg.storage);
-        auto storage = Downcast<Storage>(storage_obj);
+        const auto& storage = Downcast<Storage>(ReadRegister(instr.alloc_tensor_reg.storage));
         auto offset = LoadScalarInt(instr.alloc_tensor.offset);
         auto obj = storage->AllocNDArray(offset, shape, instr.alloc_tensor_reg.dtype);
         VLOG(2) << "allocated "
@@ -798,28 +1195,33 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         WriteRegister(instr.dst, obj);
         OpStopHook();
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocADT: {
+      TVM_VM_OP(AllocADT) {
+        const Instruction& instr = code_[pc_];
         std::vector<ObjectRef> fields;
+        fields.reserve(instr.num_fields);
         for (Index i = 0; i < instr.num_fields; ++i) {
           fields.push_back(ReadRegister(instr.datatype_fields[i]));
         }
         ObjectRef obj = ADT(instr.constructor_tag, fields);
         WriteRegister(instr.dst, obj);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocClosure: {
+      TVM_VM_OP(AllocClosure) {
+        const Instruction& instr = code_[pc_];
         std::vector<ObjectRef> free_vars;
+        free_vars.reserve(instr.num_freevar);
         for (Index i = 0; i < instr.num_freevar; i++) {
           free_vars.push_back(ReadRegister(instr.free_vars[i]));
         }
         WriteRegister(instr.dst, VMClosure(instr.func_index, free_vars));
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::AllocStorage: {
+      TVM_VM_OP(AllocStorage) {
+        const Instruction& instr = code_[pc_];
         OpStartHook(instr);
         auto size = LoadScalarInt(instr.alloc_storage.allocation_size);
         auto alignment = instr.alloc_storage.alignment;
@@ -836,24 +1238,39 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         WriteRegister(instr.dst, storage);
         OpStopHook();
         pc_++;
-        goto main_loop;
+        // Superinstruction: the memory planner emits most storages immediately followed by the
+        // tensors carved out of them. Allocate those directly from the storage in hand instead of
+        // dispatching each AllocTensor and reading the storage back from its register.
+        while (code_[pc_].op == Opcode::AllocTensor &&
+               code_[pc_].alloc_tensor.storage == instr.dst &&
+               (output_tensor_reg_indices.empty() ||
+                !FindIndex(output_tensor_reg_indices, code_[pc_].dst))) {
+          VLOG(2) << "Executing(" << pc_ << "): " << code_[pc_];
+          OpStartHook(code_[pc_]);
+          WriteAllocatedTensor(code_[pc_], storage);
+          OpStopHook();
+          pc_++;
+        }
+        TVM_VM_DISPATCH();
       }
-      case Opcode::ShapeOf: {
-        auto input = ReadRegister(instr.shape_of.tensor);
-        NDArray input_array = Downcast<NDArray>(input);
-        int ndim = input_array->ndim;
+      TVM_VM_OP(ShapeOf) {
+        const Instruction& instr = code_[pc_];
+        const auto* input_array = ReadRegister(instr.shape_of.tensor).as<NDArray::ContainerType>();
+        ICHECK(input_array) << "ShapeOf expects a tensor";
+        int ndim = input_array->dl_tensor.ndim;
         auto out_tensor =
             NDArray::Empty({ndim}, {kDLInt, 64, 1}, GetDevice(exec_->host_device_index));
         for (int i = 0; i < ndim; ++i) {
-          reinterpret_cast<int64_t*>(out_tensor->data)[i] = input_array->shape[i];
+          reinterpret_cast<int64_t*>(out_tensor->data)[i] = input_array->dl_tensor.shape[i];
         }
         VLOG(2) << "shape = "
                 << RuntimeObject2String(out_tensor, GetDevice(exec_->host_device_index));
         WriteRegister(instr.dst, out_tensor);
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::Ret: {
+      TVM_VM_OP(Ret) {
+        const Instruction& instr = code_[pc_];
         // If we have hit the point from which we started
         // running, we should return to the caller breaking
         // the dispatch loop.
@@ -865,17 +1282,18 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
           // Otherwise we are just returning from a local call.
         } else {
           WriteRegister(caller_return_register, return_register_);
-          goto main_loop;
+          TVM_VM_DISPATCH();
         }
       }
-      case Opcode::ReshapeTensor: {
+      TVM_VM_OP(ReshapeTensor) {
+        const Instruction& instr = code_[pc_];
         OpStartHook(instr);
         Device cpu_dev = GetDevice(exec_->host_device_index);
-        auto tensor_obj = ReadRegister(instr.reshape_tensor.tensor);
+        const ObjectRef& tensor_obj = ReadRegister(instr.reshape_tensor.tensor);
         NDArray tensor_arr = Downcast<NDArray>(tensor_obj);
         // Read the shape from shape tensor
-        auto shape_obj = ReadRegister(instr.reshape_tensor.newshape);
-        NDArray shape_tensor = Downcast<NDArray>(CopyTo(shape_obj, cpu_dev));
+        NDArray shape_tensor =
+            Downcast<NDArray>(CopyTo(ReadRegister(instr.reshape_tensor.newshape), cpu_dev));
         const DLTensor* dl_tensor = shape_tensor.operator->();
         ICHECK_EQ(dl_tensor->dtype.code, 0u);
         ICHECK_EQ(dl_tensor->dtype.bits, 64u);
@@ -885,17 +1303,17 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         // Reshape the input tensor
         auto out_tensor = tensor_arr.CreateView(shape, tensor_arr->dtype);
         VLOG(2) << "reshaped "
-                << RuntimeObject2String(tensor_obj, GetDevice(exec_->host_device_index)) << " to "
+                << RuntimeObject2String(tensor_arr, GetDevice(exec_->host_device_index)) << " to "
                 << RuntimeObject2String(out_tensor, GetDevice(exec_->host_device_index));
         WriteRegister(instr.dst, out_tensor);
         OpStopHook();
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::DeviceCopy: {
+      TVM_VM_OP(DeviceCopy) {
+        const Instruction& instr = code_[pc_];
         OpStartHook(instr);
-        auto tensor_src = ReadRegister(instr.device_copy.src);
-        NDArray src_data = Downcast<NDArray>(tensor_src);
+        NDArray src_data = Downcast<NDArray>(ReadRegister(instr.device_copy.src));
         Device actual_src_dev = src_data->device;
         Device inst_src_dev = GetDevice(instr.device_copy.src_device_index);
         ICHECK_EQ(actual_src_dev.device_type, inst_src_dev.device_type);
@@ -906,31 +1324,36 @@ void VirtualMachine::RunLoop(const std::vector<Index>& output_tensor_reg_indices
         WriteRegister(instr.dst, dst_data);
         OpStopHook();
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
-      case Opcode::KillRegister: {
+      TVM_VM_OP(KillRegister) {
+        const Instruction& instr = code_[pc_];
         OpStartHook(instr);
         WriteRegister(instr.dst, ObjectRef());
         OpStopHook();
         pc_++;
-        goto main_loop;
+        TVM_VM_DISPATCH();
       }
+#if !TVM_VM_USE_COMPUTED_GOTO
       default:
-        LOG(FATAL) << "Unknown instruction opcode: " << int(instr.op);
+        LOG(FATAL) << "Unknown instruction opcode: " << int(code_[pc_].op);
+#endif
     }
   }
 }
 
-void VirtualMachine::WriteAllocatedTensor(const Instruction& instr) {
-  auto shape = std::vector<int64_t>(instr.alloc_tensor.ndim);
+#undef TVM_VM_OP
+#undef TVM_VM_DISPATCH
+#undef TVM_VM_USE_COMPUTED_GOTO
 
-  for (uint32_t i = 0; i < instr.alloc_tensor.ndim; ++i) {
-    shape[i] = instr.alloc_tensor.shape[i];
-  }
+void VirtualMachine::WriteAllocatedTensor(const Instruction& instr) {
+  WriteAllocatedTensor(instr, Downcast<Storage>(ReadRegister(instr.alloc_tensor.storage)));
+}
 
-  auto storage_obj = ReadRegister(instr.alloc_tensor.storage);
+void VirtualMachine::WriteAllocatedTensor(const Instruction& instr, const Storage& storage) {
+  auto shape = std::vector<int64_t>(instr.alloc_tensor.shape,
+                                    instr.alloc_tensor.shape + instr.alloc_tensor.ndim);
   auto offset = LoadScalarInt(instr.alloc_tensor.offset);
-  auto storage = Downcast<Storage>(storage_obj);
   auto obj = storage->AllocNDArray(offset, shape, instr.alloc_tensor.dtype);
   VLOG(2) << "allocated "
           << RuntimeObject2String(obj, GetDevice(exec_->host_device_index),
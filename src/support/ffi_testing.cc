@@ -29,7 +29,11 @@
 #include <tvm/tir/expr.h>
 
 #include <chrono>
+#include <string>
 #include <thread>
+#include <vector>
+
+#include "../runtime/library_module.h"
 
 namespace tvm {
 // Attrs used to python API
@@ -112,6 +116,22 @@ void ErrorTest(int x, int y) {
 
 TVM_REGISTER_GLOBAL("testing.ErrorTest").set_body_typed(ErrorTest);
 
+// Call a compiled function through its direct-call entry, with a null array of type codes.
+TVM_REGISTER_GLOBAL("testing.call_direct").set_body([](TVMArgs args, TVMRetValue* ret) {
+  runtime::Module mod = args[0];
+  std::string name = args[1];
+  std::string signature;
+  TVMBackendPackedCFunc faddr = runtime::GetDirectCallFunc(mod, name, &signature);
+  ICHECK(faddr != nullptr) << "Function " << name << " does not have a direct-call entry";
+  ICHECK_EQ(signature, std::string(args.size() - 2, 'h'))
+      << "Only functions taking DLTensor arguments are supported";
+  std::vector<TVMValue> values(args.size() - 2);
+  for (int i = 2; i < args.size(); ++i) {
+    values[i - 2].v_handle = args[i].operator DLTensor*();
+  }
+  runtime::CallDirect(faddr, values.data(), static_cast<int>(values.size()));
+});
+
 // internal function used for debug and testing purposes
 TVM_REGISTER_GLOBAL("testing.object_use_count").set_body([](TVMArgs args, TVMRetValue* ret) {
   runtime::ObjectRef obj = args[0];
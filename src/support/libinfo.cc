@@ -95,6 +95,10 @@
 #define TVM_INFO_USE_GRAPH_EXECUTOR "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_POOLED_OBJ_ALLOCATOR
+#define TVM_INFO_USE_POOLED_OBJ_ALLOCATOR "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_PROFILER
 #define TVM_INFO_USE_PROFILER "NOT-FOUND"
 #endif
@@ -175,6 +179,10 @@
 #define TVM_INFO_USE_ROCBLAS "NOT-FOUND"
 #endif
 
+#ifndef TVM_INFO_USE_LAYOUT_TRANSFORM
+#define TVM_INFO_USE_LAYOUT_TRANSFORM "NOT-FOUND"
+#endif
+
 #ifndef TVM_INFO_USE_SORT
 #define TVM_INFO_USE_SORT "NOT-FOUND"
 #endif
@@ -283,6 +291,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_HEXAGON_EXTERNAL_LIBS", TVM_INFO_USE_HEXAGON_EXTERNAL_LIBS},
       {"USE_IOS_RPC", TVM_INFO_USE_IOS_RPC},
       {"USE_KHRONOS_SPIRV", TVM_INFO_USE_KHRONOS_SPIRV},
+      {"USE_LAYOUT_TRANSFORM", TVM_INFO_USE_LAYOUT_TRANSFORM},
       {"USE_LIBBACKTRACE", TVM_INFO_USE_LIBBACKTRACE},
       {"USE_LIBTORCH", TVM_INFO_USE_LIBTORCH},
       {"USE_LLVM", TVM_INFO_USE_LLVM},
@@ -297,6 +306,7 @@ TVM_DLL Map<String, String> GetLibInfo() {
       {"USE_OPENCL_GTEST", TVM_INFO_USE_OPENCL_GTEST},
       {"USE_OPENMP", TVM_INFO_USE_OPENMP},
       {"USE_PAPI", TVM_INFO_USE_PAPI},
+      {"USE_POOLED_OBJ_ALLOCATOR", TVM_INFO_USE_POOLED_OBJ_ALLOCATOR},
       {"USE_PROFILER", TVM_INFO_USE_PROFILER},
       {"USE_PT_TVMDSOOP", TVM_INFO_USE_PT_TVMDSOOP},
       {"USE_RANDOM", TVM_INFO_USE_RANDOM},
@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file mapped_file.h
+ * \brief Platform independent read-only view of a whole file.
+ */
+#ifndef TVM_SUPPORT_MAPPED_FILE_H_
+#define TVM_SUPPORT_MAPPED_FILE_H_
+
+#include <tvm/runtime/logging.h>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#include <string>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace tvm {
+namespace support {
+
+/*!
+ * \brief A read-only view of a file's content.
+ *
+ * On POSIX systems the file is memory mapped, so that the content is paged in lazily and
+ * can be scanned by multiple threads without copying. On other platforms the file is read
+ * into an owned buffer with a single bulk read.
+ */
+class MappedFile {
+ public:
+  /*!
+   * \brief Open a file as a read-only view.
+   * \param path The path to the file.
+   * \param allow_missing Whether a missing file is treated as empty instead of an error.
+   */
+  explicit MappedFile(const std::string& path, bool allow_missing = false) {
+#ifdef _WIN32
+    std::ifstream is(path, std::ios::binary);
+    if (!is.good()) {
+      CHECK(allow_missing) << "ValueError: Cannot open file: " << path;
+      return;
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      CHECK(allow_missing) << "ValueError: Cannot open file: " << path << ": " << strerror(errno);
+      return;
+    }
+    struct stat st;
+    CHECK_EQ(fstat(fd, &st), 0) << "ValueError: Cannot stat file: " << path;
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ != 0) {
+      void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      CHECK(addr != MAP_FAILED) << "ValueError: Cannot map file: " << path << ": "
+                                << strerror(errno);
+      // The content is scanned front to back by each reader.
+      madvise(addr, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char*>(addr);
+    }
+    close(fd);
+#endif
+  }
+
+  ~MappedFile() {
+#ifndef _WIN32
+    if (data_ != nullptr) {
+      munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /*! \return The pointer to the beginning of the content, nullptr if the file is empty. */
+  const char* data() const { return data_; }
+  /*! \return The number of bytes in the file. */
+  size_t size() const { return size_; }
+
+ private:
+  /*! \brief The beginning of the content. */
+  const char* data_{nullptr};
+  /*! \brief The number of bytes in the content. */
+  size_t size_{0};
+#ifdef _WIN32
+  /*! \brief The owned content when memory mapping is not used. */
+  std::string buffer_;
+#endif
+};
+
+}  // namespace support
+}  // namespace tvm
+
+#endif  // TVM_SUPPORT_MAPPED_FILE_H_
@@ -192,9 +192,33 @@ void CodeGenCPU::AddFunction(const PrimFunc& f) {
     export_system_symbols_.emplace_back(
         std::make_pair(global_symbol.value().operator std::string(), function_));
   }
+  if (auto signature = f->GetAttr<String>(tir::attr::kDirectCallSignature)) {
+    auto global_symbol = f->GetAttr<String>(tvm::attr::kGlobalSymbol);
+    if (global_symbol.defined()) {
+      AddDirectCallSignature(global_symbol.value(), signature.value());
+    }
+  }
   AddDebugInformation(f, function_);
 }
 
+void CodeGenCPU::AddDirectCallSignature(const std::string& global_symbol,
+                                        const std::string& signature) {
+  std::string name = runtime::symbol::tvm_direct_call_signature_prefix + global_symbol;
+  llvm::Type* type = llvm::ArrayType::get(t_char_, signature.length() + 1);
+  llvm::GlobalVariable* global = new llvm::GlobalVariable(
+      *module_, type, true, llvm::GlobalValue::ExternalLinkage,
+      llvm::ConstantDataArray::getString(*llvm_target_->GetContext(), signature), name);
+#if TVM_LLVM_VERSION >= 100
+  global->setAlignment(llvm::Align(1));
+#else
+  global->setAlignment(1);
+#endif
+  global->setDLLStorageClass(llvm::GlobalVariable::DLLExportStorageClass);
+  if (f_tvm_register_system_symbol_ != nullptr) {
+    export_system_symbols_.emplace_back(std::make_pair(name, global));
+  }
+}
+
 // Following Glow |DebugInfo::generateFunctionDebugInfo|, https://git.io/fjadv
 void CodeGenCPU::AddDebugInformation(PrimFunc f_tir, llvm::Function* f_llvm) {
 #if TVM_LLVM_VERSION >= 50
@@ -197,6 +197,8 @@ class CodeGenCPU : public CodeGenLLVM {
   llvm::DIType* GetDebugType(const Type& ty_tir, llvm::Type* ty_llvm);
   // Adds the DWARF debug information for |function| to |dbg_info_|.
   void AddDebugInformation(PrimFunc f_tir, llvm::Function* f_llvm);
+  // Exports the direct-call signature of the packed function |global_symbol|.
+  void AddDirectCallSignature(const std::string& global_symbol, const std::string& signature);
 };
 
 }  // namespace codegen
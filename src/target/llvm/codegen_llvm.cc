@@ -1253,6 +1253,12 @@ llvm::Value* CodeGenLLVM::CreateIntrinsic(const CallNode* op) {
     uint64_t high = static_cast<uint64_t>(Downcast<IntImm>(op->args[1])->value);
     uint64_t val = (high << 32U) | low;
     return llvm::ConstantInt::get(DTypeToLLVMType(op->dtype), val);
+  } else if (op->op.same_as(builtin::if_then_else()) && op->args[0].dtype().is_vector()) {
+    // Lane-wise select from a vectorized loop, the loads of each branch are masked to its lanes.
+    llvm::Value* cond = MakeValue(op->args[0]);
+    llvm::Value* then_value = MakeValueUnderLaneMask(op->args[1], cond);
+    llvm::Value* else_value = MakeValueUnderLaneMask(op->args[2], builder_->CreateNot(cond));
+    return builder_->CreateSelect(cond, then_value, else_value);
   } else if (op->op.same_as(builtin::if_then_else())) {
     ICHECK_EQ(op->args[0].dtype().lanes(), 1) << "if_then_else can only take scalar condition";
     llvm::LLVMContext* ctx = llvm_target_->GetContext();
@@ -1602,8 +1608,23 @@ llvm::Value* CodeGenLLVM::VisitExpr_(const BufferLoadNode* op) {
 
   std::vector<llvm::Value*> loads;
 
-  auto make_load = [this, &loads](TypedPointer buffer_ptr, int /* subelement_i */, int alignment,
-                                  bool is_volatile) {
+  auto make_load = [this, &loads, value_dtype](TypedPointer buffer_ptr, int /* subelement_i */,
+                                               int alignment,
+                                               bool is_volatile) -> llvm::Instruction* {
+    if (IsLaneMasked(value_dtype, buffer_ptr, is_volatile)) {
+      llvm::Value* passthru = llvm::Constant::getNullValue(buffer_ptr.type);
+#if TVM_LLVM_VERSION >= 130
+      auto load = builder_->CreateMaskedLoad(buffer_ptr.type, buffer_ptr.addr,
+                                             llvm::Align(alignment), lane_mask_, passthru);
+#elif TVM_LLVM_VERSION >= 110
+      auto load =
+          builder_->CreateMaskedLoad(buffer_ptr.addr, llvm::Align(alignment), lane_mask_, passthru);
+#else
+      auto load = builder_->CreateMaskedLoad(buffer_ptr.addr, alignment, lane_mask_, passthru);
+#endif
+      loads.push_back(load);
+      return load;
+    }
 #if TVM_LLVM_VERSION >= 110
     auto load = builder_->CreateAlignedLoad(buffer_ptr.type, buffer_ptr.addr,
                                             llvm::Align(alignment), is_volatile);
@@ -1707,8 +1728,17 @@ void CodeGenLLVM::VisitStmt_(const BufferStoreNode* op) {
 
   llvm::Value* value = MakeValue(op->value);
 
-  auto make_store = [this, value](TypedPointer buffer_ptr, int subelement_i, int alignment,
-                                  bool is_volatile) {
+  auto make_store = [this, value, value_dtype](TypedPointer buffer_ptr, int subelement_i,
+                                               int alignment,
+                                               bool is_volatile) -> llvm::Instruction* {
+    if (subelement_i == -1 && IsLaneMasked(value_dtype, buffer_ptr, is_volatile)) {
+#if TVM_LLVM_VERSION >= 110
+      return builder_->CreateMaskedStore(value, buffer_ptr.addr, llvm::Align(alignment),
+                                         lane_mask_);
+#else
+      return builder_->CreateMaskedStore(value, buffer_ptr.addr, alignment, lane_mask_);
+#endif
+    }
     llvm::Value* to_store = value;
     if (subelement_i != -1) {
       to_store = builder_->CreateExtractElement(value, subelement_i);
@@ -1754,7 +1784,31 @@ void CodeGenLLVM::VisitStmt_(const WhileNode* op) {
   builder_->SetInsertPoint(while_merge);
 }
 
+bool CodeGenLLVM::IsLaneMasked(DataType value_dtype, const TypedPointer& buffer_ptr,
+                               bool is_volatile) {
+  return lane_mask_ != nullptr && !is_volatile && value_dtype.lanes() > 1 &&
+         buffer_ptr.type->isVectorTy() && GetVectorNumElements(lane_mask_) == value_dtype.lanes();
+}
+
+llvm::Value* CodeGenLLVM::MakeValueUnderLaneMask(const PrimExpr& e, llvm::Value* mask) {
+  llvm::Value* outer_mask = lane_mask_;
+  lane_mask_ = outer_mask != nullptr ? builder_->CreateAnd(outer_mask, mask) : mask;
+  llvm::Value* value = MakeValue(e);
+  lane_mask_ = outer_mask;
+  return value;
+}
+
 void CodeGenLLVM::VisitStmt_(const IfThenElseNode* op) {
+  if (op->condition.dtype().is_vector()) {
+    // A masked statement from a vectorized loop, each lane stores under its condition.
+    ICHECK(!op->else_case.defined()) << "A vector condition cannot have an else case";
+    llvm::Value* mask = MakeValue(op->condition);
+    llvm::Value* outer_mask = lane_mask_;
+    lane_mask_ = outer_mask != nullptr ? builder_->CreateAnd(outer_mask, mask) : mask;
+    this->VisitStmt(op->then_case);
+    lane_mask_ = outer_mask;
+    return;
+  }
   llvm::Value* cond = MakeValue(op->condition);
   llvm::LLVMContext* ctx = llvm_target_->GetContext();
   auto* then_block = llvm::BasicBlock::Create(*ctx, "if_then", function_);
@@ -408,6 +408,19 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
    * \param vec The value, must be of a vector type.
    */
   inline int GetVectorNumElements(llvm::Value* vec);
+  /*!
+   * \brief Whether a vector access through buffer_ptr is masked by the current lane mask.
+   * \param value_dtype The type of the accessed value.
+   * \param buffer_ptr The address of the access.
+   * \param is_volatile Whether the access is volatile, which is never masked.
+   */
+  bool IsLaneMasked(DataType value_dtype, const TypedPointer& buffer_ptr, bool is_volatile);
+  /*!
+   * \brief Make the value of an expression whose vector loads are masked.
+   * \param e The expression.
+   * \param mask The lanes to load, within the current lane mask.
+   */
+  llvm::Value* MakeValueUnderLaneMask(const PrimExpr& e, llvm::Value* mask);
   // initialize the function state.
   void InitFuncState();
   // Get alignment given index.
@@ -516,6 +529,8 @@ class CodeGenLLVM : public ExprFunctor<llvm::Value*(const PrimExpr&)>,
   std::unordered_set<const VarNode*> alias_var_set_;
   // set of volatile buffer.
   std::unordered_set<const VarNode*> volatile_buf_;
+  // The mask of the lanes accessed by vector loads and stores, under a vector condition.
+  llvm::Value* lane_mask_{nullptr};
   // deep comparison of PrimExpr
   ExprDeepEqual deep_equal_;
   // binding of let variables. Enables duplicate var defs that map to same value
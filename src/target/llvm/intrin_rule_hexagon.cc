@@ -54,7 +54,8 @@ inline PrimExpr DispatchTVMQHLWrapperFp16(const PrimExpr& e) {
   Array<PrimExpr> new_args;
 #if ENABLE_QHL
   // Check target for qfloat enablement
-  const auto* f = tvm::runtime::Registry::Get("target.TargetCurrent");
+  static const tvm::runtime::Registry::Handle ftarget_current("target.TargetCurrent");
+  const auto* f = ftarget_current.Get();
   ICHECK(f != nullptr);
   const auto ret = (*f)(true);
   const Target t = ret.AsObjectRef<Target>();
@@ -105,7 +106,8 @@ TVM_REGISTER_OP("tir.tanh")
 
 #if ENABLE_QHL
       // Check target for qfloat enablement
-      const auto* f = tvm::runtime::Registry::Get("target.TargetCurrent");
+      static const tvm::runtime::Registry::Handle ftarget_current("target.TargetCurrent");
+      const auto* f = ftarget_current.Get();
       ICHECK(f != nullptr);
       const auto ret = (*f)(true);
       const Target t = ret.AsObjectRef<Target>();
@@ -141,7 +143,8 @@ TVM_REGISTER_OP("tir.tan").set_attr<FLowerIntrinsic>(
       const PrimExpr& x = call->args[0];
 #if ENABLE_QHL
       // Check target for qfloat enablement
-      const auto* f = tvm::runtime::Registry::Get("target.TargetCurrent");
+      static const tvm::runtime::Registry::Handle ftarget_current("target.TargetCurrent");
+      const auto* f = ftarget_current.Get();
       ICHECK(f != nullptr);
       const auto ret = (*f)(true);
       const Target t = ret.AsObjectRef<Target>();
@@ -172,7 +175,8 @@ TVM_REGISTER_OP("tir.sigmoid")
       const PrimExpr& x = call->args[0];
 #if ENABLE_QHL
       // Check target for qfloat enablement
-      const auto* f = tvm::runtime::Registry::Get("target.TargetCurrent");
+      static const tvm::runtime::Registry::Handle ftarget_current("target.TargetCurrent");
+      const auto* f = ftarget_current.Get();
       ICHECK(f != nullptr);
       const auto ret = (*f)(true);
       const Target t = ret.AsObjectRef<Target>();
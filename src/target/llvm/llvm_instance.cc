@@ -73,6 +73,7 @@ namespace {
 namespace defaults {
 static const char* cpu = "generic";
 static const llvm::CodeGenOpt::Level opt_level = llvm::CodeGenOpt::Aggressive;
+static const char* jit_engine = "mcjit";
 }  // namespace defaults
 }  // namespace
 
@@ -244,6 +245,17 @@ LLVMTargetInfo::LLVMTargetInfo(LLVMInstance& instance, const Target& target) {
 
   target_options_.UseInitArray = true;
 
+  jit_engine_ = target->GetAttr<String>("jit").value_or(defaults::jit_engine);
+  if (jit_engine_ != "mcjit" && jit_engine_ != "orcjit") {
+    LOG(FATAL) << "invalid -jit option " << jit_engine_ << ", expected mcjit or orcjit";
+  }
+#if TVM_LLVM_VERSION < 130
+  if (jit_engine_ == "orcjit") {
+    LOG(WARNING) << "-jit=orcjit requires LLVM 13 or newer, using mcjit instead";
+    jit_engine_ = defaults::jit_engine;
+  }
+#endif
+
   // Fast math options
 
   auto GetBoolFlag = [&target](llvm::StringRef flag) -> bool {
@@ -380,6 +392,10 @@ std::string LLVMTargetInfo::str() const {
     }
   }
 
+  if (jit_engine_ != defaults::jit_engine) {
+    os << " -jit=" << jit_engine_;
+  }
+
   if (size_t num = llvm_options_.size(); num > 0) {
     os << " -cl-opt=";
     std::vector<std::string> opts;
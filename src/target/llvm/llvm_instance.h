@@ -217,6 +217,11 @@ class LLVMTargetInfo {
    * \return optimization level for this target
    */
   llvm::CodeGenOpt::Level GetOptLevel() const { return opt_level_; }
+  /*!
+   * \brief Get the JIT engine used to run modules for this target
+   * \return "mcjit" or "orcjit"
+   */
+  const std::string& GetJITEngine() const { return jit_engine_; }
 
   /*!
    * \class Option
@@ -285,6 +290,7 @@ class LLVMTargetInfo {
   llvm::CodeGenOpt::Level opt_level_;
   llvm::Reloc::Model reloc_model_ = llvm::Reloc::PIC_;
   llvm::CodeModel::Model code_model_ = llvm::CodeModel::Small;
+  std::string jit_engine_;
   std::shared_ptr<llvm::TargetMachine> target_machine_;
 };
 
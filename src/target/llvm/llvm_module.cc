@@ -28,9 +28,19 @@
 #include <dmlc/io.h>
 #include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/StringRef.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/MCJIT.h>  // Force linking of MCJIT
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#if TVM_LLVM_VERSION >= 130
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#endif
 #include <llvm/IR/DataLayout.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Intrinsics.h>
@@ -42,8 +52,10 @@
 #include <llvm/IR/Verifier.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/xxhash.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Transforms/Utils/Cloning.h>
@@ -62,6 +74,9 @@
 #include <tvm/target/target.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
 #include <memory>
 #include <mutex>
 #include <sstream>
@@ -85,6 +100,95 @@ using runtime::PackedFunc;
 using runtime::TVMArgs;
 using runtime::TVMRetValue;
 
+/*!
+ * \brief An object file cache on disk for the ORC JIT.
+ *
+ *  Objects are keyed by a hash of the IR of the compiled module together with the target
+ *  and the LLVM version, so that a module compiled once is loaded from the cache by later
+ *  processes. With lazy compilation, each compiled module is a partition of the original.
+ */
+class LLVMObjectCache : public llvm::ObjectCache {
+ public:
+  /*!
+   * \brief Create the cache.
+   * \param dir The directory holding the cached objects, created if it does not exist.
+   * \param target The string representation of the target the objects are compiled for.
+   */
+  LLVMObjectCache(std::string dir, std::string target)
+      : dir_(std::move(dir)), target_(std::move(target)) {
+    if (std::error_code ecode = llvm::sys::fs::create_directories(dir_)) {
+      LOG(WARNING) << "Cannot create the JIT object cache directory " << dir_ << ": "
+                   << ecode.message();
+    }
+  }
+
+  void notifyObjectCompiled(const llvm::Module* module, llvm::MemoryBufferRef obj) final {
+    std::string path = GetPath(*module);
+    // Write to a unique temporary file and rename it, so that concurrent readers never see a
+    // partially written object.
+    int fd;
+    llvm::SmallString<256> tmp_path;
+    if (llvm::sys::fs::createUniqueFile(path + ".%%%%%%.tmp", fd, tmp_path)) return;
+    {
+      llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+      os << obj.getBuffer();
+      os.close();
+      if (os.has_error()) {
+        os.clear_error();
+        llvm::sys::fs::remove(tmp_path);
+        return;
+      }
+    }
+    if (llvm::sys::fs::rename(tmp_path, path)) {
+      llvm::sys::fs::remove(tmp_path);
+    }
+  }
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) final {
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> buffer =
+        llvm::MemoryBuffer::getFile(GetPath(*module));
+    if (!buffer) return nullptr;
+    ++num_hits;
+    return std::move(buffer.get());
+  }
+
+  /*! \brief The number of objects loaded from a cache instead of being compiled. */
+  static std::atomic<int64_t> num_hits;
+
+ private:
+  std::string GetPath(const llvm::Module& module) const {
+    // The module identifier is left out, it differs between runs for the same IR.
+    std::string key;
+    llvm::raw_string_ostream os(key);
+    os << target_ << '\n' << LLVM_VERSION_STRING << '\n' << module.getTargetTriple() << '\n'
+       << module.getDataLayoutStr() << '\n'
+       << module.getModuleInlineAsm() << '\n';
+    for (const llvm::GlobalVariable& var : module.globals()) {
+      var.print(os);
+      os << '\n';
+    }
+    for (const llvm::GlobalAlias& alias : module.aliases()) {
+      alias.print(os);
+      os << '\n';
+    }
+    for (const llvm::Function& func : module.functions()) {
+      func.print(os);
+    }
+    os.flush();
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << llvm::xxHash64(key) << '-'
+         << std::dec << key.size() << ".o";
+    return dir_ + "/" + name.str();
+  }
+
+  /*! \brief The directory holding the cached objects. */
+  std::string dir_;
+  /*! \brief The target the objects are compiled for. */
+  std::string target_;
+};
+
+std::atomic<int64_t> LLVMObjectCache::num_hits{0};
+
 class LLVMModuleNode final : public runtime::ModuleNode {
  public:
   ~LLVMModuleNode();
@@ -106,6 +210,8 @@ class LLVMModuleNode final : public runtime::ModuleNode {
 
  private:
   void LazyInitJIT();
+  void InitMCJIT(LLVMTarget* llvm_target);
+  void InitORCJIT(LLVMTarget* llvm_target);
   bool IsCompatibleWithHost(const llvm::TargetMachine* tm) const;
   void* GetGlobalAddr(const std::string& name, const LLVMTarget& llvm_target) const;
   void* GetFunctionAddr(const std::string& name, const LLVMTarget& llvm_target) const;
@@ -114,8 +220,16 @@ class LLVMModuleNode final : public runtime::ModuleNode {
   std::unique_ptr<LLVMInstance> llvm_instance_;
   // JIT lock
   std::mutex mutex_;
+  // Whether the JIT engine has been initialized.
+  std::atomic<bool> jit_initialized_{false};
   // execution engine
   llvm::ExecutionEngine* ee_{nullptr};
+#if TVM_LLVM_VERSION >= 130
+  // The ORC JIT engine, used instead of ee_ for targets with -jit=orcjit.
+  std::unique_ptr<llvm::orc::LLJIT> orcjit_ee_;
+  // The object cache of orcjit_ee_, if enabled.
+  std::unique_ptr<LLVMObjectCache> object_cache_;
+#endif
   // The raw pointer to the module.
   llvm::Module* module_{nullptr};
   // The unique_ptr owning the module. This becomes empty once JIT has been initialized
@@ -130,6 +244,14 @@ LLVMModuleNode::~LLVMModuleNode() {
     ee_->runStaticConstructorsDestructors(true);
     delete ee_;
   }
+#if TVM_LLVM_VERSION >= 130
+  if (orcjit_ee_ != nullptr) {
+    if (llvm::Error err = orcjit_ee_->deinitialize(orcjit_ee_->getMainJITDylib())) {
+      LOG(WARNING) << "Failed to run static destructors: " << llvm::toString(std::move(err));
+    }
+    orcjit_ee_.reset();
+  }
+#endif
   module_owning_ptr_.reset();
 }
 
@@ -149,12 +271,22 @@ PackedFunc LLVMModuleNode::GetFunction(const std::string& name,
     std::string target_string = LLVMTarget::GetTargetMetadata(*module_);
     return PackedFunc([target_string](TVMArgs args, TVMRetValue* rv) { *rv = target_string; });
   }
-  if (ee_ == nullptr) LazyInitJIT();
+  if (!jit_initialized_.load(std::memory_order_acquire)) LazyInitJIT();
 
   std::lock_guard<std::mutex> lock(mutex_);
 
   TVMBackendPackedCFunc faddr;
   With<LLVMTarget> llvm_target(*llvm_instance_, LLVMTarget::GetTargetMetadata(*module_));
+  const std::string query_prefix = runtime::symbol::tvm_direct_call_query_prefix;
+  if (name.compare(0, query_prefix.size(), query_prefix) == 0) {
+    return MakeDirectCallQuery(
+        name.substr(query_prefix.size()),
+        [this, &llvm_target](const char* symbol) {
+          void* addr = GetFunctionAddr(symbol, *llvm_target);
+          return addr != nullptr ? addr : GetGlobalAddr(symbol, *llvm_target);
+        },
+        sptr_to_self);
+  }
   if (name == runtime::symbol::tvm_module_main) {
     const char* entry_name = reinterpret_cast<const char*>(
         GetGlobalAddr(runtime::symbol::tvm_module_main, *llvm_target));
@@ -352,10 +484,34 @@ bool LLVMModuleNode::ImplementsFunction(const String& name, bool query_imports)
 
 void LLVMModuleNode::LazyInitJIT() {
   std::lock_guard<std::mutex> lock(mutex_);
-  if (ee_) {
+  if (jit_initialized_.load(std::memory_order_relaxed)) {
     return;
   }
   With<LLVMTarget> llvm_target(*llvm_instance_, LLVMTarget::GetTargetMetadata(*module_));
+  if (llvm_target->GetJITEngine() == "orcjit") {
+    InitORCJIT(llvm_target.get());
+  } else {
+    InitMCJIT(llvm_target.get());
+  }
+
+  if (void** ctx_addr =
+          reinterpret_cast<void**>(GetGlobalAddr(runtime::symbol::tvm_module_ctx, *llvm_target))) {
+    *ctx_addr = this;
+  }
+  runtime::InitContextFunctions(
+      [this, &llvm_target](const char* name) { return GetGlobalAddr(name, *llvm_target); });
+  if (ee_ != nullptr) {
+    // There is a problem when a JITed function contains a call to a runtime function.
+    // The runtime function (e.g. __truncsfhf2) may not be resolved, and calling it will
+    // lead to a runtime crash.
+    // Do name lookup on a symbol that doesn't exist. This will force MCJIT to finalize
+    // all loaded objects, which will resolve symbols in JITed code.
+    ee_->getFunctionAddress("__some_name_that_hopefully_doesnt_exist__b49f8aaade5877eaba7583b91");
+  }
+  jit_initialized_.store(true, std::memory_order_release);
+}
+
+void LLVMModuleNode::InitMCJIT(LLVMTarget* llvm_target) {
   llvm::EngineBuilder builder(std::move(module_owning_ptr_));
   builder.setEngineKind(llvm::EngineKind::JIT);
   builder.setOptLevel(llvm::CodeGenOpt::Aggressive);
@@ -374,20 +530,119 @@ void LLVMModuleNode::LazyInitJIT() {
   ee_ = builder.create(tm.release());
   ICHECK(ee_ != nullptr) << "Failed to initialize jit engine for " << module_->getTargetTriple();
   ee_->runStaticConstructorsDestructors(false);
+}
 
-  if (void** ctx_addr =
-          reinterpret_cast<void**>(GetGlobalAddr(runtime::symbol::tvm_module_ctx, *llvm_target))) {
-    *ctx_addr = this;
+#if TVM_LLVM_VERSION >= 130
+namespace {
+// Called by the lazy call-through stubs of the ORC JIT when a function fails to compile.
+void ORCJITLazyCompileFailure() {
+  LOG(ERROR) << "LLVM ORC JIT failed to compile a function on its first call";
+  std::abort();
+}
+}  // namespace
+#endif
+
+void LLVMModuleNode::InitORCJIT(LLVMTarget* llvm_target) {
+#if TVM_LLVM_VERSION >= 130
+  llvm::TargetMachine* tm = llvm_target->GetOrCreateTargetMachine();
+  if (!IsCompatibleWithHost(tm)) {
+    LOG(FATAL) << "Cannot run module, architecture mismatch";
   }
-  runtime::InitContextFunctions(
-      [this, &llvm_target](const char* name) { return GetGlobalAddr(name, *llvm_target); });
-  // There is a problem when a JITed function contains a call to a runtime function.
-  // The runtime function (e.g. __truncsfhf2) may not be resolved, and calling it will
-  // lead to a runtime crash.
-  // Do name lookup on a symbol that doesn't exist. This will force MCJIT to finalize
-  // all loaded objects, which will resolve symbols in JITed code.
-  ee_->getFunctionAddress("__some_name_that_hopefully_doesnt_exist__b49f8aaade5877eaba7583b91");
+  llvm::DataLayout layout(tm->createDataLayout());
+  ICHECK(layout == module_->getDataLayout())
+      << "Data layout mismatch between module("
+      << module_->getDataLayout().getStringRepresentation() << ")"
+      << " and ORC JIT (" << layout.getStringRepresentation() << ")";
+
+  llvm::orc::JITTargetMachineBuilder tm_builder(tm->getTargetTriple());
+  tm_builder.setCPU(llvm_target->GetCPU())
+      .addFeatures(llvm_target->GetTargetFeatures().vec())
+      .setOptions(llvm_target->GetTargetOptions())
+      .setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+
+  // Objects are cached on disk when TVM_LLVM_JIT_CACHE_DIR is set.
+  if (const char* cache_dir = std::getenv("TVM_LLVM_JIT_CACHE_DIR")) {
+    object_cache_ = std::make_unique<LLVMObjectCache>(cache_dir, llvm_target->str());
+  }
+  // Functions compile on their first call, on the calling thread.
+  LLVMObjectCache* object_cache = object_cache_.get();
+  auto compile_function_creator = [object_cache](llvm::orc::JITTargetMachineBuilder jtmb)
+      -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+    return std::make_unique<llvm::orc::ConcurrentIRCompiler>(std::move(jtmb), object_cache);
+  };
+
+  llvm::orc::LLLazyJITBuilder lazy_builder;
+  lazy_builder.setJITTargetMachineBuilder(tm_builder)
+      .setCompileFunctionCreator(compile_function_creator);
+#if TVM_LLVM_VERSION >= 160
+  lazy_builder.setLazyCompileFailureAddr(
+      llvm::orc::ExecutorAddr::fromPtr(&ORCJITLazyCompileFailure));
+#else
+  lazy_builder.setLazyCompileFailureAddr(
+      llvm::pointerToJITTargetAddress(&ORCJITLazyCompileFailure));
+#endif
+  bool lazy = true;
+  if (auto jit = lazy_builder.create()) {
+    orcjit_ee_ = std::move(jit.get());
+  } else {
+    // Lazy call-through stubs are not available on every architecture, compile eagerly there.
+    std::string reason = llvm::toString(jit.takeError());
+    DLOG(INFO) << "Falling back to eager ORC JIT: " << reason;
+    lazy = false;
+    llvm::orc::LLJITBuilder builder;
+    builder.setJITTargetMachineBuilder(tm_builder).setCompileFunctionCreator(
+        compile_function_creator);
+    auto eager_jit = builder.create();
+    ICHECK(eager_jit) << "Failed to initialize ORC JIT for " << module_->getTargetTriple() << ": "
+                      << llvm::toString(eager_jit.takeError());
+    orcjit_ee_ = std::move(eager_jit.get());
+  }
+
+  // Resolve runtime functions (e.g. __truncsfhf2) from the current process.
+  llvm::orc::JITDylib& dylib = orcjit_ee_->getMainJITDylib();
+  dylib.addGenerator(llvm::cantFail(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+      layout.getGlobalPrefix())));
+
+  // The JIT owns the context of the modules it compiles, so hand it a copy of the module in a
+  // fresh context. module_ stays valid for GetSource and the symbol queries.
+  llvm::SmallVector<char, 0> bitcode;
+  {
+    llvm::raw_svector_ostream os(bitcode);
+    llvm::WriteBitcodeToFile(*module_, os);
+  }
+  auto context = std::make_unique<llvm::LLVMContext>();
+  llvm::Expected<std::unique_ptr<llvm::Module>> copy = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()), "TVMMod"), *context);
+  ICHECK(copy) << "Failed to copy the module for ORC JIT: " << llvm::toString(copy.takeError());
+  llvm::orc::ThreadSafeModule tsm(std::move(copy.get()), std::move(context));
+  llvm::Error err = lazy ? static_cast<llvm::orc::LLLazyJIT*>(orcjit_ee_.get())
+                               ->addLazyIRModule(std::move(tsm))
+                         : orcjit_ee_->addIRModule(std::move(tsm));
+  ICHECK(!err) << "Failed to add module to ORC JIT: " << llvm::toString(std::move(err));
+  err = orcjit_ee_->initialize(dylib);
+  ICHECK(!err) << "Failed to run static constructors: " << llvm::toString(std::move(err));
+#else
+  LOG(FATAL) << "ORC JIT requires LLVM 13 or newer";
+#endif
+}
+
+#if TVM_LLVM_VERSION >= 130
+namespace {
+void* LookupORCJIT(llvm::orc::LLJIT* jit, const std::string& name) {
+  auto symbol = jit->lookup(name);
+  if (!symbol) {
+    // Same as MCJIT, which returns a null address for symbols without a definition.
+    llvm::consumeError(symbol.takeError());
+    return nullptr;
+  }
+#if TVM_LLVM_VERSION >= 150
+  return reinterpret_cast<void*>(symbol->getValue());
+#else
+  return reinterpret_cast<void*>(symbol->getAddress());
+#endif
 }
+}  // namespace
+#endif
 
 bool LLVMModuleNode::IsCompatibleWithHost(const llvm::TargetMachine* tm) const {
   LLVMTargetInfo host_target(*llvm_instance_, "llvm");
@@ -404,6 +659,9 @@ bool LLVMModuleNode::IsCompatibleWithHost(const llvm::TargetMachine* tm) const {
 void* LLVMModuleNode::GetGlobalAddr(const std::string& name, const LLVMTarget& llvm_target) const {
   // first verifies if GV exists.
   if (module_->getGlobalVariable(name) != nullptr) {
+#if TVM_LLVM_VERSION >= 130
+    if (orcjit_ee_ != nullptr) return LookupORCJIT(orcjit_ee_.get(), name);
+#endif
     return reinterpret_cast<void*>(ee_->getGlobalValueAddress(name));
   } else {
     return nullptr;
@@ -414,6 +672,9 @@ void* LLVMModuleNode::GetFunctionAddr(const std::string& name,
                                       const LLVMTarget& llvm_target) const {
   // first verifies if GV exists.
   if (module_->getFunction(name) != nullptr) {
+#if TVM_LLVM_VERSION >= 130
+    if (orcjit_ee_ != nullptr) return LookupORCJIT(orcjit_ee_.get(), name);
+#endif
     return reinterpret_cast<void*>(ee_->getFunctionAddress(name));
   } else {
     return nullptr;
@@ -465,6 +726,10 @@ TVM_REGISTER_GLOBAL("target.llvm_version_major").set_body_typed([]() -> int {
   return TVM_LLVM_VERSION / 10;
 });
 
+TVM_REGISTER_GLOBAL("target.llvm_jit_object_cache_hits").set_body_typed([]() -> int64_t {
+  return LLVMObjectCache::num_hits.load();
+});
+
 TVM_REGISTER_GLOBAL("runtime.module.loadfile_ll")
     .set_body_typed([](std::string filename, std::string fmt) -> runtime::Module {
       auto n = make_object<LLVMModuleNode>();
@@ -290,6 +290,22 @@ void CodeGenStackVM::VisitExpr_(const CallNode* op) {
     this->Push(op->args[0]);
     this->PushOp(StackVM::PUSH_I64, 0);
     this->PushOp(StackVM::EQ_HANDLE);
+  } else if (op->op.same_as(builtin::if_then_else())) {
+    // Only evaluate the selected branch, the other one can be unsafe, e.g. a guarded load.
+    ICHECK_EQ(op->args.size(), 3U);
+    this->Push(op->args[0]);
+    int64_t label_ejump = this->GetPC();
+    int64_t else_jump = this->PushOp(StackVM::RJUMP_IF_FALSE, 0);
+    this->PushOp(StackVM::POP);
+    this->Push(op->args[1]);
+    int64_t label_then_jump = this->GetPC();
+    int64_t then_jump = this->PushOp(StackVM::RJUMP, 0);
+    int64_t else_begin = this->GetPC();
+    this->SetOperand(else_jump, else_begin - label_ejump);
+    this->PushOp(StackVM::POP);
+    this->Push(op->args[2]);
+    int64_t if_end = this->GetPC();
+    this->SetOperand(then_jump, if_end - label_then_jump);
   } else {
     LOG(FATAL) << "unknown function call " << op->op;
   }
@@ -274,6 +274,15 @@ TVM_REGISTER_TARGET_KIND("llvm", kDLCPU)
     .add_attr_option<Bool>("fast-math-contract")
     .add_attr_option<Bool>("fast-math-reassoc")
     .add_attr_option<Integer>("opt-level")
+    // The JIT engine used to run modules in process, "mcjit" (default) or "orcjit"
+    .add_attr_option<String>("jit")
+    // Software prefetching of streaming loads in reduction loops, and the latency in cycles
+    // the prefetches hide (200 by default)
+    .add_attr_option<Bool>("sw-prefetch")
+    .add_attr_option<Integer>("sw-prefetch-latency")
+    // Use the cache-blocked layout transform kernel of the C++ runtime, which the runtime of
+    // the deployment has to be built with
+    .add_attr_option<Bool>("layout-transform-kernel")
     // LLVM command line flags, see below
     .add_attr_option<Array<String>>("cl-opt")
     .set_default_keys({"cpu"})
@@ -58,6 +58,17 @@ class PrimFuncPassNode : public PassNode {
    */
   PassInfo Info() const override { return pass_info; }
 
+  /*!
+   * \brief Run the pass on the functions concurrently. Only used for passes marked
+   *  thread-safe, when enabled by the config "ir.function_pass_num_threads".
+   *
+   * \param mod The module that an optimization pass is applied on.
+   * \param pass_ctx The context that an optimization pass executes on.
+   *
+   * \return Return the updated module.
+   */
+  IRModule RunParallel(IRModule mod, const PassContext& pass_ctx) const;
+
   static constexpr const char* _type_key = "tir.PrimFuncPass";
   TVM_DECLARE_FINAL_OBJECT_INFO(PrimFuncPassNode, PassNode);
 };
@@ -88,6 +99,9 @@ PrimFuncPass::PrimFuncPass(
 // Perform Module -> Module optimizations at the PrimFunc level.
 IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx) const {
   ICHECK(mod.defined());
+  if (GetFunctionPassNumThreads(pass_ctx, pass_info, mod->functions.size()) > 1) {
+    return RunParallel(std::move(mod), pass_ctx);
+  }
   std::vector<ObjectRef> deleted_list;
   IRModuleNode* mod_ptr = mod.CopyOnWrite();
   auto* func_dict = mod_ptr->functions.CopyOnWrite();
@@ -113,10 +127,37 @@ IRModule PrimFuncPassNode::operator()(IRModule mod, const PassContext& pass_ctx)
   return mod;
 }
 
+IRModule PrimFuncPassNode::RunParallel(IRModule mod, const PassContext& pass_ctx) const {
+  Array<GlobalVar> gvars;
+  std::vector<PrimFunc> funcs;
+  for (const auto& kv : mod->functions) {
+    if (const auto* func = kv.second.as<PrimFuncNode>()) {
+      gvars.push_back(kv.first);
+      funcs.push_back(GetRef<PrimFunc>(func));
+    }
+  }
+  // Every function is transformed against the same, unchanged module; the results are
+  // merged into a copy of the module once all of them are done.
+  std::vector<PrimFunc> updated(funcs.size());
+  ForEachFunction(pass_ctx, pass_info, gvars,
+                  [&](int i) { updated[i] = pass_func(funcs[i], mod, pass_ctx); });
+
+  IRModuleNode* mod_ptr = mod.CopyOnWrite();
+  for (size_t i = 0; i < funcs.size(); ++i) {
+    if (updated[i].defined()) {
+      mod_ptr->functions.Set(gvars[i], updated[i]);
+    } else {
+      // automatic removal of None
+      mod_ptr->functions.erase(gvars[i]);
+    }
+  }
+  return mod;
+}
+
 Pass CreatePrimFuncPass(
     const runtime::TypedPackedFunc<PrimFunc(PrimFunc, IRModule, PassContext)>& pass_func,
-    int opt_level, String name, tvm::Array<String> required) {
-  PassInfo pass_info = PassInfo(opt_level, name, required);
+    int opt_level, String name, tvm::Array<String> required, bool thread_safe) {
+  PassInfo pass_info = PassInfo(opt_level, name, required, thread_safe);
   return PrimFuncPass(pass_func, pass_info);
 }
 
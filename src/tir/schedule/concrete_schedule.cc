@@ -18,6 +18,7 @@
  */
 #include "./concrete_schedule.h"
 
+#include <atomic>
 #include <random>
 
 namespace tvm {
@@ -192,18 +193,47 @@ void ConcreteScheduleNode::Copy(ScheduleState* new_state, TSymbolTable* new_symb
   new_state->get()->DebugVerify();
 }
 
+void ConcreteScheduleNode::DetachState() {
+  if (state_fork_token_.use_count() > 1) {
+    ScheduleState new_state;
+    TSymbolTable new_symbol_table;
+    ConcreteScheduleNode::Copy(&new_state, &new_symbol_table);
+    state_ = std::move(new_state);
+    symbol_table_ = std::move(new_symbol_table);
+  } else {
+    // All the other forks have detached or been destroyed. Synchronize with the reads they did
+    // on the shared state before taking it over.
+    std::atomic_thread_fence(std::memory_order_acquire);
+  }
+  state_fork_token_.reset();
+}
+
+void ConcreteScheduleNode::ForkState(ConcreteScheduleNode* fork) {
+  if (state_fork_token_ == nullptr) {
+    state_fork_token_ = std::make_shared<const int>(0);
+  }
+  fork->state_ = this->state_;
+  fork->symbol_table_ = this->symbol_table_;
+  fork->state_fork_token_ = this->state_fork_token_;
+}
+
 Schedule ConcreteScheduleNode::Copy() {
   ObjectPtr<ConcreteScheduleNode> n = make_object<ConcreteScheduleNode>();
   n->func_working_on_ = this->func_working_on_;
   n->error_render_level_ = this->error_render_level_;
-  ConcreteScheduleNode::Copy(&n->state_, &n->symbol_table_);
+  ForkState(n.get());
   n->analyzer_ = std::make_unique<arith::Analyzer>();  // new analyzer needed because it is stateful
   n->rand_state_ = ForkSeed();
   return Schedule(std::move(n));
 }
 
-/*! \brief Macro that guards the beginning of each invocation of TensorIR schedule primitive */
-#define TVM_TIR_SCHEDULE_BEGIN() try {
+/*!
+ * \brief Macro that guards the beginning of each invocation of TensorIR schedule primitive.
+ * The state is detached from the forked schedules before it is read as an argument.
+ */
+#define TVM_TIR_SCHEDULE_BEGIN() \
+  this->EnsureUniqueState();     \
+  try {
 /*!
  * \brief Macro that pairs with `TVM_TIR_SCHEDULE_BEGIN`, handling potential errors and error
  * message rendering
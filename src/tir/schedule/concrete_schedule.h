@@ -48,6 +48,12 @@ class ConcreteScheduleNode : public ScheduleNode {
   std::unique_ptr<arith::Analyzer> analyzer_;
   /*! \brief The value of random state for sampling. */
   support::LinearCongruentialEngine::TRandState rand_state_;
+  /*!
+   * \brief A token shared by the schedules forked from each other by `Copy` that have not yet
+   * detached. While it is shared, `state_` and the srefs in `symbol_table_` are shared as well,
+   * and are deep-copied lazily before they are mutated or exposed.
+   */
+  std::shared_ptr<const int> state_fork_token_{nullptr};
 
  public:
   void VisitAttrs(tvm::AttrVisitor* v) {
@@ -62,7 +68,11 @@ class ConcreteScheduleNode : public ScheduleNode {
   virtual ~ConcreteScheduleNode() = default;
 
  public:
-  ScheduleState state() const final { return state_; }
+  IRModule mod() const override { return state_->mod; }
+  ScheduleState state() const final {
+    const_cast<ConcreteScheduleNode*>(this)->EnsureUniqueState();
+    return state_;
+  }
   Optional<Trace> trace() const override { return NullOpt; }
   void WorkOn(const String& func_name) final;
   Schedule Copy() override;
@@ -167,6 +177,19 @@ class ConcreteScheduleNode : public ScheduleNode {
    * \param new_symbol_table The symbol table copied
    */
   void Copy(ScheduleState* new_state, TSymbolTable* new_symbol_table) const;
+  /*!
+   * \brief Make sure the schedule state and the srefs in the symbol table are not shared with any
+   * forked schedule, so that they can be mutated or handed out safely.
+   */
+  inline void EnsureUniqueState();
+  /*! \brief The slow path of `EnsureUniqueState`, deep-copying the state if it is shared */
+  void DetachState();
+  /*!
+   * \brief Share the schedule state and the symbol table with a newly forked schedule. The deep
+   * copy is deferred until either of them calls `EnsureUniqueState`.
+   * \param fork The forked schedule
+   */
+  void ForkState(ConcreteScheduleNode* fork);
   /*!
    * \brief Add srefs as random variables into the symbol table
    * \tparam T The type of the random variables
@@ -208,6 +231,12 @@ class ConcreteScheduleNode : public ScheduleNode {
 
 // implementations
 
+inline void ConcreteScheduleNode::EnsureUniqueState() {
+  if (state_fork_token_ != nullptr) {
+    DetachState();
+  }
+}
+
 /******** Lookup random variables ********/
 
 inline Block ConcreteScheduleNode::Get(const BlockRV& block_rv) const {
@@ -249,6 +278,7 @@ inline bool ConcreteScheduleNode::HasBlock(const BlockRV& block_rv) const {
 }
 
 inline StmtSRef ConcreteScheduleNode::GetSRef(const BlockRV& block_rv) const {
+  const_cast<ConcreteScheduleNode*>(this)->EnsureUniqueState();
   auto it = this->symbol_table_.find(block_rv);
   if (it == this->symbol_table_.end()) {
     LOG(FATAL) << "IndexError: Cannot find corresponding BlockRV: " << block_rv;
@@ -268,6 +298,7 @@ inline StmtSRef ConcreteScheduleNode::GetSRef(const BlockRV& block_rv) const {
 inline StmtSRef ConcreteScheduleNode::GetSRef(const LoopRV& loop_rv) const {
   static StmtSRef inline_mark = StmtSRef::InlineMark();
   static StmtSRef root_mark = StmtSRef::RootMark();
+  const_cast<ConcreteScheduleNode*>(this)->EnsureUniqueState();
   auto it = this->symbol_table_.find(loop_rv);
   if (it == this->symbol_table_.end()) {
     LOG(FATAL) << "IndexError: Cannot find corresponding LoopRV: " << loop_rv;
@@ -184,11 +184,16 @@ class BF16LowerRewriter : public StmtExprMutator {
       PrimExpr float32_v = is_from_float32 ? op_val : Cast(float32_dtype, op_val);
       PrimExpr uint32_v = Call(uint32_dtype, builtin::reinterpret(), {float32_v});
       DataType uint16_dtype(kDLUInt, 16, op_val->dtype.lanes());
-      /* the following TIR is equivalent to the C++ code below:
+      /* the following TIR is equivalent to the C++ code below, which matches
+      RoundToNearestEven; NaNs are quieted as rounding could turn them into infinities:
+      if ((U32 & 0x7FFFFFFF) > 0x7F800000) return UINT16_C(0x7FC0);
       uint32_t rounding_bias = ((U32 >> 16) & 1) + UINT32_C(0x7FFF);
       return static_cast<uint16_t>((U32 + rounding_bias) >> 16);*/
       PrimExpr rounding_bias = ((uint32_v >> 16) & 1) + make_const(uint16_dtype, 0x7FFF);
-      return Cast(uint16_dtype, {(uint32_v + rounding_bias) >> 16});
+      PrimExpr rounded = Cast(uint16_dtype, {(uint32_v + rounding_bias) >> 16});
+      PrimExpr is_nan = (uint32_v & make_const(uint32_dtype, 0x7FFFFFFF)) >
+                        make_const(uint32_dtype, 0x7F800000);
+      return Select(is_nan, make_const(uint16_dtype, 0x7FC0), rounded);
     }
     if (op->value.same_as(op_val)) return GetRef<PrimExpr>(op);
     return Cast(op->dtype, op_val);
@@ -0,0 +1,253 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file inject_software_prefetch.cc
+ * \brief Insert prefetches for the streaming loads of innermost reduction loops on CPU.
+ */
+#include <tvm/arith/analyzer.h>
+#include <tvm/arith/pattern.h>
+#include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
+#include <tvm/tir/analysis.h>
+#include <tvm/tir/builtin.h>
+#include <tvm/tir/op.h>
+#include <tvm/tir/stmt_functor.h>
+#include <tvm/tir/transform.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ir_utils.h"
+
+namespace tvm {
+namespace tir {
+
+/*! \brief The size of a cache line, the granularity of the prefetches. */
+constexpr int64_t kCacheLineBytes = 64;
+/*! \brief The maximum number of streams prefetched by a loop. */
+constexpr size_t kMaxPrefetchStreams = 4;
+/*! \brief The default number of cycles of memory latency to hide. */
+constexpr int64_t kDefaultPrefetchLatency = 200;
+
+/*! \brief Estimate the number of cycles of an iteration from the complexity of its expressions. */
+class IterationCostEstimator : public StmtVisitor {
+ public:
+  static int64_t Estimate(const Stmt& stmt) {
+    IterationCostEstimator estimator;
+    estimator(stmt);
+    return std::max<int64_t>(estimator.cost_, 1);
+  }
+
+ private:
+  void VisitStmt_(const ForNode* op) final {
+    int64_t outer = cost_;
+    cost_ = 0;
+    StmtVisitor::VisitStmt_(op);
+    const auto* extent = op->extent.as<IntImmNode>();
+    cost_ = outer + cost_ * (extent != nullptr ? std::max<int64_t>(extent->value, 1) : 1);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    cost_ += static_cast<int64_t>(CalculateExprComplexity(op->value));
+  }
+
+  void VisitStmt_(const EvaluateNode* op) final {
+    cost_ += static_cast<int64_t>(CalculateExprComplexity(op->value));
+  }
+
+  int64_t cost_{0};
+};
+
+/*!
+ * \brief Insert prefetches into the innermost serial loops that accumulate into loop invariant
+ *  locations, i.e. reduction loops.
+ *
+ * A load of a global buffer whose flattened index advances by a constant stride with the loop
+ * variable is a stream. Its address `distance` iterations ahead is prefetched at the beginning of
+ * each iteration, where the distance covers the memory latency given the estimated cost of an
+ * iteration, and is at least one cache line.
+ */
+class SoftwarePrefetchInjector : public StmtExprMutator {
+ public:
+  explicit SoftwarePrefetchInjector(int64_t latency) : latency_(latency) {}
+
+  Stmt VisitStmt_(const ForNode* op) final {
+    // Whether a loop was found among the siblings visited before this one.
+    bool found_sibling_loop = found_loop_;
+    found_loop_ = false;
+    Stmt ret = StmtExprMutator::VisitStmt_(op);
+    bool has_inner_loop = found_loop_;
+    // Unrolled loops are expanded later and do not end the search for the innermost loop.
+    found_loop_ = found_sibling_loop || op->kind != ForKind::kUnrolled || has_inner_loop;
+    if (has_inner_loop || op->kind != ForKind::kSerial) {
+      return ret;
+    }
+    return InjectPrefetch(Downcast<For>(ret));
+  }
+
+ private:
+  /*! \brief A streaming load to prefetch. */
+  struct Stream {
+    Buffer buffer;
+    PrimExpr index;
+    int64_t stride;
+  };
+
+  Stmt InjectPrefetch(For loop) {
+    const Var& var = loop->loop_var;
+    auto uses_loop_var = [&var](const VarNode* v) { return v == var.get(); };
+
+    bool is_reduction = false;
+    bool has_prefetch = false;
+    std::unordered_map<const VarNode*, PrimExpr> inner_loop_min;
+    std::unordered_set<const VarNode*> inner_defs;
+    std::vector<const BufferLoadNode*> loads;
+    PostOrderVisit(loop->body, [&](const ObjectRef& node) {
+      if (const auto* store = node.as<BufferStoreNode>()) {
+        bool invariant = true;
+        for (const PrimExpr& index : store->indices) {
+          invariant = invariant && !UsesVar(index, uses_loop_var);
+        }
+        is_reduction = is_reduction || invariant;
+      } else if (const auto* load = node.as<BufferLoadNode>()) {
+        loads.push_back(load);
+      } else if (const auto* call = node.as<CallNode>()) {
+        has_prefetch = has_prefetch || call->op.same_as(builtin::prefetch());
+      } else if (const auto* inner = node.as<ForNode>()) {
+        inner_loop_min[inner->loop_var.get()] = inner->min;
+      } else if (const auto* let = node.as<LetStmtNode>()) {
+        inner_defs.insert(let->var.get());
+      } else if (const auto* let = node.as<LetNode>()) {
+        inner_defs.insert(let->var.get());
+      } else if (const auto* alloc = node.as<AllocateNode>()) {
+        inner_defs.insert(alloc->buffer_var.get());
+      }
+    });
+    if (!is_reduction || has_prefetch || loads.empty()) {
+      return std::move(loop);
+    }
+
+    std::vector<Stream> streams;
+    for (const BufferLoadNode* load : loads) {
+      if (streams.size() == kMaxPrefetchStreams) break;
+      if (load->indices.size() != 1) continue;
+      String scope = GetPtrStorageScope(load->buffer->data);
+      if (scope != "global" && scope != "") continue;
+      PrimExpr index = load->indices[0];
+      if (const auto* ramp = index.as<RampNode>()) {
+        index = ramp->base;
+      }
+      if (index.dtype().lanes() != 1) continue;
+      // Prefetch the first iteration of inner unrolled loops, which are short.
+      index = Substitute(index, [&](const Var& v) -> Optional<PrimExpr> {
+        auto it = inner_loop_min.find(v.get());
+        if (it != inner_loop_min.end()) return it->second;
+        return NullOpt;
+      });
+      if (UsesVar(index, [&](const VarNode* v) {
+            return inner_defs.count(v) || inner_loop_min.count(v);
+          })) {
+        continue;
+      }
+      Array<PrimExpr> coeffs = arith::DetectLinearEquation(index, {var});
+      if (coeffs.empty()) continue;
+      const auto* stride = coeffs[0].as<IntImmNode>();
+      if (stride == nullptr || stride->value == 0) continue;
+      // Loads of the same stream within a cache line share the prefetch.
+      int64_t elem_bytes = load->buffer->dtype.bytes();
+      bool covered = false;
+      for (const Stream& stream : streams) {
+        if (!stream.buffer->data.same_as(load->buffer->data) || stream.stride != stride->value) {
+          continue;
+        }
+        PrimExpr diff = analyzer_.Simplify(index - stream.index);
+        const auto* diff_imm = diff.as<IntImmNode>();
+        if (diff_imm != nullptr && std::abs(diff_imm->value) * elem_bytes < kCacheLineBytes) {
+          covered = true;
+          break;
+        }
+      }
+      if (!covered) {
+        streams.push_back(Stream{load->buffer, index, stride->value});
+      }
+    }
+    if (streams.empty()) {
+      return std::move(loop);
+    }
+
+    int64_t cost = IterationCostEstimator::Estimate(loop->body);
+    std::vector<Stmt> seq;
+    for (const Stream& stream : streams) {
+      int64_t stride_bytes = std::abs(stream.stride) * stream.buffer->dtype.bytes();
+      if (const auto* extent = loop->extent.as<IntImmNode>()) {
+        // The whole loop touches a single cache line.
+        if (extent->value * stride_bytes <= kCacheLineBytes) continue;
+      }
+      int64_t distance = (latency_ + cost - 1) / cost;
+      distance = std::max(distance, (kCacheLineBytes + stride_bytes - 1) / stride_bytes);
+      Map<Var, PrimExpr> ahead{{var, var + make_const(var.dtype(), distance)}};
+      PrimExpr index = Substitute(stream.index, ahead);
+      PrimExpr load = BufferLoad(stream.buffer, {analyzer_.Simplify(index)});
+      PrimExpr address = Call(DataType::Handle(), builtin::address_of(), {load});
+      seq.push_back(Evaluate(Call(stream.buffer->dtype, builtin::prefetch(), {address, 0, 3, 1})));
+    }
+    if (seq.empty()) {
+      return std::move(loop);
+    }
+    seq.push_back(loop->body);
+    loop.CopyOnWrite()->body = SeqStmt(seq);
+    return std::move(loop);
+  }
+
+  /*! \brief The number of cycles of memory latency to hide. */
+  int64_t latency_;
+  /*! \brief Whether a loop, other than an unrolled one, was found in the visited statement. */
+  bool found_loop_{false};
+  arith::Analyzer analyzer_;
+};
+
+namespace transform {
+
+Pass InjectSoftwarePrefetch() {
+  auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
+    Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+    if (!target.defined() || target.value()->GetTargetDeviceType() != kDLCPU ||
+        !target.value()->GetAttr<Bool>("sw-prefetch").value_or(Bool(false))) {
+      return f;
+    }
+    int64_t latency = target.value()
+                          ->GetAttr<Integer>("sw-prefetch-latency")
+                          .value_or(Integer(kDefaultPrefetchLatency))
+                          ->value;
+    auto* n = f.CopyOnWrite();
+    n->body = SoftwarePrefetchInjector(latency)(std::move(n->body));
+    return f;
+  };
+  return CreatePrimFuncPass(pass_func, 0, "tir.InjectSoftwarePrefetch", {});
+}
+
+TVM_REGISTER_GLOBAL("tir.transform.InjectSoftwarePrefetch").set_body_typed(InjectSoftwarePrefetch);
+
+}  // namespace transform
+
+}  // namespace tir
+}  // namespace tvm
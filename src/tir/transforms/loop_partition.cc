@@ -29,6 +29,7 @@
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
+#include <algorithm>
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
@@ -44,6 +45,9 @@ struct LoopPartitionConfigNode : public tvm::AttrsNode<LoopPartitionConfigNode>
   bool partition_const_loop;
   bool no_unroll_loop_with_extent_one;
   bool unroll_loop_with_partition_hint_no_interval;
+  bool cost_guided;
+  double min_hot_iteration_ratio;
+  int code_size_budget;
 
   TVM_DECLARE_ATTRS(LoopPartitionConfigNode, "tir.transform.LoopPartitionConfig") {
     TVM_ATTR_FIELD(partition_const_loop).describe("Split constant loop").set_default(false);
@@ -53,6 +57,15 @@ struct LoopPartitionConfigNode : public tvm::AttrsNode<LoopPartitionConfigNode>
     TVM_ATTR_FIELD(unroll_loop_with_partition_hint_no_interval)
         .describe("Unroll loops with pragma_loop_partition_hint and no interval")
         .set_default(false);
+    TVM_ATTR_FIELD(cost_guided)
+        .describe("Only partition when the condition free partition runs most of the iterations")
+        .set_default(false);
+    TVM_ATTR_FIELD(min_hot_iteration_ratio)
+        .describe("Minimum estimated share of the iterations in the condition free partition")
+        .set_default(0.5);
+    TVM_ATTR_FIELD(code_size_budget)
+        .describe("Maximum estimated code size growth per function in instructions, -1 for none")
+        .set_default(-1);
   }
 };
 
@@ -377,15 +390,59 @@ class ThreadPartitionInserter : public StmtMutator {
   bool innermost_thread_scope_;
 };
 
+// Estimate the number of instructions generated for a statement, i.e. the number of
+// statements and expression nodes, with the body of unrolled loops repeated.
+class CodeSizeEstimator : public StmtExprVisitor {
+ public:
+  static int64_t Estimate(const Stmt& stmt) {
+    CodeSizeEstimator estimator;
+    estimator(stmt);
+    return estimator.size_;
+  }
+
+  void VisitStmt(const Stmt& stmt) final {
+    ++size_;
+    StmtExprVisitor::VisitStmt(stmt);
+  }
+
+  void VisitExpr(const PrimExpr& expr) final {
+    ++size_;
+    StmtExprVisitor::VisitExpr(expr);
+  }
+
+  void VisitStmt_(const ForNode* op) final {
+    const auto* extent = op->extent.as<IntImmNode>();
+    if (op->kind != ForKind::kUnrolled || extent == nullptr) {
+      StmtExprVisitor::VisitStmt_(op);
+      return;
+    }
+    int64_t outer = size_;
+    size_ = 0;
+    this->VisitStmt(op->body);
+    size_ = outer + size_ * std::max<int64_t>(extent->value, 1);
+  }
+
+ private:
+  int64_t size_{0};
+};
+
 // Try to partition range of iteration variables in order to remove (some)
 // likely conditions
 class LoopPartitioner : public StmtMutator {
  public:
   explicit LoopPartitioner(bool partition_const_loop, bool no_unroll_loop_with_extent_one,
-                           bool unroll_loop_with_partition_hint_no_interval)
-      : selector(CandidateSelector(partition_const_loop)),
+                           bool unroll_loop_with_partition_hint_no_interval,
+                           bool cost_guided = false, double min_hot_iteration_ratio = 0.5,
+                           int64_t code_size_budget = -1, bool enable_memoization = false)
+      // Cost guided partitioning decides for constant loops as well.
+      : selector(CandidateSelector(partition_const_loop || cost_guided)),
         no_unroll_loop_with_extent_one_(no_unroll_loop_with_extent_one),
-        unroll_loop_with_partition_hint_no_interval_(unroll_loop_with_partition_hint_no_interval) {}
+        unroll_loop_with_partition_hint_no_interval_(unroll_loop_with_partition_hint_no_interval),
+        cost_guided_(cost_guided),
+        min_hot_iteration_ratio_(min_hot_iteration_ratio),
+        code_size_budget_(code_size_budget) {
+    analyzer_.EnableMemoization(enable_memoization);
+  }
 
   Stmt VisitAndMutate(Stmt stmt) {
     selector(stmt);
@@ -448,6 +505,11 @@ class LoopPartitioner : public StmtMutator {
 
   inline Stmt MakeFor(const Object* op, PrimExpr extent, Stmt body);
 
+  double EstimateIterationShare(PrimExpr min, PrimExpr max, PrimExpr begin, PrimExpr end);
+
+  bool ShouldPartition(const Stmt& stmt, PrimExpr min, PrimExpr max, PrimExpr begin,
+                       PrimExpr end, const Array<Stmt>& partitions);
+
   /* Candidate IRs that may be partitioned potentially */
   std::unordered_map<const VarNode*, IntSet> hint_map_;
   std::unordered_map<const VarNode*, IntSet> relax_map_;
@@ -455,8 +517,49 @@ class LoopPartitioner : public StmtMutator {
   CandidateSelector selector;
   bool no_unroll_loop_with_extent_one_;
   bool unroll_loop_with_partition_hint_no_interval_;
+  // Whether partitions are decided by the estimated iteration share and code size.
+  bool cost_guided_;
+  double min_hot_iteration_ratio_;
+  // The remaining code size growth allowed, negative for no limit.
+  int64_t code_size_budget_;
 };
 
+// Estimates the share of the iterations of [min, max] that run in [begin, end). A loop
+// of symbolic extent is assumed to be much longer than its tails when they are bounded,
+// and to split its iterations evenly otherwise.
+double LoopPartitioner::EstimateIterationShare(PrimExpr min, PrimExpr max, PrimExpr begin,
+                                               PrimExpr end) {
+  PrimExpr total = analyzer_.Simplify(max - min + 1);
+  PrimExpr tails = analyzer_.Simplify((begin - min) + (max + 1 - end));
+  arith::ConstIntBound tail_bound = analyzer_.const_int_bound(tails);
+  if (const auto* total_imm = total.as<IntImmNode>()) {
+    if (total_imm->value <= 0) return 0.0;
+    if (tail_bound->max_value == arith::ConstIntBound::kPosInf) return 0.5;
+    int64_t tail = std::min(std::max<int64_t>(tail_bound->max_value, 0), total_imm->value);
+    return 1.0 - static_cast<double>(tail) / static_cast<double>(total_imm->value);
+  }
+  return tail_bound->max_value == arith::ConstIntBound::kPosInf ? 0.5 : 1.0;
+}
+
+// Decides whether to replace stmt by the given partitions when partitioning is cost guided:
+// the condition free partition [begin, end) has to run most of the iterations, and the
+// code size growth has to fit in the budget, which it is then charged to.
+bool LoopPartitioner::ShouldPartition(const Stmt& stmt, PrimExpr min, PrimExpr max,
+                                      PrimExpr begin, PrimExpr end,
+                                      const Array<Stmt>& partitions) {
+  if (!cost_guided_) return true;
+  if (EstimateIterationShare(min, max, begin, end) < min_hot_iteration_ratio_) return false;
+  int64_t growth = -CodeSizeEstimator::Estimate(stmt);
+  for (const Stmt& partition : partitions) {
+    growth += CodeSizeEstimator::Estimate(partition);
+  }
+  if (code_size_budget_ >= 0) {
+    if (growth > code_size_budget_) return false;
+    code_size_budget_ -= std::max<int64_t>(growth, 0);
+  }
+  return true;
+}
+
 // Returns an interval (in the first component) in which all the conditions
 // given in the second component provably have value given by cond_value
 std::pair<IntSet, ExpressionSet> LoopPartitioner::GetIntervalAndCondset(
@@ -670,6 +773,12 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
       Stmt simplified_body = ConditionEliminator(cond_set, cond_value)(body);
       Stmt new_body = Substitute(simplified_body, {{Var{var}, var + body_begin}});
       mid_stmt = MakeFor(stmt.get(), post_doubt_begin - body_begin, new_body);
+      Array<Stmt> partitions{mid_stmt};
+      if (pre_stmt.defined()) partitions.push_back(pre_stmt);
+      if (post_stmt.defined()) partitions.push_back(post_stmt);
+      if (!ShouldPartition(stmt, min, max, body_begin, post_doubt_begin, partitions)) {
+        return Stmt();
+      }
       // Recurse until partitions is empty
       mid_stmt = VisitAndMutate(mid_stmt);
       // Recurse for each non-empty subrange only if there are at least
@@ -682,6 +791,14 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
           post_stmt = VisitAndMutate(post_stmt);
         }
       }
+    } else {
+      // The middle subrange is empty, so the loop is only split at the doubt boundaries.
+      Array<Stmt> partitions;
+      if (pre_stmt.defined()) partitions.push_back(pre_stmt);
+      if (post_stmt.defined()) partitions.push_back(post_stmt);
+      if (!ShouldPartition(stmt, min, max, body_begin, post_doubt_begin, partitions)) {
+        return Stmt();
+      }
     }
     s = SeqStmt::Flatten(pre_stmt, mid_stmt, post_stmt);
   } else {
@@ -689,6 +806,9 @@ Stmt LoopPartitioner::TryPartition(const Stmt& stmt, Var var, PrimExpr min, Prim
     if (!analyzer_.CanProve(body_begin == min)) cond = cond && (var >= body_begin);
     if (!analyzer_.CanProve(post_doubt_begin == (max + 1))) cond = cond && (var < post_doubt_begin);
     s = ThreadPartitionInserter(cond_set, cond)(stmt);
+    if (!ShouldPartition(stmt, min, max, body_begin, post_doubt_begin, {s})) {
+      return Stmt();
+    }
   }
   s = ConvertSSA(s);
   return s;
@@ -728,9 +848,12 @@ class RemoveLikelyTagsAndHints : public StmtExprMutator {
 };
 
 Stmt LoopPartition(Stmt stmt, bool partition_const_loop, bool no_unroll_loop_with_extent_one,
-                   bool unroll_loop_with_partition_hint_no_interval) {
+                   bool unroll_loop_with_partition_hint_no_interval, bool cost_guided = false,
+                   double min_hot_iteration_ratio = 0.5, int64_t code_size_budget = -1,
+                   bool enable_memoization = false) {
   stmt = LoopPartitioner(partition_const_loop, no_unroll_loop_with_extent_one,
-                         unroll_loop_with_partition_hint_no_interval)
+                         unroll_loop_with_partition_hint_no_interval, cost_guided,
+                         min_hot_iteration_ratio, code_size_budget, enable_memoization)
              .VisitAndMutate(std::move(stmt));
   stmt = RemoveLikelyTagsAndHints()(std::move(stmt));
   return stmt;
@@ -747,7 +870,10 @@ Pass LoopPartition() {
     }
     n->body = LoopPartition(std::move(n->body), cfg.value()->partition_const_loop,
                             cfg.value()->no_unroll_loop_with_extent_one,
-                            cfg.value()->unroll_loop_with_partition_hint_no_interval);
+                            cfg.value()->unroll_loop_with_partition_hint_no_interval,
+                            cfg.value()->cost_guided, cfg.value()->min_hot_iteration_ratio,
+                            cfg.value()->code_size_budget,
+                            ctx->GetConfig<Bool>("arith.enable_memoization", Bool(false)).value());
     return f;
   };
   return CreatePrimFuncPass(pass_func, 0, "tir.LoopPartition", {});
@@ -27,6 +27,7 @@
 #include <tvm/tir/buffer.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
+#include <tvm/tir/op.h>
 #include <tvm/tir/stmt_functor.h>
 #include <tvm/tir/transform.h>
 
@@ -188,6 +189,13 @@ PrimFunc MakePackedAPI(PrimFunc&& func) {
     return res;
   };
 
+  // The type codes are not checked if the function is called through its direct-call entry,
+  // which passes a null array of type codes.
+  PrimExpr no_type_codes =
+      Call(DataType::Bool(), builtin::isnullptr(), {buf_packed_arg_type_ids->data});
+  // The kind of each argument for direct calls, see tir::attr::kDirectCallSignature.
+  std::string direct_call_signature;
+
   // Need to re-declare vars, in case some arguments also appears in the buffer.
   std::vector<std::pair<Var, Var>> var_def;
   std::vector<std::pair<Var, Buffer>> buffer_def;
@@ -219,24 +227,31 @@ PrimFunc MakePackedAPI(PrimFunc&& func) {
     seq_init.emplace_back(LetStmt(v_arg, f_arg_value(v_arg.dtype(), i), nop));
     // type code checks
     Var tcode(v_arg->name_hint + ".code", DataType::Int(32));
-    seq_init.emplace_back(
-        LetStmt(tcode, BufferLoad(buf_packed_arg_type_ids, {IntImm(DataType::Int(32), i)}), nop));
+    auto f_check_tcode = [&](PrimExpr cond, const std::string& msg) {
+      PrimExpr checked =
+          Let(tcode, BufferLoad(buf_packed_arg_type_ids, {IntImm(DataType::Int(32), i)}), cond);
+      seq_check.emplace_back(AssertStmt(if_then_else(no_type_codes, const_true(), checked),
+                                        tvm::tir::StringImm(msg), nop));
+    };
     DataType t = v_arg.dtype();
     if (t.is_handle()) {
       std::ostringstream msg;
       msg << name_hint << ": Expect arg[" << i << "] to be pointer";
-      seq_check.emplace_back(AssertStmt(tcode == kTVMOpaqueHandle || tcode == kTVMNDArrayHandle ||
-                                            tcode == kTVMDLTensorHandle || tcode == kTVMNullptr,
-                                        tvm::tir::StringImm(msg.str()), nop));
+      f_check_tcode(tcode == kTVMOpaqueHandle || tcode == kTVMNDArrayHandle ||
+                        tcode == kTVMDLTensorHandle || tcode == kTVMNullptr,
+                    msg.str());
+      direct_call_signature.push_back('h');
     } else if (t.is_int() || t.is_uint()) {
       std::ostringstream msg;
       msg << name_hint << ": Expect arg[" << i << "] to be int";
-      seq_check.emplace_back(AssertStmt(tcode == kDLInt, tvm::tir::StringImm(msg.str()), nop));
+      f_check_tcode(tcode == kDLInt, msg.str());
+      direct_call_signature.push_back('i');
     } else {
       ICHECK(t.is_float());
       std::ostringstream msg;
       msg << name_hint << ": Expect arg[" << i << "] to be float";
-      seq_check.emplace_back(AssertStmt(tcode == kDLFloat, tvm::tir::StringImm(msg.str()), nop));
+      f_check_tcode(tcode == kDLFloat, msg.str());
+      direct_call_signature.push_back('f');
     }
   }
 
@@ -260,6 +275,7 @@ PrimFunc MakePackedAPI(PrimFunc&& func) {
   }
 
   func = WithAttr(std::move(func), tvm::attr::kCallingConv, Integer(CallingConv::kCPackedFunc));
+  func = WithAttr(std::move(func), attr::kDirectCallSignature, String(direct_call_signature));
 
   Stmt body = RewriteReturn(func_ptr->body, v_out_ret_value, v_out_ret_tcode);
   body = AttrStmt(make_zero(DataType::Int(32)), attr::compute_scope,
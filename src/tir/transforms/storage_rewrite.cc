@@ -400,6 +400,10 @@ class StoragePlanRewriter : public StmtExprMutator {
   using StmtEntry = LinearAccessPatternFinder::StmtEntry;
   using AllocEntry = LinearAccessPatternFinder::AllocEntry;
 
+  explicit StoragePlanRewriter(bool enable_memoization = false) {
+    analyzer_.EnableMemoization(enable_memoization);
+  }
+
   Stmt Rewrite(Stmt stmt, bool detect_inplace) {
     detect_inplace_ = detect_inplace;
     // plan the rewrite
@@ -1679,7 +1683,9 @@ namespace transform {
 Pass StorageRewrite() {
   auto pass_func = [](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
-    n->body = StoragePlanRewriter().Rewrite(std::move(n->body), true);
+    bool enable_memoization =
+        ctx->GetConfig<Bool>("arith.enable_memoization", Bool(false)).value();
+    n->body = StoragePlanRewriter(enable_memoization).Rewrite(std::move(n->body), true);
     // Parameters may not be rewritten, but internal allocations may.
     // Vectorization of AllocateConst is currently disabled, as it has
     // indexing issues for types that include padding (e.g. int8x3
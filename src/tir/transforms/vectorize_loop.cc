@@ -23,6 +23,7 @@
 // Loop vectorizer as in Halide pipeline.
 #include <tvm/arith/analyzer.h>
 #include <tvm/runtime/registry.h>
+#include <tvm/target/target.h>
 #include <tvm/tir/analysis.h>
 #include <tvm/tir/builtin.h>
 #include <tvm/tir/expr.h>
@@ -35,9 +36,35 @@
 #include <unordered_set>
 #include <vector>
 
+#include "ir_utils.h"
+
 namespace tvm {
 namespace tir {
 
+struct VectorizeLoopConfigNode : public tvm::AttrsNode<VectorizeLoopConfigNode> {
+  bool enable_masked_tail;
+  int dynamic_extent_lanes;
+
+  TVM_DECLARE_ATTRS(VectorizeLoopConfigNode, "tir.transform.VectorizeLoopConfig") {
+    TVM_ATTR_FIELD(enable_masked_tail)
+        .describe(
+            "Vectorize statements guarded by a lane-varying condition as masked accesses, "
+            "only applied to functions for the llvm target")
+        .set_default(false);
+    TVM_ATTR_FIELD(dynamic_extent_lanes)
+        .describe("Lanes of loops of dynamic extent, vectorized with a masked tail when enabled")
+        .set_default(0);
+  }
+};
+
+class VectorizeLoopConfig : public Attrs {
+ public:
+  TVM_DEFINE_NOTNULLABLE_OBJECT_REF_METHODS(VectorizeLoopConfig, Attrs, VectorizeLoopConfigNode);
+};
+
+TVM_REGISTER_NODE_TYPE(VectorizeLoopConfigNode);
+TVM_REGISTER_PASS_CONFIG_OPTION("tir.VectorizeLoop", VectorizeLoopConfig);
+
 inline PrimExpr BroadcastTo(PrimExpr e, int lanes) {
   if (e.dtype().lanes() == lanes) return e;
   if (const BroadcastNode* op = e.as<BroadcastNode>()) {
@@ -151,6 +178,89 @@ class VecAllocAccess : public StmtExprMutator {
   arith::Analyzer analyzer_;
 };
 
+// Check whether a vectorized statement or expression can run under a lane mask, i.e.
+// the code generator can mask each of its memory accesses and it has no other side
+// effects or lane operations that may trap:
+//
+// - stores and vector loads access contiguous lanes matching the mask.
+// - scalar loads are loop invariant and considered safe.
+// - integer divisions are by constants.
+class MaskableChecker : public StmtExprVisitor {
+ public:
+  static bool Check(const ObjectRef& node, int lanes) {
+    MaskableChecker checker(lanes);
+    if (const auto* stmt = node.as<StmtNode>()) {
+      checker(GetRef<Stmt>(stmt));
+    } else {
+      checker(Downcast<PrimExpr>(node));
+    }
+    return checker.maskable_;
+  }
+
+ private:
+  explicit MaskableChecker(int lanes) : lanes_(lanes) {}
+
+  void VisitStmt(const Stmt& stmt) final {
+    if (!maskable_) return;
+    if (stmt->IsInstance<SeqStmtNode>() || stmt->IsInstance<LetStmtNode>() ||
+        stmt->IsInstance<BufferStoreNode>() || stmt->IsInstance<IfThenElseNode>()) {
+      StmtExprVisitor::VisitStmt(stmt);
+    } else {
+      maskable_ = false;
+    }
+  }
+
+  void VisitExpr(const PrimExpr& expr) final {
+    if (!maskable_) return;
+    StmtExprVisitor::VisitExpr(expr);
+  }
+
+  void VisitStmt_(const BufferStoreNode* op) final {
+    maskable_ = op->value.dtype().lanes() == lanes_ && IsContiguous(op->buffer, op->indices);
+    StmtExprVisitor::VisitStmt_(op);
+  }
+
+  void VisitExpr_(const BufferLoadNode* op) final {
+    if (op->dtype.lanes() != 1) {
+      maskable_ = op->dtype.lanes() == lanes_ && IsContiguous(op->buffer, op->indices);
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const CallNode* op) final {
+    if (SideEffect(GetRef<PrimExpr>(op)) > CallEffectKind::kReadState) {
+      maskable_ = false;
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  void VisitExpr_(const DivNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const ModNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const FloorDivNode* op) final { VisitDivision(op); }
+  void VisitExpr_(const FloorModNode* op) final { VisitDivision(op); }
+
+  template <typename T>
+  void VisitDivision(const T* op) {
+    if (!op->dtype.is_float()) {
+      PrimExpr divisor = op->b;
+      if (const auto* broadcast = divisor.as<BroadcastNode>()) {
+        divisor = broadcast->value;
+      }
+      maskable_ = maskable_ && is_const_int(divisor) && !is_zero(divisor);
+    }
+    StmtExprVisitor::VisitExpr_(op);
+  }
+
+  bool IsContiguous(const Buffer& buffer, const Array<PrimExpr>& indices) {
+    const auto* ramp = indices[indices.size() - 1].as<RampNode>();
+    return buffer->dtype.lanes() == 1 && ramp != nullptr && ramp->lanes == lanes_ &&
+           is_one(ramp->stride);
+  }
+
+  int lanes_;
+  bool maskable_{true};
+};
+
 // We use ExprFunctor directly instead of StmtExprMutator
 // This is because the transformation can change the dtype of the Expr
 // The existing ExprMutator transformation rules may not be well defined.
@@ -159,7 +269,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   using ExprFunctor::VisitExpr;
   using StmtMutator::operator();
 
-  Vectorizer(Var var, int var_lanes) : var_(var), var_lanes_(var_lanes) {
+  Vectorizer(Var var, int var_lanes, bool enable_masked_tail = false)
+      : var_(var), var_lanes_(var_lanes), enable_masked_tail_(enable_masked_tail) {
     ramp_ = Ramp(IntImm(var->dtype, 0), IntImm(var->dtype, 1), var_lanes);
   }
 
@@ -306,6 +417,19 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   PrimExpr MutateIfThenElseExpr_(const CallNode* op) {
     PrimExpr cond = this->VisitExpr(op->args[0]);
     if (cond.dtype().is_vector()) {
+      if (enable_masked_tail_ && !need_scalarize_) {
+        // Evaluate each branch under the mask of its lanes.
+        int lanes = cond.dtype().lanes();
+        PrimExpr t = this->VisitExpr(op->args[1]);
+        PrimExpr f = this->VisitExpr(op->args[2]);
+        if (!need_scalarize_ && t.dtype().lanes() <= lanes && f.dtype().lanes() <= lanes) {
+          t = BroadcastTo(t, lanes);
+          f = BroadcastTo(f, lanes);
+          if (MaskableChecker::Check(t, lanes) && MaskableChecker::Check(f, lanes)) {
+            return Call(op->dtype.with_lanes(lanes), op->op, {cond, t, f});
+          }
+        }
+      }
       need_scalarize_ = true;
       return GetRef<PrimExpr>(op);
     }
@@ -487,6 +611,13 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
     ICHECK(!op->condition.dtype().is_vector());
     PrimExpr condition = this->VisitExpr(op->condition);
     if (condition.dtype().is_vector()) {
+      if (enable_masked_tail_ && !need_scalarize_ && !op->else_case) {
+        // Store the lanes for which the condition holds.
+        Stmt then_case = this->VisitStmt(op->then_case);
+        if (MaskableChecker::Check(then_case, condition.dtype().lanes())) {
+          return IfThenElse(condition, then_case);
+        }
+      }
       return Scalarize(GetRef<Stmt>(op));
     }
     Stmt then_case = this->VisitStmt(op->then_case);
@@ -587,6 +718,8 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
   int var_lanes_;
   // ramp representing the var.
   PrimExpr ramp_;
+  // whether lane-varying conditions are vectorized as masks.
+  bool enable_masked_tail_;
   // flag to mark requirment of scalarization.
   bool need_scalarize_{false};
   // Let binding
@@ -656,18 +789,53 @@ class Vectorizer : public StmtMutator, public ExprFunctor<PrimExpr(const PrimExp
 
 class LoopVectorizer : public StmtMutator {
  public:
+  explicit LoopVectorizer(bool enable_masked_tail = false, int dynamic_extent_lanes = 0)
+      : enable_masked_tail_(enable_masked_tail), dynamic_extent_lanes_(dynamic_extent_lanes) {}
+
   Stmt VisitStmt_(const ForNode* op) final {
     if (op->kind == ForKind::kVectorized) {
       ICHECK(is_zero(op->min));
       auto* extent_as_int = op->extent.as<IntImmNode>();
+      if (!extent_as_int && enable_masked_tail_ && dynamic_extent_lanes_ > 1) {
+        return VectorizeDynamicExtent(op);
+      }
       if (!extent_as_int || extent_as_int->value < 1) {
         LOG(FATAL) << "Failed to vectorize loop with extent " << op->extent;
       }
-      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value))(op->body);
+      return Vectorizer(op->loop_var, static_cast<int>(extent_as_int->value),
+                        enable_masked_tail_)(op->body);
     } else {
       return StmtMutator::VisitStmt_(op);
     }
   }
+
+ private:
+  // Vectorize a loop of dynamic extent by dynamic_extent_lanes_, with a masked tail:
+  //
+  // for (i.outer, 0, floordiv(n, lanes)) body[i = i.outer * lanes + ramp]
+  // if (floordiv(n, lanes) * lanes < n)
+  //   if (base + ramp < n) body[i = base + ramp] with base = floordiv(n, lanes) * lanes
+  Stmt VectorizeDynamicExtent(const ForNode* op) {
+    DataType dtype = op->loop_var.dtype();
+    PrimExpr lanes = make_const(dtype, dynamic_extent_lanes_);
+    PrimExpr num_vectors = floordiv(op->extent, lanes);
+    PrimExpr tail_base = num_vectors * lanes;
+
+    Var outer(op->loop_var->name_hint + ".outer", dtype);
+    Var inner(op->loop_var->name_hint + ".inner", dtype);
+    Stmt body = Substitute(op->body, {{op->loop_var, outer * lanes + inner}});
+    body = Vectorizer(inner, dynamic_extent_lanes_, true)(body);
+    Stmt main_loop = For(outer, make_zero(dtype), num_vectors, ForKind::kSerial, body);
+
+    Stmt tail = Substitute(op->body, {{op->loop_var, tail_base + inner}});
+    tail = IfThenElse(tail_base + inner < op->extent, tail);
+    tail = Vectorizer(inner, dynamic_extent_lanes_, true)(tail);
+    tail = IfThenElse(tail_base < op->extent, tail);
+    return ConvertSSA(SeqStmt({main_loop, tail}));
+  }
+
+  bool enable_masked_tail_;
+  int dynamic_extent_lanes_;
 };
 
 Stmt VectorizeLoop(Stmt stmt) { return LoopVectorizer()(std::move(stmt)); }
@@ -687,6 +855,19 @@ class VectorizeSkipper : public StmtMutator {
 
 Stmt SkipVectorize(Stmt stmt) { return VectorizeSkipper()(std::move(stmt)); }
 
+/*!
+ * \brief Returns whether \p f is compiled for the llvm target, the only codegen which lowers
+ * the vector conditions of masked statements. The pass runs before the target is bound to the
+ * function, so the current target is used when the function has none.
+ */
+bool SupportsMaskedVectorize(const PrimFunc& f) {
+  Optional<Target> target = f->GetAttr<Target>(tvm::attr::kTarget);
+  if (!target.defined()) {
+    target = Target::Current(/*allow_not_defined=*/true);
+  }
+  return target.defined() && target.value()->kind->name == "llvm";
+}
+
 namespace transform {
 
 // TODO(tvm-team): Make it as a target property.
@@ -694,7 +875,13 @@ Pass VectorizeLoop(bool enable_vectorize) {
   auto pass_func = [=](PrimFunc f, IRModule m, PassContext ctx) {
     auto* n = f.CopyOnWrite();
     if (enable_vectorize) {
-      n->body = LoopVectorizer()(std::move(n->body));
+      auto cfg = ctx->GetConfig<VectorizeLoopConfig>("tir.VectorizeLoop");
+      if (!cfg.defined()) {
+        cfg = AttrsWithDefaultValues<VectorizeLoopConfig>();
+      }
+      bool enable_masked_tail = cfg.value()->enable_masked_tail && SupportsMaskedVectorize(f);
+      n->body = LoopVectorizer(enable_masked_tail, cfg.value()->dynamic_extent_lanes)(
+          std::move(n->body));
     } else {
       n->body = VectorizeSkipper()(std::move(n->body));
     }
@@ -54,6 +54,36 @@ TEST(Simplify, Mod) {
   ICHECK(tvm::tir::is_zero(es));
 }
 
+TEST(Simplify, Memoization) {
+  tvm::arith::Analyzer ana;
+  ana.EnableMemoization();
+  auto x = tvm::te::var("x");
+  auto cond = x >= 0;
+  ICHECK(!ana.CanProve(cond));
+  int64_t hits = ana.GetMemoStats().hits;
+  ICHECK(!ana.CanProve(cond));
+  ICHECK_GT(ana.GetMemoStats().hits, hits);
+  {
+    // The constraint changes the known facts, the memoized result must not be used.
+    tvm::With<tvm::arith::ConstraintContext> ctx(&ana, x > 4);
+    ICHECK(ana.CanProve(cond));
+  }
+  // Leaving the scope restores the facts, and the recorded results.
+  hits = ana.GetMemoStats().hits;
+  ICHECK(!ana.CanProve(cond));
+  ICHECK_GT(ana.GetMemoStats().hits, hits);
+  // Binding a variable invalidates the recorded results.
+  ana.Bind(x, tvm::Range::FromMinExtent(0, 10));
+  ICHECK(ana.CanProve(cond));
+  // Queries on the same operands hit, even though the compared difference is a new expression.
+  auto y = tvm::te::var("y");
+  ICHECK(!ana.CanProveEqual(x, y));
+  hits = ana.GetMemoStats().hits;
+  ICHECK(!ana.CanProveEqual(x, y));
+  ICHECK_GT(ana.GetMemoStats().hits, hits);
+  ICHECK(!ana.CanProveEqual(y, x + 1));
+}
+
 TEST(ConstantFold, Broadcast) {
   tvm::StructuralEqual checker;
   auto i32x4 = tvm::tir::Broadcast(tvm::IntImm(tvm::DataType::Int(32), 10), 4);
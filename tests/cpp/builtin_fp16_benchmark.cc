@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file builtin_fp16_benchmark.cc
+ * \brief Micro-benchmarks of the bulk fp16/bf16 conversions against the scalar conversions.
+ *
+ * The benchmarks are disabled by default, run them with
+ *
+ *   cpptest --gtest_also_run_disabled_tests --gtest_filter='FP16Benchmark.*'
+ */
+#include <gtest/gtest.h>
+#include <tvm/runtime/builtin_fp16.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+/*! \brief The number of elements converted per run. */
+const std::vector<size_t> kSizes = {64, 4096, 1 << 20};
+
+/*! \brief Run `func` repeatedly for at least 50ms and report the time per element. */
+void Report(const std::string& name, size_t size, const std::function<void()>& func) {
+  using Clock = std::chrono::steady_clock;
+  func();
+  size_t num_runs = 0;
+  Clock::time_point begin = Clock::now();
+  Clock::duration elapsed{};
+  do {
+    func();
+    ++num_runs;
+    elapsed = Clock::now() - begin;
+  } while (elapsed < std::chrono::milliseconds(50));
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  std::printf("%-24s size=%-8zu %10.3f ns/elem\n", name.c_str(), size,
+              ns / static_cast<double>(num_runs * size));
+}
+
+TEST(FP16Benchmark, DISABLED_Convert) {
+  for (size_t n : kSizes) {
+    std::vector<float> f32(n);
+    std::vector<uint16_t> u16(n);
+    for (size_t i = 0; i < n; ++i) f32[i] = static_cast<float>(i) * 0.37f - 100.0f;
+
+    Report("Scalar/FloatToHalf", n, [&]() {
+      for (size_t i = 0; i < n; ++i) u16[i] = __gnu_f2h_ieee(f32[i]);
+    });
+    Report("Bulk/FloatToHalf", n, [&]() { TVMFloatToHalf(f32.data(), u16.data(), n); });
+    Report("Scalar/HalfToFloat", n, [&]() {
+      for (size_t i = 0; i < n; ++i) f32[i] = __gnu_h2f_ieee(u16[i]);
+    });
+    Report("Bulk/HalfToFloat", n, [&]() { TVMHalfToFloat(u16.data(), f32.data(), n); });
+    Report("Scalar/FloatToBFloat16", n, [&]() {
+      for (size_t i = 0; i < n; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &f32[i], sizeof(bits));
+        u16[i] = static_cast<uint16_t>((bits + ((bits >> 16) & 1) + 0x7FFF) >> 16);
+      }
+    });
+    Report("Bulk/FloatToBFloat16", n, [&]() { TVMFloatToBFloat16(f32.data(), u16.data(), n); });
+    Report("Bulk/BFloat16ToFloat", n, [&]() { TVMBFloat16ToFloat(u16.data(), f32.data(), n); });
+  }
+}
+
+}  // namespace
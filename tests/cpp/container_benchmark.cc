@@ -0,0 +1,155 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*!
+ * \file container_benchmark.cc
+ * \brief Micro-benchmarks of runtime::Map against std::unordered_map.
+ *
+ * The benchmarks are disabled by default, run them with
+ *
+ *   cpptest --gtest_also_run_disabled_tests --gtest_filter='MapBenchmark.*'
+ *
+ * To compare two implementations of Map, run the benchmarks on both builds. The
+ * std::unordered_map numbers, which use the same hash and equality as Map, serve as a common
+ * baseline across builds.
+ */
+#include <gtest/gtest.h>
+#include <tvm/runtime/container/map.h>
+#include <tvm/runtime/container/string.h>
+#include <tvm/tir/var.h>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace tvm;
+using namespace tvm::runtime;
+
+using StdMap = std::unordered_map<ObjectRef, ObjectRef, ObjectHash, ObjectEqual>;
+
+/*! \brief The number of elements of the maps being benchmarked. */
+const std::vector<size_t> kMapSizes = {8, 64, 1024, 65536};
+
+/*! \brief Run `func` repeatedly for at least 50ms and report the time per operation. */
+void Report(const std::string& name, size_t map_size, size_t ops_per_run,
+            const std::function<void()>& func) {
+  using Clock = std::chrono::steady_clock;
+  func();
+  size_t num_runs = 0;
+  Clock::time_point begin = Clock::now();
+  Clock::duration elapsed{};
+  do {
+    func();
+    ++num_runs;
+    elapsed = Clock::now() - begin;
+  } while (elapsed < std::chrono::milliseconds(50));
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  std::printf("%-24s size=%-8zu %10.2f ns/op\n", name.c_str(), map_size,
+              ns / static_cast<double>(num_runs * ops_per_run));
+}
+
+/*! \brief Keys with pointer hashing, as in Map<Var, ...>. */
+std::vector<ObjectRef> MakeVarKeys(size_t n, const std::string& prefix) {
+  std::vector<ObjectRef> keys;
+  keys.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys.push_back(tir::Var(prefix + std::to_string(i)));
+  }
+  return keys;
+}
+
+/*! \brief Keys with content hashing, as in Map<String, ...>. */
+std::vector<ObjectRef> MakeStringKeys(size_t n, const std::string& prefix) {
+  std::vector<ObjectRef> keys;
+  keys.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys.push_back(String(prefix + std::to_string(i)));
+  }
+  return keys;
+}
+
+void RunBenchmarks(const std::string& kind,
+                   std::function<std::vector<ObjectRef>(size_t, const std::string&)> make_keys) {
+  for (size_t n : kMapSizes) {
+    std::vector<ObjectRef> keys = make_keys(n, "k");
+    std::vector<ObjectRef> misses = make_keys(n, "m");
+    ObjectRef value = String("value");
+    Map<ObjectRef, ObjectRef> map;
+    StdMap std_map;
+    for (const ObjectRef& key : keys) {
+      map.Set(key, value);
+      std_map[key] = value;
+    }
+    size_t sink = 0;
+
+    Report(kind + "/Map/Insert", n, n, [&]() {
+      Map<ObjectRef, ObjectRef> m;
+      for (const ObjectRef& key : keys) m.Set(key, value);
+      sink += m.size();
+    });
+    Report(kind + "/Std/Insert", n, n, [&]() {
+      StdMap m;
+      for (const ObjectRef& key : keys) m[key] = value;
+      sink += m.size();
+    });
+    Report(kind + "/Map/LookupHit", n, n, [&]() {
+      for (const ObjectRef& key : keys) sink += map.count(key);
+    });
+    Report(kind + "/Std/LookupHit", n, n, [&]() {
+      for (const ObjectRef& key : keys) sink += std_map.count(key);
+    });
+    Report(kind + "/Map/LookupMiss", n, n, [&]() {
+      for (const ObjectRef& key : misses) sink += map.count(key);
+    });
+    Report(kind + "/Std/LookupMiss", n, n, [&]() {
+      for (const ObjectRef& key : misses) sink += std_map.count(key);
+    });
+    Report(kind + "/Map/EraseInsert", n, n, [&]() {
+      // Erase and re-insert every key, which keeps the size of the map stable.
+      for (const ObjectRef& key : keys) {
+        map.erase(key);
+        map.Set(key, value);
+      }
+    });
+    Report(kind + "/Std/EraseInsert", n, n, [&]() {
+      for (const ObjectRef& key : keys) {
+        std_map.erase(key);
+        std_map[key] = value;
+      }
+    });
+    Report(kind + "/Map/Iterate", n, n, [&]() {
+      for (const auto& kv : map) sink += kv.second.defined();
+    });
+    Report(kind + "/Std/Iterate", n, n, [&]() {
+      for (const auto& kv : std_map) sink += kv.second.defined();
+    });
+    ICHECK_GT(sink, 0);
+  }
+}
+
+TEST(MapBenchmark, DISABLED_VarKeys) { RunBenchmarks("Var", MakeVarKeys); }
+
+TEST(MapBenchmark, DISABLED_StringKeys) { RunBenchmarks("String", MakeStringKeys); }
+
+}  // namespace
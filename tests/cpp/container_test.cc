@@ -523,6 +523,42 @@ TEST(Map, Erase) {
   }
 }
 
+TEST(Map, EraseInsertStress) {
+  // Interleave insertion and erasure to exercise deleted slots and rehashing of DenseMapNode.
+  std::vector<Var> vars;
+  for (int i = 0; i < 512; ++i) {
+    vars.push_back(Var("v" + std::to_string(i)));
+  }
+  Map<Var, Integer> map;
+  std::unordered_map<const Object*, int64_t> expected;
+  uint64_t state = 42;
+  auto next = [&state]() {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33;
+  };
+  for (int step = 0; step < 20000; ++step) {
+    const Var& var = vars[next() % vars.size()];
+    if (next() % 3 == 0) {
+      map.erase(var);
+      expected.erase(var.get());
+    } else {
+      int64_t value = static_cast<int64_t>(next() % 1000);
+      map.Set(var, Integer(value));
+      expected[var.get()] = value;
+    }
+    ICHECK_EQ(map.size(), expected.size());
+  }
+  size_t num_visited = 0;
+  for (const auto& kv : map) {
+    ICHECK_EQ(expected.at(kv.first.get()), kv.second.IntValue());
+    ++num_visited;
+  }
+  ICHECK_EQ(num_visited, expected.size());
+  for (const Var& var : vars) {
+    ICHECK_EQ(map.count(var), expected.count(var.get()));
+  }
+}
+
 #if TVM_LOG_DEBUG
 TEST(Map, Race) {
   using namespace tvm::runtime;
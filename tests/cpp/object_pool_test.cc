@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/memory.h>
+#include <tvm/runtime/object.h>
+#include <tvm/runtime/registry.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tvm {
+namespace test {
+
+using namespace tvm::runtime;
+
+class PoolObj : public Object {
+ public:
+  explicit PoolObj(int64_t value) : value(value) {}
+  int64_t value;
+  std::string name{"pooled"};
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "test.PoolObj";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PoolObj, Object);
+};
+
+class PoolArrayObj : public Object {
+ public:
+  explicit PoolArrayObj(size_t size) : size(size) {}
+  size_t size;
+
+  int64_t* data() { return reinterpret_cast<int64_t*>(this + 1); }
+
+  static constexpr const uint32_t _type_index = TypeIndex::kDynamic;
+  static constexpr const char* _type_key = "test.PoolArrayObj";
+  TVM_DECLARE_FINAL_OBJECT_INFO(PoolArrayObj, Object);
+};
+
+}  // namespace test
+}  // namespace tvm
+
+using namespace tvm::runtime;
+using namespace tvm::test;
+
+TEST(ObjectPool, Basic) {
+  std::vector<ObjectPtr<PoolObj>> objs;
+  for (int64_t i = 0; i < 10000; ++i) {
+    objs.push_back(PooledObjAllocator().make_object<PoolObj>(i));
+  }
+  for (int64_t i = 0; i < 10000; ++i) {
+    EXPECT_EQ(objs[i]->value, i);
+    EXPECT_EQ(objs[i]->name, "pooled");
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(objs[i].get()) % kObjectPoolAlignment, 0);
+  }
+  objs.clear();
+  // Freed blocks are reused.
+  auto obj = PooledObjAllocator().make_object<PoolObj>(1);
+  EXPECT_EQ(obj->value, 1);
+}
+
+TEST(ObjectPool, InplaceArray) {
+  std::vector<ObjectPtr<PoolArrayObj>> arrays;
+  for (size_t n : {0, 1, 7, 100, 1000}) {
+    auto array = PooledObjAllocator().make_inplace_array<PoolArrayObj, int64_t>(n, n);
+    for (size_t i = 0; i < n; ++i) {
+      array->data()[i] = static_cast<int64_t>(i);
+    }
+    arrays.push_back(array);
+  }
+  for (const auto& array : arrays) {
+    for (size_t i = 0; i < array->size; ++i) {
+      EXPECT_EQ(array->data()[i], static_cast<int64_t>(i));
+    }
+  }
+}
+
+TEST(ObjectPool, CrossThread) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumObjs = 5000;
+  std::vector<std::vector<ObjectPtr<PoolObj>>> objs(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&objs, t]() {
+      for (int i = 0; i < kNumObjs; ++i) {
+        objs[t].push_back(PooledObjAllocator().make_object<PoolObj>(t * kNumObjs + i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  threads.clear();
+  // Free the objects in threads other than the ones which allocated them.
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&objs, t]() {
+      auto& to_free = objs[(t + 1) % kNumThreads];
+      int expected = ((t + 1) % kNumThreads) * kNumObjs;
+      for (const auto& obj : to_free) {
+        EXPECT_EQ(obj->value, expected++);
+      }
+      to_free.clear();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(ObjectPool, Stats) {
+  auto obj = PooledObjAllocator().make_object<PoolObj>(0);
+  const PackedFunc* fstats = Registry::Get("runtime.ObjectPoolStats");
+  ASSERT_NE(fstats, nullptr);
+  std::string stats = (*fstats)();
+  EXPECT_NE(stats.find("\"enabled\""), std::string::npos);
+  EXPECT_NE(stats.find("\"bytes_reserved\""), std::string::npos);
+}
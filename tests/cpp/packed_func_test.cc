@@ -24,6 +24,9 @@
 #include <tvm/tir/expr.h>
 #include <tvm/tir/transform.h>
 
+#include <string>
+#include <unordered_map>
+
 TEST(PackedFunc, Basic) {
   using namespace tvm;
   using namespace tvm::tir;
@@ -307,3 +310,51 @@ TEST(TypedPackedFunc, RValue) {
     tf(1, true);
   }
 }
+
+TEST(Registry, Handle) {
+  using namespace tvm::runtime;
+  const std::string name = "testing.registry_handle";
+  Registry::Handle handle(name);
+  ICHECK(handle.Get() == nullptr);
+  ICHECK(handle.Get() == nullptr);
+
+  Registry::Register(name).set_body_typed([]() { return 1; });
+  const PackedFunc* f = handle.Get();
+  ICHECK(f != nullptr);
+  ICHECK(f == Registry::Get(name));
+  ICHECK_EQ(static_cast<int>((*f)()), 1);
+
+  // The handle resolves the name again after the function is overridden.
+  Registry::Register(name, true).set_body_typed([]() { return 2; });
+  ICHECK_EQ(static_cast<int>((*handle.Get())()), 2);
+  ICHECK(handle.Get() == Registry::Get(name));
+
+  ICHECK(Registry::Remove(name));
+  ICHECK(handle.Get() == nullptr);
+  ICHECK(Registry::Get(name) == nullptr);
+}
+
+TEST(Registry, LookupCounts) {
+  using namespace tvm::runtime;
+  const std::string name = "testing.registry_lookup_counts";
+  const std::string missing = "testing.registry_lookup_counts_missing";
+  Registry::Register(name).set_body_typed([]() {});
+  Registry::Handle handle(name);
+
+  Registry::SetLookupCounting(true);
+  for (int i = 0; i < 3; ++i) {
+    Registry::Get(name);
+    handle.Get();
+    Registry::Get(missing);
+  }
+  Registry::SetLookupCounting(false);
+  Registry::Get(name);
+
+  std::unordered_map<std::string, uint64_t> counts;
+  for (const auto& kv : Registry::LookupCounts()) {
+    counts[kv.first] = kv.second;
+  }
+  ICHECK_EQ(counts[name], 6U);
+  ICHECK_EQ(counts[missing], 3U);
+  Registry::Remove(name);
+}
@@ -0,0 +1,148 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/builtin_fp16.h>
+#include <tvm/runtime/ndarray.h>
+#include <tvm/runtime/registry.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace tvm {
+namespace runtime {
+namespace {
+
+bool IsHalfNaN(uint16_t h) { return (h & 0x7FFF) > 0x7C00; }
+
+/*! \brief The float32 to bfloat16 cast as lowered by BF16Legalize. */
+uint16_t FloatToBFloat16Reference(float f) {
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  if ((bits & 0x7FFFFFFF) > 0x7F800000) return 0x7FC0;
+  return static_cast<uint16_t>((bits + ((bits >> 16) & 1) + 0x7FFF) >> 16);
+}
+
+float FloatFromBits(uint32_t bits) {
+  float f;
+  std::memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+/*! \brief Random bit patterns, which cover every exponent, plus the special values. */
+std::vector<float> MakeInputs() {
+  // An odd size, so that the scalar tail of the vectorized loops is exercised as well.
+  std::vector<float> inputs(4099);
+  std::mt19937 rng(0);
+  for (float& v : inputs) {
+    uint32_t bits = rng();
+    std::memcpy(&v, &bits, sizeof(bits));
+  }
+  const float specials[] = {0.0f,
+                            -0.0f,
+                            1.0f,
+                            65504.0f,
+                            65520.0f,
+                            5.96e-8f,
+                            1e-8f,
+                            std::numeric_limits<float>::infinity(),
+                            -std::numeric_limits<float>::infinity(),
+                            std::numeric_limits<float>::quiet_NaN(),
+                            std::numeric_limits<float>::denorm_min(),
+                            // NaNs whose rounding would give an infinity or a negative zero.
+                            FloatFromBits(0x7F800001),
+                            FloatFromBits(0x7FFFFFFF),
+                            FloatFromBits(0xFFFFFFFF)};
+  std::copy(std::begin(specials), std::end(specials), inputs.begin());
+  return inputs;
+}
+
+TEST(BuiltinFP16, HalfToFloatAllValues) {
+  std::vector<uint16_t> src(1 << 16);
+  for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<uint16_t>(i);
+  std::vector<float> dst(src.size());
+  TVMHalfToFloat(src.data(), dst.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    float expected = __gnu_h2f_ieee(src[i]);
+    if (std::isnan(expected)) {
+      EXPECT_TRUE(std::isnan(dst[i])) << "half bits " << src[i];
+    } else {
+      EXPECT_EQ(std::memcmp(&expected, &dst[i], sizeof(float)), 0) << "half bits " << src[i];
+    }
+  }
+}
+
+TEST(BuiltinFP16, FloatToHalf) {
+  std::vector<float> src = MakeInputs();
+  std::vector<uint16_t> dst(src.size());
+  TVMFloatToHalf(src.data(), dst.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    uint16_t expected = __gnu_f2h_ieee(src[i]);
+    if (IsHalfNaN(expected)) {
+      EXPECT_TRUE(IsHalfNaN(dst[i])) << "input " << src[i];
+    } else {
+      EXPECT_EQ(expected, dst[i]) << "input " << src[i];
+    }
+  }
+}
+
+TEST(BuiltinFP16, BFloat16RoundTrip) {
+  std::vector<float> src = MakeInputs();
+  std::vector<uint16_t> bf16(src.size());
+  TVMFloatToBFloat16(src.data(), bf16.data(), src.size());
+  std::vector<float> back(src.size());
+  TVMBFloat16ToFloat(bf16.data(), back.data(), src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    EXPECT_EQ(FloatToBFloat16Reference(src[i]), bf16[i]) << "input " << src[i];
+    if (std::isnan(src[i])) {
+      EXPECT_EQ(bf16[i], 0x7FC0) << "input " << src[i];
+    }
+    uint32_t bits;
+    std::memcpy(&bits, &back[i], sizeof(bits));
+    EXPECT_EQ(static_cast<uint32_t>(bf16[i]) << 16, bits);
+  }
+}
+
+TEST(BuiltinFP16, ConvertFloatTensor) {
+  const PackedFunc* convert = Registry::Get("runtime.ConvertFloatTensor");
+  ASSERT_NE(convert, nullptr);
+  std::vector<float> values = {1.0f, -2.5f, 0.333333f, 65504.0f, 1e-3f};
+  int64_t n = static_cast<int64_t>(values.size());
+  NDArray f32 = NDArray::Empty({n}, DataType::Float(32), {kDLCPU, 0});
+  NDArray f16 = NDArray::Empty({n}, DataType::Float(16), {kDLCPU, 0});
+  NDArray out = NDArray::Empty({n}, DataType::Float(32), {kDLCPU, 0});
+  f32.CopyFromBytes(values.data(), values.size() * sizeof(float));
+  (*convert)(f32, f16);
+  (*convert)(f16, out);
+  const uint16_t* half = static_cast<const uint16_t*>(f16->data);
+  const float* result = static_cast<const float*>(out->data);
+  for (int64_t i = 0; i < n; ++i) {
+    EXPECT_EQ(__gnu_f2h_ieee(values[i]), half[i]);
+    EXPECT_EQ(__gnu_h2f_ieee(half[i]), result[i]);
+  }
+  NDArray i32 = NDArray::Empty({n}, DataType::Int(32), {kDLCPU, 0});
+  EXPECT_THROW((*convert)(i32, f16), Error);
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace tvm
@@ -21,6 +21,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "../../src/runtime/crt/include/tvm/runtime/crt/internal/graph_executor/load_json.h"
 
 namespace {
@@ -112,4 +118,143 @@ TEST(TVMGraphExecutor_Load, Parse) {
   EXPECT_EQ(executor.nodes_count, 3);
 }
 
+// Encodes the graph of kJson in the binary graph format.
+class BinaryGraphBuilder {
+ public:
+  BinaryGraphBuilder() : strings_(1, '\0') {
+    memset(&header_, 0, sizeof(header_));
+    header_.magic = TVM_GRAPH_BINARY_MAGIC;
+    header_.version = TVM_GRAPH_BINARY_VERSION;
+  }
+
+  std::vector<uint64_t> Build() {
+    TVMGraphBinaryNode nodes[] = {
+        {String("null"), String("x"), 0, 0, 0, 0, 0, 0},
+        {String("null"), String("p0"), 0, 0, 0, 0, 0, 0},
+        {String("tvm_op"), String("tvmgen_default_fused_add"), String("tvmgen_default_fused_add"),
+         2, 1, 0, 0, 2},
+    };
+    TVMGraphBinaryNodeEntry node_inputs[] = {{0, 0, 0}, {1, 0, 0}};
+    uint32_t arg_nodes[] = {0, 1};
+    TVMGraphBinaryNodeEntry heads[] = {{2, 0, 0}};
+    uint32_t node_row_ptr[] = {0, 1, 2, 3};
+    uint32_t storage_id[] = {0, 1, 2};
+    uint32_t device_index[] = {1, 1, 1};
+    DLDataType dltype[] = {{kDLFloat, 32, 1}, {kDLFloat, 32, 1}, {kDLFloat, 32, 1}};
+    uint32_t ndim[] = {2, 2, 2};
+    uint32_t shape_index[] = {0, 2, 4};
+    int64_t shape[] = {10, 5, 1, 5, 10, 5};
+
+    header_.num_nodes = 3;
+    header_.num_node_inputs = 2;
+    header_.num_arg_nodes = 2;
+    header_.num_heads = 1;
+    header_.num_entries = 3;
+    header_.num_shape_dims = 6;
+    header_.nodes_offset = Section(nodes, sizeof(nodes));
+    header_.node_inputs_offset = Section(node_inputs, sizeof(node_inputs));
+    header_.arg_nodes_offset = Section(arg_nodes, sizeof(arg_nodes));
+    header_.heads_offset = Section(heads, sizeof(heads));
+    header_.node_row_ptr_offset = Section(node_row_ptr, sizeof(node_row_ptr));
+    header_.storage_id_offset = Section(storage_id, sizeof(storage_id));
+    header_.device_index_offset = Section(device_index, sizeof(device_index));
+    header_.dltype_offset = Section(dltype, sizeof(dltype));
+    header_.ndim_offset = Section(ndim, sizeof(ndim));
+    header_.shape_index_offset = Section(shape_index, sizeof(shape_index));
+    header_.shape_offset = Section(shape, sizeof(shape));
+    header_.strings_size = strings_.size();
+    header_.strings_offset = Section(strings_.data(), strings_.size());
+    body_.resize((body_.size() + 7) / 8 * 8);
+    header_.total_size = sizeof(header_) + body_.size();
+
+    std::vector<uint64_t> graph(header_.total_size / 8);
+    memcpy(graph.data(), &header_, sizeof(header_));
+    memcpy(reinterpret_cast<char*>(graph.data()) + sizeof(header_), body_.data(), body_.size());
+    return graph;
+  }
+
+ private:
+  uint32_t String(const std::string& value) {
+    uint32_t offset = strings_.size();
+    strings_.append(value);
+    strings_.push_back('\0');
+    return offset;
+  }
+
+  uint32_t Section(const void* data, size_t size) {
+    body_.resize((body_.size() + 7) / 8 * 8);
+    uint32_t offset = sizeof(header_) + body_.size();
+    body_.append(static_cast<const char*>(data), size);
+    return offset;
+  }
+
+  TVMGraphBinaryHeader header_;
+  std::string strings_;
+  std::string body_;
+};
+
+// Check a binary graph is loaded into an aligned copy, without parsing it.
+TEST(TVMGraphExecutor_LoadBinary, Copy) {
+  std::vector<uint64_t> graph = BinaryGraphBuilder().Build();
+  size_t size = graph.size() * 8;
+  // The caller's buffer need not be 8-byte aligned.
+  std::vector<char> buffer(size + 4);
+  memcpy(buffer.data() + 4, graph.data(), size);
+  TVMGraphExecutor executor;
+  memset(&executor, 0, sizeof(executor));
+  int status = TVMGraphExecutor_LoadBinary(&executor, buffer.data() + 4, size);
+  ASSERT_EQ(status, 0);
+  // Only the copy is read after loading.
+  memset(buffer.data(), 0xff, buffer.size());
+  const TVMGraphBinaryHeader* header = executor.graph;
+  ASSERT_NE(header, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(header) % 8, 0);
+  EXPECT_EQ(executor.nodes_count, 3);
+  EXPECT_EQ(executor.input_nodes_count, 2);
+  EXPECT_EQ(executor.outputs_count, 1);
+  EXPECT_EQ(executor.outputs[0].node_id, 2);
+  EXPECT_EQ(executor.node_row_ptr[3], 3);
+  EXPECT_EQ(executor.attrs.storage_id[2], 2);
+  EXPECT_EQ(executor.attrs.ndim[1], 2);
+  EXPECT_EQ(TVMGraphExecutor_GetInputIndex(&executor, "p0"), 1);
+  // The graph arrays point into the copy rather than being allocated one by one.
+  EXPECT_EQ(reinterpret_cast<const char*>(executor.input_nodes),
+            reinterpret_cast<const char*>(header) + header->arg_nodes_offset);
+  DLDevice dev = {kDLCPU, 0};
+  EXPECT_EQ(TVMPlatformMemoryFree(executor.graph_storage, dev), kTvmErrorNoError);
+}
+
+// Check the executor does not refer to the caller's buffer once it is created.
+TEST(TVMGraphExecutor_LoadBinary, CallerBufferReleased) {
+  std::vector<uint64_t> graph = BinaryGraphBuilder().Build();
+  auto buffer = std::make_unique<std::vector<uint64_t>>(graph);
+  DLDevice dev = {kDLCPU, 0};
+  TVMGraphExecutor* executor = nullptr;
+  // The module does not provide the kernel, which only matters when the graph is run.
+  int status = TVMGraphExecutor_Create(reinterpret_cast<const char*>(buffer->data()), nullptr,
+                                       &dev, &executor);
+  ASSERT_EQ(status, 0);
+  std::fill(buffer->begin(), buffer->end(), ~uint64_t(0));
+  buffer.reset();
+  EXPECT_EQ(TVMGraphExecutor_GetInputIndex(executor, "x"), 0);
+  EXPECT_EQ(TVMGraphExecutor_GetInputIndex(executor, "p0"), 1);
+  EXPECT_EQ(TVMGraphExecutor_Release(&executor), 0);
+}
+
+// Check a corrupt binary graph is rejected before it is used.
+TEST(TVMGraphExecutor_LoadBinary, Invalid) {
+  std::vector<uint64_t> graph = BinaryGraphBuilder().Build();
+  TVMGraphExecutor executor;
+  memset(&executor, 0, sizeof(executor));
+  EXPECT_NE(TVMGraphExecutor_LoadBinary(&executor, graph.data(), graph.size() * 8 - 8), 0);
+
+  auto* header = reinterpret_cast<TVMGraphBinaryHeader*>(graph.data());
+  auto* node_inputs = reinterpret_cast<TVMGraphBinaryNodeEntry*>(
+      reinterpret_cast<char*>(graph.data()) + header->node_inputs_offset);
+  node_inputs[1].node_id = 3;
+  EXPECT_NE(TVMGraphExecutor_LoadBinary(&executor, graph.data(), graph.size() * 8), 0);
+  EXPECT_EQ(executor.graph, nullptr);
+  EXPECT_EQ(executor.graph_storage, nullptr);
+}
+
 }  // namespace
@@ -0,0 +1,242 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <tvm/runtime/crt/internal/memory/tlsf_allocator.h>
+#include <tvm/runtime/crt/tlsf_allocator.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "crt_config.h"
+
+static constexpr const size_t kMemoryPoolSizeBytes = 64 * 1024;
+static constexpr const size_t kAlignmentBytesLog2 = 6;  // 64 byte alignment.
+static constexpr const size_t kAlignmentBytes = 1 << kAlignmentBytesLog2;
+
+class TLSFAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(memory_pool, 0, sizeof(memory_pool));
+    ASSERT_EQ(TLSFMemoryManagerCreate(&interface, memory_pool, sizeof(memory_pool),
+                                      kAlignmentBytesLog2),
+              kTvmErrorNoError);
+    mgr = reinterpret_cast<TLSFMemoryManager*>(interface);
+    ASSERT_NE(interface->GetStats, nullptr);
+    dev_ = {kDLCPU, 0};
+  }
+
+  MemoryManagerStats Stats() {
+    MemoryManagerStats stats;
+    EXPECT_EQ(interface->GetStats(interface, &stats), kTvmErrorNoError);
+    return stats;
+  }
+
+  void* Allocate(size_t num_bytes) {
+    void* ptr = nullptr;
+    EXPECT_EQ(interface->Allocate(interface, num_bytes, dev_, &ptr), kTvmErrorNoError);
+    EXPECT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % kAlignmentBytes, 0);
+    return ptr;
+  }
+
+  void Free(void* ptr) { EXPECT_EQ(interface->Free(interface, ptr, dev_), kTvmErrorNoError); }
+
+  uint8_t memory_pool[kMemoryPoolSizeBytes];
+  MemoryManagerInterface* interface;
+  TLSFMemoryManager* mgr;
+  DLDevice dev_;
+};
+
+TEST_F(TLSFAllocatorTest, Create) {
+  MemoryManagerStats stats = Stats();
+  EXPECT_GT(stats.total_bytes, kMemoryPoolSizeBytes - sizeof(TLSFMemoryManager) - 2 * 64);
+  EXPECT_EQ(stats.free_bytes, stats.total_bytes);
+  EXPECT_EQ(stats.largest_free_block_bytes, stats.total_bytes);
+  EXPECT_EQ(stats.num_free_blocks, 1);
+  EXPECT_EQ(stats.allocated_bytes, 0);
+
+  // The alignment must leave room for the free list links.
+  MemoryManagerInterface* other;
+  EXPECT_EQ(TLSFMemoryManagerCreate(&other, memory_pool, sizeof(memory_pool), 2),
+            kTvmErrorPlatformCheckFailure);
+  EXPECT_EQ(TLSFMemoryManagerCreate(&other, memory_pool, sizeof(TLSFMemoryManager), 6),
+            kTvmErrorPlatformNoMemory);
+}
+
+TEST_F(TLSFAllocatorTest, MappingIsMonotonic) {
+  int last_fl = 0, last_sl = 0;
+  for (size_t units = 1; units < (1 << 16); ++units) {
+    int fl, sl;
+    TLSFMemoryManager_MappingInsert(mgr, units * kAlignmentBytes, &fl, &sl);
+    ASSERT_LT(fl, TLSF_FL_INDEX_COUNT);
+    ASSERT_LT(sl, TLSF_SL_INDEX_COUNT);
+    ASSERT_TRUE(fl > last_fl || (fl == last_fl && sl >= last_sl)) << units;
+    last_fl = fl;
+    last_sl = sl;
+  }
+}
+
+TEST_F(TLSFAllocatorTest, CoalesceOnFree) {
+  const size_t total_bytes = Stats().total_bytes;
+  std::vector<void*> ptrs;
+  void* ptr;
+  while (interface->Allocate(interface, 200, dev_, &ptr) == kTvmErrorNoError) {
+    memset(ptr, 0xab, 200);
+    ptrs.push_back(ptr);
+  }
+  EXPECT_EQ(interface->vleak_size, static_cast<int>(ptrs.size()));
+  EXPECT_EQ(Stats().num_failed_allocations, 1);
+
+  // Free every other block first, leaving holes that cannot hold a large allocation.
+  for (size_t i = 0; i < ptrs.size(); i += 2) Free(ptrs[i]);
+  MemoryManagerStats stats = Stats();
+  EXPECT_EQ(stats.num_free_blocks, (ptrs.size() + 1) / 2 + (ptrs.size() % 2 == 0 ? 1 : 0));
+  EXPECT_LT(stats.largest_free_block_bytes, stats.free_bytes);
+  EXPECT_EQ(interface->Allocate(interface, 1024, dev_, &ptr), kTvmErrorPlatformNoMemory);
+
+  for (size_t i = 1; i < ptrs.size(); i += 2) Free(ptrs[i]);
+  stats = Stats();
+  EXPECT_EQ(interface->vleak_size, 0);
+  EXPECT_EQ(stats.num_free_blocks, 1);
+  EXPECT_EQ(stats.free_bytes, total_bytes);
+  EXPECT_EQ(stats.largest_free_block_bytes, total_bytes);
+  EXPECT_EQ(stats.allocated_bytes, 0);
+  EXPECT_GE(stats.peak_allocated_bytes, total_bytes - 256);
+
+  // The whole pool is available again.
+  Free(Allocate(total_bytes - TLSF_BLOCK_HEADER_SIZE));
+}
+
+TEST_F(TLSFAllocatorTest, ReusesSmallestFittingHole) {
+  void* a = Allocate(1024);
+  void* b = Allocate(64);
+  void* c = Allocate(4096);
+  void* d = Allocate(64);
+  Free(a);
+  Free(c);
+  // A small allocation goes to the small hole, keeping the large one intact.
+  void* e = Allocate(512);
+  EXPECT_EQ(e, a);
+  void* f = Allocate(4000);
+  EXPECT_EQ(f, c);
+  Free(b);
+  Free(d);
+  Free(e);
+  Free(f);
+  EXPECT_EQ(Stats().num_free_blocks, 1);
+}
+
+TEST_F(TLSFAllocatorTest, BadFree) {
+  void* a = Allocate(100);
+  void* b = Allocate(100);
+  EXPECT_EQ(interface->Free(interface, static_cast<uint8_t*>(a) + 1, dev_),
+            kTvmErrorPlatformMemoryManagerBadFree);
+  EXPECT_EQ(interface->Free(interface, memory_pool, dev_), kTvmErrorPlatformMemoryManagerBadFree);
+  EXPECT_EQ(interface->Free(interface, nullptr, dev_), kTvmErrorPlatformMemoryManagerBadFree);
+  Free(a);
+  EXPECT_EQ(interface->Free(interface, a, dev_), kTvmErrorPlatformMemoryManagerBadFree);
+  Free(b);
+  EXPECT_EQ(interface->vleak_size, 0);
+}
+
+TEST_F(TLSFAllocatorTest, DoubleFreeOfMergedBlock) {
+  void* a = Allocate(100);
+  void* b = Allocate(100);
+  void* c = Allocate(100);
+  Free(a);
+  // b is merged into the free block of a. Its header stays in memory and must not look
+  // allocated anymore, which is only reliable until that memory is allocated again.
+  Free(b);
+  MemoryManagerStats stats = Stats();
+  EXPECT_EQ(interface->Free(interface, b, dev_), kTvmErrorPlatformMemoryManagerBadFree);
+  EXPECT_EQ(Stats().allocated_bytes, stats.allocated_bytes);
+  EXPECT_EQ(Stats().free_bytes, stats.free_bytes);
+  EXPECT_EQ(interface->vleak_size, 1);
+  Free(c);
+  EXPECT_EQ(interface->vleak_size, 0);
+  EXPECT_EQ(Stats().free_bytes, Stats().total_bytes);
+}
+
+TEST_F(TLSFAllocatorTest, FreeOfStaleOrInnerPointer) {
+  void* a = Allocate(100);
+  void* b = Allocate(100);
+  void* c = Allocate(100);
+  Free(a);
+  Free(b);
+  // The merged block is handed out again and its contents overwrite the stale header of b.
+  void* d = Allocate(200);
+  EXPECT_EQ(d, a);
+  memset(d, 0x5a, 200);
+  void* e = Allocate(1024);
+  memset(e, 0, 1024);
+  MemoryManagerStats stats = Stats();
+  EXPECT_EQ(interface->Free(interface, b, dev_), kTvmErrorPlatformMemoryManagerBadFree);
+  // An aligned pointer into the middle of an allocation has no header of its own.
+  EXPECT_EQ(interface->Free(interface, static_cast<uint8_t*>(e) + 4 * kAlignmentBytes, dev_),
+            kTvmErrorPlatformMemoryManagerBadFree);
+  EXPECT_EQ(Stats().allocated_bytes, stats.allocated_bytes);
+  EXPECT_EQ(Stats().free_bytes, stats.free_bytes);
+  EXPECT_EQ(interface->vleak_size, 3);
+  Free(c);
+  Free(d);
+  Free(e);
+  EXPECT_EQ(interface->vleak_size, 0);
+  EXPECT_EQ(Stats().free_bytes, Stats().total_bytes);
+}
+
+TEST_F(TLSFAllocatorTest, RandomAllocFree) {
+  std::mt19937 rng(0);
+  std::vector<std::pair<uint8_t*, size_t>> live;
+  size_t peak = 0;
+  for (int iter = 0; iter < 20000; ++iter) {
+    if (live.empty() || rng() % 3 != 0) {
+      size_t num_bytes = 1 + rng() % (rng() % 8 == 0 ? 8192 : 256);
+      void* ptr;
+      if (interface->Allocate(interface, num_bytes, dev_, &ptr) != kTvmErrorNoError) continue;
+      ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % kAlignmentBytes, 0);
+      uint8_t* data = static_cast<uint8_t*>(ptr);
+      memset(data, static_cast<int>(live.size() & 0xff), num_bytes);
+      live.emplace_back(data, num_bytes);
+    } else {
+      size_t index = rng() % live.size();
+      std::swap(live[index], live.back());
+      // The content must not have been overwritten by other allocations.
+      uint8_t* data = live.back().first;
+      uint8_t value = data[0];
+      ASSERT_TRUE(std::all_of(data, data + live.back().second,
+                              [value](uint8_t v) { return v == value; }));
+      Free(data);
+      live.pop_back();
+    }
+    MemoryManagerStats stats = Stats();
+    ASSERT_EQ(stats.allocated_bytes + stats.free_bytes, stats.total_bytes);
+    ASSERT_LE(stats.largest_free_block_bytes, stats.free_bytes);
+    peak = std::max(peak, stats.allocated_bytes);
+    ASSERT_EQ(stats.peak_allocated_bytes, peak);
+  }
+  for (const auto& kv : live) Free(kv.first);
+  MemoryManagerStats stats = Stats();
+  EXPECT_EQ(interface->vleak_size, 0);
+  EXPECT_EQ(stats.num_free_blocks, 1);
+  EXPECT_EQ(stats.largest_free_block_bytes, stats.total_bytes);
+}
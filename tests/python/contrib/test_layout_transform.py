@@ -0,0 +1,118 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+import pytest
+
+import tvm
+import tvm.testing
+from tvm import relay, te, topi
+from tvm.contrib import graph_executor, layout_transform
+
+
+requires_layout_transform = pytest.mark.skipif(
+    tvm.get_global_func("tvm.contrib.layout_transform.transpose", allow_missing=True) is None,
+    reason="layout transform kernel is not built",
+)
+
+
+def test_transpose_view():
+    assert layout_transform.get_transpose_view([1, 32, 5, 7], "NCHW", "NCHW16c") == (
+        [2, 16, 5, 7],
+        [0, 2, 3, 1],
+        [1, 2, 5, 7, 16],
+    )
+    view_shape, perm, out_shape = layout_transform.get_transpose_view(
+        [2, 4, 5, 7, 8], "NCHW8c", "NHWC"
+    )
+    assert out_shape == [2, 5, 7, 32]
+    assert [view_shape[axis] for axis in perm] == [2, 5, 7, 4, 8]
+    # The split factor does not divide the channels.
+    assert layout_transform.get_transpose_view([1, 24, 5, 7], "NCHW", "NCHW16c") is None
+    # Not every primal axis is in both layouts.
+    assert layout_transform.get_transpose_view([1, 24, 5, 7], "NCHW", "NCH") is None
+
+
+@requires_layout_transform
+@pytest.mark.parametrize(
+    "shape,src_layout,dst_layout,dtype",
+    [
+        ((1, 32, 13, 11), "NCHW", "NCHW16c", "float32"),
+        ((2, 2, 13, 11, 16), "NCHW16c", "NCHW", "float32"),
+        ((2, 4, 9, 9, 8), "NCHW8c", "NCHW16c", "float32"),
+        ((1, 67, 33, 31), "NCHW", "NHWC", "int8"),
+        ((1, 33, 31, 67), "NHWC", "NCHW", "float16"),
+        ((1, 17, 19, 64), "NHWC", "NCHW4c", "float64"),
+        ((1, 256, 64, 64), "NCHW", "NHWC", "float32"),
+    ],
+)
+def test_layout_transform_kernel(shape, src_layout, dst_layout, dtype):
+    data = te.placeholder(shape, name="data", dtype=dtype)
+    out = layout_transform.layout_transform(data, src_layout, dst_layout)
+    ref = topi.layout_transform(data, src_layout, dst_layout)
+    s = te.create_schedule([out.op, ref.op])
+    f = tvm.build(s, [data, out, ref], "llvm")
+
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(-100, 100, size=shape).astype(dtype), dev)
+    b = tvm.nd.empty(out.shape, dtype, dev)
+    c = tvm.nd.empty(ref.shape, dtype, dev)
+    f(a, b, c)
+    tvm.testing.assert_allclose(b.numpy(), c.numpy())
+
+
+def _layout_transform_module():
+    x = relay.var("x", shape=(1, 32, 28, 28), dtype="float32")
+    y = relay.layout_transform(x, "NCHW", "NCHW16c")
+    y = relay.layout_transform(relay.nn.relu(y), "NCHW16c", "NHWC")
+    return tvm.IRModule.from_expr(relay.Function([x], y))
+
+
+@tvm.testing.requires_llvm
+def test_relay_layout_transform_kernel_opt_in():
+    mod = _layout_transform_module()
+    # The kernel is only used when the target asks for it.
+    for target in ["llvm", "c"]:
+        with tvm.transform.PassContext(opt_level=3):
+            lib = relay.build(mod, target=target)
+        assert "tvm.contrib.layout_transform.transpose" not in lib.get_lib().get_source()
+    # The CRT runtime does not have the kernel.
+    with pytest.raises(ValueError):
+        with tvm.transform.PassContext(opt_level=3):
+            relay.build(
+                mod,
+                target="llvm -layout-transform-kernel=1",
+                runtime=relay.backend.Runtime("crt"),
+            )
+
+
+@requires_layout_transform
+def test_relay_layout_transform_uses_kernel():
+    mod = _layout_transform_module()
+    target = tvm.target.Target("llvm -layout-transform-kernel=1")
+    with tvm.transform.PassContext(opt_level=3):
+        lib = relay.build(mod, target=target)
+    assert "tvm.contrib.layout_transform.transpose" in lib.get_lib().get_source()
+
+    data = np.random.uniform(size=(1, 32, 28, 28)).astype("float32")
+    m = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+    m.set_input("x", data)
+    m.run()
+    tvm.testing.assert_allclose(m.get_output(0).numpy(), np.maximum(data, 0).transpose(0, 2, 3, 1))
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
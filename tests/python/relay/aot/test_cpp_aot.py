@@ -18,6 +18,7 @@
 
 import re
 import textwrap
+import threading
 
 import numpy as np
 import pytest
@@ -242,5 +243,50 @@ def test_aot_input_name_with_special_character(target_kind: str, input_name: str
         assert (runner.get_output(0).asnumpy() == expected_output).all()
 
 
+@pytest.mark.parametrize("enable_usmp", [True, False])
+def test_create_context(enable_usmp):
+    """Test execution contexts sharing one loaded module run concurrently."""
+    dtype = "float32"
+    data = relay.var("data", shape=(16, 8), dtype=dtype)
+    weight = relay.var("weight", shape=(4, 8), dtype=dtype)
+    func = relay.Function([data, weight], relay.nn.relu(relay.nn.dense(data, weight)))
+    weight_data = np.random.uniform(-1, 1, size=(4, 8)).astype(dtype)
+
+    with tvm.transform.PassContext(opt_level=3, config={"tir.usmp.enable": enable_usmp}):
+        mod = tvm.relay.build(
+            tvm.IRModule.from_expr(func),
+            target="llvm",
+            params={"weight": weight_data},
+            executor=backend.Executor("aot", {"interface-api": "packed"}),
+        )
+    temp_dir = tvm.contrib.utils.TempDirectory()
+    test_so_path = temp_dir / "test.so"
+    mod.export_library(test_so_path)
+    loaded_mod = tvm.runtime.load_module(test_so_path)
+    runner = tvm.runtime.executor.AotModule(loaded_mod["default"](tvm.cpu(0)))
+
+    num_contexts = 4
+    contexts = [runner] + [runner.create_context() for _ in range(num_contexts - 1)]
+    inputs = [np.random.uniform(-1, 1, size=(16, 8)).astype(dtype) for _ in range(num_contexts)]
+    outputs = [None] * num_contexts
+
+    def run(index):
+        for _ in range(10):
+            contexts[index].set_input("data", inputs[index])
+            contexts[index].run()
+            outputs[index] = contexts[index].get_output(0).numpy()
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(num_contexts)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    for data_in, data_out in zip(inputs, outputs):
+        np.testing.assert_allclose(data_out, np.maximum(data_in @ weight_data.T, 0), rtol=1e-5)
+    # Each context has its own inputs.
+    assert not np.array_equal(contexts[0].get_input(0).numpy(), contexts[1].get_input(0).numpy())
+
+
 if __name__ == "__main__":
     tvm.testing.main()
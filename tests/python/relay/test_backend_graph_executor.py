@@ -468,6 +468,30 @@ def test_graph_executor_api():
         assert dtype_dict[name] == ty.dtype
 
 
+@tvm.testing.requires_llvm
+def test_graph_executor_direct_call():
+    shape = (4, 4)
+    x = relay.var("x", shape=shape, dtype="float32")
+    y = relay.var("y", shape=shape, dtype="float32")
+    func = relay.Function([x, y], relay.add(x, y))
+    lib = relay.build(tvm.IRModule.from_expr(func), "llvm")
+
+    def check(lib):
+        mod = graph_executor.GraphModule(lib["default"](tvm.cpu(0)))
+        # The kernel only takes tensors, so it is called through its direct-call entry.
+        assert mod.module["get_num_direct_call_ops"]() == 1
+        x_np = np.random.uniform(size=shape).astype("float32")
+        y_np = np.random.uniform(size=shape).astype("float32")
+        mod.run(x=x_np, y=y_np)
+        tvm.testing.assert_allclose(mod.get_output(0).numpy(), x_np + y_np)
+
+    check(lib)
+    temp = utils.tempdir()
+    path = temp.relpath("lib.so")
+    lib.export_library(path)
+    check(tvm.runtime.load_module(path))
+
+
 @tvm.testing.requires_llvm
 def test_benchmark():
     mod, params = mlp.get_workload(1)
@@ -56,12 +56,20 @@ def _mock_get_pattern_table(target):
 
 
 def run_collage(
-    input_mod, targets, cost_estimator, expected_mod, tvm_max_depth=8, byoc_max_depth=8
+    input_mod,
+    targets,
+    cost_estimator,
+    expected_mod,
+    tvm_max_depth=8,
+    byoc_max_depth=8,
+    extra_config=None,
 ):
     ctxt = {
         "relay.collage.tvm_max_depth": tvm_max_depth,
         "relay.collage.byoc_max_depth": byoc_max_depth,
     }
+    if extra_config:
+        ctxt.update(extra_config)
     expected_mod = InferType()(expected_mod)
     pass_ctxt = tvm.transform.PassContext(config=ctxt)
     with pass_ctxt:
@@ -114,6 +122,94 @@ def test_partition_single_op_llvm(mock_get_pattern_table):
     run_collage(mod, targets, cost_estimator, expected_mod)
 
 
+@patch("tvm.relay.op.contrib.get_pattern_table", wraps=_mock_get_pattern_table)
+def test_persistent_cost_cache(mock_get_pattern_table, tmp_path):
+    mod_txt = """
+      #[version = "0.0.5"]
+      def @main(%x: Tensor[(10, 10), float32]) {
+        nn.relu(%x)
+      }
+    """
+    mod = tvm.parser.fromtext(mod_txt)
+
+    expected_txt = """
+      #[version = "0.0.5"]
+      def @main(%x: Tensor[(10, 10), float32]) -> Tensor[(10, 10), float32] {
+        nn.relu(%x)
+      }
+    """
+    expected_mod = tvm.parser.fromtext(expected_txt)
+
+    targets = [
+        tvm.target.Target("llvm"),
+        tvm.target.Target("example_target_hook"),
+    ]
+    extra_config = {
+        "relay.collage.cost_cache_path": str(tmp_path / "collage_costs.txt"),
+        "relay.collage.num_estimate_threads": 4,
+    }
+    cost_estimator = MockCostEstimator(
+        {
+            "llvm": 1,
+            "example_target_hook": 2,
+        }
+    )
+    run_collage(mod, targets, cost_estimator, expected_mod, extra_config=extra_config)
+    assert cost_estimator.num_estimates > 0
+    assert "example_target_hook" in (tmp_path / "collage_costs.txt").read_text()
+
+    # The costs recorded by the first run win over those the estimator would now give, and no
+    # candidate needs to be estimated again.
+    cost_estimator = MockCostEstimator(
+        {
+            "llvm": 2,
+            "example_target_hook": 1,
+        }
+    )
+    run_collage(mod, targets, cost_estimator, expected_mod, extra_config=extra_config)
+    assert cost_estimator.num_estimates == 0
+
+
+@patch("tvm.relay.op.contrib.get_pattern_table", wraps=_mock_get_pattern_table)
+def test_persistent_cost_cache_mismatch(mock_get_pattern_table, tmp_path):
+    mod_txt = """
+      #[version = "0.0.5"]
+      def @main(%x: Tensor[(10, 10), float32]) {
+        nn.relu(%x)
+      }
+    """
+    mod = tvm.parser.fromtext(mod_txt)
+    expected_mod = tvm.parser.fromtext(
+        """
+      #[version = "0.0.5"]
+      def @main(%x: Tensor[(10, 10), float32]) -> Tensor[(10, 10), float32] {
+        nn.relu(%x)
+      }
+    """
+    )
+    targets = [
+        tvm.target.Target("llvm"),
+        tvm.target.Target("example_target_hook"),
+    ]
+    cache_path = tmp_path / "collage_costs.txt"
+    extra_config = {"relay.collage.cost_cache_path": str(cache_path)}
+    cost_estimator = MockCostEstimator({"llvm": 1, "example_target_hook": 2})
+    run_collage(mod, targets, cost_estimator, expected_mod, extra_config=extra_config)
+    num_estimates = cost_estimator.num_estimates
+    assert num_estimates > 0
+
+    # Records whose function text does not match, as after a hash collision, are not reused.
+    records = []
+    for line in cache_path.read_text().splitlines():
+        fields = line.split("\t")
+        fields[4] = "not the function"
+        records.append("\t".join(fields))
+    cache_path.write_text("\n".join(records) + "\n")
+    cost_estimator = MockCostEstimator({"llvm": 1, "example_target_hook": 2})
+    run_collage(mod, targets, cost_estimator, expected_mod, extra_config=extra_config)
+    assert cost_estimator.num_estimates == num_estimates
+
+
 @patch("tvm.relay.op.contrib.get_pattern_table", wraps=_mock_get_pattern_table)
 def test_partition_single_op_byoc(mock_get_pattern_table):
     mod_txt = """
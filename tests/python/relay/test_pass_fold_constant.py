@@ -371,6 +371,97 @@ def test_fold_dropout():
     tvm.ir.assert_structural_equal(run_infer_type(before_mod["main"]), after_mod["main"])
 
 
+def test_fold_const_batch_evaluation():
+    c_data = np.array([1, 2, 3]).astype("float32")
+    t = relay.TensorType([3], "float32")
+
+    def before():
+        x = relay.var("x", t)
+        # Two structurally equal constant sub-expressions and an independent one.
+        y1 = relay.multiply(relay.add(relay.const(c_data), relay.const(c_data)), relay.const(2.0))
+        y2 = relay.multiply(relay.add(relay.const(c_data), relay.const(c_data)), relay.const(2.0))
+        y3 = relay.negative(relay.const(c_data))
+        z = relay.add(relay.add(x, y1), relay.subtract(y2, y3))
+        # Folding the let-bound value exposes one more constant sub-expression.
+        v = relay.var("v", t)
+        w = relay.Let(v, relay.negative(relay.const(c_data)), relay.add(z, relay.abs(v)))
+        return relay.Function([x], w)
+
+    def expected():
+        x = relay.var("x", t)
+        y1 = relay.const((c_data + c_data) * 2)
+        y23 = relay.const((c_data + c_data) * 2 + c_data)
+        z = relay.add(relay.add(x, y1), y23)
+        return relay.Function([x], relay.add(z, relay.const(np.abs(-c_data))))
+
+    with tvm.transform.PassContext(config={"relay.FoldConstant.batch_evaluation": True}):
+        zz = run_opt_pass(before(), transform.FoldConstant())
+    zexpected = run_opt_pass(expected(), transform.InferType())
+    tvm.ir.assert_structural_equal(zz, zexpected)
+
+
+def test_fold_const_batch_evaluation_shared_roots():
+    c_data = np.array([1, 2, 3]).astype("float32")
+    t = relay.TensorType([3], "float32")
+
+    def before():
+        x = relay.var("x", t)
+        # Two structurally equal maximal constant sub-expressions.
+        y1 = relay.multiply(relay.add(relay.const(c_data), relay.const(c_data)), relay.const(2.0))
+        y2 = relay.multiply(relay.add(relay.const(c_data), relay.const(c_data)), relay.const(2.0))
+        z = relay.add(relay.add(x, y1), relay.add(x, y2))
+        # The shape of a partly folded expression is folded too.
+        return relay.Function([x], relay.Tuple([z, relay.shape_of(relay.add(x, y1))]))
+
+    def expected():
+        x = relay.var("x", t)
+        y = relay.const((c_data + c_data) * 2)
+        z = relay.add(relay.add(x, y), relay.add(x, y))
+        return relay.Function([x], relay.Tuple([z, relay.const(np.array([3], "int32"))]))
+
+    with tvm.transform.PassContext(config={"relay.FoldConstant.batch_evaluation": True}):
+        zz = run_opt_pass(before(), transform.FoldConstant())
+    zexpected = run_opt_pass(expected(), transform.InferType())
+    tvm.ir.assert_structural_equal(zz, zexpected)
+    # Both roots are replaced by the value of a single evaluation.
+    lhs, rhs = zz.body.fields[0].args
+    assert lhs.args[1].data.handle.contents.data == rhs.args[1].data.handle.contents.data
+
+
+def test_fold_const_batch_evaluation_failure():
+    c_data = np.array([1, 2, 3]).astype("float32")
+    t = relay.TensorType([3], "float32")
+
+    def before():
+        x = relay.var("x", t)
+        y1 = relay.negative(relay.const(c_data))
+        y2 = relay.erf(relay.const(c_data))
+        return relay.Function([x], relay.add(relay.add(x, y1), y2))
+
+    def expected():
+        x = relay.var("x", t)
+        y2 = relay.erf(relay.const(c_data))
+        return relay.Function([x], relay.add(relay.add(x, relay.const(-c_data)), y2))
+
+    def fail_strategy(attrs, inputs, out_type, target):
+        raise RuntimeError("erf cannot be evaluated")
+
+    # Make one of the constant sub-expressions fail to evaluate, the batch falls back to
+    # evaluating them one at a time and still folds the other.
+    erf = relay.op.get("erf")
+    strategy = erf.get_attr("FTVMStrategy")
+    erf.reset_attr("FTVMStrategy")
+    erf.set_attr("FTVMStrategy", fail_strategy)
+    try:
+        with tvm.transform.PassContext(config={"relay.FoldConstant.batch_evaluation": True}):
+            zz = run_opt_pass(before(), transform.FoldConstant())
+    finally:
+        erf.reset_attr("FTVMStrategy")
+        erf.set_attr("FTVMStrategy", strategy)
+    zexpected = run_opt_pass(expected(), transform.InferType())
+    tvm.ir.assert_structural_equal(zz, zexpected)
+
+
 def test_fold_qnn_const():
     def before():
         # QNN op with 2 constant arguments.
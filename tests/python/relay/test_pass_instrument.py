@@ -20,7 +20,7 @@ import pytest
 import tvm
 import tvm.relay
 from tvm.relay import op
-from tvm.ir.instrument import PassTimingInstrument, pass_instrument
+from tvm.ir.instrument import PassProfilingInstrument, PassTimingInstrument, pass_instrument
 
 
 def get_test_model():
@@ -59,6 +59,32 @@ def test_pass_timing_instrument():
     assert profiles == ""
 
 
+def test_pass_profiling_instrument(tmp_path):
+    pass_profiling = PassProfilingInstrument(count_objects=True)
+    with tvm.transform.PassContext(instruments=[pass_profiling]):
+        mod = get_test_model()
+        mod = tvm.transform.Sequential(
+            [tvm.relay.transform.InferType(), tvm.relay.transform.ToANormalForm()],
+            name="Pipeline",
+        )(mod)
+
+    # Results stay available after exiting the context.
+    profiles = pass_profiling.render()
+    lines = profiles.splitlines()
+    assert lines[0].startswith("Pipeline:")
+    assert any(line.startswith("\tToANormalForm:") for line in lines)
+    assert "funcs: 1/1" in profiles
+    assert "objects: " in profiles
+    assert "rss: " in profiles
+
+    path = tmp_path / "passes.folded"
+    pass_profiling.export_flamegraph(str(path))
+    stacks = [line.rsplit(" ", 1) for line in path.read_text().splitlines()]
+    assert stacks[0][0] == "Pipeline"
+    assert ["Pipeline", "ToANormalForm"] in [frames.split(";")[:2] for frames, _ in stacks]
+    assert all(int(us) >= 0 for _, us in stacks)
+
+
 instrument_definition_type = tvm.testing.parameter("decorator", "subclass")
 
 
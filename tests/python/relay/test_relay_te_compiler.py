@@ -284,6 +284,60 @@ def test_compile_propogate_hash():
         assert "hash" in f.attrs.keys()
 
 
+def test_shape_buckets_from_profile():
+    observed = [8, 16, 8, 5, (8,), 16, 8, 3]
+    assert te_compiler.shape_buckets_from_profile(observed) == [[8], [16], [5], [3]]
+    assert te_compiler.shape_buckets_from_profile(observed, max_buckets=2) == [[8], [16]]
+    assert te_compiler.shape_buckets_from_profile(observed, coverage=0.5) == [[8]]
+    assert te_compiler.shape_buckets_from_profile(np.array(observed[:4], "int64")) == [
+        [8],
+        [16],
+        [5],
+    ]
+    observed = [(1, 128), (4, 128), (1, 128)]
+    assert te_compiler.shape_buckets_from_profile(observed) == [[1, 128], [4, 128]]
+
+
+@tvm.testing.requires_llvm
+def test_compile_dynamic_shape_buckets():
+    x = relay.var("x", shape=(relay.Any(), 4), dtype="float32")
+    y = relay.var("y", shape=(4,), dtype="float32")
+    mod = tvm.IRModule.from_expr(relay.Function([x, y], relay.add(x, y)))
+    mod = relay.transform.InferType()(mod)
+    config = {"relay.backend.dynamic_shape_buckets": [[8], [16], [2, 3]]}
+
+    tec = te_compiler.get()
+    tec.clear()
+    with tvm.transform.PassContext(config=config):
+        cached_func = tec.lower(mod["main"], "llvm")
+    tec.clear()
+    branches = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.IfThenElse):
+            values = set()
+
+            def _collect(cond):
+                if isinstance(cond, tvm.tir.EQ) and isinstance(cond.b, tvm.tir.IntImm):
+                    values.add(int(cond.b))
+
+            tvm.tir.stmt_functor.post_order_visit(op.condition, _collect)
+            branches.extend(values)
+
+    tvm.tir.stmt_functor.post_order_visit(cached_func.funcs[cached_func.prim_fn_var].body, _visit)
+    # The bucket with more values than dynamic dimensions is skipped.
+    assert sorted(branches) == [8, 16]
+
+    with tvm.transform.PassContext(opt_level=3, config=config):
+        exe = relay.vm.compile(mod, target="llvm")
+    vm = tvm.runtime.vm.VirtualMachine(exe, tvm.cpu())
+    y_np = np.random.uniform(size=(4,)).astype("float32")
+    for n in [8, 16, 5]:
+        x_np = np.random.uniform(size=(n, 4)).astype("float32")
+        out = vm.run(x_np, y_np)
+        tvm.testing.assert_allclose(out.numpy(), x_np + y_np)
+
+
 if __name__ == "__main__":
     test_get_valid_implementations()
     test_select_implementation()
@@ -293,3 +347,5 @@ if __name__ == "__main__":
     test_compile_tuple_dup()
     test_compile_full()
     test_compile_nhwc_pack()
+    test_shape_buckets_from_profile()
+    test_compile_dynamic_shape_buckets()
@@ -16,12 +16,13 @@
 # under the License.
 import numpy as np
 import pytest
+import threading
 import time
 from unittest.mock import patch
 
 import tvm
 from tvm import runtime
-from tvm import relay, IRModule
+from tvm import relay, IRModule, te, topi
 from tvm.relay.backend import vm
 from tvm.relay.scope_builder import ScopeBuilder
 from tvm.relay.prelude import Prelude
@@ -32,6 +33,7 @@ from tvm import rpc
 import tvm.testing
 from tvm.relay.transform import InferType
 from tvm.relay.testing import mlp
+from tvm.relay.testing.temp_op_attr import TempOpAttr
 from tvm.relay.dataflow_pattern import wildcard, is_op
 from tvm.relay.backend.vm import VMCompiler
 
@@ -969,6 +971,140 @@ def test_vm_invoke_with_outputs():
     np.testing.assert_allclose(output_tensor.numpy(), np_input + np_input)
 
 
+def test_vm_packed_concurrency():
+    target = tvm.target.Target("llvm")
+    shape = (16, 16)
+
+    # Independent branches give groups of packed calls which can run concurrently.
+    x = relay.var("x", shape=shape)
+    y = relay.var("y", shape=shape)
+    branches = [relay.exp(x), relay.log(y), relay.nn.relu(x), relay.sigmoid(y)]
+    f = relay.Function([x, y], relay.concatenate(branches, axis=0))
+    mod = IRModule.from_expr(f)
+
+    vm_exec = vm.compile(mod, target=target)
+    vm_factory = runtime.vm.VirtualMachine(vm_exec, tvm.cpu())
+    x_np = np.random.uniform(size=shape).astype("float32")
+    y_np = np.random.uniform(1, 2, size=shape).astype("float32")
+    expected = np.concatenate(
+        [np.exp(x_np), np.log(y_np), np.maximum(x_np, 0), 1 / (1 + np.exp(-y_np))], axis=0
+    )
+    for num_threads in [4, 1, 4]:
+        vm_factory.set_packed_concurrency(num_threads)
+        for _ in range(3):
+            out = vm_factory.invoke("main", x_np, y_np)
+            tvm.testing.assert_allclose(out.numpy(), expected, rtol=1e-5, atol=1e-5)
+
+
+def test_vm_packed_calls_overlap():
+    # The kernels of negative wait for each other, so they only finish when run concurrently.
+    barrier = threading.Barrier(2, timeout=30)
+
+    @tvm.register_func("testing.vm_packed_calls_overlap", override=True)
+    def _wait_and_negate(x, out):
+        barrier.wait()
+        out.copyfrom(-x.numpy())
+
+    def _compute(attrs, inputs, out_type):
+        return [
+            te.extern(
+                inputs[0].shape,
+                [inputs[0]],
+                lambda ins, outs: tvm.tir.call_packed(
+                    "testing.vm_packed_calls_overlap", ins[0], outs[0]
+                ),
+                name="wait_and_negate",
+            )
+        ]
+
+    def _strategy(attrs, inputs, out_type, target):
+        strategy = relay.op.OpStrategy()
+        strategy.add_implementation(
+            _compute,
+            relay.op.strategy.wrap_topi_schedule(topi.generic.schedule_extern),
+            name="wait_and_negate.generic",
+        )
+        return strategy
+
+    shape = (4, 4)
+    x = relay.var("x", shape=shape)
+    y = relay.var("y", shape=shape)
+    f = relay.Function([x, y], relay.add(relay.negative(x), relay.negative(y)))
+    mod = IRModule.from_expr(f)
+    with TempOpAttr("negative", "FTVMStrategy", _strategy):
+        with TempOpAttr("negative", "TOpPattern", relay.op.OpPattern.OPAQUE):
+            vm_exec = vm.compile(mod, target="llvm")
+
+    vm_factory = runtime.vm.VirtualMachine(vm_exec, tvm.cpu())
+    vm_factory.set_packed_concurrency(2)
+    x_np = np.random.uniform(size=shape).astype("float32")
+    y_np = np.random.uniform(size=shape).astype("float32")
+    out = vm_factory.invoke("main", x_np, y_np)
+    tvm.testing.assert_allclose(out.numpy(), -x_np - y_np)
+
+
+def test_vm_reentrant_packed_call():
+    # The kernel of negative invokes the VM running it, which must then resume the outer call.
+    vm_factory = None
+
+    @tvm.register_func("testing.vm_reentrant_packed_call", override=True)
+    def _negate_helper(x, out):
+        out.copyfrom(-vm_factory.invoke("helper", x.numpy()).numpy())
+
+    def _compute(attrs, inputs, out_type):
+        return [
+            te.extern(
+                inputs[0].shape,
+                [inputs[0]],
+                lambda ins, outs: tvm.tir.call_packed(
+                    "testing.vm_reentrant_packed_call", ins[0], outs[0]
+                ),
+                name="negate_helper",
+            )
+        ]
+
+    def _strategy(attrs, inputs, out_type, target):
+        strategy = relay.op.OpStrategy()
+        strategy.add_implementation(
+            _compute,
+            relay.op.strategy.wrap_topi_schedule(topi.generic.schedule_extern),
+            name="negate_helper.generic",
+        )
+        return strategy
+
+    shape = (4, 4)
+    mod = IRModule()
+    helper = relay.GlobalVar("helper")
+    a = relay.var("a", shape=shape)
+    mod[helper] = relay.Function([a], relay.exp(a))
+    x = relay.var("x", shape=shape)
+    y = relay.var("y", shape=shape)
+    mod["main"] = relay.Function([x, y], relay.add(relay.negative(x), helper(y)))
+    with TempOpAttr("negative", "FTVMStrategy", _strategy):
+        with TempOpAttr("negative", "TOpPattern", relay.op.OpPattern.OPAQUE):
+            vm_exec = vm.compile(mod, target="llvm")
+
+    vm_factory = runtime.vm.VirtualMachine(vm_exec, tvm.cpu())
+    x_np = np.random.uniform(size=shape).astype("float32")
+    y_np = np.random.uniform(size=shape).astype("float32")
+    for _ in range(2):
+        out = vm_factory.invoke("main", x_np, y_np)
+        tvm.testing.assert_allclose(out.numpy(), -np.exp(x_np) + np.exp(y_np), rtol=1e-5)
+
+
+def test_vm_direct_call():
+    shape = (4, 4)
+    x = relay.var("x", shape=shape)
+    mod = IRModule.from_expr(relay.Function([x], relay.exp(x)))
+    vm_exec = vm.compile(mod, target="llvm")
+    vm_factory = runtime.vm.VirtualMachine(vm_exec, tvm.cpu())
+    # The kernel only takes tensors, so InvokePacked can call it through its direct-call entry.
+    assert vm_factory.module["get_num_direct_call_funcs"]() == 1
+    x_np = np.random.uniform(size=shape).astype("float32")
+    out = vm_factory.invoke("main", x_np)
+    tvm.testing.assert_allclose(out.numpy(), np.exp(x_np), rtol=1e-5, atol=1e-5)
+
+
 def test_get_output_single():
     target = tvm.target.Target("llvm")
 
@@ -43,6 +43,20 @@ def test_infer_bound():
     s = dag.infer_bound_from_state(s)
 
 
+def test_infer_bound_incremental():
+    dag, s = get_tiled_matmul()
+    # Cache the schedule replayed for the parent state
+    dag.infer_bound_from_state(s)
+    C = s.stage_ops[2]
+    fused = s.fuse(C, s[C].iters[:2])
+    s.parallel(C, fused)
+    incremental = dag.infer_bound_from_state(s)
+
+    dag.set_infer_bound_cache_size(0)
+    expected = dag.infer_bound_from_state(s)
+    assert str(incremental) == str(expected)
+
+
 def test_estimate_flop():
     N = 512
     A, B, C = matmul_auto_scheduler_test(N, N, N)
@@ -152,6 +166,7 @@ def test_invalid_compute_dag():
 if __name__ == "__main__":
     test_apply_steps()
     test_infer_bound()
+    test_infer_bound_incremental()
     test_estimate_flop()
     test_stage_order()
     test_invalid_compute_dag()
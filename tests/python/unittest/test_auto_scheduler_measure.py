@@ -203,6 +203,51 @@ def test_recover_measure_input():
         assert str(correct_inp.state) == str(inp.state)
 
 
+def test_load_records_parallel():
+    if not tvm.testing.device_enabled("llvm"):
+        return
+
+    tasks = [
+        auto_scheduler.SearchTask(
+            func=matmul_auto_scheduler_test, args=(n, n, n), target=tvm.target.Target("llvm")
+        )
+        for n in [64, 128]
+    ]
+    inputs, results = [], []
+    for i in range(8):
+        task = tasks[i % 2]
+        inputs.append(auto_scheduler.MeasureInput(task, task.compute_dag.init_state))
+        error_no = 1 if i == 7 else 0
+        results.append(auto_scheduler.MeasureResult([0.1 * (i + 1)], error_no, "", 0.2, 1))
+
+    with tempfile.NamedTemporaryFile() as fp:
+        auto_scheduler.save_records(fp.name, inputs, results)
+
+        ref_inputs, ref_results = auto_scheduler.RecordReader(fp.name).read_lines()
+        for num_threads in [1, 4]:
+            p_inputs, p_results = auto_scheduler.load_records_parallel(
+                fp.name, num_threads=num_threads
+            )
+            assert len(p_inputs) == len(ref_inputs)
+            for ref_res, res in zip(ref_results, p_results):
+                assert str(ref_res) == str(res)
+
+        p_inputs, _ = auto_scheduler.load_records_parallel(fp.name, tasks[1].workload_key)
+        assert len(p_inputs) == 4
+        assert all(inp.task.workload_key == tasks[1].workload_key for inp in p_inputs)
+
+        best = auto_scheduler.load_best_records(fp.name)
+        assert set(best.keys()) == {task.workload_key for task in tasks}
+        for task, expected_cost in zip(tasks, [0.1, 0.2]):
+            assert len(best[task.workload_key]) == 1
+            _, res = best[task.workload_key][0]
+            assert abs(res.costs[0].value - expected_cost) < 1e-6
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        p_inputs, _ = auto_scheduler.load_records_parallel(tmpdir + "/missing.json")
+        assert len(p_inputs) == 0
+
+
 def test_workload_dis_factor():
     calc = auto_scheduler.utils.calc_workload_dis_factor
     decode = auto_scheduler.utils.decode_workload_key
@@ -134,6 +134,55 @@ def test_meta_schedule_multiple_build():
     _check_build_results(builder_results)
 
 
+def test_meta_schedule_persistent_batched_build():
+    """Test meta schedule builder with persistent workers and batched builds"""
+    builder = LocalBuilder(
+        max_workers=2, persistent_workers=True, max_worker_uses=2, batch_size=2
+    )
+    builder_inputs = [
+        BuilderInput(MatmulModule, Target("llvm")),
+        BuilderInput(MatmulReluModule, Target("llvm")),
+        BuilderInput(BatchMatmulModule, Target("llvm")),
+    ]
+    for _ in range(3):
+        builder_results = builder.build(builder_inputs)
+        assert len(builder_results) == len(builder_inputs)
+        _check_build_results(builder_results)
+    builder.close()
+    assert builder._pool is None  # pylint: disable=protected-access
+    # A closed builder starts a fresh pool on the next build.
+    builder_results = builder.build(builder_inputs)
+    _check_build_results(builder_results)
+    builder.close()
+
+
+def test_meta_schedule_error_handle_batched_build():
+    """Test that an error in one candidate does not fail the rest of its batch"""
+
+    def initializer():
+        @register_func("meta_schedule.builder.test_partial_build")
+        def test_build(mod: Module, target: Target, _):  # pylint: disable=unused-variable
+            if "batch_matmul" in [gv.name_hint for gv in mod.get_global_vars()]:
+                raise ValueError("Builder intended Test Error (batched build).")
+            return tvm.build(mod, target=target)
+
+    builder = LocalBuilder(
+        f_build="meta_schedule.builder.test_partial_build",
+        initializer=initializer,
+        batch_size=3,
+    )
+    builder_inputs = [
+        BuilderInput(MatmulModule, Target("llvm")),
+        BuilderInput(BatchMatmulModule, Target("llvm")),
+        BuilderInput(MatmulReluModule, Target("llvm")),
+    ]
+    builder_results = builder.build(builder_inputs)
+    assert len(builder_results) == len(builder_inputs)
+    _check_build_results([builder_results[0], builder_results[2]])
+    assert builder_results[1].artifact_path is None
+    assert builder_results[1].error_msg.startswith("LocalBuilder: An exception occurred")
+
+
 def test_meta_schedule_error_handle_test_builder():
     """Test the error handing during building"""
 
@@ -19,6 +19,7 @@ import tvm.testing
 from tvm import te, runtime
 import numpy as np
 import json
+import pytest
 from tvm import rpc
 from tvm import relay
 from tvm.contrib import utils, graph_executor
@@ -138,6 +139,33 @@ def test_load_unexpected_params():
     rt_mod.load_params(runtime.save_param_dict(new_params))
 
 
+def test_graph_binary():
+    x = relay.var("x", shape=(2, 8))
+    y = relay.var("y", shape=(2, 8))
+    func = relay.Function([x, y], relay.nn.relu(relay.add(x, y)) * y)
+    graph, lib, _ = relay.build(func, target="llvm")
+
+    graph_binary = graph_executor.graph_json_to_binary(graph)
+    assert graph_binary[:4] == b"TVMG"
+    assert len(graph_binary) % 8 == 0
+
+    x_in = np.random.uniform(-1, 1, size=(2, 8)).astype("float32")
+    y_in = np.random.uniform(-1, 1, size=(2, 8)).astype("float32")
+    outputs = []
+    for g in [graph, graph_binary]:
+        mod = graph_executor.create(g, lib, tvm.cpu(0))
+        assert mod.get_num_inputs() == 2
+        mod.run(x=x_in, y=y_in)
+        outputs.append(mod.get_output(0).numpy())
+    np.testing.assert_equal(outputs[1], outputs[0])
+
+    # A corrupt binary graph is rejected rather than used.
+    truncated = graph_binary[: len(graph_binary) - 8]
+    with pytest.raises(tvm.TVMError):
+        graph_executor.create(truncated, lib, tvm.cpu(0))
+
+
 if __name__ == "__main__":
     test_graph_simple()
     test_load_unexpected_params()
+    test_graph_binary()
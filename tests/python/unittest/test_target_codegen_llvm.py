@@ -18,6 +18,7 @@ import collections
 import ctypes
 import json
 import math
+import os
 import numpy as np
 import pytest
 import re
@@ -978,5 +979,79 @@ def test_llvm_target_attributes():
         assert n in functions_with_target
 
 
+@tvm.testing.requires_llvm
+def test_llvm_direct_call_entry():
+    n = 16
+    A = te.placeholder((n,), name="A")
+    B = te.compute(A.shape, lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    f = tvm.build(s, [A, B], "llvm", name="add_one")
+
+    def check(mod):
+        # The kernel exports the signature of its direct-call entry.
+        query = mod.get_function("__tvm_direct_call__add_one")
+        assert query() is not None
+        with pytest.raises(AttributeError):
+            mod.get_function("__tvm_direct_call__not_a_function", query_imports=True)
+        dev = tvm.cpu(0)
+        a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+        b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+        mod["add_one"](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+        # Call the kernel through its direct-call entry, with a null array of type codes.
+        c = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+        tvm.testing.call_direct(mod, "add_one", a, c)
+        tvm.testing.assert_allclose(c.numpy(), a.numpy() + 1.0)
+
+    check(f)
+    temp = utils.tempdir()
+    path = temp.relpath("add_one.so")
+    f.export_library(path)
+    check(tvm.runtime.load_module(path))
+
+
+@pytest.mark.skipif(
+    tvm.target.codegen.llvm_version_major() < 13, reason="ORC JIT requires LLVM 13 or newer"
+)
+def test_llvm_orcjit(monkeypatch):
+    temp = utils.tempdir()
+    monkeypatch.setenv("TVM_LLVM_JIT_CACHE_DIR", temp.relpath("jit_cache"))
+    n = 64
+    A = te.placeholder((n,), name="A")
+    B = te.compute(A.shape, lambda i: A[i] + 1.0, name="B")
+    C = te.compute(A.shape, lambda i: A[i] * 2.0, name="C")
+    s_add = te.create_schedule(B.op)
+    s_mul = te.create_schedule(C.op)
+    s_mul[C].parallel(C.op.axis[0])
+    mod = tvm.IRModule({})
+    mod.update(tvm.lower(s_add, [A, B], name="add_one"))
+    mod.update(tvm.lower(s_mul, [A, C], name="mul_two"))
+    target = tvm.target.Target("llvm -jit=orcjit")
+    assert target.attrs["jit"] == "orcjit"
+
+    dev = tvm.cpu(0)
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype), dev)
+
+    def check():
+        f = tvm.build(mod, target=target)
+        b = tvm.nd.array(np.zeros(n, dtype=B.dtype), dev)
+        c = tvm.nd.array(np.zeros(n, dtype=C.dtype), dev)
+        f["add_one"](a, b)
+        tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+        f["mul_two"](a, c)
+        tvm.testing.assert_allclose(c.numpy(), a.numpy() * 2.0)
+        # The module is still available after being JIT compiled.
+        assert "add_one" in f.get_source()
+
+    cache_hits = tvm.get_global_func("target.llvm_jit_object_cache_hits")
+    num_hits = cache_hits()
+    check()
+    assert len(os.listdir(temp.relpath("jit_cache"))) > 0
+    assert cache_hits() == num_hits
+    # The second build loads the compiled objects from the cache.
+    check()
+    assert cache_hits() > num_hits
+
+
 if __name__ == "__main__":
     tvm.testing.main()
@@ -18,6 +18,7 @@ import tvm
 import tvm.testing
 from tvm import te
 import numpy as np
+import pytest
 
 
 def run_jit(fapi, check):
@@ -122,7 +123,46 @@ def test_vm_parallel():
     run_jit(mod, check)
 
 
+def test_stack_vm_packed_api():
+    # MakePackedAPI guards the type code checks with an if_then_else on the type code array.
+    if not tvm.testing.device_enabled("stackvm"):
+        return
+    n = 10
+    A = te.placeholder((n,), name="A")
+    B = te.compute(A.shape, lambda i: A[i] + 1.0, name="B")
+    s = te.create_schedule(B.op)
+    f = tvm.build(s, [A, B], "stackvm", name="add_one")
+
+    a = tvm.nd.array(np.random.uniform(size=n).astype(A.dtype))
+    b = tvm.nd.array(np.zeros(n, dtype=B.dtype))
+    f(a, b)
+    tvm.testing.assert_allclose(b.numpy(), a.numpy() + 1.0)
+    with pytest.raises(tvm.TVMError, match="Expect arg\\[0\\] to be pointer"):
+        f(1, b)
+
+
+def test_stack_vm_if_then_else():
+    dtype = "int64"
+    n = te.size_var("n")
+    Ab = tvm.tir.decl_buffer((n,), dtype)
+    ib = tvm.tir.ir_builder.create()
+    A = ib.buffer_ptr(Ab)
+    with ib.for_range(0, n, "i") as i:
+        A[i] = tvm.tir.if_then_else(i % 2 == 0, A[i] + 1, A[i] - 1)
+    stmt = ib.get()
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([Ab], stmt).with_attr("global_symbol", "test"))
+
+    def check(f):
+        a = tvm.nd.array(np.zeros(10, dtype=dtype))
+        f(a)
+        np.testing.assert_equal(a.numpy(), [1, -1] * 5)
+
+    run_jit(mod, check)
+
+
 if __name__ == "__main__":
+    test_stack_vm_if_then_else()
+    test_stack_vm_packed_api()
     test_vm_parallel()
     test_stack_vm_loop()
     test_stack_vm_basic()
@@ -254,6 +254,32 @@ def test_tir_schedule_copy_2():
     verify_trace_roundtrip(sch_copy, mod=matmul)
 
 
+def test_tir_schedule_copy_3():
+    # Tests:
+    # - Schedule.copy when the forks are mutated in an interleaved order
+    sch = tir.Schedule(mod=matmul, debug_mask="all")
+    block = sch.get_block("update")
+    i, j, k = sch.get_loops(block)
+    sch_1 = sch.copy()
+    sch_2 = sch_1.copy()
+    sch.parallel(i)
+    sch_1.vectorize(k)
+    assert sch.get(i).kind == tir.ForKind.PARALLEL
+    assert sch.get(k).kind == tir.ForKind.SERIAL
+    assert sch_1.get(i).kind == tir.ForKind.SERIAL
+    assert sch_1.get(k).kind == tir.ForKind.VECTORIZED
+    assert sch_2.get(i).kind == tir.ForKind.SERIAL
+    assert sch_2.get(k).kind == tir.ForKind.SERIAL
+    tvm.ir.assert_structural_equal(sch_2.mod["main"], matmul)
+    sch_2.reorder(k, j)
+    assert not sch_2.get_sref(j).same_as(sch_1.get_sref(j))
+    assert sch_2.get_sref(j).parent.same_as(sch_2.get_sref(k))
+    assert sch_1.get_sref(k).parent.same_as(sch_1.get_sref(j))
+    verify_trace_roundtrip(sch, mod=matmul)
+    verify_trace_roundtrip(sch_1, mod=matmul)
+    verify_trace_roundtrip(sch_2, mod=matmul)
+
+
 def test_tir_schedule_remove_rv():
     # Tests:
     # - Schedule.remove_rv
@@ -134,11 +134,16 @@ def test_legalize():
             "uint32", "tir.bitwise_and", rounding_bias, tvm.tir.const(1, "uint32")
         )
         rounding_bias = rounding_bias + tvm.tir.const(0x7FFF, "uint16")
-        uint32_v = uint32_v + rounding_bias
-        uint32_v = tvm.tir.call_intrin(
-            "uint32", "tir.shift_right", uint32_v, tvm.tir.const(16, "uint32")
+        rounded = uint32_v + rounding_bias
+        rounded = tvm.tir.call_intrin(
+            "uint32", "tir.shift_right", rounded, tvm.tir.const(16, "uint32")
+        )
+        rounded = topi.cast(rounded, "uint16")
+        abs_v = tvm.tir.call_intrin(
+            "uint32", "tir.bitwise_and", uint32_v, tvm.tir.const(0x7FFFFFFF, "uint32")
         )
-        return topi.cast(uint32_v, "uint16")
+        is_nan = abs_v > tvm.tir.const(0x7F800000, "uint32")
+        return tvm.tir.Select(is_nan, tvm.tir.const(0x7FC0, "uint16"), rounded)
 
     def check(fcompute_before, fcompute_after):
         a = te.placeholder((100,), dtype="bfloat16", name="A")
@@ -0,0 +1,151 @@
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+import numpy as np
+
+import tvm
+import tvm.testing
+from tvm.script import tir as T
+
+
+@T.prim_func
+def matvec(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, [65536], "float32")
+    B = T.match_buffer(b, [256], "float32")
+    C = T.match_buffer(c, [256], "float32")
+    for i in T.serial(256):
+        C[i] = T.float32(0)
+        for k in T.serial(256):
+            C[i] = C[i] + A[i * 256 + k] * B[k]
+
+
+@T.prim_func
+def transposed_matvec(a: T.handle, b: T.handle, c: T.handle) -> None:
+    A = T.match_buffer(a, [65536], "float32")
+    B = T.match_buffer(b, [256], "float32")
+    C = T.match_buffer(c, [256], "float32")
+    for i in T.serial(256):
+        C[i] = T.float32(0)
+        for k in T.serial(256):
+            C[i] = C[i] + A[k * 256 + i] * B[k]
+
+
+@T.prim_func
+def inner_loop_and_unrolled(a: T.handle, b: T.handle, c: T.handle, d: T.handle) -> None:
+    A = T.match_buffer(a, [65536], "float32")
+    B = T.match_buffer(b, [512], "float32")
+    C = T.match_buffer(c, [4], "float32")
+    D = T.match_buffer(d, [2], "float32")
+    for k in T.serial(256):
+        for j in T.serial(4):
+            C[j] = C[j] + A[k * 256 + j]
+        for u in T.unroll(2):
+            D[u] = D[u] + B[k * 2 + u]
+
+
+@T.prim_func
+def elementwise(a: T.handle, b: T.handle) -> None:
+    A = T.match_buffer(a, [65536], "float32")
+    B = T.match_buffer(b, [65536], "float32")
+    for i in T.serial(65536):
+        B[i] = A[i] + T.float32(1)
+
+
+def _prefetches(func, target):
+    mod = tvm.IRModule.from_expr(func.with_attr("target", tvm.target.Target(target)))
+    body = tvm.tir.transform.InjectSoftwarePrefetch()(mod)["main"].body
+    calls = []
+
+    def _visit(op):
+        if isinstance(op, tvm.tir.Call) and op.op.same_as(tvm.ir.Op.get("tir.prefetch")):
+            calls.append(op)
+
+    tvm.tir.stmt_functor.post_order_visit(body, _visit)
+    return calls
+
+
+def _offsets(prefetches):
+    """The prefetched index of each buffer at the first iteration of all loops."""
+    result = {}
+    for prefetch in prefetches:
+        load = prefetch.args[0].args[0]
+        index = load.indices[0]
+        zeros = {}
+
+        def _zero(op):
+            if isinstance(op, tvm.tir.Var):
+                zeros[op] = tvm.tir.const(0, op.dtype)
+
+        tvm.tir.stmt_functor.post_order_visit(index, _zero)
+        zero = tvm.tir.stmt_functor.substitute(index, zeros)
+        result[load.buffer.name] = int(tvm.arith.Analyzer().simplify(zero))
+    return result
+
+
+def test_reduction_streams():
+    prefetches = _prefetches(matvec, "llvm -sw-prefetch=1")
+    assert len(prefetches) == 2
+    for prefetch in prefetches:
+        assert [int(arg) for arg in prefetch.args[1:]] == [0, 3, 1]
+    assert sorted(_offsets(prefetches)) == ["A", "B"]
+
+
+def test_latency_attribute():
+    short = _offsets(_prefetches(matvec, "llvm -sw-prefetch=1 -sw-prefetch-latency=1"))
+    long = _offsets(_prefetches(matvec, "llvm -sw-prefetch=1 -sw-prefetch-latency=1000"))
+    # With a negligible latency, the prefetch is one cache line ahead.
+    assert short == {"A": 16, "B": 16}
+    assert long["A"] == long["B"] > 16
+
+
+def test_strided_stream():
+    prefetches = _prefetches(transposed_matvec, "llvm -sw-prefetch=1 -sw-prefetch-latency=1")
+    # A stride of a cache line or more is prefetched a single iteration ahead.
+    assert _offsets(prefetches) == {"A": 256, "B": 16}
+
+
+def test_not_applied():
+    # Disabled by default.
+    assert not _prefetches(matvec, "llvm")
+    # Not a reduction loop.
+    assert not _prefetches(elementwise, "llvm -sw-prefetch=1")
+    # Not an innermost loop, the serial loop is followed by an unrolled sibling.
+    assert not _prefetches(inner_loop_and_unrolled, "llvm -sw-prefetch=1")
+
+
+def test_idempotent():
+    mod = tvm.IRModule.from_expr(
+        matvec.with_attr("target", tvm.target.Target("llvm -sw-prefetch=1"))
+    )
+    once = tvm.tir.transform.InjectSoftwarePrefetch()(mod)
+    twice = tvm.tir.transform.InjectSoftwarePrefetch()(once)
+    tvm.ir.assert_structural_equal(once, twice)
+
+
+@tvm.testing.requires_llvm
+def test_build():
+    target = "llvm -sw-prefetch=1"
+    mod = tvm.build(matvec, target=target)
+    assert "llvm.prefetch" in mod.get_source("ll")
+    a = np.random.uniform(size=65536).astype("float32")
+    b = np.random.uniform(size=256).astype("float32")
+    c = tvm.nd.empty((256,), "float32")
+    mod(tvm.nd.array(a), tvm.nd.array(b), c)
+    tvm.testing.assert_allclose(c.numpy(), a.reshape(256, 256).dot(b), rtol=1e-5)
+
+
+if __name__ == "__main__":
+    tvm.testing.main()
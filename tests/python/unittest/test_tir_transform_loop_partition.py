@@ -96,6 +96,60 @@ def test_no_unroll_loop():
     assert sum(collect_visit(stmt, lambda x: isinstance(x, tvm.tir.For))) == 4
 
 
+def _partition_split_loop(config):
+    n = 21
+    A = te.placeholder((n,), name="A")
+    B = te.placeholder((n,), name="B")
+
+    T = te.compute((n,), lambda i: A[i] + B[i])
+    s = te.create_schedule(T.op)
+    xo, xi = s[T].split(T.op.axis[0], factor=4)
+
+    bounds = tvm.te.schedule.InferBound(s)
+    stmt = tvm.te.schedule.ScheduleOps(s, bounds)
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([], stmt))
+    config = {"cost_guided": True, **config}
+    with tvm.transform.PassContext(config={"tir.LoopPartition": config}):
+        mod = tvm.tir.transform.LoopPartition()(mod)
+        return tvm.tir.transform.Simplify()(mod)["main"].body
+
+
+def test_cost_guided_partition():
+    def num_if(stmt):
+        return sum(collect_visit(stmt, lambda x: isinstance(x, tvm.tir.IfThenElse)))
+
+    def outer_extents(stmt):
+        return [
+            int(x.extent)
+            for x in collect_visit(stmt, lambda x: x)
+            if isinstance(x, tvm.tir.For) and x.loop_var.name == "i.outer"
+        ]
+
+    # The outer loop is split as its first 5 of 6 iterations are condition free, but not
+    # the inner loop of the tail, where the condition holds for 1 of 4 iterations.
+    stmt = _partition_split_loop({})
+    assert outer_extents(stmt) == [5]
+    assert num_if(stmt) == 1
+
+    # None of the partitions runs enough of the iterations.
+    stmt = _partition_split_loop({"min_hot_iteration_ratio": 0.9})
+    assert outer_extents(stmt) == [6]
+    assert num_if(stmt) == 1
+
+    # Partitioning always grows the code.
+    stmt = _partition_split_loop({"code_size_budget": 0})
+    assert outer_extents(stmt) == [6]
+    assert num_if(stmt) == 1
+
+    stmt = _partition_split_loop({"code_size_budget": 1000})
+    assert outer_extents(stmt) == [5]
+
+    # Constant loops are only partitioned when asked to.
+    stmt = _partition_split_loop({"cost_guided": False})
+    assert outer_extents(stmt) == [6]
+
+
 def test_multi_loop():
     ib = tvm.tir.ir_builder.create()
     m = te.size_var("m")
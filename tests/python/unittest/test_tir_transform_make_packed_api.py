@@ -147,5 +147,40 @@ def test_device_api_context_implicit_resource_handle():
     assert call_extern.args[2] == device_context_in_resource_handle
 
 
+def test_direct_call_signature():
+    n = te.size_var("n")
+    A = te.placeholder((n,), name="A")
+    B = te.compute(A.shape, lambda *i: A(*i) + 1.0, name="B")
+    s = te.create_schedule(B.op)
+
+    mod = schedule_to_module(s, [n, A, B])
+    mod = tvm.tir.transform.StorageFlatten(64)(mod)
+    mod = tvm.tir.transform.Apply(
+        lambda f: f.with_attr(
+            {
+                "target": tvm.target.Target("llvm"),
+                "global_symbol": "main",
+            }
+        )
+    )(mod)
+
+    f = tvm.tir.transform.MakePackedAPI()(mod)["main"]
+    assert f.attrs["tir.direct_call_signature"] == "ihh"
+
+    # The type codes are only checked when they are passed in.
+    type_code_checks = []
+
+    def visit(stmt):
+        if isinstance(stmt, tvm.tir.AssertStmt) and "Expect arg[" in stmt.message.value:
+            type_code_checks.append(stmt.condition)
+
+    tvm.tir.stmt_functor.post_order_visit(f.body, visit)
+    assert len(type_code_checks) == 3
+    for cond in type_code_checks:
+        assert isinstance(cond, tvm.tir.Call) and cond.op.name == "tir.if_then_else"
+        assert cond.args[0].op.name == "tir.isnullptr"
+
+
 if __name__ == "__main__":
     test_makeapi()
+    test_direct_call_signature()
@@ -14,6 +14,8 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import threading
+
 import tvm
 import tvm.testing
 from tvm import te
@@ -63,6 +65,73 @@ def test_cow_pass():
     assert func_hash == mod["main"].__hash__()
 
 
+def test_parallel_prim_func_pass():
+    funcs = {}
+    for i in range(16):
+        x = te.var("x")
+        body = tvm.tir.Evaluate(tvm.tir.Add(x, tvm.tir.IntImm("int32", 0)))
+        funcs["func%d" % i] = tvm.tir.PrimFunc([x], body).with_attr("index", i)
+    mod = tvm.IRModule(funcs)
+    expected = tvm.tir.transform.Simplify()(mod)
+
+    for num_threads in [2, -1]:
+        with tvm.transform.PassContext(config={"ir.function_pass_num_threads": num_threads}):
+            result = tvm.tir.transform.Simplify()(mod)
+        tvm.ir.assert_structural_equal(result, expected)
+        # The input module is not modified while its functions are transformed.
+        assert not tvm.ir.structural_equal(mod, expected)
+
+    def fremove(func, mod, ctx):
+        return None if func.attrs["index"] % 2 else func
+
+    with tvm.transform.PassContext(config={"ir.function_pass_num_threads": 4}):
+        result = tvm.tir.transform.prim_func_pass(fremove, opt_level=0, thread_safe=True)(mod)
+    assert len(result.functions) == 8
+
+
+def test_parallel_prim_func_pass_opt_in():
+    funcs = {}
+    for i in range(8):
+        x = te.var("x")
+        funcs["func%d" % i] = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x))
+    mod = tvm.IRModule(funcs)
+
+    thread_ids = set()
+
+    def frecord(func, mod, ctx):
+        thread_ids.add(threading.get_ident())
+        return func
+
+    # Passes that are not marked thread-safe keep transforming one function at a time.
+    with tvm.transform.PassContext(config={"ir.function_pass_num_threads": 4}):
+        tvm.tir.transform.prim_func_pass(frecord, opt_level=0)(mod)
+    assert thread_ids == {threading.get_ident()}
+    assert not tvm.tir.transform.prim_func_pass(frecord, opt_level=0).info.thread_safe
+    assert tvm.tir.transform.Simplify().info.thread_safe
+
+
+def test_parallel_prim_func_pass_timing():
+    funcs = {}
+    for i in range(4):
+        x = te.var("x")
+        funcs["func%d" % i] = tvm.tir.PrimFunc([x], tvm.tir.Evaluate(x + 0))
+    mod = tvm.IRModule(funcs)
+
+    timing_inst = tvm.ir.instrument.PassTimingInstrument()
+    with tvm.transform.PassContext(
+        instruments=[timing_inst], config={"ir.function_pass_num_threads": 2}
+    ):
+        tvm.tir.transform.Simplify()(mod)
+        profiles = timing_inst.render()
+    assert "tir.Simplify" in profiles
+    # Every function transformed concurrently is reported under the pass.
+    for name in funcs:
+        assert "%s (concurrent)" % name in profiles
+
+
 if __name__ == "__main__":
     test_cow_pass()
     test_prim_func_pass()
+    test_parallel_prim_func_pass()
+    test_parallel_prim_func_pass_opt_in()
+    test_parallel_prim_func_pass_timing()
@@ -142,6 +142,7 @@ class BaseBeforeAfter(tvm.testing.CompareBeforeAfter):
     apply_constraints_to_boolean_branches = False
     propagate_knowns_to_prove_conditional = False
     propagate_knowns_to_simplify_expressions = False
+    enable_memoization = False
 
     def transform(self):
         def inner(mod):
@@ -152,7 +153,8 @@ class BaseBeforeAfter(tvm.testing.CompareBeforeAfter):
                     "apply_constraints_to_boolean_branches": self.apply_constraints_to_boolean_branches,
                     "propagate_knowns_to_prove_conditional": self.propagate_knowns_to_prove_conditional,
                     "propagate_knowns_to_simplify_expressions": self.propagate_knowns_to_simplify_expressions,
-                }
+                },
+                "arith.enable_memoization": self.enable_memoization,
             }
             with tvm.transform.PassContext(config=config):
                 mod = tvm.tir.transform.Simplify()(mod)
@@ -226,6 +228,33 @@ class TestNestedProvableCondition(BaseBeforeAfter):
                 A[i] = 0.0
 
 
+class TestNestedProvableConditionMemoized(TestNestedProvableCondition):
+    """As TestNestedProvableCondition, with memoized analyzer queries."""
+
+    enable_memoization = True
+
+
+class TestMemoizedConditionOutOfScope(BaseBeforeAfter):
+    """A condition proven under a constraint is not proven outside of it."""
+
+    enable_memoization = True
+
+    def before(A: T.Buffer[(16,), "float32"]):
+        for i in T.serial(16):
+            if i == 5:
+                if i < 7:
+                    A[i] = 0.0
+            if i < 7:
+                A[i] = 1.0
+
+    def expected(A: T.Buffer[(16,), "float32"]):
+        for i in T.serial(16):
+            if i == 5:
+                A[i] = 0.0
+            if i < 7:
+                A[i] = 1.0
+
+
 class TestNestedVarCondition(BaseBeforeAfter):
     """Simplify inner conditional using constraint from outer.
 
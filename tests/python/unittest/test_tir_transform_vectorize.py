@@ -14,7 +14,10 @@
 # KIND, either express or implied.  See the License for the
 # specific language governing permissions and limitations
 # under the License.
+import numpy as np
+
 import tvm
+import tvm.testing
 from tvm import te
 
 
@@ -171,6 +174,143 @@ def test_vectorize_if_then_else():
     assert isinstance(stmt.body.value.args[2], tvm.tir.Broadcast)
 
 
+masked_tail_config = {"tir.VectorizeLoop": {"enable_masked_tail": True}}
+
+
+def test_vectorize_masked_if():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            A[i] = A[i] + 1
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, n], stmt))
+    with tvm.target.Target("llvm"), tvm.transform.PassContext(config=masked_tail_config):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    assert isinstance(stmt, tvm.tir.IfThenElse)
+    assert stmt.condition.dtype == "boolx4"
+    assert isinstance(stmt.then_case.indices[0], tvm.tir.Ramp)
+    assert stmt.then_case.value.dtype == "float32x4"
+
+
+def test_vectorize_masked_if_then_else():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    B = ib.pointer("float32", name="B")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        B[i] = tvm.tir.call_intrin("float32", "tir.if_then_else", i < n, A[i], 0.0)
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, B, n], stmt))
+    with tvm.target.Target("llvm"), tvm.transform.PassContext(config=masked_tail_config):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    assert isinstance(stmt, tvm.tir.BufferStore)
+    assert stmt.value.args[0].dtype == "boolx4"
+    assert stmt.value.dtype == "float32x4"
+
+
+def test_vectorize_masked_if_gather_fallback():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, 4, kind="vectorize") as i:
+        with ib.if_scope(i < n):
+            A[i] = A[i * 2] + 1
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, n], stmt))
+    with tvm.target.Target("llvm"), tvm.transform.PassContext(config=masked_tail_config):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    # A strided load cannot be masked, the statement is scalarized.
+    assert isinstance(stmt, tvm.tir.For)
+
+
+def test_vectorize_dynamic_extent():
+    n = te.var("n")
+    ib = tvm.tir.ir_builder.create()
+    A = ib.pointer("float32", name="A")
+    with ib.for_range(0, n, kind="vectorize") as i:
+        A[i] = A[i] + 1
+    stmt = ib.get()
+
+    mod = tvm.IRModule.from_expr(tvm.tir.PrimFunc([A, n], stmt))
+    config = {"enable_masked_tail": True, "dynamic_extent_lanes": 8}
+    with tvm.target.Target("llvm"), tvm.transform.PassContext(config={"tir.VectorizeLoop": config}):
+        stmt = tvm.tir.transform.VectorizeLoop()(mod)["main"].body
+
+    main_loop, tail = stmt
+    assert isinstance(main_loop, tvm.tir.For)
+    assert main_loop.body.value.dtype == "float32x8"
+    assert isinstance(tail, tvm.tir.IfThenElse)
+    assert tail.condition.dtype == "bool"
+    assert tail.then_case.condition.dtype == "boolx8"
+    assert tail.then_case.then_case.value.dtype == "float32x8"
+
+
+@tvm.testing.requires_llvm
+def test_vectorize_masked_tail_llvm():
+    n = te.size_var("n")
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1, name="B")
+    C = te.compute((n,), lambda i: B[i] * 2, name="C")
+    s = te.create_schedule(C.op)
+    _, inner = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(inner)
+    s[C].vectorize(C.op.axis[0])
+
+    # The target is needed while lowering, masking is only applied for llvm.
+    config = {"enable_masked_tail": True, "dynamic_extent_lanes": 8}
+    with tvm.target.Target("llvm"), tvm.transform.PassContext(config={"tir.VectorizeLoop": config}):
+        f = tvm.build(s, [A, C])
+    ll = f.get_source("ll")
+    assert "llvm.masked.load" in ll
+    assert "llvm.masked.store" in ll
+
+    dev = tvm.cpu()
+    for size in [5, 8, 37]:
+        a = tvm.nd.array(np.random.uniform(size=size).astype("float32"), dev)
+        c = tvm.nd.array(np.zeros(size, dtype="float32"), dev)
+        f(a, c)
+        tvm.testing.assert_allclose(c.numpy(), (a.numpy() + 1) * 2)
+
+
+def test_vectorize_masked_tail_non_llvm():
+    n = te.size_var("n")
+    A = te.placeholder((n,), name="A")
+    B = te.compute((n,), lambda i: A[i] + 1, name="B")
+    s = te.create_schedule(B.op)
+    _, inner = s[B].split(B.op.axis[0], factor=8)
+    s[B].vectorize(inner)
+
+    def vector_conditions(mod):
+        conditions = []
+
+        def fvisit(node):
+            if isinstance(node, tvm.tir.IfThenElse):
+                conditions.append(node.condition)
+            elif isinstance(node, tvm.tir.Call) and node.op.name == "tir.if_then_else":
+                conditions.append(node.args[0])
+
+        tvm.tir.stmt_functor.post_order_visit(mod["main"].body, fvisit)
+        return [cond for cond in conditions if cond.dtype.lanes > 1]
+
+    # Codegens other than llvm print vector conditions as is, the guarded statement is
+    # scalarized instead of masked.
+    config = {"tir.VectorizeLoop": {"enable_masked_tail": True, "dynamic_extent_lanes": 8}}
+    with tvm.transform.PassContext(config=config):
+        assert not vector_conditions(tvm.lower(s, [A, B]))
+        with tvm.target.Target("c"):
+            assert not vector_conditions(tvm.lower(s, [A, B]))
+            f = tvm.build(s, [A, B])
+    assert "for (" in f.get_source()
+
+
 def test_vectorize_while_fail():
     """A while loop inside a vectorized loop should fail."""
 
@@ -234,5 +374,11 @@ if __name__ == "__main__":
     test_vectorize_with_le_cond()
     test_vectorize_with_ge_cond()
     test_vectorize_let()
+    test_vectorize_masked_if()
+    test_vectorize_masked_if_then_else()
+    test_vectorize_masked_if_gather_fallback()
+    test_vectorize_dynamic_extent()
+    test_vectorize_masked_tail_llvm()
+    test_vectorize_masked_tail_non_llvm()
     test_vectorize_while_fail()
     test_vectorize_dtype_mismatch()